@@ -0,0 +1,151 @@
+#ifndef Aligned_Write_Updater_h
+#define Aligned_Write_Updater_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IUpdater.h"
+
+// Library include.
+#include <stdlib.h>
+#include <string.h>
+
+
+// Default size of the aligned blocks, same as the flash sector size of the ESP32 and ESP8266
+size_t constexpr ALIGNED_WRITE_BLOCK_SIZE = 4096U;
+
+constexpr char ALIGNED_WRITE_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate (%u) bytes for the aligned write buffer";
+constexpr char ALIGNED_WRITE_FAILED[] = "Only (%u) bytes of the aligned block with (%u) bytes were written";
+
+
+/// @brief IUpdater decorator that coalesces the received chunks into blocks of a configurable size, before they are written into the wrapped updater.
+/// The chunk size the firmware is received in is arbitrary, which causes writes that start and end in the middle of a flash sector or page
+/// and force the flash driver to read, modify and write back the partially written sector. Instead only complete blocks, starting at an offset that is a multiple of the block size,
+/// are written into the wrapped updater, only the last block of the firmware binary is smaller and written once the update is ended.
+/// The block size should therefore be the sector or page size of the flash memory or a multiple of it.
+/// Complete blocks are written directly out of the received chunk if nothing is buffered, meaning the buffer is only used for the unaligned beginning and end of each chunk.
+/// The amount of write calls into the wrapped updater is counted, to allow measuring the difference to writing the chunks directly.
+/// Resuming an interrupted update is not supported, because persisted checkpoints might include bytes that were still buffered when the device lost power
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Aligned_Write_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param target Updater the aligned blocks are written into, has to stay valid for the lifetime of this instance
+    /// @param block_size Size of the aligned blocks, should be the sector or page size of the flash memory or a multiple of it, default = ALIGNED_WRITE_BLOCK_SIZE
+    Aligned_Write_Updater(IUpdater & target, size_t const & block_size = ALIGNED_WRITE_BLOCK_SIZE)
+      : m_target(&target)
+      , m_block_size(block_size)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, frees the buffer if the update was not ended or reset
+    ~Aligned_Write_Updater() {
+        Free_Buffer();
+    }
+
+    /// @brief Gets the amount of write calls into the wrapped updater since the current or last update was started
+    /// @return Amount of write calls into the wrapped updater
+    size_t const & Get_Write_Count() const {
+        return m_write_count;
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        Free_Buffer();
+        m_write_count = 0U;
+        m_buffer = static_cast<uint8_t *>(malloc(m_block_size));
+        if (m_buffer == nullptr) {
+            Logger::printfln(ALIGNED_WRITE_BUFFER_ALLOCATION_FAILED, m_block_size);
+            return false;
+        }
+        if (!m_target->begin(firmware_size)) {
+            Free_Buffer();
+            return false;
+        }
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        if (m_buffer == nullptr) {
+            return 0U;
+        }
+        size_t consumed_bytes = 0U;
+        while (consumed_bytes < total_bytes) {
+            size_t const remaining_bytes = total_bytes - consumed_bytes;
+            if (m_buffer_length == 0U && remaining_bytes >= m_block_size) {
+                size_t const block_bytes = remaining_bytes - (remaining_bytes % m_block_size);
+                if (!Write_Block(payload + consumed_bytes, block_bytes)) {
+                    return consumed_bytes;
+                }
+                consumed_bytes += block_bytes;
+                continue;
+            }
+            size_t const copied_bytes = (remaining_bytes < m_block_size - m_buffer_length) ? remaining_bytes : m_block_size - m_buffer_length;
+            (void)memcpy(m_buffer + m_buffer_length, payload + consumed_bytes, copied_bytes);
+            m_buffer_length += copied_bytes;
+            consumed_bytes += copied_bytes;
+            if (m_buffer_length == m_block_size && !Flush_Buffer()) {
+                return consumed_bytes - copied_bytes;
+            }
+        }
+        return total_bytes;
+    }
+
+    void reset() override {
+        Free_Buffer();
+        m_target->reset();
+    }
+
+    bool end() override {
+        if (m_buffer == nullptr || !Flush_Buffer()) {
+            return false;
+        }
+        Free_Buffer();
+        return m_target->end();
+    }
+
+  private:
+    /// @brief Writes the buffered bytes into the wrapped updater and empties the buffer
+    /// @return Whether writing was successful or not
+    bool Flush_Buffer() {
+        if (m_buffer_length == 0U) {
+            return true;
+        }
+        if (!Write_Block(m_buffer, m_buffer_length)) {
+            return false;
+        }
+        m_buffer_length = 0U;
+        return true;
+    }
+
+    /// @brief Writes the given data into the wrapped updater
+    /// @param data Data that should be written, has to start at an offset that is a multiple of the block size
+    /// @param length Amount of bytes that should be written, has to be a multiple of the block size except for the last block of the firmware binary
+    /// @return Whether writing was successful or not
+    bool Write_Block(uint8_t * data, size_t const & length) {
+        m_write_count++;
+        size_t const written_bytes = m_target->write(data, length);
+        if (written_bytes != length) {
+            Logger::printfln(ALIGNED_WRITE_FAILED, written_bytes, length);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Frees the buffer and discards any buffered bytes
+    void Free_Buffer() {
+        free(m_buffer);
+        m_buffer = nullptr;
+        m_buffer_length = 0U;
+    }
+
+    IUpdater *m_target = {};        // Updater the aligned blocks are written into
+    size_t   m_block_size = {};     // Size of the aligned blocks
+    uint8_t  *m_buffer = {};        // Buffer the unaligned bytes are collected in, allocated while an update is in progress
+    size_t   m_buffer_length = {};  // Amount of bytes currently held by the buffer
+    size_t   m_write_count = {};    // Amount of write calls into the wrapped updater since the update was started
+};
+
+#endif // Aligned_Write_Updater_h
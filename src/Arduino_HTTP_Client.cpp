@@ -3,6 +3,15 @@
 
 #ifdef ARDUINO
 
+// Local includes.
+#include "Helper.h"
+
+
+// HTTP range request header.
+char constexpr RANGE_HEADER_KEY[] = "Range";
+char constexpr RANGE_HEADER_VALUE_FMT[] = "bytes=%u-";
+
+
 Arduino_HTTP_Client::Arduino_HTTP_Client(Client& transport_client, char const * host, uint16_t port) :
     m_http_client(transport_client, host, port)
 {
@@ -44,4 +53,32 @@ String Arduino_HTTP_Client::get_response_body() {
 #endif // THINGSBOARD_ENABLE_STL
 }
 
+int Arduino_HTTP_Client::get_range(char const * url_path, size_t const & first_byte) {
+    // Sending the request has to be delayed, until all additional headers have been added, which is done by beginning the request first
+    m_http_client.beginRequest();
+    int const result = m_http_client.get(url_path);
+    if (result != 0) {
+        return result;
+    }
+    char range[Helper::detectSize(RANGE_HEADER_VALUE_FMT, first_byte)] = {};
+    (void)snprintf(range, sizeof(range), RANGE_HEADER_VALUE_FMT, first_byte);
+    m_http_client.sendHeader(RANGE_HEADER_KEY, range);
+    m_http_client.endRequest();
+    return 0;
+}
+
+int Arduino_HTTP_Client::read_response_body(uint8_t * buffer, size_t const & buffer_size) {
+    // Skipping is only done once, if the headers have already been skipped it returns immediately
+    (void)m_http_client.skipResponseHeaders();
+    if (m_http_client.endOfBodyReached()) {
+        return -1;
+    }
+    // Blocks until atleast the given amount of bytes have been received or the stream timeout (1 second per default) elapsed, which prevents busy waiting
+    size_t const read_bytes = m_http_client.readBytes(buffer, buffer_size);
+    if (read_bytes == 0U && !m_http_client.connected()) {
+        return -1;
+    }
+    return read_bytes;
+}
+
 #endif // ARDUINO
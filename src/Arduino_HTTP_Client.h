@@ -42,6 +42,10 @@ class Arduino_HTTP_Client : public IHTTP_Client {
     String get_response_body() override;
 #endif // THINGSBOARD_ENABLE_STL
 
+    int get_range(char const * url_path, size_t const & first_byte) override;
+
+    int read_response_body(uint8_t * buffer, size_t const & buffer_size) override;
+
   private:
     HttpClient m_http_client; // Underlying HTTP client instance used to send data
 };
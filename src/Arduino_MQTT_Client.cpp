@@ -5,6 +5,7 @@
 
 Arduino_MQTT_Client::Arduino_MQTT_Client(Client& transport_client) :
     m_connected_callback(),
+    m_clean_session(true),
     m_mqtt_client(transport_client)
 {
     // Nothing to do
@@ -47,11 +48,18 @@ void Arduino_MQTT_Client::set_server(char const* domain, uint16_t port)
 
 bool Arduino_MQTT_Client::connect(char const* client_id, char const* user_name, char const* password)
 {
-    bool const result = m_mqtt_client.connect(client_id, user_name, password);
+    // Overload without a last will, because it is the only one that allows to set the clean session flag
+    bool const result = m_mqtt_client.connect(client_id, user_name, password, nullptr, 0U, false, nullptr, m_clean_session);
     m_connected_callback.Call_Callback();
     return result;
 }
 
+bool Arduino_MQTT_Client::set_clean_session(bool clean_session)
+{
+    m_clean_session = clean_session;
+    return true;
+}
+
 void Arduino_MQTT_Client::disconnect()
 {
     m_mqtt_client.disconnect();
@@ -67,9 +75,33 @@ bool Arduino_MQTT_Client::publish(char const* topic, uint8_t const* payload, siz
     return m_mqtt_client.publish(topic, payload, length, false);
 }
 
+bool Arduino_MQTT_Client::publish_segments(char const* topic, MQTT_Segment const* segments, size_t const& segment_count)
+{
+    if (segments == nullptr) {
+        return false;
+    }
+    // Write the segments directly into the underlying network client, which removes the need to copy them into the internal buffer first.
+    // Only the MQTT header is built in the internal buffer, meaning the payload is additionally not restricted to the send buffer size
+    if (!m_mqtt_client.beginPublish(topic, get_segments_length(segments, segment_count), false)) {
+        return false;
+    }
+    for (size_t i = 0U; i < segment_count; i++) {
+        if (segments[i].length == 0U) {
+            continue;
+        }
+        if (m_mqtt_client.write(segments[i].data, segments[i].length) != segments[i].length) {
+            // The remaining length of the PUBLISH has already been sent, meaning the broker would read the following packets as the missing payload.
+            // Therefore the connection has to be closed instead, which allows the caller to recognize the failure and reconnect
+            m_mqtt_client.disconnect();
+            return false;
+        }
+    }
+    return m_mqtt_client.endPublish();
+}
+
 bool Arduino_MQTT_Client::subscribe(char const* topic)
 {
-    return m_mqtt_client.subscribe(topic);
+    return m_mqtt_client.subscribe(topic, m_clean_session ? 0U : 1U);
 }
 
 bool Arduino_MQTT_Client::unsubscribe(char const* topic)
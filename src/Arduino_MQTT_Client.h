@@ -41,12 +41,21 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 
     bool connect(char const * client_id, char const * user_name, char const * password) override;
 
+    /// @brief Sets whether the next call to connect() requests a clean session. The underlying PubSubClient does not expose the session present flag of the CONNACK,
+    /// therefore get_session_present() always returns false and all topics are subscribed again once connected, but the server still keeps the messages
+    /// that arrived while the client was disconnected, because the subscriptions use QoS level 1 if the session is kept
+    /// @param clean_session Whether the server should discard any previous session and not keep the new one once the client disconnects, default = true
+    /// @return Always true
+    bool set_clean_session(bool clean_session) override;
+
     void disconnect() override;
 
     bool loop() override;
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
 
+    bool publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) override;
+
     bool subscribe(char const * topic) override;
 
     bool unsubscribe(char const * topic) override;
@@ -71,6 +80,7 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 
   private:
     Callback<void> m_connected_callback = {}; // Callback that will be called as soon as the mqtt client has connected
+    bool           m_clean_session = true;    // Whether the connection requests a clean session, if not subscriptions use QoS level 1 so the server keeps their messages while disconnected
     PubSubClient   m_mqtt_client = {};        // Underlying MQTT client instance used to send data
 };
 
@@ -87,12 +87,12 @@ public:
         return API_Process_Type::JSON;
     }
 
-    void Process_Response(char const* topic, uint8_t* payload, unsigned int length) override
+    void Process_Response(String_View const& topic, uint8_t* payload, unsigned int length) override
     {
         // Nothing to do
     }
 
-    void Process_Json_Response(char const* topic, JsonDocument const& data) override
+    void Process_Json_Response(String_View const& topic, JsonDocument const& data) override
     {
         size_t const request_id = Helper::parseRequestId(ATTRIBUTE_RESPONSE_TOPIC, topic);
         JsonObjectConst object = data.template as<JsonObjectConst>();
@@ -155,9 +155,9 @@ public:
         }
     }
 
-    bool Compare_Response_Topic(char const* topic) const override
+    bool Compare_Response_Topic(String_View const& topic) const override
     {
-        return strncmp(ATTRIBUTE_RESPONSE_TOPIC, topic, strlen(ATTRIBUTE_RESPONSE_TOPIC)) == 0;
+        return topic.starts_with(String_View(ATTRIBUTE_RESPONSE_TOPIC, sizeof(ATTRIBUTE_RESPONSE_TOPIC) - 1U));
     }
 
     bool Unsubscribe() override
@@ -170,6 +170,25 @@ public:
         return Unsubscribe();
     }
 
+    bool Restore_Topic(bool const & session_present, bool const & keep_requests) override
+    {
+        if (!keep_requests)
+        {
+            return Unsubscribe();
+        }
+        else if (session_present || m_attribute_request_callbacks.empty())
+        {
+            return true;
+        }
+        // Pending requests are kept, but the server discarded the session, therefore the response topic has to be subscribed again to still receive their responses
+        if (!m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC))
+        {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
+            return false;
+        }
+        return true;
+    }
+
 #if !THINGSBOARD_USE_ESP_TIMER
     void loop() override
     {
@@ -0,0 +1,45 @@
+#ifndef CRC32_Checksum_h
+#define CRC32_Checksum_h
+
+// Local includes.
+#include "Configuration.h"
+#include "IChecksum.h"
+
+
+/// @brief IChecksum implementation which calculates the CRC32 with the reflected IEEE 802.3 polynomial 0xEDB88320, the same checksum zlib and Guava calculate.
+/// Uses the table driven slice-by-8 algorithm, which processes 8 bytes per step with 8 lookups into separate tables that do not depend on each other,
+/// instead of one lookup per byte that always depends on the result of the previous lookup. Requires 8 KiB of constant data for the tables, which are placed in flash memory.
+/// The result is printed as the little endian bytes of the CRC32, the same as the HashCode of Guava the server calculates the checksum with
+class CRC32_Checksum : public IChecksum {
+  public:
+    /// @brief Constructor
+    CRC32_Checksum() = default;
+
+    /// @brief Calculates the CRC32 of the given data, without having to create an instance first
+    /// @param data Data the CRC32 should be calculated over
+    /// @param length Amount of bytes in the given data
+    /// @param crc Result of a previous call, allows to calculate the CRC32 over data that is split into multiple parts, default = 0
+    /// @return CRC32 of the given data, continued from the given previous result
+    static uint32_t calculate(uint8_t const * data, size_t const & length, uint32_t const & crc = 0U);
+
+    bool start() override;
+
+    bool update(uint8_t const * data, size_t const & length) override;
+
+    bool finish(uint8_t * result) override;
+
+    void stop() override;
+
+    size_t get_size() const override;
+
+    size_t get_context_size() const override;
+
+    bool save(uint8_t * context, size_t const & context_size) const override;
+
+    bool restore(uint8_t const * context, size_t const & context_size) override;
+
+  private:
+    uint32_t m_crc = {}; // CRC32 over all bytes passed so far
+};
+
+#endif // CRC32_Checksum_h
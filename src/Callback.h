@@ -59,7 +59,9 @@ class Callback {
     /// we instead return a defaulted instance of the requested return variable
     return_typ Call_Callback(argument_types const &... arguments) const {
         if (!m_callback) {
+#ifdef ARDUINO
             Serial.println("No Callback function available");
+#endif // ARDUINO
           return return_typ();
         }
         return m_callback(arguments...);
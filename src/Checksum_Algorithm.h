@@ -0,0 +1,21 @@
+#ifndef Checksum_Algorithm_h
+#define Checksum_Algorithm_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Checksum algorithms the server can calculate the checksum of a firmware binary with, see the fw_checksum_algorithm shared attribute.
+/// The cryptographic hashes are calculated with Mbed TLS, the remaining ones are implemented by the library itself,
+/// they are considerably cheaper per byte on devices without a hardware accelerator for the cryptographic hashes, but only protect against accidental corruption
+enum class Checksum_Algorithm : uint8_t {
+    MD5,         ///< 128 bit MD5 digest, calculated with Mbed TLS
+    SHA256,      ///< 256 bit SHA-2 digest, calculated with Mbed TLS
+    SHA384,      ///< 384 bit SHA-2 digest, calculated with Mbed TLS
+    SHA512,      ///< 512 bit SHA-2 digest, calculated with Mbed TLS
+    CRC32,       ///< 32 bit cyclic redundancy check with the IEEE 802.3 polynomial, calculated with a table driven slice-by-8 implementation
+    MURMUR3_32,  ///< 32 bit MurmurHash3 (x86_32 variant) with seed 0
+    MURMUR3_128  ///< 128 bit MurmurHash3 (x64_128 variant) with seed 0
+};
+
+#endif // Checksum_Algorithm_h
@@ -0,0 +1,357 @@
+#ifndef Client_Attribute_Cache_h
+#define Client_Attribute_Cache_h
+
+// Local includes.
+#include "Callback_Watchdog.h"
+#include "IAPI_Implementation.h"
+#include "Telemetry.h"
+
+// Library includes.
+#if THINGSBOARD_ENABLE_STL
+#include <functional>
+#include <string>
+#endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_USE_ESP_TIMER
+#include <atomic>
+#endif // THINGSBOARD_USE_ESP_TIMER
+#include <string.h>
+
+
+// Log messages.
+#if !THINGSBOARD_ENABLE_DYNAMIC
+char constexpr CLIENT_ATTRIBUTE_CACHE_FULL[] = "Client attribute cache full, can not add (%s), increase (MaxAttributes) (%u)";
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+char constexpr CLIENT_ATTRIBUTE_FLUSH_FAILED[] = "Flushing (%u) changed client attributes failed, they are kept and sent with the next flush";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr CLIENT_ATTRIBUTE_UNCHANGED[] = "Client attribute (%s) did not change, skipping";
+char constexpr CLIENT_ATTRIBUTE_FLUSHED[] = "Flushed (%u) changed client attributes";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Handles caching client-side attributes on the device and only sending the ones that changed since they were last sent.
+/// Each attribute is stored keyed by its name together with a dirty flag, setting an attribute to the value it already has is a no-op,
+/// whereas setting a new value marks the attribute as dirty. Calling Flush() explicitly or periodically with Set_Flush_Interval(),
+/// sends all dirty attributes combined into one single message over the attribute topic and clears their dirty flag once that message was sent successfully.
+/// Because ThingsBoard only keeps the latest value of client-side attributes, this allows to coalesce many updates from different places of the firmware into one message.
+/// Once the connection to the server is (re-)established the complete cache is marked dirty and sent again, to ensure the server has the same state as the device.
+/// See https://thingsboard.io/docs/reference/mqtt-api/#publish-attribute-update-to-the-server for more information
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename Logger = DefaultLogger>
+#else
+/// @tparam MaxAttributes Maximum amount of different client-side attributes that will ever be cached.
+/// Once the maximum amount has been reached it is not possible to increase the size, this is done because it allows to allcoate the memory on the stack instead of the heap, default = Default_Cached_Attributes_Amount (8)
+template <size_t MaxAttributes = Default_Cached_Attributes_Amount, typename Logger = DefaultLogger>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+class Client_Attribute_Cache final : public IAPI_Implementation
+{
+public:
+    /// @brief Constructor
+    Client_Attribute_Cache()
+#if THINGSBOARD_ENABLE_STL
+      : m_flush_timer(std::bind(&Client_Attribute_Cache::Flush_Timeout, this))
+#else
+      : m_flush_timer(Client_Attribute_Cache::staticFlushTimeout)
+#endif // THINGSBOARD_ENABLE_STL
+    {
+#if !THINGSBOARD_ENABLE_STL
+        m_subscribedInstance = this;
+#endif // !THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Sets the cached value of the client-side attribute with the given key, if the value is different to the currently cached value the attribute is marked dirty
+    /// and is sent with the next flush. If the value did not change nothing is done, meaning the attribute is not sent again
+    /// @tparam T Type of the passed value, has to be supported by the Telemetry class (bool, integral or floating point)
+    /// @param key Key of the client-side attribute, is not copied and therefore has to stay valid for the lifetime of the cache, should therefore ideally be a string literal
+    /// @param value Value the client-side attribute should be set to
+    /// @return Whether caching the value was successful or not
+    template <typename T>
+    bool Set_Attribute(char const * key, T const & value) {
+        Telemetry const attribute(key, value);
+        return Store_Attribute(key, attribute, nullptr);
+    }
+
+    /// @brief Sets the cached string value of the client-side attribute with the given key, if the value is different to the currently cached value the attribute is marked dirty
+    /// and is sent with the next flush. If the value did not change nothing is done, meaning the attribute is not sent again
+    /// @param key Key of the client-side attribute, is not copied and therefore has to stay valid for the lifetime of the cache, should therefore ideally be a string literal
+    /// @param value Value the client-side attribute should be set to, is copied into the cache so the passed string does not have to outlive this call
+    /// @return Whether caching the value was successful or not
+    bool Set_Attribute(char const * key, char const * value) {
+        if (value == nullptr) {
+            return false;
+        }
+        Telemetry const attribute(key, value);
+        return Store_Attribute(key, attribute, value);
+    }
+
+    /// @brief Sets the cached string value of the client-side attribute with the given key, needed because the generic template would otherwise be chosen for non-const strings and character arrays,
+    /// which would cache the pointer instead of a copy of the string and compare the pointer instead of the content to detect changes
+    /// @param key Key of the client-side attribute, is not copied and therefore has to stay valid for the lifetime of the cache, should therefore ideally be a string literal
+    /// @param value Value the client-side attribute should be set to, is copied into the cache so the passed string does not have to outlive this call
+    /// @return Whether caching the value was successful or not
+    bool Set_Attribute(char const * key, char * value) {
+        return Set_Attribute(key, static_cast<char const *>(value));
+    }
+
+    /// @brief Returns the amount of cached client-side attributes that changed since the last successful flush
+    /// @return Amount of dirty client-side attributes
+    size_t Get_Dirty_Amount() const {
+        size_t dirty_amount = 0U;
+        for (auto const & attribute : m_attributes) {
+            if (attribute.dirty) {
+                dirty_amount++;
+            }
+        }
+        return dirty_amount;
+    }
+
+    /// @brief Sends all cached client-side attributes that changed since the last successful flush, combined into one single message.
+    /// If sending fails, the attributes stay dirty and are attempted to be sent again on the next flush
+    /// @return Whether sending the changed attributes was successful or not, also true if there was nothing to send
+    bool Flush() {
+        size_t const dirty_amount = Get_Dirty_Amount();
+        if (dirty_amount == 0U) {
+            return true;
+        }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        // String values are stored as const char * inside the JsonDocument --> zero copy, meaning the size for the strings is 0 bytes.
+        // Data structure size, therefore only depends on the amount of dirty key value pairs.
+        // See https://arduinojson.org/v6/assistant/ for more information on the needed size for the JsonDocument
+        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(dirty_amount));
+#else
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxAttributes)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        for (auto const & attribute : m_attributes) {
+            if (!attribute.dirty) {
+                continue;
+            }
+            if (!attribute.Get_Value().SerializeKeyValue(json_buffer)) {
+                Logger::printfln(UNABLE_TO_SERIALIZE);
+                return false;
+            }
+        }
+
+        if (!m_send_json_callback.Call_Callback(ATTRIBUTE_TOPIC, json_buffer, Helper::Measure_Json(json_buffer))) {
+            Logger::printfln(CLIENT_ATTRIBUTE_FLUSH_FAILED, dirty_amount);
+            return false;
+        }
+
+        for (auto & attribute : m_attributes) {
+            attribute.dirty = false;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(CLIENT_ATTRIBUTE_FLUSHED, dirty_amount);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
+
+    /// @brief Sets the interval in which the changed client-side attributes are flushed automatically.
+    /// The flush is always executed from the loop() method of the ThingsBoard client, even when using the ESP Timer, because the cache and the client are not thread safe,
+    /// meaning the actual interval depends on how often that method is called
+    /// @param interval_microseconds Amount of microseconds between two automatic flushes, 0 disables automatic flushing and only flushes on explicit calls to Flush()
+    void Set_Flush_Interval(uint64_t const & interval_microseconds) {
+        m_flush_interval = interval_microseconds;
+        m_flush_timer.detach();
+        Start_Flush_Timer();
+    }
+
+    API_Process_Type Get_Process_Type() const override {
+        return API_Process_Type::JSON;
+    }
+
+    void Process_Response(String_View const & /*topic*/, uint8_t * /*payload*/, unsigned int /*length*/) override {
+        // Nothing to do
+    }
+
+    void Process_Json_Response(String_View const & /*topic*/, JsonDocument const & /*data*/) override {
+        // Nothing to do
+    }
+
+    bool Compare_Response_Topic(String_View const & /*topic*/) const override {
+        // Client-side attributes are only ever sent to the server, therefore there is no response topic to handle
+        return false;
+    }
+
+    bool Unsubscribe() override {
+        m_flush_timer.detach();
+        return true;
+    }
+
+    bool Resubscribe_Topic() override {
+        // The server might have missed updates sent while we were disconnected, therefore simply resend the complete cache
+        for (auto & attribute : m_attributes) {
+            attribute.dirty = true;
+        }
+        return Flush();
+    }
+
+    void loop() override {
+#if !THINGSBOARD_USE_ESP_TIMER
+        m_flush_timer.update();
+#endif // !THINGSBOARD_USE_ESP_TIMER
+        if (!m_flush_pending) {
+            return;
+        }
+        m_flush_pending = false;
+        (void)Flush();
+        Start_Flush_Timer();
+    }
+
+    void Initialize() override {
+        Start_Flush_Timer();
+    }
+
+    const char * GetDeviceId() override {
+        return m_deviceId ? m_deviceId : "";
+    }
+
+    void SetDeviceId(const char * device_id) override {
+        m_deviceId = device_id;
+    }
+
+    const char * GetDeviceProfile() override {
+        return m_deviceProfile ? m_deviceProfile : "";
+    }
+
+    void SetDeviceProfile(const char * device_profile) override {
+        m_deviceProfile = device_profile;
+    }
+
+    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function /*subscribe_api_callback*/, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function /*send_json_string_callback*/, Callback<bool, char const * const>::function /*subscribe_topic_callback*/, Callback<bool, char const * const>::function /*unsubscribe_topic_callback*/, Callback<uint16_t>::function /*get_receive_size_callback*/, Callback<uint16_t>::function /*get_send_size_callback*/, Callback<bool, uint16_t, uint16_t>::function /*set_buffer_size_callback*/, Callback<size_t *>::function /*get_request_id_callback*/) override {
+        m_send_json_callback.Set_Callback(send_json_callback);
+    }
+
+private:
+    /// @brief Single cached client-side attribute, string values are copied into the owned text member,
+    /// because the pointer passed to Set_Attribute() is not guaranteed to outlive the call
+    struct Cached_Attribute {
+        char const * key = {};   // Non-owning key of the client-side attribute
+        Telemetry    value = {}; // Value of the client-side attribute, only used if it is not a string
+#if THINGSBOARD_ENABLE_STL
+        std::string  text = {};  // Owned copy of the value of the client-side attribute, only used if it is a string
+#else
+        String       text = {};  // Owned copy of the value of the client-side attribute, only used if it is a string
+#endif // THINGSBOARD_ENABLE_STL
+        bool         is_text = {}; // Whether the value is a string and therefore stored in text instead of value
+        bool         dirty = {};   // Whether the value changed since it was last sent successfully
+
+        /// @brief Returns the cached value as a Telemetry record, string values point to the owned copy
+        /// and are therefore only valid as long as the cached attribute is not changed
+        /// @return Telemetry record containing the key and cached value
+        Telemetry Get_Value() const {
+            return is_text ? Telemetry(key, text.c_str()) : value;
+        }
+    };
+
+    /// @brief Searches the cache for the client-side attribute with the given key
+    /// @param key Key of the client-side attribute we want to find
+    /// @return Pointer to the cached attribute or nullptr if it has not been cached yet
+    Cached_Attribute * Find_Attribute(char const * key) {
+        for (auto & attribute : m_attributes) {
+            if (strcmp(attribute.key, key) == 0) {
+                return &attribute;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Stores the given value into the cache and marks it dirty, if it is different to the currently cached value
+    /// @param key Key of the client-side attribute
+    /// @param attribute Telemetry record containing the key and new value
+    /// @param text String value that should be copied into the cache or nullptr if the value is not a string
+    /// @return Whether caching the value was successful or not
+    bool Store_Attribute(char const * key, Telemetry const & attribute, char const * text) {
+        if (Helper::stringIsNullorEmpty(key) || attribute.IsEmpty()) {
+            return false;
+        }
+
+        Cached_Attribute * cached = Find_Attribute(key);
+        if (cached == nullptr) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+            if (m_attributes.size() + 1U > m_attributes.capacity()) {
+                Logger::printfln(CLIENT_ATTRIBUTE_CACHE_FULL, key, MaxAttributes);
+                return false;
+            }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+            Cached_Attribute new_attribute = {};
+            new_attribute.key = key;
+            m_attributes.push_back(new_attribute);
+            cached = &m_attributes.back();
+        }
+        else if (cached->Get_Value().HasSameValue(attribute)) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(CLIENT_ATTRIBUTE_UNCHANGED, key);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return true;
+        }
+
+        cached->is_text = text != nullptr;
+        if (cached->is_text) {
+            cached->text = text;
+            cached->value = Telemetry();
+        }
+        else {
+            cached->value = attribute;
+        }
+        cached->dirty = true;
+        return true;
+    }
+
+    /// @brief Starts the timer until the next automatic flush, if automatic flushing has been enabled with Set_Flush_Interval()
+    void Start_Flush_Timer() {
+        if (m_flush_interval == 0U) {
+            return;
+        }
+        m_flush_timer.once(m_flush_interval);
+    }
+
+    /// @brief Callback that will be called once the flush interval passed
+    void Flush_Timeout() {
+        // The ESP Timer calls this from its own task, where flushing would access the cache and the client concurrently with the task calling loop() and Set_Attribute().
+        // Otherwise this is called from loop(), but restarting the timer is not possible from inside its own callback, because the expired task still occupies the single timer slot until the callback returns.
+        // Therefore the flush is deferred to the next call of loop() in both cases, where the timer is also restarted afterwards
+        m_flush_pending = true;
+    }
+
+#if !THINGSBOARD_ENABLE_STL
+    static void staticFlushTimeout() {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->Flush_Timeout();
+    }
+
+    static Client_Attribute_Cache *m_subscribedInstance;
+#endif // !THINGSBOARD_ENABLE_STL
+
+    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {}; // Send json document callback
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Cached_Attribute>                       m_attributes = {};      // Cached client-side attributes
+#else
+    Array<Cached_Attribute, MaxAttributes>         m_attributes = {};      // Cached client-side attributes
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    uint64_t                                       m_flush_interval = {};  // Interval in microseconds between automatic flushes, 0 if disabled
+    Callback_Watchdog                              m_flush_timer;          // Timer that triggers the automatic flush
+#if THINGSBOARD_USE_ESP_TIMER
+    std::atomic<bool>                              m_flush_pending = {};   // Whether the flush interval passed and the flush should be executed on the next loop() call, set from the ESP Timer task
+#else
+    bool                                           m_flush_pending = {};   // Whether the flush interval passed and the flush should be executed on the next loop() call
+#endif // THINGSBOARD_USE_ESP_TIMER
+    const char                                     *m_deviceId = {};       // Non-owning device id
+    const char                                     *m_deviceProfile = {};  // Non-owning device profile
+};
+
+#if !THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename Logger>
+Client_Attribute_Cache<Logger> *Client_Attribute_Cache<Logger>::m_subscribedInstance = nullptr;
+#else
+template <size_t MaxAttributes, typename Logger>
+Client_Attribute_Cache<MaxAttributes, Logger> *Client_Attribute_Cache<MaxAttributes, Logger>::m_subscribedInstance = nullptr;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#endif // !THINGSBOARD_ENABLE_STL
+
+#endif // Client_Attribute_Cache_h
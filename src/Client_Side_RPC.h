@@ -107,11 +107,11 @@ class Client_Side_RPC : public IAPI_Implementation {
         return API_Process_Type::JSON;
     }
 
-    void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
+    void Process_Response(String_View const & topic, uint8_t * payload, unsigned int length) override {
         // Nothing to do
     }
 
-    void Process_Json_Response(char const * topic, JsonDocument const & data) override {
+    void Process_Json_Response(String_View const & topic, JsonDocument const & data) override {
         size_t const request_id = Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic);
 
 #if THINGSBOARD_ENABLE_STL
@@ -146,8 +146,8 @@ class Client_Side_RPC : public IAPI_Implementation {
         }
     }
 
-    bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(RPC_RESPONSE_TOPIC, topic, strlen(RPC_RESPONSE_TOPIC)) == 0;
+    bool Compare_Response_Topic(String_View const & topic) const override {
+        return topic.starts_with(String_View(RPC_RESPONSE_TOPIC, sizeof(RPC_RESPONSE_TOPIC) - 1U));
     }
 
     bool Unsubscribe() override {
@@ -158,6 +158,21 @@ class Client_Side_RPC : public IAPI_Implementation {
         return Unsubscribe();
     }
 
+    bool Restore_Topic(bool const & session_present, bool const & keep_requests) override {
+        if (!keep_requests) {
+            return Unsubscribe();
+        }
+        else if (session_present || m_rpc_request_callbacks.empty()) {
+            return true;
+        }
+        // Pending requests are kept, but the server discarded the session, therefore the response topic has to be subscribed again to still receive their responses
+        if (!m_subscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_RESPONSE_SUBSCRIBE_TOPIC);
+            return false;
+        }
+        return true;
+    }
+
 #if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         for (auto & rpc_request : m_rpc_request_callbacks) {
@@ -114,6 +114,66 @@
 #    endif
 #  endif
 
+// Use the nvs header internally for persisting the progress of ota updates, as long as the header exists,
+// to allow users that do have the needed component to use the Espressif_NVS_Checkpoint_Store to resume interrupted updates after a reboot.
+// Only exists following major version 2 minor version 0 on ESP32 (https://github.com/espressif/esp-idf/releases/tag/v2.0) and major version 3 minor version 0 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.0-rc1).
+#  ifndef THINGSBOARD_USE_ESP_NVS
+#    ifdef __has_include
+#      if __has_include(<nvs.h>)
+#        define THINGSBOARD_USE_ESP_NVS 1
+#      else
+#        define THINGSBOARD_USE_ESP_NVS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_ESP_NVS 0
+#    endif
+#  endif
+
+// Use the FreeRTOS headers internally for writing received ota update data in a separate task, as long as the header exists,
+// to allow overlapping the flash writes with receiving and requesting the next chunks, instead of writing every chunk in the context that received it.
+// Exists on ESP32 for every version of Espressif IDF and on ESP8266 following major version 3 minor version 0 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.0-rc1), including their Arduino cores.
+#  ifndef THINGSBOARD_USE_FREERTOS
+#    ifdef __has_include
+#      if __has_include(<freertos/FreeRTOS.h>)
+#        define THINGSBOARD_USE_FREERTOS 1
+#      else
+#        define THINGSBOARD_USE_FREERTOS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_FREERTOS 0
+#    endif
+#  endif
+
+// Use the thread header of the C++ STL library internally for writing received ota update data in a separate thread, as long as FreeRTOS is not used and the needed headers exist,
+// allows the same overlapping of flash writes with receiving the next chunks on hosted platforms like Linux, where the underlying implementation is based on pthreads.
+#  ifndef THINGSBOARD_USE_STD_THREAD
+#    ifdef __has_include
+#      if !THINGSBOARD_USE_FREERTOS && THINGSBOARD_ENABLE_STL && __has_include(<thread>) && __has_include(<mutex>) && __has_include(<condition_variable>)
+#        define THINGSBOARD_USE_STD_THREAD 1
+#      else
+#        define THINGSBOARD_USE_STD_THREAD 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_STD_THREAD 0
+#    endif
+#  endif
+
+// Use the POSIX socket headers internally for the POSIX_MQTT_Client, as long as the headers exist and we are neither compiling for Espressif IDF nor Arduino,
+// to allow running the same application logic on Linux gateways or a workstation, without an Espressif or Arduino MQTT client.
+// Requires THINGSBOARD_USE_STD_THREAD, because the client receives in its own std::thread and uses std::atomic and std::mutex to share the receive buffer with the thread calling loop().
+// Espressif IDF additionally provides the socket headers through lwIP, which is why it is explicitly excluded, because the Espressif_MQTT_Client should be used instead.
+#  ifndef THINGSBOARD_USE_POSIX_SOCKETS
+#    ifdef __has_include
+#      if !defined(ESP_PLATFORM) && !defined(ARDUINO) && THINGSBOARD_USE_STD_THREAD && __has_include(<sys/socket.h>) && __has_include(<sys/uio.h>) && __has_include(<poll.h>) && __has_include(<netdb.h>)
+#        define THINGSBOARD_USE_POSIX_SOCKETS 1
+#      else
+#        define THINGSBOARD_USE_POSIX_SOCKETS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_POSIX_SOCKETS 0
+#    endif
+#  endif
+
 // Enables the ThingsBoard class to be fully dynamic instead of requiring template arguments to statically allocate memory.
 // If enabled the program might be slightly slower and all the memory will be placed onto the heap instead of the stack.
 // See https://arduinojson.org/v6/api/dynamicjsondocument/ for the main difference in the underlying code.
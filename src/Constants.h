@@ -13,10 +13,12 @@
 #define Default_Response_Amount 8
 #define Default_Subscriptions_Amount 1
 #define Default_Attributes_Amount 1
+#define Default_Cached_Attributes_Amount 8
 #define Default_RPC_Amount 0
 #define Default_Request_RPC_Amount 2
 #define Default_Payload_Size 64
 #define Default_Max_Stack_Size 1024
+#define Default_Fan_Out_Sinks_Amount 8
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #define Default_Buffering_Size 64
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
@@ -24,6 +26,9 @@
 #define Default_Max_Response_Size 0
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
+// Shared, safe stack buffer for topics containing the device id (avoid VLAs), used by the server-side RPC and the OTA firmware update
+constexpr size_t TOPIC_BUF_SIZE = 256;
+
 
 // Log messages.
 #if !THINGSBOARD_ENABLE_DYNAMIC
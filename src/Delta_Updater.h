@@ -0,0 +1,400 @@
+#ifndef Delta_Updater_h
+#define Delta_Updater_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "HashGenerator.h"
+#include "IFirmware_Source.h"
+#include "IUpdater.h"
+
+// Library include.
+#include <stdlib.h>
+#include <string.h>
+
+
+// Default amount of bytes of the reconstructed firmware binary that are kept in memory, before they are written into the wrapped updater.
+// Every read of the currently running firmware binary is limited to this size as well, meaning it is the only memory the delta updater allocates besides the instance itself
+size_t constexpr DELTA_WINDOW_SIZE = 4096U;
+// Magic string every uncompressed binary patch starts with, created with bsdiff from https://github.com/mendsley/bsdiff or compatible tools
+char constexpr DELTA_PATCH_MAGIC[] = "ENDSLEY/BSDIFF43";
+// Size of the magic string in the binary patch, which is not null terminated
+size_t constexpr DELTA_PATCH_MAGIC_SIZE = sizeof(DELTA_PATCH_MAGIC) - 1U;
+// Size of a single encoded integer in the binary patch
+size_t constexpr DELTA_PATCH_INTEGER_SIZE = 8U;
+// Size of the header, consisting of the magic string and the size of the reconstructed firmware binary
+size_t constexpr DELTA_PATCH_HEADER_SIZE = DELTA_PATCH_MAGIC_SIZE + DELTA_PATCH_INTEGER_SIZE;
+// Size of a control block, consisting of the diff length, the extra length and the seek offset into the currently running firmware binary
+size_t constexpr DELTA_PATCH_CONTROL_SIZE = 3U * DELTA_PATCH_INTEGER_SIZE;
+
+constexpr char DELTA_WINDOW_ALLOCATION_FAILED[] = "Failed to allocate (%u) bytes for the delta update window";
+constexpr char DELTA_SOURCE_OPEN_FAILED[] = "Failed to open the currently running firmware binary the patch is applied to";
+constexpr char DELTA_INVALID_MAGIC[] = "Received firmware is not an uncompressed ENDSLEY/BSDIFF43 binary patch";
+constexpr char DELTA_INVALID_SIZE[] = "Binary patch contains an invalid reconstructed firmware size";
+constexpr char DELTA_INVALID_CONTROL[] = "Binary patch contains an invalid control block at reconstructed byte (%u)";
+constexpr char DELTA_TRAILING_DATA[] = "Binary patch contains additional data after the reconstructed firmware binary is complete";
+constexpr char DELTA_SOURCE_READ_FAILED[] = "Reading (%u) bytes of the currently running firmware binary at offset (%u) failed";
+constexpr char DELTA_TARGET_BEGIN_FAILED[] = "Beginning the update of the reconstructed firmware binary with size (%u) failed";
+constexpr char DELTA_TARGET_WRITE_FAILED[] = "Only (%u) bytes of (%u) of the reconstructed firmware binary were written";
+constexpr char DELTA_PATCH_INCOMPLETE[] = "Binary patch ended after (%u) of (%u) bytes of the reconstructed firmware binary";
+constexpr char DELTA_CHECKSUM_FAILED[] = "Reconstructed firmware checksum verification failed, calculated: (%s), expected: (%s), ensure the patch was created against the currently running firmware";
+
+
+/// @brief IUpdater implementation that applies the received firmware as a binary patch to the currently running firmware binary and writes the reconstructed new firmware binary into the wrapped updater.
+/// Allows to only download the difference between the running and the new firmware, which is mostly a small fraction of the complete firmware binary.
+/// The patch has to be in the uncompressed ENDSLEY/BSDIFF43 format, as created by bsdiff from https://github.com/mendsley/bsdiff, or by detools with the sequential bsdiff patch type and no compression.
+/// The patch is applied while it is received, the running firmware binary is read from the given IFirmware_Source and the reconstructed bytes are buffered in a single window of a configurable size,
+/// which is the only memory allocated during the update, independent of the size of the firmware or the patch.
+/// The checksum the update was started with is the checksum of the patch itself, the reconstructed firmware binary can additionally be verified with Set_Target_Checksum,
+/// which is highly recommended, because applying a patch to a different firmware binary than the one it was created against succeeds but results in a corrupted firmware.
+/// Resuming an interrupted update is not supported, because the progress inside the patch is not persisted
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Delta_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param target Updater the reconstructed firmware binary is written into, has to stay valid for the lifetime of this instance
+    /// @param source Source the currently running firmware binary the patch has been created against is read from, has to stay valid for the lifetime of this instance
+    /// @param window_size Amount of bytes of the reconstructed firmware binary that are buffered before they are written into the target updater
+    /// and maximum amount of bytes that are read from the source at once, default = DELTA_WINDOW_SIZE
+    Delta_Updater(IUpdater & target, IFirmware_Source & source, size_t const & window_size = DELTA_WINDOW_SIZE)
+      : m_target(&target)
+      , m_source(&source)
+      , m_window_size(window_size)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, frees the window if the update was not ended or reset
+    ~Delta_Updater() {
+        Free_Window();
+    }
+
+    /// @brief Sets the checksum the reconstructed firmware binary is verified against once the update is ended, with the update being discarded if it does not match.
+    /// Has to be set before the update is started, because the reconstructed firmware binary is hashed while it is written
+    /// @param checksum Expected checksum of the reconstructed firmware binary as a hex string, has to stay valid until the update is ended, nullptr disables the verification, default = nullptr
+    /// @param checksum_algorithm Algorithm used to calculate the expected checksum
+    void Set_Target_Checksum(char const * checksum, Checksum_Algorithm const & checksum_algorithm) {
+        m_target_checksum = checksum;
+        m_target_checksum_algorithm = checksum_algorithm;
+    }
+
+    bool begin(size_t const & /*firmware_size*/) override {
+        reset();
+        m_window = static_cast<uint8_t *>(malloc(m_window_size));
+        if (m_window == nullptr) {
+            Logger::printfln(DELTA_WINDOW_ALLOCATION_FAILED, m_window_size);
+            return false;
+        }
+        if (!m_source->open()) {
+            Logger::printfln(DELTA_SOURCE_OPEN_FAILED);
+            Free_Window();
+            return false;
+        }
+        if (m_target_checksum != nullptr && !m_target_hash.start(m_target_checksum_algorithm)) {
+            m_source->close();
+            Free_Window();
+            return false;
+        }
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        if (m_window == nullptr) {
+            return 0U;
+        }
+        size_t consumed_bytes = 0U;
+        while (consumed_bytes < total_bytes) {
+            size_t const available_bytes = total_bytes - consumed_bytes;
+            uint8_t const * data = payload + consumed_bytes;
+            size_t processed_bytes = 0U;
+            switch (m_state) {
+                case Patch_State::HEADER:
+                case Patch_State::CONTROL:
+                    processed_bytes = Read_Field(data, available_bytes);
+                    if (!Parse_Field()) {
+                        return 0U;
+                    }
+                    break;
+                case Patch_State::DIFF:
+                    processed_bytes = Apply_Diff(data, available_bytes);
+                    if (processed_bytes == 0U) {
+                        return 0U;
+                    }
+                    break;
+                case Patch_State::EXTRA:
+                    processed_bytes = Apply_Extra(data, available_bytes);
+                    if (processed_bytes == 0U) {
+                        return 0U;
+                    }
+                    break;
+                default:
+                    Logger::printfln(DELTA_TRAILING_DATA);
+                    return 0U;
+            }
+            consumed_bytes += processed_bytes;
+        }
+        return total_bytes;
+    }
+
+    void reset() override {
+        if (m_target_started) {
+            m_target->reset();
+        }
+        if (m_window != nullptr) {
+            m_source->close();
+        }
+        Free_Window();
+    }
+
+    bool end() override {
+        if (m_window == nullptr) {
+            return false;
+        }
+        if (m_state != Patch_State::DONE) {
+            Logger::printfln(DELTA_PATCH_INCOMPLETE, m_new_position, m_new_size);
+            return false;
+        }
+        if (!Flush_Window()) {
+            return false;
+        }
+
+        if (m_target_checksum != nullptr) {
+            char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
+            (void)m_target_hash.finish(calculated_checksum);
+            if (strncmp(m_target_checksum, calculated_checksum, strlen(m_target_checksum)) != 0) {
+                Logger::printfln(DELTA_CHECKSUM_FAILED, calculated_checksum, m_target_checksum);
+                // Verified before the window is freed, because freeing it forgets that the target updater has been started and a following reset() would therefore not reset it
+                reset();
+                return false;
+            }
+        }
+        m_source->close();
+        Free_Window();
+        return m_target->end();
+    }
+
+  private:
+    /// @brief Part of the binary patch that is currently being received
+    enum class Patch_State : uint8_t {
+        HEADER, ///< Magic string and size of the reconstructed firmware binary
+        CONTROL, ///< Control block describing the following diff and extra data
+        DIFF, ///< Bytes that are added to the bytes of the currently running firmware binary
+        EXTRA, ///< Bytes that are copied into the reconstructed firmware binary unchanged
+        DONE ///< Reconstructed firmware binary is complete, no further data is expected
+    };
+
+    /// @brief Decodes a single integer of the binary patch, which is encoded in little endian sign magnitude format with the sign in the most significant bit of the last byte
+    /// @param buffer Buffer containing the 8 bytes of the encoded integer
+    /// @return Decoded signed integer
+    static int64_t Decode_Integer(uint8_t const * buffer) {
+        int64_t value = buffer[DELTA_PATCH_INTEGER_SIZE - 1U] & 0x7FU;
+        for (size_t index = DELTA_PATCH_INTEGER_SIZE - 1U; index > 0U; index--) {
+            value = (value * 256) + buffer[index - 1U];
+        }
+        return (buffer[DELTA_PATCH_INTEGER_SIZE - 1U] & 0x80U) != 0U ? -value : value;
+    }
+
+    /// @brief Copies bytes of the header or control block into the field buffer, until the complete field has been received
+    /// @param data Received patch data
+    /// @param available_bytes Amount of bytes in the received patch data
+    /// @return Amount of bytes that were copied
+    size_t Read_Field(uint8_t const * data, size_t const & available_bytes) {
+        size_t const field_size = (m_state == Patch_State::HEADER) ? DELTA_PATCH_HEADER_SIZE : DELTA_PATCH_CONTROL_SIZE;
+        size_t const copied_bytes = (available_bytes < field_size - m_field_length) ? available_bytes : field_size - m_field_length;
+        (void)memcpy(m_field + m_field_length, data, copied_bytes);
+        m_field_length += copied_bytes;
+        return copied_bytes;
+    }
+
+    /// @brief Parses the header or control block, once it has been received completely
+    /// @return Whether the field is still incomplete or was parsed successfully, false if it is invalid
+    bool Parse_Field() {
+        if (m_state == Patch_State::HEADER) {
+            if (m_field_length < DELTA_PATCH_HEADER_SIZE) {
+                return true;
+            }
+            if (memcmp(m_field, DELTA_PATCH_MAGIC, DELTA_PATCH_MAGIC_SIZE) != 0) {
+                Logger::printfln(DELTA_INVALID_MAGIC);
+                return false;
+            }
+            int64_t const new_size = Decode_Integer(m_field + DELTA_PATCH_MAGIC_SIZE);
+            if (new_size < 0 || static_cast<uint64_t>(new_size) > SIZE_MAX) {
+                Logger::printfln(DELTA_INVALID_SIZE);
+                return false;
+            }
+            m_new_size = static_cast<size_t>(new_size);
+            if (!m_target->begin(m_new_size)) {
+                Logger::printfln(DELTA_TARGET_BEGIN_FAILED, m_new_size);
+                return false;
+            }
+            m_target_started = true;
+            m_state = Patch_State::CONTROL;
+        }
+        else {
+            if (m_field_length < DELTA_PATCH_CONTROL_SIZE) {
+                return true;
+            }
+            int64_t const diff_length = Decode_Integer(m_field);
+            int64_t const extra_length = Decode_Integer(m_field + DELTA_PATCH_INTEGER_SIZE);
+            uint64_t const remaining_bytes = m_new_size - m_new_position;
+            // Lengths are checked one after another, to ensure adding them can not overflow
+            if (diff_length < 0 || extra_length < 0 || static_cast<uint64_t>(diff_length) > remaining_bytes || static_cast<uint64_t>(extra_length) > remaining_bytes - static_cast<uint64_t>(diff_length)) {
+                Logger::printfln(DELTA_INVALID_CONTROL, m_new_position);
+                return false;
+            }
+            m_diff_remaining = static_cast<size_t>(diff_length);
+            m_extra_remaining = static_cast<size_t>(extra_length);
+            m_seek_offset = Decode_Integer(m_field + (2U * DELTA_PATCH_INTEGER_SIZE));
+            m_state = Patch_State::DIFF;
+        }
+        m_field_length = 0U;
+        Skip_Empty_Segments();
+        return true;
+    }
+
+    /// @brief Advances the state past any diff or extra data with a length of 0, because those states would otherwise wait for data that is never received
+    void Skip_Empty_Segments() {
+        if (m_state == Patch_State::DIFF && m_diff_remaining == 0U) {
+            m_state = Patch_State::EXTRA;
+        }
+        if (m_state == Patch_State::EXTRA && m_extra_remaining == 0U) {
+            m_old_position += m_seek_offset;
+            m_state = Patch_State::CONTROL;
+        }
+        if (m_state != Patch_State::DIFF && m_state != Patch_State::EXTRA && m_new_position == m_new_size) {
+            m_state = Patch_State::DONE;
+        }
+    }
+
+    /// @brief Calculates how many bytes of the received data can be applied at once, limited by the remaining bytes of the current segment and the remaining space in the window
+    /// @param available_bytes Amount of bytes in the received patch data
+    /// @param segment_remaining Amount of bytes remaining in the current diff or extra data
+    /// @return Amount of bytes that can be applied into the window
+    size_t Get_Applicable_Bytes(size_t const & available_bytes, size_t const & segment_remaining) const {
+        size_t applicable_bytes = m_window_size - m_window_length;
+        if (available_bytes < applicable_bytes) {
+            applicable_bytes = available_bytes;
+        }
+        if (segment_remaining < applicable_bytes) {
+            applicable_bytes = segment_remaining;
+        }
+        return applicable_bytes;
+    }
+
+    /// @brief Reads the bytes of the currently running firmware binary at the current old position into the window and adds the received diff bytes to them.
+    /// Bytes outside of the currently running firmware binary are treated as 0, the same way bspatch does
+    /// @param data Received patch data
+    /// @param available_bytes Amount of bytes in the received patch data
+    /// @return Amount of bytes that were applied, 0 if reading the currently running firmware binary or writing the full window failed
+    size_t Apply_Diff(uint8_t const * data, size_t const & available_bytes) {
+        size_t const applied_bytes = Get_Applicable_Bytes(available_bytes, m_diff_remaining);
+        uint8_t * window = m_window + m_window_length;
+        (void)memset(window, 0, applied_bytes);
+
+        int64_t const source_size = static_cast<int64_t>(m_source->size());
+        int64_t const read_start = (m_old_position < 0) ? 0 : m_old_position;
+        int64_t const read_end = (m_old_position + static_cast<int64_t>(applied_bytes) > source_size) ? source_size : m_old_position + static_cast<int64_t>(applied_bytes);
+        if (read_start < read_end) {
+            size_t const read_bytes = static_cast<size_t>(read_end - read_start);
+            size_t const read_offset = static_cast<size_t>(read_start);
+            if (!m_source->read(read_offset, window + (read_start - m_old_position), read_bytes)) {
+                Logger::printfln(DELTA_SOURCE_READ_FAILED, read_bytes, read_offset);
+                return 0U;
+            }
+        }
+        for (size_t index = 0U; index < applied_bytes; index++) {
+            window[index] += data[index];
+        }
+
+        m_old_position += static_cast<int64_t>(applied_bytes);
+        m_diff_remaining -= applied_bytes;
+        if (!Advance_Window(applied_bytes)) {
+            return 0U;
+        }
+        return applied_bytes;
+    }
+
+    /// @brief Copies the received extra bytes into the window unchanged
+    /// @param data Received patch data
+    /// @param available_bytes Amount of bytes in the received patch data
+    /// @return Amount of bytes that were applied, 0 if writing the full window failed
+    size_t Apply_Extra(uint8_t const * data, size_t const & available_bytes) {
+        size_t const applied_bytes = Get_Applicable_Bytes(available_bytes, m_extra_remaining);
+        (void)memcpy(m_window + m_window_length, data, applied_bytes);
+        m_extra_remaining -= applied_bytes;
+        if (!Advance_Window(applied_bytes)) {
+            return 0U;
+        }
+        return applied_bytes;
+    }
+
+    /// @brief Marks the given amount of bytes in the window as reconstructed, writes the window into the target updater once it is full and advances the state if the current segment is complete
+    /// @param applied_bytes Amount of bytes that were added to the window
+    /// @return Whether writing the full window was successful or not
+    bool Advance_Window(size_t const & applied_bytes) {
+        m_window_length += applied_bytes;
+        m_new_position += applied_bytes;
+        if (m_window_length == m_window_size && !Flush_Window()) {
+            return false;
+        }
+        Skip_Empty_Segments();
+        return true;
+    }
+
+    /// @brief Writes all reconstructed bytes in the window into the target updater and into the hash function of the reconstructed firmware binary
+    /// @return Whether writing was successful or not
+    bool Flush_Window() {
+        if (m_window_length == 0U) {
+            return true;
+        }
+        size_t const written_bytes = m_target->write(m_window, m_window_length);
+        if (written_bytes != m_window_length) {
+            Logger::printfln(DELTA_TARGET_WRITE_FAILED, written_bytes, m_window_length);
+            return false;
+        }
+        if (m_target_checksum != nullptr) {
+            (void)m_target_hash.update(m_window, m_window_length);
+        }
+        m_window_length = 0U;
+        return true;
+    }
+
+    /// @brief Frees the window and resets the progress of the applied patch
+    void Free_Window() {
+        free(m_window);
+        m_window = nullptr;
+        m_window_length = 0U;
+        m_state = Patch_State::HEADER;
+        m_field_length = 0U;
+        m_new_size = 0U;
+        m_new_position = 0U;
+        m_old_position = 0;
+        m_diff_remaining = 0U;
+        m_extra_remaining = 0U;
+        m_seek_offset = 0;
+        m_target_started = false;
+    }
+
+    IUpdater          *m_target = {};                              // Updater the reconstructed firmware binary is written into
+    IFirmware_Source  *m_source = {};                              // Source the currently running firmware binary is read from
+    size_t            m_window_size = {};                          // Size of the window the reconstructed bytes are buffered in
+    uint8_t           *m_window = {};                              // Window the reconstructed bytes are buffered in, allocated while an update is in progress
+    size_t            m_window_length = {};                        // Amount of reconstructed bytes currently buffered in the window
+    char const        *m_target_checksum = {};                     // Expected checksum of the reconstructed firmware binary, nullptr if it is not verified
+    Checksum_Algorithm m_target_checksum_algorithm = {};            // Algorithm used to calculate the expected checksum of the reconstructed firmware binary
+    HashGenerator     m_target_hash = {};                          // Hash of the reconstructed firmware binary that has been written so far
+    Patch_State       m_state = {};                                // Part of the binary patch that is currently being received
+    uint8_t           m_field[DELTA_PATCH_HEADER_SIZE] = {};       // Received bytes of the header or control block that is currently being received, header and control block have the same size
+    size_t            m_field_length = {};                         // Amount of received bytes of the header or control block that is currently being received
+    size_t            m_new_size = {};                             // Size of the reconstructed firmware binary
+    size_t            m_new_position = {};                         // Amount of bytes of the reconstructed firmware binary that have been reconstructed so far
+    int64_t           m_old_position = {};                         // Position in the currently running firmware binary the next diff bytes are added to, might be outside of it
+    size_t            m_diff_remaining = {};                       // Amount of diff bytes remaining in the current segment
+    size_t            m_extra_remaining = {};                      // Amount of extra bytes remaining in the current segment
+    int64_t           m_seek_offset = {};                          // Offset the old position is moved by after the current segment
+    bool              m_target_started = {};                       // Whether the target updater has been started and has to be reset if the update fails
+};
+
+#endif // Delta_Updater_h
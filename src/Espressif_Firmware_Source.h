@@ -0,0 +1,80 @@
+#ifndef Espressif_Firmware_Source_h
+#define Espressif_Firmware_Source_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_ESP_PARTITION
+
+// Local include.
+#include "IFirmware_Source.h"
+
+// Library include.
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#ifndef ESP8266
+#include <esp_image_format.h>
+#endif // !ESP8266
+
+constexpr char MISSING_RUNNING_APP[] = "Failed to find the currently running app partition";
+constexpr char READ_RUNNING_APP_FAILED[] = "Reading the currently running app partition failed with error reason (%s)";
+
+
+/// @brief IFirmware_Source implementation that uses the Partition API from Espressif (https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/storage/partition.html)
+/// under the hood to read the firmware binary directly from the currently running app partition, which is the partition Espressif_Updater does not write into.
+/// The size of the running binary is read from the app image header, because the partition itself is most likely bigger than the binary
+/// and the erased bytes after the binary would not match the binary the patch was created against.
+/// On ESP8266 the header can not be parsed, therefore the complete partition size is used instead and the patch has to be created against the binary padded with 0xFF up to the partition size
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Espressif_Firmware_Source : public IFirmware_Source {
+  public:
+    Espressif_Firmware_Source() = default;
+
+    bool open() override {
+        esp_partition_t const * running = esp_ota_get_running_partition();
+        if (running == nullptr) {
+            Logger::printfln(MISSING_RUNNING_APP);
+            return false;
+        }
+        m_partition = running;
+        m_size = running->size;
+#ifndef ESP8266
+        esp_partition_pos_t const position = { .offset = running->address, .size = running->size };
+        esp_image_metadata_t metadata = {};
+        if (esp_image_get_metadata(&position, &metadata) == ESP_OK) {
+            m_size = metadata.image_len;
+        }
+#endif // !ESP8266
+        return true;
+    }
+
+    size_t size() const override {
+        return m_size;
+    }
+
+    bool read(size_t const & offset, uint8_t * buffer, size_t const & total_bytes) override {
+        if (m_partition == nullptr) {
+            return false;
+        }
+        esp_err_t const error = esp_partition_read(m_partition, offset, buffer, total_bytes);
+        if (error != ESP_OK) {
+            Logger::printfln(READ_RUNNING_APP_FAILED, esp_err_to_name(error));
+            return false;
+        }
+        return true;
+    }
+
+    void close() override {
+        m_partition = nullptr;
+        m_size = 0U;
+    }
+
+  private:
+    esp_partition_t const *m_partition = {}; // Currently running app partition the firmware binary is read from
+    size_t                 m_size = {};      // Size in bytes of the currently running firmware binary
+};
+
+#endif // THINGSBOARD_USE_ESP_PARTITION
+
+#endif // Espressif_Firmware_Source_h
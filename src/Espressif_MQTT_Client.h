@@ -7,22 +7,45 @@
 #if THINGSBOARD_USE_ESP_MQTT
 
 // Local includes.
+#include "Espressif_TLS_Transport.h"
 #include "IMQTT_Client.h"
+#include "MQTT_Reassembly_Buffer.h"
 
 // Library includes.
 #include <mqtt_client.h>
 #include <esp_crt_bundle.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // The error integer -1 means a general failure while handling the mqtt client,
 // where as -2 means that the outbox is filled and the message can therefore not be sent.
 // Therefore we have to check if the value is smaller or equal to the MQTT_FAILURE_MESSAGE_ID,
 // to ensure other errors are indentified as well
 constexpr int MQTT_FAILURE_MESSAGE_ID = -1;
+// Maximum total size of the segments passed to publish_segments() that is concatenated on the stack instead of the heap
+constexpr size_t MQTT_SEGMENTS_MAX_STACK_SIZE = 256U;
+// Maximum size of the topic of a message received in fragments including the null termination, only the first fragment contains the topic, therefore it has to be copied for the following fragments
+constexpr size_t MQTT_FRAGMENT_TOPIC_MAX_SIZE = 128U;
+// Default maximum size of a message that is received in fragments and reassembled, before it is passed to the data callback
+constexpr size_t MQTT_DEFAULT_REASSEMBLY_MAX_SIZE = 8192U;
+// Default time in microseconds after which the memory used to reassemble messages is released, if no message has been reassembled in the meantime
+constexpr uint64_t MQTT_DEFAULT_REASSEMBLY_IDLE_TIMEOUT = 10U * 1000U * 1000U;
+// Size of the internal buffers the ESP MQTT client allocates if the configured size is 0, the default value of the ESP IDF menuconfig
+constexpr uint16_t MQTT_DEFAULT_INTERNAL_BUFFER_SIZE = 1024U;
+// Maximum amount of bytes a QoS level 0 publish message needs besides the topic and payload, 5 bytes for the fixed header and 2 bytes for the length of the topic
+constexpr size_t MQTT_PUBLISH_HEADER_SIZE = 7U;
 constexpr char MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char MQTT_DATA_EXCEEDS_REASSEMBLY_SIZE[] = "Received amount of data (%u) is bigger than current buffer size (%u) and could not be reassembled with maximum reassembly size (%u), increase accordingly";
+constexpr char MQTT_FRAGMENT_TOPIC_TOO_LONG[] = "Topic of message received in fragments is longer than (%u) bytes, message is discarded";
+constexpr char MQTT_FRAGMENTED_MESSAGE_INCOMPLETE[] = "Message received in fragments over topic (%s) was interrupted after (%u) of (%u) bytes, message is discarded";
 #if THINGSBOARD_ENABLE_DEBUG
 constexpr char RECEIVED_MQTT_EVENT[] = "Handling received mqtt event: (%s)";
 constexpr char UPDATING_CONFIGURATION[] = "Updated configuration after inital connection with response: (%s)";
 constexpr char OVERRIDING_DEFAULT_CRT_BUNDLE[] = "Overriding default CRT bundle with response: (%s)";
+constexpr char REASSEMBLED_MQTT_MESSAGE[] = "Reassembled message with size (%u) bytes received in fragments over topic (%s)";
+constexpr char RELEASED_REASSEMBLY_BUFFER[] = "Released (%u) bytes used to reassemble messages after being idle";
+constexpr char LOADED_TLS_SESSION[] = "Loaded TLS session from session storage: (%s)";
 #endif // THINGSBOARD_ENABLE_DEBUG
 
 
@@ -37,9 +60,32 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     /// @brief Constructs a IMQTT_Client implementation which creates and empty esp_mqtt_client_config_t, which then has to be configured with the other methods in the class
     Espressif_MQTT_Client()
       : m_received_data_callback()
+      , m_received_data_view_callback()
+      , m_receive_data_views(false)
+      , m_received_fragment_callback()
+      , m_receive_fragments(false)
+      , m_fragment_topic()
+      , m_forwarding_fragments(false)
+      , m_fragment_received(0U)
+      , m_fragment_size(0U)
+      , m_reassembly_buffer(MQTT_DEFAULT_REASSEMBLY_MAX_SIZE)
+      , m_reassembly_max_size(MQTT_DEFAULT_REASSEMBLY_MAX_SIZE)
+      , m_reassembly_mutex(xSemaphoreCreateMutex())
+      , m_reassembly_idle_timeout(MQTT_DEFAULT_REASSEMBLY_IDLE_TIMEOUT)
+      , m_reassembly_last_used(0)
+      , m_reassembled_messages(0U)
+      , m_dropped_messages(0U)
       , m_connected_callback()
+      , m_internal_receive_buffer_size(0U)
+      , m_internal_send_buffer_size(0U)
       , m_connected(false)
+      , m_clean_session(true)
+      , m_session_present(false)
       , m_enqueue_messages(false)
+#if ESP_IDF_VERSION_MAJOR >= 5
+      , m_use_tls_transport(false)
+      , m_tls_transport()
+#endif // ESP_IDF_VERSION_MAJOR >= 5
       , m_mqtt_configuration()
       , m_mqtt_client(nullptr)
     {
@@ -49,6 +95,9 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     /// @brief Destructor
     ~Espressif_MQTT_Client() {
         (void)esp_mqtt_client_destroy(m_mqtt_client);
+        if (m_reassembly_mutex != nullptr) {
+            vSemaphoreDelete(m_reassembly_mutex);
+        }
     }
 
     /// @brief Configures the server certificate, which allows to connect to the MQTT broker over a secure TLS / SSL conenction instead of the default unencrypted channel.
@@ -113,6 +162,67 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return update_configuration();
     }
 
+    /// @brief Sets whether TLS connections are established with the Espressif_TLS_Transport instead of the default transport of the ESP MQTT client, which keeps the TLS session of the last connection
+    /// and offers it to the server when reconnecting. The server can then resume the session with an abbreviated handshake, that skips verifying the certificate chain and the key exchange,
+    /// which on an ESP32 shortens reconnects by 1 to 3 seconds of CPU time and several kilobytes of traffic. If the server does not know the session anymore, the full handshake is performed instead.
+    /// Additionally the session can be written into the given storage, which should be placed into RTC memory with RTC_NOINIT_ATTR so the first connection after waking up from deep sleep is resumed as well.
+    /// The duration of every handshake is measured and can be compared with get_tls_handshake_time(), passing false for enable keeps using the transport but always performs the full handshake,
+    /// which allows to measure the baseline. Has to be called before initally calling connect() on the client together with set_server_certificate() or set_server_crt_bundle(),
+    /// because the transport can not be exchanged once the client has been initalized. Requires Espressif IDF v5.X, because earlier versions do not allow to pass a custom transport
+    /// @param enable Whether the session of the last connection is offered to the server when reconnecting
+    /// @param session_storage Memory the session is additionally written into and loaded from, has to stay valid for as long as this instance exists, default = nullptr (session is only kept in memory)
+    /// @param session_storage_size Amount of bytes in the given memory, the serialized session needs between a few hundred bytes and a few kilobytes depending on the server, default = 0
+    /// @return Whether the transport is used for the connection, false if the client has already been initalized or the Espressif IDF version does not support custom transports
+    bool set_tls_session_resumption(bool enable, uint8_t * session_storage = nullptr, size_t const & session_storage_size = 0U) {
+#if ESP_IDF_VERSION_MAJOR < 5
+        return false;
+#else
+        if (m_mqtt_client != nullptr) {
+            return false;
+        }
+        m_use_tls_transport = true;
+        m_tls_transport.Set_Session_Resumption(enable);
+#if THINGSBOARD_ENABLE_DEBUG
+        bool const loaded = m_tls_transport.Set_Session_Storage(session_storage, session_storage_size);
+        Logger::printfln(LOADED_TLS_SESSION, loaded ? "true" : "false");
+#else
+        (void)m_tls_transport.Set_Session_Storage(session_storage, session_storage_size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+#endif // ESP_IDF_VERSION_MAJOR < 5
+    }
+
+    /// @brief Gets the duration of the last TLS handshake, only measured if set_tls_session_resumption() has been called
+    /// @return Duration in microseconds from the start of the TLS handshake until it completed, 0 if no handshake has been measured yet
+    uint64_t get_tls_handshake_time() const {
+#if ESP_IDF_VERSION_MAJOR < 5
+        return 0U;
+#else
+        return m_tls_transport.Get_Handshake_Time();
+#endif // ESP_IDF_VERSION_MAJOR < 5
+    }
+
+    /// @brief Gets the amount of TLS handshakes, that have been completed since this instance has been created, only counted if set_tls_session_resumption() has been called
+    /// @return Amount of completed handshakes
+    size_t get_tls_handshakes() const {
+#if ESP_IDF_VERSION_MAJOR < 5
+        return 0U;
+#else
+        return m_tls_transport.Get_Handshakes();
+#endif // ESP_IDF_VERSION_MAJOR < 5
+    }
+
+    /// @brief Whether a kept TLS session has been offered to the server during the last handshake, the server might still have performed the full handshake,
+    /// which can be recognized by comparing get_tls_handshake_time() with the duration of a full handshake
+    /// @return Whether a session has been offered during the last handshake
+    bool get_tls_session_offered() const {
+#if ESP_IDF_VERSION_MAJOR < 5
+        return false;
+#else
+        return m_tls_transport.Was_Session_Offered();
+#endif // ESP_IDF_VERSION_MAJOR < 5
+    }
+
     /// @brief Sets the keep alive timeout in seconds, if the value is 0 then the default of 120 seconds is used instead to disable the keep alive mechanism use set_disable_keep_alive() instead.
     /// The default timeout value ThingsBoard expectes to receive any message including a keep alive to not show the device as inactive can be found here https://thingsboard.io/fig/#mqtt-server-parameters
     /// under the transport.sessions.inactivity_timeout section and is 300 seconds. Meaning a value bigger than 300 seconds with the default config defeats the purpose of the keep alive alltogetherdocs/user-guide/install/con
@@ -143,6 +253,20 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return update_configuration();
     }
 
+    bool set_clean_session(bool clean_session) override {
+        m_clean_session = clean_session;
+#if ESP_IDF_VERSION_MAJOR < 5
+        m_mqtt_configuration.disable_clean_session = !clean_session;
+#else
+        m_mqtt_configuration.session.disable_clean_session = !clean_session;
+#endif // ESP_IDF_VERSION_MAJOR < 5
+        return update_configuration();
+    }
+
+    bool get_session_present() override {
+        return m_session_present;
+    }
+
     /// @brief Wheter to disable or enable that the MQTT client will reconnect to the server automatically if it errors or disconnects. The default is false meaning we will automatically reconnect
     /// @param disable_auto_reconnect Whether to automatically reconnect if the the client errors or disconnects
     /// @return Whether enabling or disabling the internal auto reconnect mechanism was successful or not
@@ -214,10 +338,63 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_received_data_callback.Set_Callback(callback);
     }
 
+    /// @brief The topic of a received message is not null terminated by the ESP MQTT client, once this callback has been set it is passed directly as a view,
+    /// instead of being copied to append the null termination and passed to the callback set with set_data_callback()
+    bool set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_view_callback.Set_Callback(callback);
+        m_receive_data_views = true;
+        return true;
+    }
+
+    /// @brief Sets the maximum size of a message, that is bigger than the receive buffer and is therefore received in multiple parts, that is reassembled and then passed to the data callback.
+    /// Messages the fragment callback does not handle itself are copied into a buffer until they have been received completely, instead of being discarded.
+    /// The buffer is only allocated once the first of those messages is received and only increased if a message bigger than every previous message is received,
+    /// which allows to keep the receive buffer small and still receive big shared attribute updates or RPC requests. Bigger messages are still discarded, to prevent unbounded heap allocations.
+    /// If the receive buffer size has been increased with set_buffer_size() after the client has been initalized, the bigger of both values is used instead
+    /// @param max_size Maximum size in bytes a reassembled message may have, 0 disables reassembling messages, default = MQTT_DEFAULT_REASSEMBLY_MAX_SIZE (8192)
+    void set_reassembly_max_size(size_t const & max_size) {
+        m_reassembly_max_size = max_size;
+        update_reassembly_max_size();
+    }
+
+    /// @brief Sets the time after which the memory used to reassemble messages is released, if no message has been reassembled in the meantime.
+    /// Released from within loop() or once the next MQTT event is received, because the memory is otherwise accessed from the task of the ESP MQTT client
+    /// @param idle_timeout_microseconds Time in microseconds the memory is kept after the last reassembled message, default = MQTT_DEFAULT_REASSEMBLY_IDLE_TIMEOUT (10 seconds)
+    void set_reassembly_idle_timeout(uint64_t const & idle_timeout_microseconds) {
+        m_reassembly_idle_timeout = idle_timeout_microseconds;
+    }
+
+    /// @brief Gets the amount of messages, that have been received in multiple parts and were reassembled and passed to the data callback since this instance has been created
+    /// @return Amount of reassembled messages
+    size_t get_reassembled_messages() const {
+        return m_reassembled_messages;
+    }
+
+    /// @brief Gets the amount of messages, that have been received in multiple parts and were discarded since this instance has been created,
+    /// because they were bigger than the maximum reassembly size, allocating the memory failed or the connection was interrupted before all parts were received
+    /// @return Amount of discarded messages
+    size_t get_dropped_messages() const {
+        return m_dropped_messages;
+    }
+
+    /// @brief Messages bigger than the receive buffer are passed by the ESP MQTT client in multiple MQTT_EVENT_DATA events, each containing the next part of the payload
+    /// and the offset of that part in the complete payload, once this callback has been set those parts are forwarded instead of reassembling or discarding the message
+    bool set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function callback) override {
+        m_received_fragment_callback.Set_Callback(callback);
+        m_receive_fragments = true;
+        return true;
+    }
+
     void set_connect_callback(Callback<void>::function callback) override {
         m_connected_callback.Set_Callback(callback);
     }
 
+    /// @brief The ESP MQTT client only allocates its internal buffers when it is initalized in the first call to connect(), changes afterwards are not applied by esp_mqtt_set_config().
+    /// See https://github.com/espressif/esp-mqtt/issues/267 for more information on the issue. Reinitalizing the client would disconnect and reconnect, which makes the connection unstable,
+    /// therefore sizes bigger than the internal buffers are instead handled by this class itself. Received messages up to the given receive buffer size are reassembled from their parts
+    /// in the reassembly buffer, which is allocated when needed and released again once idle, and published messages up to the given send buffer size are passed to esp_mqtt_client_publish(),
+    /// which writes messages bigger than its internal buffer in multiple parts. Smaller sizes simply keep the memory of the internal buffers allocated.
+    /// Meaning the internal buffers should be initalized with the size most messages fit in and only the rare bigger messages need the additional work
     bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
 #if ESP_IDF_VERSION_MAJOR < 5
         m_mqtt_configuration.buffer_size = receive_buffer_size;
@@ -226,16 +403,22 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_mqtt_configuration.buffer.size = receive_buffer_size;
         m_mqtt_configuration.buffer.out_size = send_buffer_size;
 #endif // ESP_IDF_VERSION_MAJOR < 5
-
-        // Calls esp_mqtt_set_config(), which should adjust the underlying mqtt client to the changed values.
-        // Which it does but not for the buffer_size, this results in the buffer size only being able to be changed when initally creating the mqtt client.
-        // If the mqtt client is reinitalized this causes disconnected and reconnects tough and the connection becomes unstable.
-        // Therefore this workaround can also not be used. Instead we expect the esp_mqtt_set_config(), to do what the name implies and therefore still call it
-        // and created an issue revolving around the aformentioned problem so it might get fixed in future version of the esp_mqtt client.
-        // See https://github.com/espressif/esp-mqtt/issues/267 for more information on the issue 
+        update_reassembly_max_size();
         return update_configuration();
     }
 
+    /// @brief Gets the size of the internal receive buffer the ESP MQTT client has been initalized with, bigger messages are received in multiple parts
+    /// @return Size of the internal receive buffer in bytes, 0 if the client has not been initalized yet
+    uint16_t get_internal_receive_buffer_size() const {
+        return m_internal_receive_buffer_size;
+    }
+
+    /// @brief Gets the size of the internal send buffer the ESP MQTT client has been initalized with, bigger messages are written in multiple parts
+    /// @return Size of the internal send buffer in bytes, 0 if the client has not been initalized yet
+    uint16_t get_internal_send_buffer_size() const {
+        return m_internal_send_buffer_size;
+    }
+
     uint16_t get_receive_buffer_size() override {
 #if ESP_IDF_VERSION_MAJOR < 5
         return m_mqtt_configuration.buffer_size;
@@ -272,6 +455,11 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_mqtt_configuration.transport = transport;
 #else
         m_mqtt_configuration.broker.address.transport = transport;
+        // Custom transport is only read when the client is initalized, it is therefore only passed before that and then kept for all following connections
+        if (m_use_tls_transport && transport_over_sll && m_mqtt_client == nullptr) {
+            m_tls_transport.Set_Verification(m_mqtt_configuration.broker.verification.certificate, m_mqtt_configuration.broker.verification.crt_bundle_attach);
+            m_mqtt_configuration.network.transport = m_tls_transport.Get_Handle();
+        }
 #endif // ESP_IDF_VERSION_MAJOR < 5
     }
 
@@ -299,6 +487,10 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         // The client is first initalized once the connect has actually been called, this is done because the passed setting are required for the client inizialitation structure,
         // additionally before we attempt to connect with the client we have to ensure it is configued by then.
         m_mqtt_client = esp_mqtt_client_init(&m_mqtt_configuration);
+        // Internal buffers keep the size they have been initalized with, see set_buffer_size() for how bigger sizes are handled afterwards.
+        // A send buffer size of 0 uses the same size as the receive buffer
+        m_internal_receive_buffer_size = get_receive_buffer_size() != 0U ? get_receive_buffer_size() : MQTT_DEFAULT_INTERNAL_BUFFER_SIZE;
+        m_internal_send_buffer_size = get_send_buffer_size() != 0U ? get_send_buffer_size() : m_internal_receive_buffer_size;
         esp_err_t error = esp_mqtt_client_register_event(m_mqtt_client, esp_mqtt_event_id_t::MQTT_EVENT_ANY, Espressif_MQTT_Client::static_mqtt_event_handler, this);
 
         if (error != ESP_OK) {
@@ -313,15 +505,19 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     }
 
     bool loop() override {
-        // Unused because the esp mqtt client uses its own task to handle receiving and sending of data, therefore we do not need to do anything in the loop method.
+        // Receiving and sending is handled by the esp mqtt client in its own task, therefore we do not need to do anything in the loop method except releasing idle memory.
         // Because the loop method is meant for clients that do not have their own process method but instead rely on the upper level code calling a loop method to provide processsing time.
+        // Never waits for the reassembly buffer, because it is only locked by the task of the esp mqtt client while a message is handled
+        release_idle_reassembly_buffer(0U);
         return m_connected;
     }
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
         int message_id = MQTT_FAILURE_MESSAGE_ID;
 
-        if (m_enqueue_messages) {
+        // Messages that do not fit into the internal send buffer can not be stored in the outbox, because it copies the message as created in the internal buffer,
+        // they are therefore always sent with the blocking method instead, which writes them in multiple parts
+        if (m_enqueue_messages && length + strlen(topic) + MQTT_PUBLISH_HEADER_SIZE <= m_internal_send_buffer_size) {
             message_id = esp_mqtt_client_enqueue(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, 0U, 0U, true);
             return message_id > MQTT_FAILURE_MESSAGE_ID;
         }
@@ -336,13 +532,37 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return message_id > MQTT_FAILURE_MESSAGE_ID;
     }
 
+    bool publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) override {
+        // The esp mqtt client only accepts one contiguous payload and copies it into its own internal buffer, before sending it.
+        // Therefore a single segment can be passed directly, while multiple segments have to be concatenated into a temporary buffer first
+        if (segments == nullptr || segment_count == 1U) {
+            return IMQTT_Client::publish_segments(topic, segments, segment_count);
+        }
+        size_t const length = get_segments_length(segments, segment_count);
+        // Bigger payloads are concatenated on the heap instead, to ensure the task calling publish does not overflow its stack
+        if (length > MQTT_SEGMENTS_MAX_STACK_SIZE) {
+            return IMQTT_Client::publish_segments(topic, segments, segment_count);
+        }
+        uint8_t payload[length] = {};
+        size_t offset = 0U;
+        for (size_t i = 0U; i < segment_count; i++) {
+            if (segments[i].length == 0U) {
+                continue;
+            }
+            memcpy(payload + offset, segments[i].data, segments[i].length);
+            offset += segments[i].length;
+        }
+        return publish(topic, payload, length);
+    }
+
     bool subscribe(char const * topic) override {
         // The esp_mqtt_client_subscribe method does not return false, if we send a subscribe request while not being connected to a broker,
         // so we have to check for that case to ensure the end user is informed that their subscribe request could not be sent and has been ignored.
         if (!connected()) {
             return false;
         }
-        int const message_id = esp_mqtt_client_subscribe(m_mqtt_client, topic, 0U);
+        // Persistent sessions only keep messages with atleast QoS level 1 while the client is disconnected, therefore the subscriptions use that level if the session is kept
+        int const message_id = esp_mqtt_client_subscribe(m_mqtt_client, topic, m_clean_session ? 0U : 1U);
         return message_id > MQTT_FAILURE_MESSAGE_ID;
     }
 
@@ -418,26 +638,27 @@ private:
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(RECEIVED_MQTT_EVENT, esp_event_id_to_name(event_id));
 #endif // THINGSBOARD_ENABLE_DEBUG
+        release_idle_reassembly_buffer(portMAX_DELAY);
         switch (event_id) {
             case esp_mqtt_event_id_t::MQTT_EVENT_CONNECTED:
                 m_connected = true;
+                // Has to be set before the callback is called, because it decides whether the topics have to be subscribed again
+                m_session_present = event->session_present != 0;
                 m_connected_callback.Call_Callback();
                 break;
             case esp_mqtt_event_id_t::MQTT_EVENT_DISCONNECTED:
                 m_connected = false;
+                // Remaining parts of a message are never received after the connection has been interrupted
+                discard_fragmented_message();
                 break;
             case esp_mqtt_event_id_t::MQTT_EVENT_DATA: {
                 // Check wheter the given message has not bee received completly, but instead would be received in multiple chunks,
-                // if it were we discard the message because receiving a message over multiple chunks is currently not supported
+                // if it were we forward the fragment if that has been requested and discard the message otherwise
                 if (event->data_len != event->total_data_len) {
-                    Logger::printfln(MQTT_DATA_EXCEEDS_BUFFER, event->total_data_len, get_receive_buffer_size());
+                    handle_fragment(event);
                     break;
                 }
-                // Topic is not null terminated, to fix this issue we copy the topic string.
-                // This overhead is acceptable, because we nearly always copy only a few bytes (around 20), meaning the overhead is insignificant.
-                char topic[event->topic_len + 1] = {};
-                strncpy(topic, event->topic, event->topic_len);
-                m_received_data_callback.Call_Callback(topic, reinterpret_cast<uint8_t*>(event->data), event->data_len);
+                handle_data(String_View(event->topic, event->topic_len), reinterpret_cast<uint8_t*>(event->data), event->data_len);
                 break;
             }
             default:
@@ -446,6 +667,151 @@ private:
         }
     }
 
+    /// @brief Passes the complete received message to the data callback, directly with the topic as a view if that callback has been set
+    /// @param topic Topic the message was received over, not necessarily null terminated
+    /// @param payload Payload of the message
+    /// @param length Amount of bytes in the payload
+    void handle_data(String_View const & topic, uint8_t * payload, size_t const & length) {
+        if (m_receive_data_views) {
+            m_received_data_view_callback.Call_Callback(topic, payload, length);
+            return;
+        }
+        // Topic is not null terminated, to fix this issue we copy the topic string.
+        // This overhead is acceptable, because we nearly always copy only a few bytes (around 20), meaning the overhead is insignificant.
+        char terminated_topic[topic.size() + 1U] = {};
+        (void)memcpy(terminated_topic, topic.data(), topic.size());
+        m_received_data_callback.Call_Callback(terminated_topic, payload, length);
+    }
+
+    /// @brief Handles the part of a message that is bigger than the receive buffer. Only the event containing the first part of the message contains the topic,
+    /// which is therefore copied and reused for all following parts of the same message. The first part decides how the complete message is handled,
+    /// if the fragment callback handles it all parts are forwarded to it, otherwise the parts are reassembled and the complete message is passed to the data callback
+    /// @param event MQTT_EVENT_DATA event containing a part of the message
+    void handle_fragment(esp_mqtt_event_handle_t const & event) {
+        size_t const offset = event->current_data_offset;
+        size_t const length = event->data_len;
+        size_t const total_length = event->total_data_len;
+        uint8_t * const payload = reinterpret_cast<uint8_t*>(event->data);
+
+        if (offset == 0U) {
+            // Parts of messages are never interleaved, therefore a previous message that has not been completed will never be completed anymore
+            discard_fragmented_message();
+            if (event->topic_len >= static_cast<int>(sizeof(m_fragment_topic))) {
+                Logger::printfln(MQTT_FRAGMENT_TOPIC_TOO_LONG, sizeof(m_fragment_topic) - 1U);
+                m_dropped_messages++;
+                return;
+            }
+            (void)memcpy(m_fragment_topic, event->topic, event->topic_len);
+            m_fragment_topic[event->topic_len] = '\0';
+            m_fragment_received = 0U;
+            m_fragment_size = total_length;
+            m_forwarding_fragments = m_receive_fragments && m_received_fragment_callback.Call_Callback(m_fragment_topic, payload, offset, length, total_length);
+            if (m_forwarding_fragments) {
+                m_fragment_received = length;
+                return;
+            }
+            if (!begin_reassembly(total_length)) {
+                if (m_reassembly_buffer.Get_Max_Size() == 0U) {
+                    Logger::printfln(MQTT_DATA_EXCEEDS_BUFFER, total_length, get_receive_buffer_size());
+                }
+                else {
+                    Logger::printfln(MQTT_DATA_EXCEEDS_REASSEMBLY_SIZE, total_length, get_receive_buffer_size(), m_reassembly_buffer.Get_Max_Size());
+                }
+                m_fragment_topic[0] = '\0';
+                m_dropped_messages++;
+                return;
+            }
+        }
+        // Topic was too long or the message could not be reassembled, therefore the remaining parts of the message are discarded as well
+        else if (m_fragment_topic[0] == '\0' || offset != m_fragment_received) {
+            return;
+        }
+        m_fragment_received += length;
+
+        if (m_forwarding_fragments) {
+            (void)m_received_fragment_callback.Call_Callback(m_fragment_topic, payload, offset, length, total_length);
+            if (m_fragment_received >= total_length) {
+                m_fragment_topic[0] = '\0';
+            }
+            return;
+        }
+
+        // Reassembly buffer is only accessed from this task while a message is reassembled, therefore it only has to be locked once it is released or allocated
+        (void)m_reassembly_buffer.Append(offset, payload, length);
+        if (!m_reassembly_buffer.Is_Complete()) {
+            return;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(REASSEMBLED_MQTT_MESSAGE, total_length, m_fragment_topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_reassembled_messages++;
+        handle_data(m_fragment_topic, m_reassembly_buffer.Get_Data(), m_reassembly_buffer.Get_Size());
+        m_fragment_topic[0] = '\0';
+        end_reassembly();
+    }
+
+    /// @brief Applies the configured maximum reassembly size, increased to the receive buffer size if it is bigger than the internal receive buffer,
+    /// because messages up to the receive buffer size have to be reassembled once the internal buffer can not be resized anymore
+    void update_reassembly_max_size() {
+        size_t max_size = m_reassembly_max_size;
+        if (m_mqtt_client != nullptr && get_receive_buffer_size() > m_internal_receive_buffer_size && get_receive_buffer_size() > max_size) {
+            max_size = get_receive_buffer_size();
+        }
+        m_reassembly_buffer.Set_Max_Size(max_size);
+    }
+
+    /// @brief Discards the message that is currently received in fragments, because its remaining parts will never be received
+    void discard_fragmented_message() {
+        if (m_fragment_topic[0] == '\0') {
+            return;
+        }
+        Logger::printfln(MQTT_FRAGMENTED_MESSAGE_INCOMPLETE, m_fragment_topic, m_fragment_received, m_fragment_size);
+        m_fragment_topic[0] = '\0';
+        // Forwarded messages are completed by the fragment callback itself, once it receives the first part of the next message or the request times out
+        if (!m_forwarding_fragments) {
+            m_dropped_messages++;
+            end_reassembly();
+        }
+    }
+
+    /// @brief Starts reassembling a message with the given size, increases the memory of the reassembly buffer if needed
+    /// @param total_length Amount of bytes in the complete message
+    /// @return Whether the message can be reassembled
+    bool begin_reassembly(size_t const & total_length) {
+        if (m_reassembly_mutex == nullptr || xSemaphoreTake(m_reassembly_mutex, portMAX_DELAY) != pdTRUE) {
+            return false;
+        }
+        bool const result = m_reassembly_buffer.Begin(total_length);
+        m_reassembly_last_used = esp_timer_get_time();
+        (void)xSemaphoreGive(m_reassembly_mutex);
+        return result;
+    }
+
+    /// @brief Stops reassembling the current message, the memory is kept for the next message until the idle timeout has passed
+    void end_reassembly() {
+        if (m_reassembly_mutex == nullptr || xSemaphoreTake(m_reassembly_mutex, portMAX_DELAY) != pdTRUE) {
+            return;
+        }
+        m_reassembly_buffer.End();
+        m_reassembly_last_used = esp_timer_get_time();
+        (void)xSemaphoreGive(m_reassembly_mutex);
+    }
+
+    /// @brief Releases the memory of the reassembly buffer, if no message is currently reassembled and no message has been reassembled for longer than the idle timeout
+    /// @param ticks_to_wait Maximum time to wait for the reassembly buffer to be unlocked, if it is locked for longer the memory is released on the next call instead
+    void release_idle_reassembly_buffer(TickType_t const & ticks_to_wait) {
+        if (m_reassembly_buffer.Get_Capacity() == 0U || m_reassembly_mutex == nullptr || xSemaphoreTake(m_reassembly_mutex, ticks_to_wait) != pdTRUE) {
+            return;
+        }
+        size_t const capacity = m_reassembly_buffer.Get_Capacity();
+        if (capacity > 0U && static_cast<uint64_t>(esp_timer_get_time() - m_reassembly_last_used) >= m_reassembly_idle_timeout && m_reassembly_buffer.Release()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RELEASED_REASSEMBLY_BUFFER, capacity);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        }
+        (void)xSemaphoreGive(m_reassembly_mutex);
+    }
+
     static void static_mqtt_event_handler(void * handler_args, esp_event_base_t base, int32_t event_id, void * event_data) {
         if (handler_args == nullptr) {
             return;
@@ -455,9 +821,32 @@ private:
     }
 
     Callback<void, char *, uint8_t *, unsigned int> m_received_data_callback = {}; // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, String_View const &, uint8_t *, unsigned int> m_received_data_view_callback = {}; // Callback that will be called as soon as the mqtt client receives any data, with the topic as a view
+    bool                                            m_receive_data_views = {};     // Whether received messages are passed to the callback with the topic as a view instead of the one with a null terminated copy
+    Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t> m_received_fragment_callback = {}; // Callback that will be called for every part of a message bigger than the receive buffer
+    bool                                            m_receive_fragments = {};      // Whether parts of messages bigger than the receive buffer are offered to the fragment callback, before they are reassembled
+    char                                            m_fragment_topic[MQTT_FRAGMENT_TOPIC_MAX_SIZE] = {}; // Topic of the message that is currently received in parts, empty if there is none or it is discarded
+    bool                                            m_forwarding_fragments = {};   // Whether the parts of the current message are forwarded to the fragment callback instead of being reassembled
+    size_t                                          m_fragment_received = {};      // Amount of bytes of the current message that have already been received
+    size_t                                          m_fragment_size = {};          // Amount of bytes in the complete current message
+    MQTT_Reassembly_Buffer                          m_reassembly_buffer;           // Buffer the parts of messages not handled by the fragment callback are reassembled in
+    size_t                                          m_reassembly_max_size = {};    // Maximum reassembly size configured with set_reassembly_max_size(), might be increased to the receive buffer size
+    SemaphoreHandle_t                               m_reassembly_mutex = {};       // Locks the memory of the reassembly buffer, so it can be released from the task calling loop()
+    uint64_t                                        m_reassembly_idle_timeout = {}; // Time in microseconds after which the memory of the reassembly buffer is released
+    int64_t                                         m_reassembly_last_used = {};   // Time in microseconds since boot the reassembly buffer has been used the last time
+    size_t                                          m_reassembled_messages = {};   // Amount of messages that have been reassembled and passed to the data callback
+    size_t                                          m_dropped_messages = {};       // Amount of messages received in parts that have been discarded
     Callback<void>                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
+    uint16_t                                        m_internal_receive_buffer_size = {}; // Size of the receive buffer the esp mqtt client has been initalized with, 0 if it has not been initalized yet
+    uint16_t                                        m_internal_send_buffer_size = {}; // Size of the send buffer the esp mqtt client has been initalized with, 0 if it has not been initalized yet
     bool                                            m_connected = {};              // Whether the client has received the connected or disconnected event
+    bool                                            m_clean_session = {};          // Whether the connection requests a clean session, if not subscriptions use QoS level 1 so the server keeps their messages while disconnected
+    bool                                            m_session_present = {};        // Whether the server still had the session of the previous connection when the last connection was established
     bool                                            m_enqueue_messages = {};       // Whether we enqueue messages making nearly all ThingsBoard calls non blocking or wheter we publish instead
+#if ESP_IDF_VERSION_MAJOR >= 5
+    bool                                            m_use_tls_transport = {};      // Whether TLS connections are established with the transport that resumes the session of the last connection
+    Espressif_TLS_Transport                         m_tls_transport;               // Transport that resumes the TLS session of the last connection, destroyed after the client which releases its handle
+#endif // ESP_IDF_VERSION_MAJOR >= 5
     esp_mqtt_client_config_t                        m_mqtt_configuration = {};     // Configuration of the underlying mqtt client, saved as a private variable to allow changes after inital configuration with the same options for all non changed settings
     esp_mqtt_client_handle_t                        m_mqtt_client = {};            // Handle to the underlying mqtt client, used to establish the communication
 };
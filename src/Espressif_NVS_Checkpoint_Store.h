@@ -0,0 +1,100 @@
+#ifndef Espressif_NVS_Checkpoint_Store_h
+#define Espressif_NVS_Checkpoint_Store_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_ESP_NVS
+
+// Local include.
+#include "IOTA_Checkpoint_Store.h"
+#include "OTA_Checkpoint.h"
+
+// Library include.
+#include <nvs.h>
+
+char constexpr CHECKPOINT_NAMESPACE[] = "tb_ota";
+char constexpr CHECKPOINT_KEY[] = "checkpoint";
+char constexpr OPEN_NVS_FAILED[] = "Failed to open non-volatile storage namespace (%s) with error reason (%s)";
+char constexpr SAVE_CHECKPOINT_FAILED[] = "Failed to save checkpoint with error reason (%s)";
+
+
+/// @brief IOTA_Checkpoint_Store implementation that uses the Non-Volatile Storage API from Espressif (https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/storage/nvs_flash.html)
+/// under the hood to persist the checkpoint as a blob. Requires the default nvs partition to be initalized with nvs_flash_init() beforehand.
+/// Writing a blob is atomic, meaning a reboot while saving keeps the previous checkpoint intact
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Espressif_NVS_Checkpoint_Store : public IOTA_Checkpoint_Store {
+  public:
+    /// @brief Constructor
+    /// @param name_space Namespace in the default nvs partition the checkpoint is saved in, can be at most 15 characters long, default = CHECKPOINT_NAMESPACE
+    /// @param key Key in the given namespace the checkpoint is saved with, can be at most 15 characters long, default = CHECKPOINT_KEY
+    Espressif_NVS_Checkpoint_Store(char const * name_space = CHECKPOINT_NAMESPACE, char const * key = CHECKPOINT_KEY)
+      : m_namespace(name_space)
+      , m_key(key)
+    {
+        // Nothing to do
+    }
+
+    bool load(OTA_Checkpoint & checkpoint) override {
+        nvs_handle_t handle = {};
+        if (!Open(NVS_READONLY, handle)) {
+            return false;
+        }
+        size_t length = sizeof(checkpoint);
+        esp_err_t const error = nvs_get_blob(handle, m_key, &checkpoint, &length);
+        nvs_close(handle);
+        return error == ESP_OK && length == sizeof(checkpoint) && checkpoint.magic == OTA_CHECKPOINT_MAGIC;
+    }
+
+    bool save(OTA_Checkpoint const & checkpoint) override {
+        nvs_handle_t handle = {};
+        if (!Open(NVS_READWRITE, handle)) {
+            return false;
+        }
+        esp_err_t error = nvs_set_blob(handle, m_key, &checkpoint, sizeof(checkpoint));
+        if (error == ESP_OK) {
+            error = nvs_commit(handle);
+        }
+        nvs_close(handle);
+        if (error != ESP_OK) {
+            Logger::printfln(SAVE_CHECKPOINT_FAILED, esp_err_to_name(error));
+            return false;
+        }
+        return true;
+    }
+
+    bool erase() override {
+        nvs_handle_t handle = {};
+        if (!Open(NVS_READWRITE, handle)) {
+            return false;
+        }
+        esp_err_t error = nvs_erase_key(handle, m_key);
+        if (error == ESP_OK) {
+            error = nvs_commit(handle);
+        }
+        nvs_close(handle);
+        return error == ESP_OK || error == ESP_ERR_NVS_NOT_FOUND;
+    }
+
+  private:
+    /// @brief Opens the configured namespace in the default nvs partition
+    /// @param open_mode Whether the namespace should be opened read only or for reading and writing
+    /// @param handle Handle the opened namespace will be copied into, has to be closed with nvs_close() afterwards if opening was successful
+    /// @return Whether opening the namespace was successful or not
+    bool Open(nvs_open_mode_t const & open_mode, nvs_handle_t & handle) const {
+        esp_err_t const error = nvs_open(m_namespace, open_mode, &handle);
+        // Opening a namespace that does not exist yet as read only fails, which simply means no checkpoint has been saved yet
+        if (error != ESP_OK && error != ESP_ERR_NVS_NOT_FOUND) {
+            Logger::printfln(OPEN_NVS_FAILED, m_namespace, esp_err_to_name(error));
+        }
+        return error == ESP_OK;
+    }
+
+    char const * m_namespace = {}; // Namespace in the default nvs partition the checkpoint is saved in
+    char const * m_key = {};       // Key in the given namespace the checkpoint is saved with
+};
+
+#endif // THINGSBOARD_USE_ESP_NVS
+
+#endif // Espressif_NVS_Checkpoint_Store_h
@@ -0,0 +1,380 @@
+// Header include.
+#include "Espressif_TLS_Transport.h"
+
+#if THINGSBOARD_USE_ESP_MQTT && ESP_IDF_VERSION_MAJOR >= 5
+
+// Local include.
+#include "Helper.h"
+
+// Library includes.
+#include <errno.h>
+#include <esp_timer.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+// Default port of MQTT over TLS, used if the ESP MQTT client does not pass a port
+constexpr uint16_t TLS_TRANSPORT_DEFAULT_PORT = 8883U;
+// Personalization string mixed into the seed of the random number generator
+constexpr char TLS_TRANSPORT_PERSONALIZATION[] = "thingsboard_tls";
+
+
+Espressif_TLS_Transport::Espressif_TLS_Transport()
+  : m_handle(nullptr)
+  , m_server_certificate(nullptr)
+  , m_crt_bundle_attach(nullptr)
+  , m_initialized(false)
+  , m_connected(false)
+  , m_session_resumption(true)
+  , m_has_session(false)
+  , m_session_offered(false)
+  , m_session_storage(nullptr)
+  , m_session_storage_size(0U)
+  , m_handshake_time(0U)
+  , m_handshakes(0U)
+  , m_entropy()
+  , m_ctr_drbg()
+  , m_certificate()
+  , m_ssl_config()
+  , m_ssl()
+  , m_net()
+  , m_session()
+{
+    mbedtls_entropy_init(&m_entropy);
+    mbedtls_ctr_drbg_init(&m_ctr_drbg);
+    mbedtls_x509_crt_init(&m_certificate);
+    mbedtls_ssl_config_init(&m_ssl_config);
+    mbedtls_ssl_init(&m_ssl);
+    mbedtls_net_init(&m_net);
+    mbedtls_ssl_session_init(&m_session);
+}
+
+Espressif_TLS_Transport::~Espressif_TLS_Transport() {
+    // Handle is only still valid if it has never been passed to an initalized ESP MQTT client, because the client destroys it together with itself
+    if (m_handle != nullptr) {
+        (void)esp_transport_destroy(m_handle);
+    }
+    (void)Close();
+    mbedtls_ssl_session_free(&m_session);
+    mbedtls_ssl_config_free(&m_ssl_config);
+    mbedtls_x509_crt_free(&m_certificate);
+    mbedtls_ctr_drbg_free(&m_ctr_drbg);
+    mbedtls_entropy_free(&m_entropy);
+}
+
+void Espressif_TLS_Transport::Set_Verification(char const * server_certificate_pem, esp_err_t (*crt_bundle_attach)(void * conf)) {
+    m_server_certificate = server_certificate_pem;
+    m_crt_bundle_attach = crt_bundle_attach;
+}
+
+void Espressif_TLS_Transport::Set_Session_Resumption(bool const & enable) {
+    m_session_resumption = enable;
+}
+
+bool Espressif_TLS_Transport::Set_Session_Storage(uint8_t * storage, size_t const & size) {
+    m_session_storage = storage;
+    m_session_storage_size = storage != nullptr ? size : 0U;
+    return Load_Session();
+}
+
+void Espressif_TLS_Transport::Clear_Session() {
+    mbedtls_ssl_session_free(&m_session);
+    mbedtls_ssl_session_init(&m_session);
+    m_has_session = false;
+    if (m_session_storage_size >= TLS_SESSION_STORAGE_HEADER_SIZE) {
+        (void)memset(m_session_storage, 0, TLS_SESSION_STORAGE_HEADER_SIZE);
+    }
+}
+
+esp_transport_handle_t Espressif_TLS_Transport::Get_Handle() {
+    if (m_handle != nullptr) {
+        return m_handle;
+    }
+    m_handle = esp_transport_init();
+    if (m_handle == nullptr) {
+        return nullptr;
+    }
+    (void)esp_transport_set_context_data(m_handle, this);
+    (void)esp_transport_set_default_port(m_handle, TLS_TRANSPORT_DEFAULT_PORT);
+    (void)esp_transport_set_func(m_handle, Static_Connect, Static_Read, Static_Write, Static_Close, Static_Poll_Read, Static_Poll_Write, Static_Destroy);
+    return m_handle;
+}
+
+bool Espressif_TLS_Transport::Has_Session() const {
+    return m_has_session;
+}
+
+bool Espressif_TLS_Transport::Was_Session_Offered() const {
+    return m_session_offered;
+}
+
+uint64_t Espressif_TLS_Transport::Get_Handshake_Time() const {
+    return m_handshake_time;
+}
+
+size_t Espressif_TLS_Transport::Get_Handshakes() const {
+    return m_handshakes;
+}
+
+bool Espressif_TLS_Transport::Initialize() {
+    if (m_initialized) {
+        return true;
+    }
+    else if (mbedtls_ctr_drbg_seed(&m_ctr_drbg, mbedtls_entropy_func, &m_entropy, reinterpret_cast<unsigned char const *>(TLS_TRANSPORT_PERSONALIZATION), strlen(TLS_TRANSPORT_PERSONALIZATION)) != 0) {
+        return false;
+    }
+    else if (mbedtls_ssl_config_defaults(&m_ssl_config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+        return false;
+    }
+    mbedtls_ssl_conf_authmode(&m_ssl_config, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_rng(&m_ssl_config, mbedtls_ctr_drbg_random, &m_ctr_drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&m_ssl_config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif // defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (m_crt_bundle_attach != nullptr) {
+        if (m_crt_bundle_attach(&m_ssl_config) != ESP_OK) {
+            return false;
+        }
+    }
+    else if (m_server_certificate != nullptr) {
+        // Parsing PEM requires the length to include the null termination
+        if (mbedtls_x509_crt_parse(&m_certificate, reinterpret_cast<unsigned char const *>(m_server_certificate), strlen(m_server_certificate) + 1U) != 0) {
+            return false;
+        }
+        mbedtls_ssl_conf_ca_chain(&m_ssl_config, &m_certificate, nullptr);
+    }
+    else {
+        // Never connect without verifying the server, because the resumed session would then be just as unverified
+        return false;
+    }
+    m_initialized = true;
+    return true;
+}
+
+int Espressif_TLS_Transport::Connect(char const * host, int const & port, int const & timeout_ms) {
+    (void)Close();
+    if (host == nullptr || !Initialize() || mbedtls_ssl_setup(&m_ssl, &m_ssl_config) != 0 || mbedtls_ssl_set_hostname(&m_ssl, host) != 0) {
+        (void)Close();
+        return -1;
+    }
+    if (!Open_Socket(host, port, timeout_ms)) {
+        (void)Close();
+        return -1;
+    }
+    mbedtls_ssl_conf_read_timeout(&m_ssl_config, timeout_ms);
+    mbedtls_ssl_set_bio(&m_ssl, &m_net, mbedtls_net_send, nullptr, mbedtls_net_recv_timeout);
+    m_session_offered = m_session_resumption && m_has_session && mbedtls_ssl_set_session(&m_ssl, &m_session) == 0;
+
+    int64_t const start = esp_timer_get_time();
+    int result = 0;
+    while ((result = mbedtls_ssl_handshake(&m_ssl)) != 0) {
+        if (result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            // Offered session might have been the reason, for example because it was corrupted, therefore the next attempt performs the full handshake instead
+            if (m_session_offered) {
+                Clear_Session();
+            }
+            (void)Close();
+            return -1;
+        }
+    }
+    m_handshake_time = static_cast<uint64_t>(esp_timer_get_time() - start);
+    m_handshakes++;
+    m_connected = true;
+    Save_Session();
+    return 0;
+}
+
+bool Espressif_TLS_Transport::Open_Socket(char const * host, int const & port, int const & timeout_ms) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    char port_string[Helper::detectSize("%d", port)] = {};
+    (void)snprintf(port_string, sizeof(port_string), "%d", port);
+    addrinfo * addresses = nullptr;
+    if (getaddrinfo(host, port_string, &hints, &addresses) != 0) {
+        return false;
+    }
+    int64_t const deadline = esp_timer_get_time() + static_cast<int64_t>(timeout_ms) * 1000;
+    for (addrinfo const * address = addresses; address != nullptr; address = address->ai_next) {
+        int64_t const remaining_ms = (deadline - esp_timer_get_time()) / 1000;
+        if (remaining_ms <= 0) {
+            break;
+        }
+        m_net.fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (m_net.fd < 0) {
+            continue;
+        }
+        // Connecting without blocking allows to abort once the timeout has passed, instead of waiting for the TCP stack to give up, which takes minutes if the server does not answer
+        if (mbedtls_net_set_nonblock(&m_net) == 0 && (connect(m_net.fd, address->ai_addr, address->ai_addrlen) == 0
+          || (errno == EINPROGRESS && mbedtls_net_poll(&m_net, MBEDTLS_NET_POLL_WRITE, static_cast<uint32_t>(remaining_ms)) > 0))) {
+            int socket_error = 0;
+            socklen_t socket_error_length = sizeof(socket_error);
+            // Reads and writes rely on blocking with the configured timeouts again, the same as with a socket connected by mbedtls_net_connect()
+            if (getsockopt(m_net.fd, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_length) == 0 && socket_error == 0 && mbedtls_net_set_block(&m_net) == 0) {
+                break;
+            }
+        }
+        mbedtls_net_free(&m_net);
+    }
+    freeaddrinfo(addresses);
+    return m_net.fd >= 0;
+}
+
+int Espressif_TLS_Transport::Read(char * buffer, int const & length, int const & timeout_ms) {
+    if (!m_connected) {
+        return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+    int const poll = Poll(true, timeout_ms);
+    if (poll <= 0) {
+        return poll < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    // Socket is readable, but the rest of the record might still take a while, therefore the read is limited to the same timeout
+    mbedtls_ssl_conf_read_timeout(&m_ssl_config, timeout_ms);
+    int const result = mbedtls_ssl_read(&m_ssl, reinterpret_cast<unsigned char *>(buffer), length);
+    if (result > 0) {
+        return result;
+    }
+    else if (result == 0 || result == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+        return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    }
+    else if (result == MBEDTLS_ERR_SSL_TIMEOUT || result == MBEDTLS_ERR_SSL_WANT_READ || result == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+#if defined(MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET)
+    else if (result == MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET) {
+        // TLS 1.3 servers only send the ticket after the handshake, therefore the session kept by Connect() can not be resumed and is replaced with the one containing the ticket
+        Save_Session();
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+#endif // defined(MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET)
+    return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+}
+
+int Espressif_TLS_Transport::Write(char const * buffer, int const & length, int const & timeout_ms) {
+    if (!m_connected) {
+        return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+    int const poll = Poll(false, timeout_ms);
+    if (poll <= 0) {
+        return poll < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    // The ESP MQTT client expects the complete data to be written, whereas a single write is limited to the maximum size of one record
+    int written = 0;
+    while (written < length) {
+        int const result = mbedtls_ssl_write(&m_ssl, reinterpret_cast<unsigned char const *>(buffer + written), length - written);
+        if (result > 0) {
+            written += result;
+        }
+        else if (result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+        }
+    }
+    return written;
+}
+
+int Espressif_TLS_Transport::Poll(bool const & read, int const & timeout_ms) {
+    if (!m_connected) {
+        return -1;
+    }
+    else if (read && mbedtls_ssl_get_bytes_avail(&m_ssl) > 0U) {
+        return 1;
+    }
+    int const result = mbedtls_net_poll(&m_net, read ? MBEDTLS_NET_POLL_READ : MBEDTLS_NET_POLL_WRITE, timeout_ms < 0 ? 0U : static_cast<uint32_t>(timeout_ms));
+    if (result < 0) {
+        return -1;
+    }
+    return result > 0 ? 1 : 0;
+}
+
+int Espressif_TLS_Transport::Close() {
+    if (m_connected) {
+        (void)mbedtls_ssl_close_notify(&m_ssl);
+        m_connected = false;
+    }
+    mbedtls_ssl_free(&m_ssl);
+    mbedtls_ssl_init(&m_ssl);
+    mbedtls_net_free(&m_net);
+    mbedtls_net_init(&m_net);
+    return 0;
+}
+
+void Espressif_TLS_Transport::Save_Session() {
+    // Has to be an empty session, otherwise the previous one would leak
+    mbedtls_ssl_session_free(&m_session);
+    mbedtls_ssl_session_init(&m_session);
+    m_has_session = mbedtls_ssl_get_session(&m_ssl, &m_session) == 0;
+    if (!m_has_session || m_session_storage_size <= TLS_SESSION_STORAGE_HEADER_SIZE) {
+        return;
+    }
+    size_t length = 0U;
+    uint8_t * const data = m_session_storage + TLS_SESSION_STORAGE_HEADER_SIZE;
+    // Invalidated first, so a session that does not fit anymore does not leave the previous one behind, which the server would not resume anyway
+    (void)memset(m_session_storage, 0, TLS_SESSION_STORAGE_HEADER_SIZE);
+    if (mbedtls_ssl_session_save(&m_session, data, m_session_storage_size - TLS_SESSION_STORAGE_HEADER_SIZE, &length) != 0) {
+        return;
+    }
+    uint32_t const header[3U] = { TLS_SESSION_STORAGE_MAGIC, Helper::calculateCRC32(data, length), static_cast<uint32_t>(length) };
+    (void)memcpy(m_session_storage, header, sizeof(header));
+}
+
+bool Espressif_TLS_Transport::Load_Session() {
+    if (m_session_storage_size <= TLS_SESSION_STORAGE_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t header[3U] = {};
+    (void)memcpy(header, m_session_storage, sizeof(header));
+    uint8_t const * const data = m_session_storage + TLS_SESSION_STORAGE_HEADER_SIZE;
+    if (header[0U] != TLS_SESSION_STORAGE_MAGIC || header[2U] > m_session_storage_size - TLS_SESSION_STORAGE_HEADER_SIZE || header[1U] != Helper::calculateCRC32(data, header[2U])) {
+        return false;
+    }
+    mbedtls_ssl_session_free(&m_session);
+    mbedtls_ssl_session_init(&m_session);
+    // Fails as well if the session has been written by a different mbedtls version or configuration, for example after a firmware update
+    m_has_session = mbedtls_ssl_session_load(&m_session, data, header[2U]) == 0;
+    return m_has_session;
+}
+
+int Espressif_TLS_Transport::Static_Connect(esp_transport_handle_t transport, char const * host, int port, int timeout_ms) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Connect(host, port, timeout_ms) : -1;
+}
+
+int Espressif_TLS_Transport::Static_Read(esp_transport_handle_t transport, char * buffer, int length, int timeout_ms) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Read(buffer, length, timeout_ms) : ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+}
+
+int Espressif_TLS_Transport::Static_Write(esp_transport_handle_t transport, char const * buffer, int length, int timeout_ms) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Write(buffer, length, timeout_ms) : ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+}
+
+int Espressif_TLS_Transport::Static_Poll_Read(esp_transport_handle_t transport, int timeout_ms) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Poll(true, timeout_ms) : -1;
+}
+
+int Espressif_TLS_Transport::Static_Poll_Write(esp_transport_handle_t transport, int timeout_ms) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Poll(false, timeout_ms) : -1;
+}
+
+int Espressif_TLS_Transport::Static_Close(esp_transport_handle_t transport) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    return instance != nullptr ? instance->Close() : 0;
+}
+
+int Espressif_TLS_Transport::Static_Destroy(esp_transport_handle_t transport) {
+    auto instance = static_cast<Espressif_TLS_Transport *>(esp_transport_get_context_data(transport));
+    if (instance == nullptr) {
+        return 0;
+    }
+    // Handle itself is released by the caller, afterwards a new one is created if the transport is used again
+    (void)instance->Close();
+    instance->m_handle = nullptr;
+    return 0;
+}
+
+#endif // THINGSBOARD_USE_ESP_MQTT && ESP_IDF_VERSION_MAJOR >= 5
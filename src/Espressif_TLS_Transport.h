@@ -0,0 +1,182 @@
+#ifndef Espressif_TLS_Transport_h
+#define Espressif_TLS_Transport_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_ESP_MQTT
+
+// Library include.
+#include <esp_idf_version.h>
+
+// Custom transports can only be passed to the ESP MQTT client since Espressif IDF v5.X
+#if ESP_IDF_VERSION_MAJOR >= 5
+
+// Library includes.
+#include <esp_err.h>
+#include <esp_transport.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+// Identifies a session written by this class into the storage passed to Set_Session_Storage(), so uninitalized memory after a cold boot is not loaded as a session
+constexpr uint32_t TLS_SESSION_STORAGE_MAGIC = 0x544C5353U;
+// Size of the header in front of the serialized session in the session storage, consisting of the magic value, the CRC32 of the session and its length
+constexpr size_t TLS_SESSION_STORAGE_HEADER_SIZE = 3U * sizeof(uint32_t);
+
+
+/// @brief TLS transport for the ESP MQTT client, that keeps the session of the last established connection and offers it to the server on the next connection,
+/// so the server can resume it with an abbreviated handshake using either the session id or a session ticket. The abbreviated handshake skips the certificate chain and the key exchange,
+/// which on an ESP32 saves 1 to 3 seconds of CPU time and several kilobytes of traffic on every reconnect. The session is kept in memory for as long as this instance exists
+/// and can additionally be written into memory that survives deep sleep, for example a buffer placed into RTC memory with RTC_NOINIT_ATTR, so even the first connection after waking up is resumed.
+/// If the server does not know the offered session anymore, it simply performs the full handshake instead. The server certificate is verified the same way as with the default transport of the ESP MQTT client,
+/// either against the given root certificate or the x509 certificate bundle. Each handshake is timed, which allows to compare the duration of full and resumed handshakes.
+/// The esp_transport_handle_t is destroyed by the ESP MQTT client it has been passed to, the instance of this class has to stay valid until then, otherwise it is destroyed together with this instance
+class Espressif_TLS_Transport {
+  public:
+    /// @brief Constructs the transport, the TLS configuration is created once the first connection is established
+    Espressif_TLS_Transport();
+
+    /// @brief Destructor, closes the connection and releases the TLS configuration and the kept session
+    ~Espressif_TLS_Transport();
+
+    Espressif_TLS_Transport(Espressif_TLS_Transport const &) = delete;
+
+    Espressif_TLS_Transport & operator=(Espressif_TLS_Transport const &) = delete;
+
+    /// @brief Sets how the certificate of the server is verified, only applied if it is set before the first connection is established
+    /// @param server_certificate_pem Null-terminated string containg the root certificate in PEM format, has to stay valid until the first connection is established, nullptr to use the bundle instead
+    /// @param crt_bundle_attach Function that attaches the x509 certificate bundle to the TLS configuration, for example esp_crt_bundle_attach, nullptr to use the root certificate instead
+    void Set_Verification(char const * server_certificate_pem, esp_err_t (*crt_bundle_attach)(void * conf));
+
+    /// @brief Sets whether the session of the last connection is offered to the server when establishing the next connection.
+    /// Disabling it performs the full handshake on every connection, which allows to measure the duration of the full handshake for comparison
+    /// @param enable Whether the session of the last connection is resumed, default = true
+    void Set_Session_Resumption(bool const & enable);
+
+    /// @brief Sets the memory the session is additionally written into after every established connection, so it survives the instance being destroyed or the device being put into deep sleep.
+    /// The memory should therefore be placed into RTC memory, for example with RTC_NOINIT_ATTR, which keeps its content during deep sleep but not when power is lost.
+    /// A valid session already contained in the memory is loaded immediately. The session contains the secrets of the connection, meaning the memory should not be readable by other applications.
+    /// Requires enough memory for the serialized session, which depending on the server and MBEDTLS_SSL_KEEP_PEER_CERTIFICATE is between a few hundred bytes and a few kilobytes,
+    /// sessions that do not fit are only kept in memory
+    /// @param storage Memory the session is written into and loaded from, has to stay valid for as long as this instance exists, nullptr to keep the session only in memory
+    /// @param size Amount of bytes in the given memory
+    /// @return Whether a valid session has been loaded from the given memory
+    bool Set_Session_Storage(uint8_t * storage, size_t const & size);
+
+    /// @brief Forgets the kept session and invalidates the session storage, meaning the next connection performs the full handshake
+    void Clear_Session();
+
+    /// @brief Gets the transport handle, that has to be passed to the ESP MQTT client configuration, creates it on the first call
+    /// @return Transport handle or nullptr if it could not be created
+    esp_transport_handle_t Get_Handle();
+
+    /// @brief Whether a session is kept, which is offered to the server on the next connection
+    /// @return Whether a session is kept
+    bool Has_Session() const;
+
+    /// @brief Whether a session has been offered to the server during the last handshake. The server might still have performed the full handshake,
+    /// if it does not know the session anymore, which can be recognized by comparing the handshake time with the one of a full handshake
+    /// @return Whether a session has been offered during the last handshake
+    bool Was_Session_Offered() const;
+
+    /// @brief Gets the duration of the last successful handshake, measured from the start of the TLS handshake until it completed, excluding establishing the TCP connection
+    /// @return Duration in microseconds, 0 if no handshake has been completed yet
+    uint64_t Get_Handshake_Time() const;
+
+    /// @brief Gets the amount of successfully completed handshakes since this instance has been created
+    /// @return Amount of completed handshakes
+    size_t Get_Handshakes() const;
+
+  private:
+    /// @brief Creates the TLS configuration with the random number generator and the configured server certificate verification, only done once
+    /// @return Whether the configuration has been created successfully
+    bool Initialize();
+
+    /// @brief Establishes the TCP connection and performs the TLS handshake, offering the kept session if session resumption is enabled
+    /// @param host Hostname of the server, used for the server name indication and to verify the certificate
+    /// @param port Port of the server
+    /// @param timeout_ms Maximum time in milliseconds to wait for the TCP connection and for each message of the handshake
+    /// @return 0 if the connection has been established, -1 otherwise
+    int Connect(char const * host, int const & port, int const & timeout_ms);
+
+    /// @brief Resolves the server and establishes the TCP connection with the first resolved address that accepts it, within the given timeout
+    /// @param host Hostname of the server
+    /// @param port Port of the server
+    /// @param timeout_ms Maximum time in milliseconds to wait for all resolved addresses together
+    /// @return Whether the connection has been established
+    bool Open_Socket(char const * host, int const & port, int const & timeout_ms);
+
+    /// @brief Reads decrypted data from the connection
+    /// @param buffer Buffer the data is read into
+    /// @param length Size of the buffer
+    /// @param timeout_ms Maximum time in milliseconds to wait for data
+    /// @return Amount of bytes read, ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT if no data has been received in time or a negative error code
+    int Read(char * buffer, int const & length, int const & timeout_ms);
+
+    /// @brief Encrypts and writes all the given data to the connection
+    /// @param buffer Data that should be written
+    /// @param length Amount of bytes in the data
+    /// @param timeout_ms Maximum time in milliseconds to wait until data can be written
+    /// @return Amount of bytes written, ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT if no data could be written in time or a negative error code
+    int Write(char const * buffer, int const & length, int const & timeout_ms);
+
+    /// @brief Waits until the connection is readable or writeable, already decrypted data that has not been read yet counts as readable
+    /// @param read Whether to wait until the connection is readable or writeable
+    /// @param timeout_ms Maximum time in milliseconds to wait
+    /// @return 1 if the connection is ready, 0 if the timeout has passed or -1 if an error occured
+    int Poll(bool const & read, int const & timeout_ms);
+
+    /// @brief Closes the connection, the kept session stays valid
+    /// @return Always 0
+    int Close();
+
+    /// @brief Keeps the session of the established connection and writes it into the session storage
+    void Save_Session();
+
+    /// @brief Loads the session contained in the session storage, if it is valid
+    /// @return Whether a valid session has been loaded
+    bool Load_Session();
+
+    static int Static_Connect(esp_transport_handle_t transport, char const * host, int port, int timeout_ms);
+
+    static int Static_Read(esp_transport_handle_t transport, char * buffer, int length, int timeout_ms);
+
+    static int Static_Write(esp_transport_handle_t transport, char const * buffer, int length, int timeout_ms);
+
+    static int Static_Poll_Read(esp_transport_handle_t transport, int timeout_ms);
+
+    static int Static_Poll_Write(esp_transport_handle_t transport, int timeout_ms);
+
+    static int Static_Close(esp_transport_handle_t transport);
+
+    static int Static_Destroy(esp_transport_handle_t transport);
+
+    esp_transport_handle_t   m_handle = {};               // Transport handle passed to the ESP MQTT client, nullptr if it has not been created yet or has been destroyed by the client
+    char const *             m_server_certificate = {};   // Root certificate in PEM format the server certificate is verified against
+    esp_err_t                (*m_crt_bundle_attach)(void * conf) = {}; // Function attaching the x509 certificate bundle the server certificate is verified against
+    bool                     m_initialized = {};          // Whether the TLS configuration has been created
+    bool                     m_connected = {};            // Whether a connection is currently established
+    bool                     m_session_resumption = {};   // Whether the kept session is offered to the server
+    bool                     m_has_session = {};          // Whether a session is kept
+    bool                     m_session_offered = {};      // Whether the kept session has been offered during the last handshake
+    uint8_t *                m_session_storage = {};      // Memory the session is additionally written into, for example in RTC memory
+    size_t                   m_session_storage_size = {}; // Amount of bytes in the session storage
+    uint64_t                 m_handshake_time = {};       // Duration of the last successful handshake in microseconds
+    size_t                   m_handshakes = {};           // Amount of successfully completed handshakes
+    mbedtls_entropy_context  m_entropy = {};              // Entropy source of the random number generator
+    mbedtls_ctr_drbg_context m_ctr_drbg = {};             // Random number generator used by the TLS configuration
+    mbedtls_x509_crt         m_certificate = {};          // Parsed root certificate
+    mbedtls_ssl_config       m_ssl_config = {};           // TLS configuration shared by all connections
+    mbedtls_ssl_context      m_ssl = {};                  // TLS context of the current connection
+    mbedtls_net_context      m_net = {};                  // Socket of the current connection
+    mbedtls_ssl_session      m_session = {};              // Session of the last established connection
+};
+
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+
+#endif // THINGSBOARD_USE_ESP_MQTT
+
+#endif // Espressif_TLS_Transport_h
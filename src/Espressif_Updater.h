@@ -11,19 +11,36 @@
 
 // Library include.
 #include <esp_ota_ops.h>
+#if !defined(ESP8266) && ((ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 4) || ESP_IDF_VERSION_MAJOR > 5)
+#include <spi_flash_mmap.h>
+#endif // !defined(ESP8266) && ((ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 4) || ESP_IDF_VERSION_MAJOR > 5)
 
 constexpr char INVALID_OTA_PARTIION[] = "The running partition and the parition we wanted to boot into were not the same meaning the previous update failed and choose the fallback partition instead";
 constexpr char MISSING_OTA_APP[] = "Missing second ota app or app was invalid";
 constexpr char BEGIN_UPDATE_FAILED[] = "Beginning update failed with error reason (%s)";
+constexpr char RESUME_OFFSET_UNALIGNED[] = "Resuming update at offset (%u) is not possible, because it is not a multiple of the flash sector size (%u)";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char SEQUENTIAL_ERASE_UNSUPPORTED[] = "Erasing sequentially is not supported by the used ESP-IDF version, erasing the complete firmware size at the start of the update instead";
+#endif // THINGSBOARD_ENABLE_DEBUG
 
 
 /// @brief IUpdater implementation that uses the Over the Air Update API from Espressif (https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/system/ota.html)
-/// under the hood to write the given binary firmware data into flash memory so we can restart with newly received firmware
+/// under the hood to write the given binary firmware data into flash memory so we can restart with newly received firmware.
+/// By default the sectors are erased sequentially while the firmware binary is written, each sector right before the first write into it, instead of erasing every sector the firmware binary will occupy
+/// at the start of the update. Erasing a complete firmware binary takes multiple seconds, which would block the task that received the first chunk and might cause the following chunk requests to time out,
+/// whereas erasing sequentially spreads the same erase time evenly over the whole download
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
 template <typename Logger = DefaultLogger>
 class Espressif_Updater : public IUpdater {
   public:
-    Espressif_Updater() = default;
+    /// @brief Constructor
+    /// @param erase_sequentially Whether each sector is erased right before the first write into it, instead of erasing the complete firmware size when the update is started.
+    /// Requires an ESP-IDF version that supports OTA_WITH_SEQUENTIAL_WRITES, older versions always erase the complete firmware size at the start of the update, default = true
+    Espressif_Updater(bool const & erase_sequentially = true)
+      : m_erase_sequentially(erase_sequentially)
+    {
+        // Nothing to do
+    }
 
     bool begin(size_t const & firmware_size) override {
         esp_partition_t const * running = esp_ota_get_running_partition();
@@ -45,7 +62,7 @@ class Espressif_Updater : public IUpdater {
         // allowing us to only include the esp_ota_ops header in the defintion (.cpp) file,
         // instead of also needing to declare it in the declaration (.h) header file
         esp_ota_handle_t ota_handle;
-        esp_err_t const error = esp_ota_begin(update_partition, firmware_size, &ota_handle);
+        esp_err_t const error = esp_ota_begin(update_partition, Get_Erase_Size(firmware_size), &ota_handle);
 
         if (error != ESP_OK) {
             Logger::printfln(BEGIN_UPDATE_FAILED, esp_err_to_name(error));
@@ -57,6 +74,54 @@ class Espressif_Updater : public IUpdater {
         return true;
     }
 
+#if !defined(ESP8266) && ((ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 4) || ESP_IDF_VERSION_MAJOR > 5)
+    bool resume(size_t const & firmware_size, size_t const & offset) override {
+        // Update that is rewound is still open, its handle has to be released first, because the partition can not be written by two handles at once
+        if (m_ota_handle != 0U) {
+            (void)esp_ota_abort(m_ota_handle);
+            m_ota_handle = 0U;
+        }
+
+        // Flash memory can only be erased in complete sectors, therefore bytes written after an offset in the middle of a sector could not be discarded without erasing the kept bytes at its start
+        if ((offset % SPI_FLASH_SEC_SIZE) != 0U) {
+            Logger::printfln(RESUME_OFFSET_UNALIGNED, offset, SPI_FLASH_SEC_SIZE);
+            return false;
+        }
+
+        esp_partition_t const * running = esp_ota_get_running_partition();
+        esp_partition_t const * configured = esp_ota_get_boot_partition();
+
+        if (configured != running) {
+            Logger::printfln(INVALID_OTA_PARTIION);
+            return false;
+        }
+
+        esp_partition_t const * update_partition = esp_ota_get_next_update_partition(nullptr);
+
+        if (update_partition == nullptr) {
+            Logger::printfln(MISSING_OTA_APP);
+            return false;
+        }
+
+        // Only the sectors following the already written bytes are erased, the bytes up to the offset are kept unchanged
+        esp_ota_handle_t ota_handle;
+        esp_err_t const error = esp_ota_resume(update_partition, Get_Erase_Size(firmware_size), offset, &ota_handle);
+
+        if (error != ESP_OK) {
+            Logger::printfln(BEGIN_UPDATE_FAILED, esp_err_to_name(error));
+            return false;
+        }
+
+        m_ota_handle = ota_handle;
+        m_update_partition = update_partition;
+        return true;
+    }
+
+    size_t get_resume_alignment() const override {
+        return SPI_FLASH_SEC_SIZE;
+    }
+#endif // !defined(ESP8266) && ((ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 4) || ESP_IDF_VERSION_MAJOR > 5)
+
     size_t write(uint8_t * payload, size_t const & total_bytes) override {
         esp_err_t const error = esp_ota_write(m_ota_handle, payload, total_bytes);
         size_t const written_bytes = (error == ESP_OK) ? total_bytes : 0U;
@@ -82,8 +147,25 @@ class Espressif_Updater : public IUpdater {
     }
 
   private:
-    uint32_t               m_ota_handle = {};       // ESP OTA hanle that is used to to access the underlying updater
-    esp_partition_t const *m_update_partition = {}; // Non active OTA partition that we write our data into
+    /// @brief Gets the size that has to be passed to the Espressif OTA API, which decides how much is erased when the update is started or resumed
+    /// @param firmware_size Total size of the firmware binary
+    /// @return Special sequential write size if sectors should be erased sequentially and that is supported, otherwise the firmware size itself
+    size_t Get_Erase_Size(size_t const & firmware_size) const {
+#ifdef OTA_WITH_SEQUENTIAL_WRITES
+        if (m_erase_sequentially) {
+            return OTA_WITH_SEQUENTIAL_WRITES;
+        }
+#elif THINGSBOARD_ENABLE_DEBUG
+        if (m_erase_sequentially) {
+            Logger::printfln(SEQUENTIAL_ERASE_UNSUPPORTED);
+        }
+#endif // OTA_WITH_SEQUENTIAL_WRITES
+        return firmware_size;
+    }
+
+    bool                   m_erase_sequentially = {}; // Whether each sector is erased right before the first write into it
+    uint32_t               m_ota_handle = {};         // ESP OTA hanle that is used to to access the underlying updater
+    esp_partition_t const *m_update_partition = {};   // Non active OTA partition that we write our data into
 };
 
 #endif // THINGSBOARD_USE_ESP_PARTITION
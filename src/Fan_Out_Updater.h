@@ -0,0 +1,315 @@
+#ifndef Fan_Out_Updater_h
+#define Fan_Out_Updater_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "Callback.h"
+#include "Constants.h"
+#include "Helper.h"
+#include "IUpdater.h"
+#include "OTA_Firmware_State.h"
+#include "OTA_Write_Pipeline.h"
+
+
+// Log messages.
+#if !THINGSBOARD_ENABLE_DYNAMIC
+char constexpr MAX_FAN_OUT_SINKS_EXCEEDED[] = "Too many fan out sinks, increase (MaxSinks) (%u)";
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+char constexpr FAN_OUT_SINKS_CHANGED_DURING_UPDATE[] = "Fan out sinks can not be changed while an update is in progress";
+char constexpr FAN_OUT_SINK_BEGIN_FAILED[] = "Beginning the update of the fan out sink failed";
+char constexpr FAN_OUT_SINK_WRITE_FAILED[] = "Writing the firmware into the fan out sink failed";
+char constexpr FAN_OUT_SINK_WRITE_TOO_SLOW[] = "Writing the firmware into the fan out sink took longer than the write timeout";
+#if THINGSBOARD_ENABLE_STL
+char constexpr FAN_OUT_SINK_QUEUE_START_FAILED[] = "Starting the write queue of the fan out sink (%s) failed, writing it directly instead";
+#endif // THINGSBOARD_ENABLE_STL
+char constexpr FAN_OUT_SINK_END_FAILED[] = "Ending the update of the fan out sink failed";
+char constexpr FAN_OUT_SINK_FAILED[] = "Fan out sink (%s) failed: %s";
+char constexpr FAN_OUT_ALL_SINKS_FAILED[] = "Every fan out sink failed, aborting the update";
+
+
+/// @brief IUpdater implementation that writes a single firmware stream into multiple registered sinks, where each sink is the IUpdater of a separate child device.
+/// Allows a gateway to download the firmware of multiple identical child devices only once, by passing this updater to the OTA_Update_Callback of the gateway itself,
+/// instead of every child device downloading the same firmware title and version separately.
+/// Every received chunk is written into every sink after it has been accepted by the OTA_Handler, which verifies the checksum over the complete firmware as usual once all chunks have been written.
+/// Failures are tracked per sink, a sink that fails to begin, write or end the update or that takes longer than the configured write timeout for a single chunk is excluded from the remaining update,
+/// without affecting any of the other sinks. The update as a whole only fails if every sink has failed, in that case it is restarted the same as if a single updater failed.
+/// Resetting the update, because it is restarted or the checksum did not match, resets every sink and includes the previously failed sinks again once the update is restarted.
+/// The firmware state of every child device is reported separately with the given callback, which receives the name of the child device the sink was added with,
+/// so it can be published for example with the gateway telemetry API (https://thingsboard.io/docs/reference/gateway-mqtt-api/#telemetry-upload-api).
+/// Sinks are written one after another in the context that writes the firmware by default, therefore a slow sink still delays the others until it exceeds the write timeout
+/// and a sink whose write never returns blocks the whole update. Configuring a sink queue instead writes every sink with its own OTA_Write_Pipeline, so each sink can fall behind
+/// by the configured amount of chunks and only a sink that does not accept the next chunk before the write timeout expired is excluded, while the others continue independently.
+/// The payload is passed to every sink, therefore sinks are not allowed to modify it.
+/// Resuming an interrupted update is not supported, because the sinks might have failed at different offsets
+#if THINGSBOARD_ENABLE_DYNAMIC
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+#else
+/// @tparam MaxSinks Maximum amount of sinks that can be added, allows to allocate the sinks on the stack instead of the heap, default = Default_Fan_Out_Sinks_Amount (8)
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <size_t MaxSinks = Default_Fan_Out_Sinks_Amount, typename Logger = DefaultLogger>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+class Fan_Out_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param send_fw_state_callback Callback that is called with the name of the child device, the firmware state and an optional error message
+    /// every time the firmware state of a sink changes, should publish the firmware state for the given child device, default = nullptr
+    Fan_Out_Updater(Callback<bool, char const *, char const *, char const *>::function send_fw_state_callback = nullptr)
+      : m_send_fw_state_callback(send_fw_state_callback)
+      , m_write_timeout()
+      , m_queue_depth()
+      , m_queue_slot_size()
+      , m_updating()
+      , m_sinks()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Copying is not allowed, because the write queues of the sinks are owned by this instance
+    Fan_Out_Updater(Fan_Out_Updater const &) = delete;
+
+    /// @brief Copying is not allowed, because the write queues of the sinks are owned by this instance
+    Fan_Out_Updater & operator=(Fan_Out_Updater const &) = delete;
+
+    /// @brief Destructor, stops the write queues of all sinks
+    ~Fan_Out_Updater() {
+        for (Sink & sink : m_sinks) {
+            Stop_Sink_Queue(sink);
+        }
+    }
+
+    /// @brief Sets the callback that is called every time the firmware state of a sink changes
+    /// @param send_fw_state_callback Callback that is called with the name of the child device, the firmware state and an optional error message
+    void Set_Send_FW_State_Callback(Callback<bool, char const *, char const *, char const *>::function send_fw_state_callback) {
+        m_send_fw_state_callback.Set_Callback(send_fw_state_callback);
+    }
+
+    /// @brief Sets the maximum time writing a single chunk into a sink may take, before the sink is excluded from the remaining update.
+    /// If a sink queue is configured, it is instead the maximum time a sink may take to accept the next chunk into its full queue and to write its remaining queue when the update ends
+    /// @param write_timeout_microseconds Maximum time in microseconds a single write may take, 0 disables the timeout, default = 0
+    void Set_Write_Timeout(uint64_t const & write_timeout_microseconds) {
+        m_write_timeout = write_timeout_microseconds;
+    }
+
+    /// @brief Sets the write queue every sink is written with in its own task, so a slow or hung sink does not delay the other sinks. Only takes effect for the next update
+    /// and only if THINGSBOARD_ENABLE_STL is set and the OTA_Write_Pipeline is supported on the current platform, otherwise sinks are still written directly.
+    /// A sink whose write never returns is excluded once the write timeout expires, but resetting the update or destroying this instance still waits for that write to return
+    /// @param depth Amount of chunks every sink can fall behind, 0 writes the sinks directly, default = 0
+    /// @param slot_size Size in bytes of every queued chunk, has to be atleast the chunk size of the firmware update
+    void Set_Sink_Queue(size_t const & depth, size_t const & slot_size) {
+        m_queue_depth = depth;
+        m_queue_slot_size = slot_size;
+    }
+
+    /// @brief Adds a sink the firmware is written into, can not be called while an update is in progress
+    /// @param device_name Name of the child device the sink belongs to, passed to the firmware state callback, has to stay valid for the lifetime of this instance
+    /// @param updater Updater of the child device, has to stay valid for the lifetime of this instance
+    /// @return Whether the sink was added, fails if an update is in progress or the maximum amount of sinks has been reached
+    bool Add_Sink(char const * device_name, IUpdater & updater) {
+        if (m_updating) {
+            Logger::printfln(FAN_OUT_SINKS_CHANGED_DURING_UPDATE);
+            return false;
+        }
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_sinks.size() + 1U > m_sinks.capacity()) {
+            Logger::printfln(MAX_FAN_OUT_SINKS_EXCEEDED, MaxSinks);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        Sink sink;
+        sink.device_name = device_name;
+        sink.updater = &updater;
+        m_sinks.push_back(sink);
+        return true;
+    }
+
+    /// @brief Removes all sinks, can not be called while an update is in progress
+    /// @return Whether the sinks were removed, fails if an update is in progress
+    bool Clear_Sinks() {
+        if (m_updating) {
+            Logger::printfln(FAN_OUT_SINKS_CHANGED_DURING_UPDATE);
+            return false;
+        }
+        m_sinks.clear();
+        return true;
+    }
+
+    /// @brief Gets the amount of added sinks
+    /// @return Amount of added sinks
+    size_t Get_Sink_Count() const {
+        return m_sinks.size();
+    }
+
+    /// @brief Gets the amount of sinks that failed during the current or last update, can be used to restart the update for only those child devices afterwards
+    /// @return Amount of failed sinks
+    size_t Get_Failed_Sink_Count() const {
+        size_t failed_sinks = 0U;
+        for (Sink const & sink : m_sinks) {
+            if (sink.failed) {
+                failed_sinks++;
+            }
+        }
+        return failed_sinks;
+    }
+
+    /// @brief Whether the sink at the given index failed during the current or last update
+    /// @param index Index of the sink, in the order the sinks were added
+    /// @return Whether the sink failed, false if the index is invalid
+    bool Is_Sink_Failed(size_t const & index) const {
+        return index < m_sinks.size() && m_sinks[index].failed;
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        m_updating = true;
+        for (Sink & sink : m_sinks) {
+            sink.failed = false;
+            sink.started = sink.updater->begin(firmware_size);
+            if (!sink.started) {
+                Sink_Failed(sink, FAN_OUT_SINK_BEGIN_FAILED);
+                continue;
+            }
+            Start_Sink_Queue(sink);
+            (void)m_send_fw_state_callback.Call_Callback(sink.device_name, FW_STATE_DOWNLOADING, "");
+        }
+        return Has_Active_Sink();
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        for (Sink & sink : m_sinks) {
+            if (sink.failed) {
+                continue;
+            }
+            else if (sink.queue != nullptr) {
+                if (!sink.queue->Enqueue(sink.written_bytes, payload, total_bytes, m_write_timeout)) {
+                    Sink_Failed(sink, sink.queue->Has_Failed() || total_bytes > m_queue_slot_size ? FAN_OUT_SINK_WRITE_FAILED : FAN_OUT_SINK_WRITE_TOO_SLOW);
+                }
+                sink.written_bytes += total_bytes;
+                continue;
+            }
+            uint64_t const start_time = Helper::getTimeMicroseconds();
+            if (sink.updater->write(payload, total_bytes) != total_bytes) {
+                Sink_Failed(sink, FAN_OUT_SINK_WRITE_FAILED);
+            }
+            else if (m_write_timeout != 0U && (Helper::getTimeMicroseconds() - start_time) > m_write_timeout) {
+                Sink_Failed(sink, FAN_OUT_SINK_WRITE_TOO_SLOW);
+            }
+        }
+        return Has_Active_Sink() ? total_bytes : 0U;
+    }
+
+    void reset() override {
+        for (Sink & sink : m_sinks) {
+            // Queue has to be stopped first, because its task might still be writing into the sink
+            Stop_Sink_Queue(sink);
+            if (sink.started) {
+                sink.updater->reset();
+                sink.started = false;
+            }
+        }
+        m_updating = false;
+    }
+
+    bool end() override {
+        bool updated = false;
+        for (Sink & sink : m_sinks) {
+            if (sink.failed) {
+                continue;
+            }
+            else if (sink.queue != nullptr && !sink.queue->Flush(m_write_timeout)) {
+                Sink_Failed(sink, sink.queue->Has_Failed() ? FAN_OUT_SINK_WRITE_FAILED : FAN_OUT_SINK_WRITE_TOO_SLOW);
+                continue;
+            }
+            (void)m_send_fw_state_callback.Call_Callback(sink.device_name, FW_STATE_DOWNLOADED, "");
+            (void)m_send_fw_state_callback.Call_Callback(sink.device_name, FW_STATE_UPDATING, "");
+            if (!sink.updater->end()) {
+                Sink_Failed(sink, FAN_OUT_SINK_END_FAILED);
+                continue;
+            }
+            sink.started = false;
+            updated = true;
+            (void)m_send_fw_state_callback.Call_Callback(sink.device_name, FW_STATE_UPDATED, "");
+        }
+        if (updated) {
+            // Sinks that failed while ending are reset, but every other sink has already completed the update, therefore the update is not reset as a whole
+            reset();
+        }
+        return updated;
+    }
+
+  private:
+    /// @brief Child device the firmware is written into
+    struct Sink {
+        char const *         device_name = {};   // Name of the child device, passed to the firmware state callback
+        IUpdater *           updater = {};       // Updater of the child device
+        bool                 started = {};       // Whether the update of the sink has been begun and not ended or reset yet
+        bool                 failed = {};        // Whether the sink failed and is excluded from the remaining update
+        OTA_Write_Pipeline * queue = {};         // Queue the sink is written with in its own task, nullptr if the sink is written directly
+        size_t               written_bytes = {}; // Amount of bytes added to the queue of the sink
+    };
+
+    /// @brief Starts the write queue of the given sink, if a sink queue is configured. If starting fails the sink is simply written directly instead
+    /// @param sink Sink that has begun the update
+    void Start_Sink_Queue(Sink & sink) {
+        sink.written_bytes = 0U;
+#if THINGSBOARD_ENABLE_STL
+        if (m_queue_depth == 0U) {
+            return;
+        }
+        sink.queue = new OTA_Write_Pipeline();
+        IUpdater * updater = sink.updater;
+        if (!sink.queue->Start(m_queue_depth, m_queue_slot_size, WRITE_PIPELINE_NO_AFFINITY, [updater](size_t const & /*offset*/, uint8_t * payload, size_t const & total_bytes) {
+            return updater->write(payload, total_bytes) == total_bytes;
+        })) {
+            Logger::printfln(FAN_OUT_SINK_QUEUE_START_FAILED, sink.device_name);
+            Stop_Sink_Queue(sink);
+        }
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Discards the chunks still queued for the given sink and stops its write queue, waits for the chunk that is currently being written into the sink
+    /// @param sink Sink whose queue should be stopped
+    void Stop_Sink_Queue(Sink & sink) {
+        if (sink.queue == nullptr) {
+            return;
+        }
+        sink.queue->Stop();
+        delete sink.queue;
+        sink.queue = nullptr;
+    }
+
+    /// @brief Excludes the given sink from the remaining update and reports its failure
+    /// @param sink Sink that failed
+    /// @param error Message describing the failure
+    void Sink_Failed(Sink & sink, char const * error) {
+        sink.failed = true;
+        Logger::printfln(FAN_OUT_SINK_FAILED, sink.device_name, error);
+        (void)m_send_fw_state_callback.Call_Callback(sink.device_name, FW_STATE_FAILED, error);
+    }
+
+    /// @brief Whether atleast one sink has not failed yet
+    /// @return Whether the update can be continued
+    bool Has_Active_Sink() const {
+        for (Sink const & sink : m_sinks) {
+            if (!sink.failed) {
+                return true;
+            }
+        }
+        Logger::printfln(FAN_OUT_ALL_SINKS_FAILED);
+        return false;
+    }
+
+    Callback<bool, char const *, char const *, char const *> m_send_fw_state_callback = {}; // Callback that publishes the firmware state of a child device
+    uint64_t                                               m_write_timeout = {};          // Maximum time in microseconds a single write into a sink may take, 0 if disabled
+    size_t                                                 m_queue_depth = {};            // Amount of chunks every sink can fall behind in its write queue, 0 if sinks are written directly
+    size_t                                                 m_queue_slot_size = {};        // Size in bytes of every chunk in the write queue of a sink
+    bool                                                   m_updating = {};               // Whether an update is in progress and the sinks can not be changed
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Sink>                                           m_sinks = {};                  // Sinks the firmware is written into
+#else
+    Array<Sink, MaxSinks>                                  m_sinks = {};                  // Sinks the firmware is written into
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Fan_Out_Updater_h
@@ -0,0 +1,87 @@
+#ifndef File_Checkpoint_Store_h
+#define File_Checkpoint_Store_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IOTA_Checkpoint_Store.h"
+#include "OTA_Checkpoint.h"
+
+// Library include.
+#include <stdio.h>
+#include <string.h>
+
+char constexpr CHECKPOINT_FILE_SUFFIX[] = ".tmp";
+char constexpr WRITE_CHECKPOINT_FAILED[] = "Failed to write checkpoint file (%s)";
+
+
+/// @brief IOTA_Checkpoint_Store implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/),
+/// under the hood to persist the checkpoint into a file. Can be used on Linux or with any file system mounted into the virtual file system of Espressif IDF, like an SD card or SPIFFS.
+/// The checkpoint is first written into a temporary file, which then replaces the previous checkpoint file, so a reboot while saving never leaves a partially written checkpoint
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Checkpoint_Store : public IOTA_Checkpoint_Store {
+  public:
+    /// @brief Constructor
+    /// @param file_path Path to the file the checkpoint is persisted in, the same path with the .tmp suffix is used as the temporary file
+    File_Checkpoint_Store(char const * file_path)
+      : m_path(file_path)
+    {
+        // Nothing to do
+    }
+
+    bool load(OTA_Checkpoint & checkpoint) override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        size_t const read_bytes = fread(&checkpoint, 1, sizeof(checkpoint), file);
+        fclose(file);
+        return read_bytes == sizeof(checkpoint) && checkpoint.magic == OTA_CHECKPOINT_MAGIC;
+    }
+
+    bool save(OTA_Checkpoint const & checkpoint) override {
+        char temporary_path[strlen(m_path) + sizeof(CHECKPOINT_FILE_SUFFIX)] = {};
+        (void)snprintf(temporary_path, sizeof(temporary_path), "%s%s", m_path, CHECKPOINT_FILE_SUFFIX);
+
+        FILE* file = fopen(temporary_path, "wb");
+        if (file == nullptr) {
+            Logger::printfln(WRITE_CHECKPOINT_FAILED, m_path);
+            return false;
+        }
+        bool const written = fwrite(&checkpoint, 1, sizeof(checkpoint), file) == sizeof(checkpoint);
+        // Closing flushes the buffered data, which might fail as well if the file system is full
+        bool const closed = fclose(file) == 0;
+        if (!written || !closed) {
+            Logger::printfln(WRITE_CHECKPOINT_FAILED, m_path);
+            (void)remove(temporary_path);
+            return false;
+        }
+
+        // Replacing an existing file is atomic on POSIX file systems, but fails on FAT file systems,
+        // there the previous checkpoint has to be removed first, which is still safe because the temporary file is complete at this point
+        if (rename(temporary_path, m_path) != 0) {
+            (void)remove(m_path);
+            if (rename(temporary_path, m_path) != 0) {
+                Logger::printfln(WRITE_CHECKPOINT_FAILED, m_path);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool erase() override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            return true;
+        }
+        fclose(file);
+        return remove(m_path) == 0;
+    }
+
+  private:
+    char const * m_path = {}; // Path to the file the checkpoint is persisted in
+};
+
+#endif // File_Checkpoint_Store_h
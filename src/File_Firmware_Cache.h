@@ -0,0 +1,338 @@
+#ifndef File_Firmware_Cache_h
+#define File_Firmware_Cache_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IFirmware_Cache.h"
+
+// Library include.
+#include <stdio.h>
+#include <string.h>
+
+
+// Maximum size of the file names used inside of the cache directory, including the separating slash and the null terminator
+size_t constexpr FIRMWARE_CACHE_MAX_NAME_SIZE = 32U;
+// Amount of hex characters of the checksum used in the file name of an entry, keeps the name short enough for file systems like SPIFFS, the index still contains the complete checksum
+size_t constexpr FIRMWARE_CACHE_NAME_CHECKSUM_LENGTH = 16U;
+char constexpr FIRMWARE_CACHE_INDEX_FILE[] = "index.txt";
+char constexpr FIRMWARE_CACHE_TEMPORARY_INDEX_FILE[] = "index.tmp";
+char constexpr FIRMWARE_CACHE_PENDING_FILE[] = "pending.bin";
+char constexpr FIRMWARE_CACHE_ENTRY_FILE_FMT[] = "%d_%.16s.bin";
+char constexpr FIRMWARE_CACHE_INDEX_LINE_FMT[] = "%d %s %lu\n";
+
+char constexpr FIRMWARE_CACHE_ENTRY_TOO_BIG[] = "Firmware binary with (%u) bytes does not fit into the cache limited to (%u) bytes";
+char constexpr FIRMWARE_CACHE_OPEN_FAILED[] = "Failed to open file (%s) of the firmware cache, ensure the directory exists and the storage medium is initalized";
+char constexpr FIRMWARE_CACHE_WRITE_FAILED[] = "Failed to write the firmware cache entry, only (%u) of (%u) bytes were written";
+char constexpr FIRMWARE_CACHE_INDEX_FAILED[] = "Failed to update the index of the firmware cache";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr FIRMWARE_CACHE_ENTRY_EVICTED[] = "Evicted least recently used firmware cache entry (%s) with (%lu) bytes";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief IFirmware_Cache implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/) under the hood to store every cached firmware binary in a separate file,
+/// inside of the given directory. Can be used on Linux or with any file system mounted into the virtual file system of Espressif IDF, like an SD card or SPIFFS.
+/// An index file in the same directory contains one line per entry with the checksum algorithm, the complete checksum and the size of the firmware binary,
+/// ordered from the least to the most recently used entry. Entries are filled into a pending file that only replaces the entry file once the update verified the checksum,
+/// so a reboot while downloading never leaves a partially written entry behind. If the total size of all entries would exceed the configured limit,
+/// the least recently used entries are evicted until the new entry fits.
+/// The file name of an entry only contains the first FIRMWARE_CACHE_NAME_CHECKSUM_LENGTH characters of the checksum, the unlikely case of two binaries sharing that prefix is still safe,
+/// because the content read out of the cache is verified against the complete checksum and discarded if it does not match
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Firmware_Cache : public IFirmware_Cache {
+  public:
+    /// @brief Constructor
+    /// @param directory Path to the already existing directory the entries and the index are stored in, without a trailing slash, has to stay valid for the lifetime of this instance
+    /// @param max_size Maximum total size in bytes of all cached firmware binaries, should leave enough space on the storage medium for the pending entry of the next update
+    File_Firmware_Cache(char const * directory, size_t const & max_size)
+      : m_directory(directory)
+      , m_max_size(max_size)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, closes the opened entry and discards the entry that is currently filled
+    ~File_Firmware_Cache() {
+        close_entry();
+        abort_entry();
+    }
+
+    bool open_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm, size_t const & fw_size) override {
+        close_entry();
+        int const algorithm = static_cast<int>(fw_checksum_algorithm);
+        Index_Entry entry;
+        if (!Find_Entry(fw_checksum, algorithm, entry) || entry.size != fw_size) {
+            return false;
+        }
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Entry_Path(fw_checksum, algorithm, path, sizeof(path));
+        m_read_file = fopen(path, "rb");
+        if (m_read_file == nullptr) {
+            // The index references a file that does not exist anymore, for example because it was deleted manually
+            remove_entry(fw_checksum, fw_checksum_algorithm);
+            return false;
+        }
+        // Appending the entry again moves it to the end of the index, which marks it as the most recently used entry
+        if (!Rewrite_Index(fw_checksum, algorithm, &entry)) {
+            Logger::printfln(FIRMWARE_CACHE_INDEX_FAILED);
+        }
+        return true;
+    }
+
+    size_t read_entry(size_t const & offset, uint8_t * buffer, size_t const & total_bytes) override {
+        if (m_read_file == nullptr || fseek(m_read_file, static_cast<long>(offset), SEEK_SET) != 0) {
+            return 0U;
+        }
+        return fread(buffer, 1, total_bytes, m_read_file);
+    }
+
+    void close_entry() override {
+        if (m_read_file == nullptr) {
+            return;
+        }
+        fclose(m_read_file);
+        m_read_file = nullptr;
+    }
+
+    bool begin_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm, size_t const & fw_size) override {
+        abort_entry();
+        if (fw_size > m_max_size) {
+            Logger::printfln(FIRMWARE_CACHE_ENTRY_TOO_BIG, fw_size, m_max_size);
+            return false;
+        }
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_PENDING_FILE, path, sizeof(path));
+        m_fill_file = fopen(path, "wb");
+        if (m_fill_file == nullptr) {
+            Logger::printfln(FIRMWARE_CACHE_OPEN_FAILED, static_cast<char const *>(path));
+            return false;
+        }
+        m_fill_entry = Index_Entry();
+        m_fill_entry.algorithm = static_cast<int>(fw_checksum_algorithm);
+        (void)strncpy(m_fill_entry.checksum, fw_checksum, sizeof(m_fill_entry.checksum) - 1U);
+        m_fill_entry.size = fw_size;
+        m_fill_written_bytes = 0U;
+        return true;
+    }
+
+    bool write_entry(uint8_t const * payload, size_t const & total_bytes) override {
+        if (m_fill_file == nullptr) {
+            return false;
+        }
+        size_t const written_bytes = fwrite(payload, 1, total_bytes, m_fill_file);
+        m_fill_written_bytes += written_bytes;
+        if (written_bytes != total_bytes) {
+            Logger::printfln(FIRMWARE_CACHE_WRITE_FAILED, written_bytes, total_bytes);
+            return false;
+        }
+        return true;
+    }
+
+    bool end_entry() override {
+        if (m_fill_file == nullptr) {
+            return false;
+        }
+        // Closing flushes the buffered data, which might fail as well if the file system is full
+        bool const closed = fclose(m_fill_file) == 0;
+        m_fill_file = nullptr;
+        char pending_path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_PENDING_FILE, pending_path, sizeof(pending_path));
+        if (!closed || m_fill_written_bytes != m_fill_entry.size) {
+            Logger::printfln(FIRMWARE_CACHE_WRITE_FAILED, m_fill_written_bytes, m_fill_entry.size);
+            (void)remove(pending_path);
+            return false;
+        }
+
+        // Evicting first ensures the space of the least recently used entries is freed, before the new entry is counted against the limit
+        if (!Rewrite_Index(m_fill_entry.checksum, m_fill_entry.algorithm, &m_fill_entry)) {
+            Logger::printfln(FIRMWARE_CACHE_INDEX_FAILED);
+            (void)remove(pending_path);
+            return false;
+        }
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Entry_Path(m_fill_entry.checksum, m_fill_entry.algorithm, path, sizeof(path));
+        // Replacing an existing file fails on FAT file systems, there an outdated entry file with the same name has to be removed first
+        if (rename(pending_path, path) != 0) {
+            (void)remove(path);
+            if (rename(pending_path, path) != 0) {
+                Logger::printfln(FIRMWARE_CACHE_OPEN_FAILED, static_cast<char const *>(path));
+                (void)remove(pending_path);
+                remove_entry(m_fill_entry.checksum, static_cast<Checksum_Algorithm>(m_fill_entry.algorithm));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void abort_entry() override {
+        if (m_fill_file == nullptr) {
+            return;
+        }
+        fclose(m_fill_file);
+        m_fill_file = nullptr;
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_PENDING_FILE, path, sizeof(path));
+        (void)remove(path);
+    }
+
+    void remove_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm) override {
+        int const algorithm = static_cast<int>(fw_checksum_algorithm);
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Entry_Path(fw_checksum, algorithm, path, sizeof(path));
+        (void)remove(path);
+        if (!Rewrite_Index(fw_checksum, algorithm, nullptr)) {
+            Logger::printfln(FIRMWARE_CACHE_INDEX_FAILED);
+        }
+    }
+
+  private:
+    /// @brief Single line of the index file, describing one cached firmware binary
+    struct Index_Entry {
+        int           algorithm = {};                   // Checksum_Algorithm the checksum was calculated with
+        char          checksum[FIRMWARE_HASH_SIZE] = {}; // Complete checksum of the cached firmware binary
+        unsigned long size = {};                         // Size in bytes of the cached firmware binary
+    };
+
+    /// @brief Copies the path of the file with the given name inside of the cache directory into the given buffer
+    /// @param name Name of the file inside of the cache directory
+    /// @param path Buffer the path is copied into
+    /// @param path_size Size of the given buffer
+    void Get_Path(char const * name, char * path, size_t const & path_size) const {
+        (void)snprintf(path, path_size, "%s/%s", m_directory, name);
+    }
+
+    /// @brief Copies the path of the file of the entry with the given checksum into the given buffer
+    /// @param fw_checksum Checksum of the firmware binary the entry contains
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @param path Buffer the path is copied into
+    /// @param path_size Size of the given buffer
+    void Get_Entry_Path(char const * fw_checksum, int const & fw_checksum_algorithm, char * path, size_t const & path_size) const {
+        char name[FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        (void)snprintf(name, sizeof(name), FIRMWARE_CACHE_ENTRY_FILE_FMT, fw_checksum_algorithm, fw_checksum);
+        Get_Path(name, path, path_size);
+    }
+
+    /// @brief Reads the next line of the given index file
+    /// @param file Opened index file
+    /// @param entry Entry the content of the line is copied into
+    /// @return Whether a complete line was read or the end of the file has been reached
+    static bool Read_Index_Entry(FILE * file, Index_Entry & entry) {
+        // Width of the checksum field has to be limited to the size of the buffer, which depends on the largest supported hash of the mbedtls configuration
+        char format[16] = {};
+        (void)snprintf(format, sizeof(format), "%%d %%%us %%lu", static_cast<unsigned int>(FIRMWARE_HASH_SIZE - 1U));
+        return fscanf(file, format, &entry.algorithm, entry.checksum, &entry.size) == 3;
+    }
+
+    /// @brief Whether the given entry contains the firmware binary with the given checksum
+    /// @param entry Entry read out of the index
+    /// @param fw_checksum Checksum of the firmware binary
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @return Whether the entry matches
+    static bool Is_Same_Entry(Index_Entry const & entry, char const * fw_checksum, int const & fw_checksum_algorithm) {
+        return entry.algorithm == fw_checksum_algorithm && strncmp(entry.checksum, fw_checksum, sizeof(entry.checksum)) == 0;
+    }
+
+    /// @brief Searches the index for the entry with the given checksum
+    /// @param fw_checksum Checksum of the firmware binary
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @param entry Entry the found line of the index is copied into
+    /// @return Whether the entry exists in the index or not
+    bool Find_Entry(char const * fw_checksum, int const & fw_checksum_algorithm, Index_Entry & entry) const {
+        char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_INDEX_FILE, path, sizeof(path));
+        FILE * file = fopen(path, "r");
+        if (file == nullptr) {
+            return false;
+        }
+        bool found = false;
+        while (!found && Read_Index_Entry(file, entry)) {
+            found = Is_Same_Entry(entry, fw_checksum, fw_checksum_algorithm);
+        }
+        fclose(file);
+        return found;
+    }
+
+    /// @brief Rewrites the index without the entry with the given checksum, optionally appending the given entry as the most recently used entry afterwards.
+    /// If the appended entry would exceed the size limit, the least recently used entries are evicted and their files removed until it fits.
+    /// The index is written into a temporary file first, which then replaces the previous index, so a reboot while rewriting never leaves a partially written index
+    /// @param fw_checksum Checksum of the firmware binary that should be removed from its current position in the index
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @param appended Entry that should be appended at the end of the index, nullptr if the entry should only be removed
+    /// @return Whether rewriting the index was successful or not
+    bool Rewrite_Index(char const * fw_checksum, int const & fw_checksum_algorithm, Index_Entry const * appended) {
+        char index_path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_INDEX_FILE, index_path, sizeof(index_path));
+        char temporary_path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+        Get_Path(FIRMWARE_CACHE_TEMPORARY_INDEX_FILE, temporary_path, sizeof(temporary_path));
+
+        // First pass calculates the size of all remaining entries, to know how many of the least recently used entries have to be evicted
+        Index_Entry entry;
+        size_t total_size = 0U;
+        FILE * index = fopen(index_path, "r");
+        if (index != nullptr) {
+            while (Read_Index_Entry(index, entry)) {
+                if (!Is_Same_Entry(entry, fw_checksum, fw_checksum_algorithm)) {
+                    total_size += entry.size;
+                }
+            }
+            rewind(index);
+        }
+        size_t const required_size = appended != nullptr ? appended->size : 0U;
+
+        FILE * temporary = fopen(temporary_path, "w");
+        if (temporary == nullptr) {
+            if (index != nullptr) {
+                fclose(index);
+            }
+            Logger::printfln(FIRMWARE_CACHE_OPEN_FAILED, static_cast<char const *>(temporary_path));
+            return false;
+        }
+        bool written = true;
+        while (index != nullptr && Read_Index_Entry(index, entry)) {
+            if (Is_Same_Entry(entry, fw_checksum, fw_checksum_algorithm)) {
+                continue;
+            }
+            if (total_size + required_size > m_max_size) {
+                char path[strlen(m_directory) + FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+                Get_Entry_Path(entry.checksum, entry.algorithm, path, sizeof(path));
+                (void)remove(path);
+                total_size -= entry.size;
+#if THINGSBOARD_ENABLE_DEBUG
+                Logger::printfln(FIRMWARE_CACHE_ENTRY_EVICTED, entry.checksum, entry.size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+                continue;
+            }
+            written = written && fprintf(temporary, FIRMWARE_CACHE_INDEX_LINE_FMT, entry.algorithm, entry.checksum, entry.size) > 0;
+        }
+        if (index != nullptr) {
+            fclose(index);
+        }
+        if (appended != nullptr) {
+            written = written && fprintf(temporary, FIRMWARE_CACHE_INDEX_LINE_FMT, appended->algorithm, appended->checksum, appended->size) > 0;
+        }
+        bool const closed = fclose(temporary) == 0;
+        if (!written || !closed) {
+            (void)remove(temporary_path);
+            return false;
+        }
+
+        // Replacing an existing file is atomic on POSIX file systems, but fails on FAT file systems,
+        // there the previous index has to be removed first, which is still safe because the temporary file is complete at this point
+        if (rename(temporary_path, index_path) != 0) {
+            (void)remove(index_path);
+            return rename(temporary_path, index_path) == 0;
+        }
+        return true;
+    }
+
+    char const  *m_directory = {};          // Path to the directory the entries and the index are stored in
+    size_t      m_max_size = {};            // Maximum total size in bytes of all cached firmware binaries
+    FILE        *m_read_file = {};          // Handle of the entry file that is currently read, opened from open_entry until close_entry
+    FILE        *m_fill_file = {};          // Handle of the pending file that is currently filled, opened from begin_entry until end_entry or abort_entry
+    Index_Entry m_fill_entry = {};          // Index line of the entry that is currently filled
+    size_t      m_fill_written_bytes = {};  // Amount of bytes written into the pending file so far
+};
+
+#endif // File_Firmware_Cache_h
@@ -0,0 +1,78 @@
+#ifndef File_Firmware_Source_h
+#define File_Firmware_Source_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IFirmware_Source.h"
+
+// Library include.
+#include <stdio.h>
+
+constexpr char OPEN_SOURCE_FILE_FAILED[] = "Failed to open firmware source file (%s), ensure path is correct and the file exists";
+
+
+/// @brief IFirmware_Source implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/),
+/// under the hood to read the currently running firmware binary from a file. Can be used to read a copy of the running binary from an SD card or to apply a binary patch to a file on a host system
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Firmware_Source : public IFirmware_Source {
+  public:
+    /// @brief Constructor
+    /// @param file_path Path to the file containing the currently running firmware binary, has to stay valid for the lifetime of this instance
+    File_Firmware_Source(char const * file_path)
+      : m_path(file_path)
+    {
+        // Nothing to do
+    }
+
+    ~File_Firmware_Source() {
+        close();
+    }
+
+    bool open() override {
+        close();
+        m_file = fopen(m_path, "rb");
+        if (m_file == nullptr) {
+            Logger::printfln(OPEN_SOURCE_FILE_FAILED, m_path);
+            return false;
+        }
+        long file_size = -1;
+        if (fseek(m_file, 0, SEEK_END) == 0) {
+            file_size = ftell(m_file);
+        }
+        if (file_size < 0) {
+            close();
+            return false;
+        }
+        m_size = static_cast<size_t>(file_size);
+        return true;
+    }
+
+    size_t size() const override {
+        return m_size;
+    }
+
+    bool read(size_t const & offset, uint8_t * buffer, size_t const & total_bytes) override {
+        if (m_file == nullptr || fseek(m_file, static_cast<long>(offset), SEEK_SET) != 0) {
+            return false;
+        }
+        return fread(buffer, 1, total_bytes, m_file) == total_bytes;
+    }
+
+    void close() override {
+        if (m_file != nullptr) {
+            fclose(m_file);
+            m_file = nullptr;
+        }
+        m_size = 0U;
+    }
+
+  private:
+    char const * m_path = {}; // Path to the file containing the currently running firmware binary
+    FILE *       m_file = {}; // Handle of the opened file, nullptr if it is not opened
+    size_t       m_size = {}; // Size in bytes of the opened file
+};
+
+#endif // File_Firmware_Source_h
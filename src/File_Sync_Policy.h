@@ -0,0 +1,16 @@
+#ifndef File_Sync_Policy_h
+#define File_Sync_Policy_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Possible policies on when the File_Updater forces the written firmware binary out of the operating system and file system caches onto the storage medium,
+/// allows to trade the write throughput against the amount of data that might be lost if the device loses power while the update is in progress
+enum class File_Sync_Policy : uint8_t {
+    NEVER, ///< Written data is only flushed to the file system when the file is closed, fastest option but the file system decides when the data actually reaches the storage medium
+    END, ///< Written data is synchronized once before the file is closed at the end of the update, ensures the complete firmware binary is stored before the update counts as successful
+    BLOCK ///< Written data is synchronized after every full write buffer, slowest option but limits the data lost on a power failure to the size of the write buffer
+};
+
+#endif // File_Sync_Policy_h
@@ -0,0 +1,207 @@
+#ifndef File_Updater_h
+#define File_Updater_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "Aligned_Write_Updater.h"
+#include "File_Sync_Policy.h"
+#include "IUpdater.h"
+
+// Library include.
+#include <stdio.h>
+#ifdef __has_include
+#  if __has_include(<unistd.h>)
+#    include <unistd.h>
+#    define THINGSBOARD_FILE_UPDATER_POSIX 1
+#  endif
+#endif
+#if defined(__linux__) && defined(THINGSBOARD_FILE_UPDATER_POSIX)
+#  include <fcntl.h>
+#  define THINGSBOARD_FILE_UPDATER_FALLOCATE 1
+#endif
+
+// Default size of the write buffer, multiple of the sector size and the most common cluster size of FAT formatted SD cards
+size_t constexpr FILE_UPDATER_BUFFER_SIZE = 4096U;
+
+constexpr char FILE_UPDATER_OPEN_FAILED[] = "Failed to open file (%s), ensure path is correct and the storage medium exists and is initalized";
+constexpr char FILE_UPDATER_PREALLOCATION_FAILED[] = "Preallocating (%u) bytes for file (%s) failed, continuing without preallocation";
+constexpr char FILE_UPDATER_WRITE_FAILED[] = "Only (%u) bytes of (%u) were written into file (%s)";
+constexpr char FILE_UPDATER_SIZE_MISMATCH[] = "Only (%u) bytes of (%u) were written into file (%s) before the update was ended";
+
+
+/// @brief IUpdater implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/) under the hood to write the given binary firmware data into a file,
+/// meant to replace the SDCard_Updater if the write throughput matters. The file is kept open from begin until end, instead of being opened and closed for every single chunk,
+/// which on FAT file systems causes a directory lookup, a walk of the cluster chain and a metadata update per chunk.
+/// The complete firmware size is preallocated once the update is started, so the clusters do not have to be allocated one after another while writing.
+/// Uses posix_fallocate on Linux and ftruncate on other POSIX compatible platforms like the Espressif IDF. Preallocating is only an optimization,
+/// if the file system does not support it, like the FATFS of the Espressif IDF not supporting growing a file with ftruncate, the clusters are allocated while writing instead.
+/// Received chunks are coalesced by an Aligned_Write_Updater with the size of the write buffer, meaning every write covers complete clusters at an offset that is a multiple of the buffer size,
+/// which avoids the file system having to read, modify and write back partially written sectors. The buffering of the c library itself is disabled, because it would only copy the data a second time.
+/// When the written data is forced onto the storage medium is configurable with the File_Sync_Policy.
+/// Resetting the update truncates the file instead of deleting it and ending the update keeps the file, so it can be used to flash the firmware binary afterwards.
+/// Resuming an interrupted update is not supported, because persisted checkpoints might include bytes that were still in the write buffer when the device lost power
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param file_path Path to the file the firmware binary is written into, has to stay valid for the lifetime of this instance
+    /// @param sync_policy Policy on when the written data is forced onto the storage medium, default = File_Sync_Policy::END
+    /// @param buffer_size Size of the write buffer, should be a multiple of the cluster size of the file system, default = FILE_UPDATER_BUFFER_SIZE
+    File_Updater(char const * file_path, File_Sync_Policy const & sync_policy = File_Sync_Policy::END, size_t const & buffer_size = FILE_UPDATER_BUFFER_SIZE)
+      : m_file_writer(file_path, sync_policy)
+      , m_aligned_writer(m_file_writer, buffer_size)
+    {
+        // Nothing to do
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        return m_aligned_writer.begin(firmware_size);
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        return m_aligned_writer.write(payload, total_bytes);
+    }
+
+    void reset() override {
+        m_aligned_writer.reset();
+    }
+
+    bool end() override {
+        return m_aligned_writer.end();
+    }
+
+  private:
+    /// @brief IUpdater implementation that writes the blocks coalesced by the Aligned_Write_Updater into the opened file, without buffering them a second time
+    class File_Writer : public IUpdater {
+      public:
+        /// @brief Constructor
+        /// @param file_path Path to the file the firmware binary is written into, has to stay valid for the lifetime of this instance
+        /// @param sync_policy Policy on when the written data is forced onto the storage medium
+        File_Writer(char const * file_path, File_Sync_Policy const & sync_policy)
+          : m_path(file_path)
+          , m_sync_policy(sync_policy)
+        {
+            // Nothing to do
+        }
+
+        /// @brief Destructor, closes the file if the update was not ended or reset
+        ~File_Writer() {
+            Close_File();
+        }
+
+        bool begin(size_t const & firmware_size) override {
+            Close_File();
+            m_file = fopen(m_path, "wb");
+            if (m_file == nullptr) {
+                Logger::printfln(FILE_UPDATER_OPEN_FAILED, m_path);
+                return false;
+            }
+            (void)setvbuf(m_file, nullptr, _IONBF, 0);
+            if (!Preallocate(firmware_size)) {
+                Logger::printfln(FILE_UPDATER_PREALLOCATION_FAILED, firmware_size, m_path);
+            }
+            m_firmware_size = firmware_size;
+            return true;
+        }
+
+        size_t write(uint8_t * payload, size_t const & total_bytes) override {
+            if (m_file == nullptr) {
+                return 0U;
+            }
+            size_t const written_bytes = fwrite(payload, 1, total_bytes, m_file);
+            m_written_bytes += written_bytes;
+            if (written_bytes != total_bytes) {
+                Logger::printfln(FILE_UPDATER_WRITE_FAILED, written_bytes, total_bytes, m_path);
+                return written_bytes;
+            }
+            if (m_sync_policy == File_Sync_Policy::BLOCK && !Sync_File()) {
+                return 0U;
+            }
+            return total_bytes;
+        }
+
+        void reset() override {
+            if (m_file == nullptr) {
+                return;
+            }
+            Close_File();
+            // Reopening the file for writing truncates it, which works on every platform, unlike ftruncate on the still open file
+            FILE * file = fopen(m_path, "wb");
+            if (file != nullptr) {
+                fclose(file);
+            }
+        }
+
+        bool end() override {
+            if (m_file == nullptr) {
+                return false;
+            }
+            if (m_written_bytes != m_firmware_size) {
+                Logger::printfln(FILE_UPDATER_SIZE_MISMATCH, m_written_bytes, m_firmware_size, m_path);
+                return false;
+            }
+            if (m_sync_policy != File_Sync_Policy::NEVER && !Sync_File()) {
+                return false;
+            }
+            bool const closed = fclose(m_file) == 0;
+            m_file = nullptr;
+            Close_File();
+            return closed;
+        }
+
+      private:
+        /// @brief Allocates the given size for the opened file, without changing the current write position
+        /// @param firmware_size Total size of the firmware binary that is going to be written
+        /// @return Whether allocating was successful or not supported on the current platform
+        bool Preallocate(size_t const & firmware_size) {
+            if (firmware_size == 0U) {
+                return true;
+            }
+#if defined(THINGSBOARD_FILE_UPDATER_FALLOCATE)
+            return posix_fallocate(fileno(m_file), 0, static_cast<off_t>(firmware_size)) == 0;
+#elif defined(THINGSBOARD_FILE_UPDATER_POSIX)
+            return ftruncate(fileno(m_file), static_cast<off_t>(firmware_size)) == 0;
+#else
+            // Clusters are allocated while writing instead
+            return true;
+#endif // defined(THINGSBOARD_FILE_UPDATER_FALLOCATE)
+        }
+
+        /// @brief Forces the written data out of the c library, the operating system and the file system caches onto the storage medium
+        /// @return Whether synchronizing was successful or not
+        bool Sync_File() {
+            if (fflush(m_file) != 0) {
+                return false;
+            }
+#if defined(THINGSBOARD_FILE_UPDATER_POSIX)
+            return fsync(fileno(m_file)) == 0;
+#else
+            return true;
+#endif // defined(THINGSBOARD_FILE_UPDATER_POSIX)
+        }
+
+        /// @brief Closes the file without synchronizing it
+        void Close_File() {
+            if (m_file != nullptr) {
+                fclose(m_file);
+                m_file = nullptr;
+            }
+            m_written_bytes = 0U;
+            m_firmware_size = 0U;
+        }
+
+        char const       *m_path = {};          // Path to the file the binary data is written into
+        File_Sync_Policy m_sync_policy = {};    // Policy on when the written data is forced onto the storage medium
+        FILE             *m_file = {};          // Handle of the file, opened from begin until end
+        size_t           m_written_bytes = {};  // Amount of bytes written into the file so far
+        size_t           m_firmware_size = {};  // Total size of the firmware binary that is going to be written
+    };
+
+    File_Writer                   m_file_writer;     // Writes the coalesced blocks into the file, has to be declared before the aligned writer referencing it
+    Aligned_Write_Updater<Logger> m_aligned_writer;  // Coalesces the received chunks into blocks with the size of the write buffer
+};
+
+#endif // File_Updater_h
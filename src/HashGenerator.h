@@ -3,37 +3,41 @@
 
 // Local includes.
 #include "Configuration.h"
+#include "Checksum_Algorithm.h"
+#include "MD_Checksum.h"
+#include "CRC32_Checksum.h"
+#include "Murmur3_32_Checksum.h"
+#include "Murmur3_128_Checksum.h"
 
 // Library includes.
-#if THINGSBOARD_USE_MBED_TLS
-#include <mbedtls/md.h>
-#else
-#include <Seeed_mbedtls.h>
-#endif // THINGSBOARD_USE_MBED_TLS
 #include <stdint.h>
 #include <stddef.h>
 
 
-/// @brief Wrapper class which allows generating a hash of the given type from any arbitrary byte payload, which is hashable in chunks.
-/// The class wraps around either the Arduino Seeed mbedtls library from Seed Studio (https://github.com/Seeed-Studio/Seeed_Arduino_mbedtls) or the offical ESP Mbed TLS implementation from Mbed TLS (https://github.com/Mbed-TLS/mbedtls), the latter takes precendence if it exists.
-/// This is done because it removes the need to include another library, because the component already exists on the system and we can therefore simply utilize that one.
-/// The ESP Mbed TLS implementationt works with both Espressif IDF v4.X and v5.X, meaning it is version idependent, this is the case
-/// because depending on the used version the implementation automatically adjusts to still initalize correctly.
-/// The class instance is meant to be started with start() which will then create the configuration for a hash of the given type
-/// and we then expect the complete binary payload to be called in multiple calls to update() and the final result to be read with get_hash_string()
-/// Documentation about the specific use and caviates of the ESP Mbedt TLS implementation can be found here https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/protocols/mbedtls.html
+// Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
+size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
+// Maximum size of the serialized hash context, the SHA-384 and SHA-512 context is the biggest of all supported hash algorithms
+size_t constexpr HASH_CONTEXT_MAX_SIZE = sizeof(mbedtls_sha512_context);
+
+
+/// @brief Wrapper class which allows generating a checksum with the given Checksum_Algorithm from any arbitrary byte payload, which is hashable in chunks.
+/// Holds one instance of every IChecksum implementation and forwards the calls to the one selected with start(), which allows to verify the firmware binary
+/// with whatever algorithm the server has been configured to use, without requiring any heap allocations while the update is running.
+/// The class instance is meant to be started with start() and we then expect the complete binary payload to be called in multiple calls to update()
+/// and the final result to be read as its hex string representation with finish()
 class HashGenerator {
   public:
     /// @brief Constructor
     HashGenerator(void) = default;
 
-    /// @brief Destructor
-    ~HashGenerator(void);
+    HashGenerator(HashGenerator const &) = delete;
+
+    HashGenerator & operator=(HashGenerator const &) = delete;
 
     /// @brief Starts the hashing process
-    /// @param type Supported type of hash that should be generated from this class
+    /// @param algorithm Supported algorithm the checksum should be generated with
     /// @return Whether initalizing and starting the hash calculation was successful or not
-    bool start(mbedtls_md_type_t const & type);
+    bool start(Checksum_Algorithm const & algorithm);
 
     /// @brief Update the current hash value with new data
     /// @param data Data that should be added to generate the hash
@@ -43,27 +47,45 @@ class HashGenerator {
 
     /// @brief Calculates the final hash string representation and stops the hash calculation no further calls to update() will work,
     /// instead the same context can be reused to start another hash calculation operation with start()
-    /// @param hash_string Output string that the hash string representation will be copied into, needs to be big enough to hold the string representation of the mbedtls_md_type_t
+    /// @param hash_string Output string that the hash string representation will be copied into, needs to be big enough to hold the string representation of the Checksum_Algorithm
     /// meaning we require 2 bytes for every single byte of hash data, therefore the biggest hash string representation has a size of 128 bytes.
-    /// For the actual hash being SHA256, requiring 256 bits = 64 bytes * 2 for the string representation resulting in 128 bytes + 1 byte for the null termination character.
-    /// Recommended size of the array to pass is simply (MBEDTLS_MD_MAX_SIZE * 2) + 1, which will result in 129 bytes, but additionally automatically update as well if the underlying max size changes
+    /// For the actual hash being SHA512, requiring 512 bits = 64 bytes * 2 for the string representation resulting in 128 bytes + 1 byte for the null termination character.
+    /// Recommended size of the array to pass is simply FIRMWARE_HASH_SIZE, which will result in 129 bytes, but additionally automatically update as well if the underlying max size changes
     /// @return Whether stopping and caculating the final hash for the given bytes was successful or not
     bool finish(char * hash_string);
 
+    /// @brief Gets the size of the serialized context of the currently started hash calculation
+    /// @return Amount of bytes needed to save the context, 0 if no hash calculation was started or the algorithm does not support saving its context
+    size_t get_context_size() const;
+
+    /// @brief Serializes the intermediate state of the currently started hash calculation, so it can be continued later on with restore(), even after a reboot.
+    /// See IChecksum::save() and the implementation of the started algorithm for the caveats of the serialized data
+    /// @param context Output buffer the serialized context will be copied into
+    /// @param context_size Size of the given output buffer, needs to be atleast get_context_size() bytes
+    /// @return Whether saving the context was successful or not
+    bool save(uint8_t * context, size_t const & context_size) const;
+
+    /// @brief Starts a hash calculation with the given algorithm and continues it from the given serialized context, previously created with save()
+    /// @param algorithm Supported algorithm the saved context was created with
+    /// @param context Serialized context that should be continued
+    /// @param context_size Size of the serialized context, needs to be the same as the context size of the given algorithm
+    /// @return Whether restoring the context was successful or not
+    bool restore(Checksum_Algorithm const & algorithm, uint8_t const * context, size_t const & context_size);
+
   private:
-    /// @brief Frees all internally allocated memory to ensure no memory leak occurs, additionally check if a hash calculation was ever started,
-    /// before freeing, because freeing without having started a hash calculation causes a crash.
-    void free();
-
-    /// @brief Calculates the amount of bytes needed for the hash output.
-    /// Is used because we if we don't calculate the exact amount needed the final hash string representation, will always be filled up with hex 00 to the maximum size of the hash string representation being 129 bytes.
-    /// Which results in hash string representation with a lot of additional 00 at the end, which might make the further processing of those strings fail
-    /// @param type Supported type of hash that should be generated from this class
-    /// @return Amount of bytes needed to be allocated by the buffer that will hold the final hash that is then transformed into a string
-    size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
-
-    size_t               m_size = {}; // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
-    mbedtls_md_context_t m_ctx = {};  // Context used to access the already written bytes and update them latter
+    /// @brief Selects the implementation of the given algorithm as the active one, releasing the resources of the previously active implementation if it differs
+    /// @param algorithm Supported algorithm the checksum should be generated with
+    /// @return Whether an implementation of the given algorithm exists or not
+    bool select(Checksum_Algorithm const & algorithm);
+
+    MD_Checksum          m_md5 = { mbedtls_md_type_t::MBEDTLS_MD_MD5 };       // Calculates Checksum_Algorithm::MD5
+    MD_Checksum          m_sha256 = { mbedtls_md_type_t::MBEDTLS_MD_SHA256 }; // Calculates Checksum_Algorithm::SHA256
+    MD_Checksum          m_sha384 = { mbedtls_md_type_t::MBEDTLS_MD_SHA384 }; // Calculates Checksum_Algorithm::SHA384
+    MD_Checksum          m_sha512 = { mbedtls_md_type_t::MBEDTLS_MD_SHA512 }; // Calculates Checksum_Algorithm::SHA512
+    CRC32_Checksum       m_crc32 = {};                                        // Calculates Checksum_Algorithm::CRC32
+    Murmur3_32_Checksum  m_murmur3_32 = {};                                   // Calculates Checksum_Algorithm::MURMUR3_32
+    Murmur3_128_Checksum m_murmur3_128 = {};                                  // Calculates Checksum_Algorithm::MURMUR3_128
+    IChecksum            *m_checksum = {};                                    // Implementation of the currently started hash calculation
 };
 
 #endif // Hash_Generator_h
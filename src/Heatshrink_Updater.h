@@ -0,0 +1,304 @@
+#ifndef Heatshrink_Updater_h
+#define Heatshrink_Updater_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "HashGenerator.h"
+#include "IUpdater.h"
+
+// Library include.
+#include <stdlib.h>
+#include <string.h>
+
+
+// Default base two logarithm of the window size, same as the default of the heatshrink command line tool (-w 8)
+uint8_t constexpr HEATSHRINK_WINDOW_BITS = 8U;
+// Default base two logarithm of the lookahead size, same as the default of the heatshrink command line tool (-l 4)
+uint8_t constexpr HEATSHRINK_LOOKAHEAD_BITS = 4U;
+// Smallest and biggest window sizes supported by the heatshrink format
+uint8_t constexpr HEATSHRINK_MIN_WINDOW_BITS = 4U;
+uint8_t constexpr HEATSHRINK_MAX_WINDOW_BITS = 15U;
+// Smallest lookahead size supported by the heatshrink format, the lookahead has to be smaller than the window
+uint8_t constexpr HEATSHRINK_MIN_LOOKAHEAD_BITS = 3U;
+// Size of the little endian decompressed size, the compressed firmware binary is prefixed with
+size_t constexpr HEATSHRINK_SIZE_PREFIX_SIZE = 4U;
+
+constexpr char HEATSHRINK_INVALID_PARAMETERS[] = "Heatshrink window (%u) and lookahead (%u) bits are invalid, window has to be between 4 and 15 and lookahead between 3 and the window bits - 1";
+constexpr char HEATSHRINK_WINDOW_ALLOCATION_FAILED[] = "Failed to allocate (%u) bytes for the heatshrink window";
+constexpr char HEATSHRINK_TARGET_BEGIN_FAILED[] = "Beginning the update of the decompressed firmware binary with size (%u) failed";
+constexpr char HEATSHRINK_TARGET_WRITE_FAILED[] = "Only (%u) bytes of (%u) of the decompressed firmware binary were written";
+constexpr char HEATSHRINK_SIZE_EXCEEDED[] = "Compressed firmware binary decompresses to more than the expected (%u) bytes";
+constexpr char HEATSHRINK_INCOMPLETE[] = "Compressed firmware binary ended after (%u) of (%u) decompressed bytes";
+constexpr char HEATSHRINK_CHECKSUM_FAILED[] = "Decompressed firmware checksum verification failed, calculated: (%s), expected: (%s)";
+
+
+/// @brief IUpdater decorator that decompresses the received firmware on the fly with the heatshrink algorithm (https://github.com/atomicobject/heatshrink)
+/// and writes the decompressed firmware binary into the wrapped updater. Reduces the amount of bytes that have to be downloaded to roughly half for most firmware binaries.
+/// The compressed firmware binary has to start with the size of the decompressed firmware binary as a 4 byte little endian integer, followed by the output of the heatshrink encoder,
+/// because heatshrink does not encode the size itself, but the wrapped updater has to know it when the update is started.
+/// The window and lookahead bits have to be the same the firmware was compressed with (heatshrink -e -w 8 -l 4 by default).
+/// The decoder only requires the window itself, which is 2^window bits bytes, the decompressed bytes are written into the wrapped updater directly out of it every time it wraps around.
+/// The checksum the update was started with is verified by OTA_Handler over the compressed stream, which is the file uploaded to the server.
+/// The decompressed firmware binary can additionally be verified with Set_Target_Checksum.
+/// Can be chained with the Delta_Updater to download compressed binary patches, by passing the Delta_Updater as the wrapped updater
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Heatshrink_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param target Updater the decompressed firmware binary is written into, has to stay valid for the lifetime of this instance
+    /// @param window_bits Base two logarithm of the window size the firmware binary was compressed with, default = HEATSHRINK_WINDOW_BITS
+    /// @param lookahead_bits Base two logarithm of the lookahead size the firmware binary was compressed with, default = HEATSHRINK_LOOKAHEAD_BITS
+    Heatshrink_Updater(IUpdater & target, uint8_t const & window_bits = HEATSHRINK_WINDOW_BITS, uint8_t const & lookahead_bits = HEATSHRINK_LOOKAHEAD_BITS)
+      : m_target(&target)
+      , m_window_bits(window_bits)
+      , m_lookahead_bits(lookahead_bits)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, frees the window if the update was not ended or reset
+    ~Heatshrink_Updater() {
+        Free_Window();
+    }
+
+    /// @brief Sets the checksum the decompressed firmware binary is verified against once the update is ended, with the update being discarded if it does not match.
+    /// Has to be set before the update is started, because the decompressed firmware binary is hashed while it is written
+    /// @param checksum Expected checksum of the decompressed firmware binary as a hex string, has to stay valid until the update is ended, nullptr disables the verification, default = nullptr
+    /// @param checksum_algorithm Algorithm used to calculate the expected checksum
+    void Set_Target_Checksum(char const * checksum, Checksum_Algorithm const & checksum_algorithm) {
+        m_target_checksum = checksum;
+        m_target_checksum_algorithm = checksum_algorithm;
+    }
+
+    bool begin(size_t const & /*firmware_size*/) override {
+        reset();
+        if (m_window_bits < HEATSHRINK_MIN_WINDOW_BITS || m_window_bits > HEATSHRINK_MAX_WINDOW_BITS || m_lookahead_bits < HEATSHRINK_MIN_LOOKAHEAD_BITS || m_lookahead_bits >= m_window_bits) {
+            Logger::printfln(HEATSHRINK_INVALID_PARAMETERS, m_window_bits, m_lookahead_bits);
+            return false;
+        }
+        size_t const window_size = static_cast<size_t>(1U) << m_window_bits;
+        // Back references before the start of the decompressed firmware binary read zeros, the same as the reference decoder
+        m_window = static_cast<uint8_t *>(calloc(window_size, sizeof(uint8_t)));
+        if (m_window == nullptr) {
+            Logger::printfln(HEATSHRINK_WINDOW_ALLOCATION_FAILED, window_size);
+            return false;
+        }
+        if (m_target_checksum != nullptr && !m_target_hash.start(m_target_checksum_algorithm)) {
+            Free_Window();
+            return false;
+        }
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        if (m_window == nullptr) {
+            return 0U;
+        }
+        for (size_t index = 0U; index < total_bytes; index++) {
+            if (m_state == Decoder_State::SIZE) {
+                if (!Read_Size(payload[index])) {
+                    return 0U;
+                }
+                continue;
+            }
+            m_bit_buffer = (m_bit_buffer << 8U) | payload[index];
+            m_bit_count += 8U;
+            if (!Decode_Bits()) {
+                return 0U;
+            }
+        }
+        return total_bytes;
+    }
+
+    void reset() override {
+        if (m_target_started) {
+            m_target->reset();
+        }
+        Free_Window();
+    }
+
+    bool end() override {
+        if (m_window == nullptr) {
+            return false;
+        }
+        // Remaining bits are the zero padding to the last full byte, the encoder never ends in the middle of a literal or back reference
+        if (m_state == Decoder_State::SIZE || m_output_position != m_decompressed_size) {
+            Logger::printfln(HEATSHRINK_INCOMPLETE, m_output_position, m_decompressed_size);
+            return false;
+        }
+        if (!Flush_Window()) {
+            return false;
+        }
+
+        if (m_target_checksum != nullptr) {
+            char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
+            (void)m_target_hash.finish(calculated_checksum);
+            if (strncmp(m_target_checksum, calculated_checksum, strlen(m_target_checksum)) != 0) {
+                Logger::printfln(HEATSHRINK_CHECKSUM_FAILED, calculated_checksum, m_target_checksum);
+                // Freeing the window forgets that the wrapped updater has been started, therefore it is reset before
+                reset();
+                return false;
+            }
+        }
+        Free_Window();
+        return m_target->end();
+    }
+
+  private:
+    /// @brief Part of the compressed firmware binary the decoder expects next
+    enum class Decoder_State : uint8_t {
+        SIZE, ///< Little endian decompressed size prefix
+        TAG, ///< Single bit deciding if a literal or a back reference follows
+        LITERAL, ///< Single byte that is copied into the output unchanged
+        INDEX, ///< Distance of the back reference minus one
+        COUNT ///< Length of the back reference minus one
+    };
+
+    /// @brief Reads a byte of the decompressed size prefix and starts the wrapped updater, once it has been received completely
+    /// @param data Received byte of the size prefix
+    /// @return Whether the size prefix is still incomplete or the wrapped updater was started successfully
+    bool Read_Size(uint8_t const & data) {
+        m_decompressed_size |= static_cast<size_t>(data) << (8U * m_size_length);
+        m_size_length++;
+        if (m_size_length < HEATSHRINK_SIZE_PREFIX_SIZE) {
+            return true;
+        }
+        if (!m_target->begin(m_decompressed_size)) {
+            Logger::printfln(HEATSHRINK_TARGET_BEGIN_FAILED, m_decompressed_size);
+            return false;
+        }
+        m_target_started = true;
+        m_state = Decoder_State::TAG;
+        return true;
+    }
+
+    /// @brief Decodes as many literals and back references as possible out of the currently buffered bits, the bits of an incomplete field are kept until the next byte is received
+    /// @return Whether decoding was successful, false if writing into the wrapped updater failed or the decompressed size was exceeded
+    bool Decode_Bits() {
+        for (;;) {
+            switch (m_state) {
+                case Decoder_State::TAG:
+                    if (m_bit_count < 1U) {
+                        return true;
+                    }
+                    m_state = (Take_Bits(1U) != 0U) ? Decoder_State::LITERAL : Decoder_State::INDEX;
+                    break;
+                case Decoder_State::LITERAL:
+                    if (m_bit_count < 8U) {
+                        return true;
+                    }
+                    if (!Output_Byte(static_cast<uint8_t>(Take_Bits(8U)))) {
+                        return false;
+                    }
+                    m_state = Decoder_State::TAG;
+                    break;
+                case Decoder_State::INDEX:
+                    if (m_bit_count < m_window_bits) {
+                        return true;
+                    }
+                    m_backref_distance = Take_Bits(m_window_bits) + 1U;
+                    m_state = Decoder_State::COUNT;
+                    break;
+                case Decoder_State::COUNT: {
+                    if (m_bit_count < m_lookahead_bits) {
+                        return true;
+                    }
+                    uint16_t const count = Take_Bits(m_lookahead_bits) + 1U;
+                    size_t const mask = (static_cast<size_t>(1U) << m_window_bits) - 1U;
+                    for (uint16_t i = 0U; i < count; i++) {
+                        if (!Output_Byte(m_window[(m_output_position - m_backref_distance) & mask])) {
+                            return false;
+                        }
+                    }
+                    m_state = Decoder_State::TAG;
+                    break;
+                }
+                default:
+                    return true;
+            }
+        }
+    }
+
+    /// @brief Removes the given amount of most significant bits from the buffered bits, heatshrink writes every field most significant bit first
+    /// @param count Amount of bits to remove, has to be smaller or equal to the amount of buffered bits
+    /// @return Value of the removed bits
+    uint16_t Take_Bits(uint8_t const & count) {
+        m_bit_count -= count;
+        uint16_t const value = static_cast<uint16_t>((m_bit_buffer >> m_bit_count) & ((1U << count) - 1U));
+        m_bit_buffer &= (1U << m_bit_count) - 1U;
+        return value;
+    }
+
+    /// @brief Appends a decompressed byte to the window and writes the window into the wrapped updater, once it wraps around
+    /// @param data Decompressed byte
+    /// @return Whether appending was successful, false if writing into the wrapped updater failed or the decompressed size was exceeded
+    bool Output_Byte(uint8_t const & data) {
+        if (m_output_position >= m_decompressed_size) {
+            Logger::printfln(HEATSHRINK_SIZE_EXCEEDED, m_decompressed_size);
+            return false;
+        }
+        size_t const mask = (static_cast<size_t>(1U) << m_window_bits) - 1U;
+        m_window[m_output_position & mask] = data;
+        m_output_position++;
+        return (m_output_position & mask) != 0U || Flush_Window();
+    }
+
+    /// @brief Writes all decompressed bytes in the window, that have not been written yet, into the wrapped updater and into the hash function of the decompressed firmware binary.
+    /// Is called every time the window wraps around, therefore the unwritten bytes are always one continous block
+    /// @return Whether writing was successful or not
+    bool Flush_Window() {
+        size_t const window_size = static_cast<size_t>(1U) << m_window_bits;
+        size_t const start = m_flushed_position & (window_size - 1U);
+        size_t const length = m_output_position - m_flushed_position;
+        if (length == 0U) {
+            return true;
+        }
+        size_t const written_bytes = m_target->write(m_window + start, length);
+        if (written_bytes != length) {
+            Logger::printfln(HEATSHRINK_TARGET_WRITE_FAILED, written_bytes, length);
+            return false;
+        }
+        if (m_target_checksum != nullptr) {
+            (void)m_target_hash.update(m_window + start, length);
+        }
+        m_flushed_position = m_output_position;
+        return true;
+    }
+
+    /// @brief Frees the window and resets the decoder state
+    void Free_Window() {
+        free(m_window);
+        m_window = nullptr;
+        m_state = Decoder_State::SIZE;
+        m_size_length = 0U;
+        m_decompressed_size = 0U;
+        m_bit_buffer = 0U;
+        m_bit_count = 0U;
+        m_backref_distance = 0U;
+        m_output_position = 0U;
+        m_flushed_position = 0U;
+        m_target_started = false;
+    }
+
+    IUpdater          *m_target = {};                   // Updater the decompressed firmware binary is written into
+    uint8_t           m_window_bits = {};               // Base two logarithm of the window size the firmware binary was compressed with
+    uint8_t           m_lookahead_bits = {};            // Base two logarithm of the lookahead size the firmware binary was compressed with
+    uint8_t           *m_window = {};                   // Window containing the last decompressed bytes, allocated while an update is in progress
+    char const        *m_target_checksum = {};          // Expected checksum of the decompressed firmware binary, nullptr if it is not verified
+    Checksum_Algorithm m_target_checksum_algorithm = {}; // Algorithm used to calculate the expected checksum of the decompressed firmware binary
+    HashGenerator     m_target_hash = {};               // Hash of the decompressed firmware binary that has been written so far
+    Decoder_State     m_state = {};                     // Part of the compressed firmware binary the decoder expects next
+    uint8_t           m_size_length = {};               // Amount of received bytes of the decompressed size prefix
+    size_t            m_decompressed_size = {};         // Size of the decompressed firmware binary
+    uint32_t          m_bit_buffer = {};                // Received bits that have not been decoded yet, right aligned
+    uint8_t           m_bit_count = {};                 // Amount of received bits that have not been decoded yet
+    uint16_t          m_backref_distance = {};          // Distance of the back reference whose count is decoded next
+    size_t            m_output_position = {};           // Amount of decompressed bytes so far
+    size_t            m_flushed_position = {};          // Amount of decompressed bytes written into the wrapped updater so far
+    bool              m_target_started = {};            // Whether the wrapped updater has been started and has to be reset if the update fails
+};
+
+#endif // Heatshrink_Updater_h
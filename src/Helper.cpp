@@ -3,9 +3,24 @@
 
 // Local includes.
 #include "Constants.h"
+#include "CRC32_Checksum.h"
 
 // Library includes.
 #include <string.h>
+#include <stdint.h>
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#elif defined(ARDUINO)
+#include <Arduino.h>
+#elif THINGSBOARD_ENABLE_STL
+#include <chrono>
+#endif // THINGSBOARD_USE_ESP_TIMER
+#ifdef __has_include
+#  if __has_include(<esp_heap_caps.h>)
+#    include <esp_heap_caps.h>
+#    define THINGSBOARD_HAS_HEAP_CAPS 1
+#  endif
+#endif
 
 size_t Helper::getOccurences(uint8_t const * bytes, char symbol, unsigned int length) {
     size_t count = 0;
@@ -25,25 +40,26 @@ bool Helper::stringIsNullorEmpty(char const * str) {
 }
 
 // NIMA CHANGES - strip the + at the end of the base topic if it exists
-size_t Helper::parseRequestId(const char* base_topic, const char* received_topic) {
+size_t Helper::parseRequestId(const char* base_topic, String_View const & received_topic) {
     size_t base_len = strlen(base_topic);
 
     // If base_topic ends with '+' (wildcard), remove it for comparison
     if (base_len > 0 && base_topic[base_len - 1] == '+') {
         base_len--;  // exclude '+'
-        // Also strip the '/' before it if present
-        if (base_len > 0 && base_topic[base_len - 1] == '/') {
-            base_len--;
-        }
     }
 
-    // Safety check: ensure received_topic is at least as long as base_len
-    if (strlen(received_topic) <= base_len) {
-        return 0; // invalid input
+    // Skip the '/' before the number, if the base topic did not already contain it
+    String_View request_id = received_topic.substr(base_len);
+    if (!request_id.empty() && request_id[0] == '/') {
+        request_id = request_id.substr(1U);
     }
 
-    // Extract the numeric part
-    return atoi(received_topic + base_len + 1); // skip the '/' before the number
+    // Extract the numeric part, the received topic is not necessarily null terminated, therefore atoi can not be used
+    size_t result = 0U;
+    for (size_t i = 0U; i < request_id.size() && request_id[i] >= '0' && request_id[i] <= '9'; i++) {
+        result = (result * 10U) + static_cast<size_t>(request_id[i] - '0');
+    }
+    return result;
 }
 //
 // size_t Helper::parseRequestId(char const * base_topic, char const * received_topic) {
@@ -52,3 +68,65 @@ size_t Helper::parseRequestId(const char* base_topic, const char* received_topic
 //     // Meaning the index we attempt to parse at, is simply the length of the base topic
 //     return atoi(received_topic + strlen(base_topic));
 // }
+
+bool Helper::topicMatches(String_View const & filter, String_View const & topic) {
+    size_t filter_index = 0U;
+    size_t topic_index = 0U;
+    // Topics beginning with $ are reserved for the broker and are not matched by filters starting with a wildcard
+    if (!topic.empty() && topic[0U] == '$' && !filter.empty() && (filter[0U] == '+' || filter[0U] == '#')) {
+        return false;
+    }
+    while (filter_index < filter.size()) {
+        char const current = filter[filter_index];
+        if (current == '#') {
+            return true;
+        }
+        else if (current == '+') {
+            while (topic_index < topic.size() && topic[topic_index] != '/') {
+                topic_index++;
+            }
+            filter_index++;
+            continue;
+        }
+        else if (topic_index >= topic.size() || current != topic[topic_index]) {
+            // The multi level wildcard additionally matches the parent level, meaning "a/#" matches "a" as well
+            return topic_index == topic.size() && current == '/' && filter_index + 2U == filter.size() && filter[filter_index + 1U] == '#';
+        }
+        filter_index++;
+        topic_index++;
+    }
+    return topic_index == topic.size();
+}
+
+uint64_t Helper::getTimeMicroseconds() {
+#if THINGSBOARD_USE_ESP_TIMER
+    return static_cast<uint64_t>(esp_timer_get_time());
+#elif defined(ARDUINO)
+    // The micros() method overflows after roughly 71 minutes, which is shorter than an update over a slow connection might take,
+    // therefore every overflow is counted and added as the upper 32 bits, requires the method to be called atleast once in that timeframe
+    static uint32_t last_time = 0U;
+    static uint64_t overflows = 0U;
+    uint32_t const current_time = micros();
+    if (current_time < last_time) {
+        overflows += (static_cast<uint64_t>(1U) << 32U);
+    }
+    last_time = current_time;
+    return overflows | current_time;
+#elif THINGSBOARD_ENABLE_STL
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    return 0U;
+#endif // THINGSBOARD_USE_ESP_TIMER
+}
+
+size_t Helper::getFreeHeapSize() {
+#ifdef THINGSBOARD_HAS_HEAP_CAPS
+    return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#else
+    return SIZE_MAX;
+#endif // THINGSBOARD_HAS_HEAP_CAPS
+}
+
+uint32_t Helper::calculateCRC32(uint8_t const * data, size_t const & length, uint32_t crc) {
+    return CRC32_Checksum::calculate(data, length, crc);
+}
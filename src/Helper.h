@@ -3,6 +3,7 @@
 
 // Local includes.
 #include "Configuration.h"
+#include "String_View.h"
 
 // Library include.
 #include <ArduinoJson.h>
@@ -48,11 +49,38 @@ class Helper {
 
     /// @brief Returns the portion of the received topic after the base topic as an integer.
     /// Should contain the request id that the original request was sent with
-    /// Is used to know which received response is connected to which inital request
-    /// @param base_topic Base portion of the topic that does not contain any parameters (v1/devices/me/attributes/response/)
+    /// Is used to know which received response is connected to which inital request.
+    /// Only the digits inside of the received topic are parsed, because it does not have to be null terminated
+    /// @param base_topic Base portion of the topic that does not contain any parameters (v1/devices/me/attributes/response/), a trailing wildcard (+) is ignored
     /// @param received_topic Received topic that contains the base topic as well as the request id parameter (v1/devices/me/rpc/response/$request_id)
     /// @return Converted integral request id if possible or 0 if parsing as an integer failed
-    static size_t parseRequestId(char const * base_topic, char const * received_topic);
+    static size_t parseRequestId(char const * base_topic, String_View const & received_topic);
+
+    /// @brief Returns whether the given topic matches the given topic filter, following the wildcard rules of MQTT 3.1.1.
+    /// Topics beginning with $ are reserved for the broker and are not matched by filters starting with a wildcard
+    /// @param filter Topic filter, may contain the single level wildcard + and the multi level wildcard #
+    /// @param topic Topic without wildcards, does not have to be null terminated
+    /// @return Whether the topic matches the filter
+    static bool topicMatches(String_View const & filter, String_View const & topic);
+
+    /// @brief Returns a monotonic timestamp in microseconds, uses esp_timer if it is available, the Arduino micros() method otherwise,
+    /// which is extended to 64 bit by counting its overflows, or as a last fallback the steady clock of the C++ STL library.
+    /// Is meant to measure the elapsed time between two events, the absolute value has no meaning
+    /// @return Monotonic timestamp in microseconds
+    static uint64_t getTimeMicroseconds();
+
+    /// @brief Returns the amount of currently free heap memory in bytes, that could be allocated with malloc,
+    /// uses the esp_heap_caps header if it is available, because there is no portable way to query the free heap memory on other platforms
+    /// @return Amount of free heap memory in bytes, or SIZE_MAX if it can not be determined on the current platform
+    static size_t getFreeHeapSize();
+
+    /// @brief Calculates the CRC32 (IEEE 802.3, reflected polynomial 0xEDB88320) of the given data, the same checksum zlib and most manifest tools calculate.
+    /// Forwards to the slice-by-8 implementation in CRC32_Checksum, which is shared with the verification of the complete firmware binary
+    /// @param data Data the checksum should be calculated over
+    /// @param length Amount of bytes in the given data
+    /// @param crc Result of a previous call, allows to calculate the checksum over data that is split into multiple parts, default = 0
+    /// @return CRC32 of the given data, continued from the given previous result
+    static uint32_t calculateCRC32(uint8_t const * data, size_t const & length, uint32_t crc = 0U);
 
     /// @brief Calculates the total size of the string the serializeJson method would produce including the null end terminator.
     /// Be aware that null terminator will later not be serialied in the serializeJson() call,
@@ -6,6 +6,7 @@
 #include "Constants.h"
 #include "DefaultLogger.h"
 #include "API_Process_Type.h"
+#include "String_View.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STL
@@ -46,25 +47,88 @@ public:
     virtual API_Process_Type Get_Process_Type() const = 0;
 
     /// @brief Process callback that will be called upon response arrival
-    /// and is responsible for handling the payload before serialization and calling the appropriate previously subscribed callbacks
+    /// and is responsible for handling the payload before serialization and calling the appropriate previously subscribed callbacks.
+    /// The topic is passed directly out of the receive buffer of the MQTT client and is therefore not necessarily null terminated.
+    /// The default implementation copies the topic and forwards it to the overload with a null terminated topic, which allows existing implementations to keep overriding that overload instead
     /// @param topic Previously subscribed topic, we got the response over
     /// @param payload Payload that was sent over the cloud and received over the given topic
     /// @param length Total length of the received payload
-    virtual void Process_Response(char const* topic, uint8_t* payload, unsigned int length) = 0;
+    virtual void Process_Response(String_View const& topic, uint8_t* payload, unsigned int length) {
+        char terminated_topic[topic.size() + 1U] = {};
+        (void)memcpy(terminated_topic, topic.data(), topic.size());
+        Process_Response(static_cast<char const*>(terminated_topic), payload, length);
+    }
+
+    /// @brief Process callback that will be called upon response arrival, with a null terminated topic.
+    /// Only called by the default implementation of the overload with a String_View topic, new implementations should override that overload instead to avoid copying the topic
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Payload that was sent over the cloud and received over the given topic
+    /// @param length Total length of the received payload
+    virtual void Process_Response(char const* topic, uint8_t* payload, unsigned int length) {
+        // Nothing to do
+    }
+
+    /// @brief Process callback that will be called for every fragment of a response, that is bigger than the receive buffer of the underlying MQTT client.
+    /// Only called for API implementations that process the response as raw bytes and only if the client supports receiving messages in fragments, see IMQTT_Client::set_fragment_callback().
+    /// The default implementation can not handle fragments and therefore ignores them
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Fragment of the payload that was sent over the cloud and received over the given topic
+    /// @param offset Byte offset of the fragment in the complete payload
+    /// @param length Length of the received fragment
+    /// @param total_length Total length of the complete payload
+    virtual void Process_Response_Fragment(String_View const& topic, uint8_t* payload, size_t const& offset, size_t const& length, size_t const& total_length) {
+        // Nothing to do
+    }
+
+    /// @brief Informs the API implementation whether responses bigger than the receive buffer of the underlying MQTT client are passed to Process_Response_Fragment(),
+    /// instead of being discarded. Allows to keep the receive buffer small even if big responses are expected.
+    /// Directly set by the used ThingsBoard client, before Initialize() is called. The default implementation ignores it
+    /// @param supported Whether responses are received in fragments if they are bigger than the receive buffer
+    virtual void Set_Fragmented_Receive(bool const& supported) {
+        // Nothing to do
+    }
 
     /// @brief Process callback that will be called upon response arrival
-    /// and is responsible for handling the alredy serialized payload and calling the appropriate previously subscribed callbacks
+    /// and is responsible for handling the alredy serialized payload and calling the appropriate previously subscribed callbacks.
+    /// The topic is passed directly out of the receive buffer of the MQTT client and is therefore not necessarily null terminated.
+    /// The default implementation copies the topic and forwards it to the overload with a null terminated topic, which allows existing implementations to keep overriding that overload instead
     /// @param topic Previously subscribed topic, we got the response over
     /// @param data Payload sent by the server over our given topic, that contains our key value pairs
-    virtual void Process_Json_Response(char const* topic, JsonDocument const& data) = 0;
+    virtual void Process_Json_Response(String_View const& topic, JsonDocument const& data) {
+        char terminated_topic[topic.size() + 1U] = {};
+        (void)memcpy(terminated_topic, topic.data(), topic.size());
+        Process_Json_Response(static_cast<char const*>(terminated_topic), data);
+    }
+
+    /// @brief Process callback that will be called upon response arrival, with a null terminated topic.
+    /// Only called by the default implementation of the overload with a String_View topic, new implementations should override that overload instead to avoid copying the topic
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param data Payload sent by the server over our given topic, that contains our key value pairs
+    virtual void Process_Json_Response(char const* topic, JsonDocument const& data) {
+        // Nothing to do
+    }
 
     /// @brief Compares received response topic and the topic this api implementation handles responses on,
     /// messages from all other topics are ignored and only messages from topics that match are handled.
-    /// For the comparsion we either compare the full expected string with the null termination, if the response topic does not include additional parameters.
-    /// Example being shared attribute update (v1/devices/me/attributes) or we compare only before the null termination for topics that include additional parameters in the response.
-    /// Like for example the original request id in the response of the attribute request (v1/devices/me/attributes/response/1)
+    /// For the comparsion we either compare the full expected string including its length, if the response topic does not include additional parameters.
+    /// Example being shared attribute update (v1/devices/me/attributes) or we compare only the beginning of the topic for topics that include additional parameters in the response.
+    /// Like for example the original request id in the response of the attribute request (v1/devices/me/attributes/response/1).
+    /// The default implementation copies the topic and forwards it to the overload with a null terminated topic, which allows existing implementations to keep overriding that overload instead
+    /// @param topic Received topic, not necessarily null terminated
     /// @return Whether the received response topic matches the topic this api implementation handles responses on
-    virtual bool Compare_Response_Topic(char const* topic) const = 0;
+    virtual bool Compare_Response_Topic(String_View const& topic) const {
+        char terminated_topic[topic.size() + 1U] = {};
+        (void)memcpy(terminated_topic, topic.data(), topic.size());
+        return Compare_Response_Topic(static_cast<char const*>(terminated_topic));
+    }
+
+    /// @brief Compares received response topic and the topic this api implementation handles responses on, with a null terminated topic.
+    /// Only called by the default implementation of the overload with a String_View topic, new implementations should override that overload instead to avoid copying the topic
+    /// @param topic Received topic, null terminated
+    /// @return Whether the received response topic matches the topic this api implementation handles responses on
+    virtual bool Compare_Response_Topic(char const* topic) const {
+        return false;
+    }
 
     /// @brief Unsubcribes all callbacks, to clear up any ongoing subscriptions and stop receiving information over the previously subscribed topic
     /// @return Whether unsubcribing all the previously subscribed callbacks
@@ -76,11 +140,27 @@ public:
     /// @return Whether resubscribing was successfull or not
     virtual bool Resubscribe_Topic() = 0;
 
+    /// @brief Restores the state of the API after the connection to the server has been established again. Permanent subscriptions skip subscribing their topic again
+    /// if the server still has the session of the previous connection and single-event subscriptions decide whether their pending requests survive the reconnect.
+    /// The default implementation ignores both values and simply forwards the call to Resubscribe_Topic(), which is the same behaviour as before
+    /// @param session_present Whether the server reported that it still had the session of the previous connection, meaning it still has all previous subscriptions
+    /// @param keep_requests Whether pending single-event requests should be kept instead of discarded, see Request_Reconnect_Policy for more information
+    /// @return Whether restoring was successfull or not
+    virtual bool Restore_Topic(bool const & session_present, bool const & keep_requests) {
+        return Resubscribe_Topic();
+    }
+
 #if !THINGSBOARD_USE_ESP_TIMER
     /// @brief Internal loop method to update inernal timers for API calls that can timeout.
     /// Only exists on boards that can not use the ESP Timer, because that one uses the FreeRTOS timer in the background instead
     /// and therefore does not require calling a loop method
     virtual void loop() = 0;
+#else
+    /// @brief Internal loop method to advance work that has to be done outside of the callbacks of the MQTT client, like downloading the firmware binary over HTTP.
+    /// Timers use the FreeRTOS timer in the background instead, therefore only implementations with such work have to override it
+    virtual void loop() {
+        // Nothing to do
+    }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
     /// @brief Method that allows to construct internal objects, after the required callback member methods have been set already.
@@ -0,0 +1,59 @@
+#ifndef IChecksum_h
+#define IChecksum_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Checksum interface that contains the methods a class that calculates a checksum over data received in multiple parts has to implement.
+/// Used by the HashGenerator, which selects the implementation for the requested Checksum_Algorithm and converts the result into its hex string representation.
+/// Implementations have to be able to serialize their intermediate state, so the calculation can be continued after a reboot from a persisted checkpoint
+class IChecksum {
+  public:
+    /// @brief Destructor, virtual so implementations that release resources in their own destructor are cleaned up, even if they are deleted through this interface
+    virtual ~IChecksum() = default;
+
+    /// @brief Starts a new checksum calculation, discarding the state of any previous calculation
+    /// @return Whether starting the calculation was successful or not
+    virtual bool start() = 0;
+
+    /// @brief Continues the started checksum calculation with the given data
+    /// @param data Data that directly follows the previously passed data
+    /// @param length Amount of bytes in the given data
+    /// @return Whether updating the calculation was successful or not
+    virtual bool update(uint8_t const * data, size_t const & length) = 0;
+
+    /// @brief Completes the started checksum calculation, no further calls to update() are allowed until the calculation is started again
+    /// @param result Output buffer the checksum is copied into, in the byte order its hex string representation is printed in, needs to be atleast get_size() bytes
+    /// @return Whether completing the calculation was successful or not
+    virtual bool finish(uint8_t * result) = 0;
+
+    /// @brief Releases any resources the started checksum calculation still holds, called if a calculation with a different algorithm is started instead
+    virtual void stop() = 0;
+
+    /// @brief Gets the size of the completed checksum
+    /// @return Amount of bytes the checksum consists of
+    virtual size_t get_size() const = 0;
+
+    /// @brief Gets the size of the serialized intermediate state of the started checksum calculation
+    /// @return Amount of bytes needed to save the state, 0 if no calculation was started or the implementation does not support saving its state
+    virtual size_t get_context_size() const = 0;
+
+    /// @brief Serializes the intermediate state of the started checksum calculation, so it can be continued later on with restore(), even after a reboot
+    /// @param context Output buffer the serialized state will be copied into
+    /// @param context_size Size of the given output buffer, needs to be atleast get_context_size() bytes
+    /// @return Whether saving the state was successful or not
+    virtual bool save(uint8_t * context, size_t const & context_size) const = 0;
+
+    /// @brief Starts a checksum calculation and continues it from the given serialized state, previously created with save()
+    /// @param context Serialized state that should be continued
+    /// @param context_size Size of the serialized state, needs to be the same as the size it was saved with
+    /// @return Whether restoring the state was successful or not
+    virtual bool restore(uint8_t const * context, size_t const & context_size) = 0;
+};
+
+#endif // IChecksum_h
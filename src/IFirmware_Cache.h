@@ -0,0 +1,64 @@
+#ifndef IFirmware_Cache_h
+#define IFirmware_Cache_h
+
+// Local include.
+#include "Configuration.h"
+#include "HashGenerator.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Firmware cache interface that contains the methods a class that stores complete firmware binaries locally, content-addressed by their checksum, has to implement.
+/// Allows to apply a firmware binary that has already been downloaded once, for example after the update was rolled back or on a gateway that updates multiple identical devices,
+/// straight out of local storage instead of downloading it again. Entries are identified by the checksum and the checksum algorithm of the firmware binary,
+/// because the same title and version could describe different binaries, while the same checksum always describes the same content.
+/// Only one entry can be read or filled at a time, the library already contains an implementation that stores every entry in a separate file
+class IFirmware_Cache {
+  public:
+    /// @brief Opens the entry with the given checksum for reading and marks it as the most recently used entry
+    /// @param fw_checksum Checksum of the firmware binary the entry should contain
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @param fw_size Complete size of the firmware binary, an entry with a different size is treated as missing
+    /// @return Whether a complete entry with the given checksum exists and opening it was successful or not
+    virtual bool open_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm, size_t const & fw_size) = 0;
+
+    /// @brief Reads the given amount of bytes out of the currently opened entry
+    /// @param offset Byte offset in the firmware binary the read should start at
+    /// @param buffer Buffer the read bytes are copied into, has to be able to hold atleast the given amount of bytes
+    /// @param total_bytes Amount of bytes that should be read
+    /// @return Amount of bytes actually read, anything less than the given amount counts as a failure
+    virtual size_t read_entry(size_t const & offset, uint8_t * buffer, size_t const & total_bytes) = 0;
+
+    /// @brief Closes the currently opened entry, has to be called once reading has finished or failed
+    virtual void close_entry() = 0;
+
+    /// @brief Starts filling a new entry with the given checksum, evicts the least recently used entries if the new entry would otherwise exceed the size limit.
+    /// The entry only becomes visible to open_entry() once it has been completed with end_entry()
+    /// @param fw_checksum Checksum of the firmware binary that is going to be written into the entry
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    /// @param fw_size Complete size of the firmware binary that is going to be written into the entry
+    /// @return Whether the entry can be filled or not, fails if the firmware binary is bigger than the size limit itself
+    virtual bool begin_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm, size_t const & fw_size) = 0;
+
+    /// @brief Appends the given firmware binary data to the entry that is currently filled, called in strictly sequential order
+    /// @param payload Firmware binary data directly following the previously written data
+    /// @param total_bytes Amount of bytes in the given firmware binary data
+    /// @return Whether writing was successful or not
+    virtual bool write_entry(uint8_t const * payload, size_t const & total_bytes) = 0;
+
+    /// @brief Completes the entry that is currently filled, called once the checksum of the complete firmware binary has been verified
+    /// @return Whether completing the entry was successful or not
+    virtual bool end_entry() = 0;
+
+    /// @brief Discards the entry that is currently filled, called if the update was restarted or failed, has no effect if no entry is filled
+    virtual void abort_entry() = 0;
+
+    /// @brief Removes the complete entry with the given checksum, called if the firmware binary read out of it did not match its checksum
+    /// @param fw_checksum Checksum of the firmware binary the entry contains
+    /// @param fw_checksum_algorithm Algorithm type the checksum was calculated with
+    virtual void remove_entry(char const * fw_checksum, Checksum_Algorithm const & fw_checksum_algorithm) = 0;
+};
+
+#endif // IFirmware_Cache_h
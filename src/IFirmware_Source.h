@@ -0,0 +1,37 @@
+#ifndef IFirmware_Source_h
+#define IFirmware_Source_h
+
+// Local include.
+#include "Configuration.h"
+#include "DefaultLogger.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Firmware source interface that contains the methods a class has to implement, to allow reading the firmware binary the device is currently running.
+/// Counterpart to the IUpdater interface, used by updaters that reconstruct the new firmware binary from the currently running one and a downloaded binary patch, see Delta_Updater
+class IFirmware_Source {
+  public:
+    /// @brief Prepares reading the currently running firmware binary
+    /// @return Whether the currently running firmware binary can be read
+    virtual bool open() = 0;
+
+    /// @brief Gets the size of the currently running firmware binary, has to be the same size the binary patch was created against.
+    /// Bytes outside of that size are never read
+    /// @return Size in bytes of the currently running firmware binary
+    virtual size_t size() const = 0;
+
+    /// @brief Reads the given amount of bytes of the currently running firmware binary, starting at the given byte offset
+    /// @param offset Byte offset of the first byte that should be read
+    /// @param buffer Buffer the read bytes will be copied into
+    /// @param total_bytes Amount of bytes that should be read, is never more than the remaining bytes after the given offset
+    /// @return Whether the given amount of bytes could be read completly
+    virtual bool read(size_t const & offset, uint8_t * buffer, size_t const & total_bytes) = 0;
+
+    /// @brief Ends reading the currently running firmware binary and frees any resources acquired in open
+    virtual void close() = 0;
+};
+
+#endif // IFirmware_Source_h
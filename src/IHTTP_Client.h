@@ -65,6 +65,29 @@ class IHTTP_Client {
 #else
     virtual String get_response_body() = 0;
 #endif // THINGSBOARD_ENABLE_STL
+
+    /// @brief Connects to the server and sends a GET request, that only requests the bytes of the resource starting at the given byte offset until its end,
+    /// by additionally sending the header "Range: bytes=first_byte-". Allows to continue downloading a resource after an interrupted connection, without having to download the already received bytes again.
+    /// The response body is not read, instead it has to be read in parts with read_response_body(), after calling get_response_status_code() and ensuring the request was successful.
+    /// A server that supports range requests responds with 206 (Partial Content), a server that does not responds with 200 (OK) and the complete resource instead.
+    /// Optional method, the default implementation simply fails, because not every client supports sending additional headers or reading the response body as a stream
+    /// @param url_path URL the GET request should be sent too
+    /// @param first_byte Byte offset of the first byte that should be contained in the response body
+    /// @return Whether the request was successful or not, returns 0 if successful or if not the internal error code
+    virtual int get_range(char const * /*url_path*/, size_t const & /*first_byte*/) {
+        return -1;
+    }
+
+    /// @brief Reads the next part of the response body of a previously sent message into the given buffer, skips any response headers if they have not been read already.
+    /// Allows to process response bodies that are too big to be kept in memory completly, like firmware binaries, as they arrive.
+    /// Should wait a short implementation specific amount of time for atleast one byte to arrive, so that calling it in a loop does not cause busy waiting.
+    /// Optional method, the default implementation simply fails, because not every client supports reading the response body as a stream
+    /// @param buffer Buffer the received bytes of the response body will be copied into
+    /// @param buffer_size Maximum amount of bytes that can be copied into the given buffer
+    /// @return Amount of bytes copied into the given buffer, 0 if no bytes have been received in time or a negative value if the connection has been closed or the complete response body has been read
+    virtual int read_response_body(uint8_t * /*buffer*/, size_t const & /*buffer_size*/) {
+        return -1;
+    }
 };
 
 #endif // IHTTP_Client_h
@@ -4,11 +4,22 @@
 // Local include.
 #include "Callback.h"
 #include "DefaultLogger.h"
+#include "String_View.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #include <Print.h>
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
+#include <string.h>
+
+
+/// @brief Single contiguous part of a payload that is published with IMQTT_Client::publish_segments(), similar to the iovec structure used by writev.
+/// Allows to publish payloads that consist of multiple seperate buffers (static prefix, dynamic value, static suffix or a header and a firmware chunk),
+/// without having to first concatenate them into one contiguous buffer. The data is not copied, meaning it has to stay valid until the publish call returns
+struct MQTT_Segment {
+    uint8_t const * data;   // Pointer to the first byte of this part of the payload
+    size_t          length; // Amount of bytes in this part of the payload
+};
 
 
 /// @brief MQTT Client interface that contains the method that a class that can be used to send and receive data over an MQTT connection should implement.
@@ -36,6 +47,31 @@ class IMQTT_Client {
     /// @param callback Method that should be called on received MQTT response
     virtual void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) = 0;
 
+    /// @brief Sets the callback that is called, if any message is received by the MQTT broker, with the topic passed as a view including its length instead of a null terminated string.
+    /// Allows implementations to pass the topic directly out of their receive buffer, instead of copying it only to append the null termination.
+    /// If the implementation supports this callback, the callback set with set_data_callback() is not called anymore.
+    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing.
+    /// The default implementation does not support it, in which case the callback set with set_data_callback() is used instead
+    /// @param callback Method that should be called on received MQTT response
+    /// @return Whether the implementation supports passing the topic as a view and will call the given callback or not
+    virtual bool set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function /*callback*/) {
+        return false;
+    }
+
+    /// @brief Sets the callback that is called for every fragment of a received message, that is bigger than the receive buffer and is therefore received in multiple parts,
+    /// instead of the complete message being discarded. The fragments of one message are passed in order and are never interleaved with fragments or complete messages of other messages.
+    /// Allows to handle messages bigger than the receive buffer without ever holding them in memory at once, for example by writing firmware chunks directly into flash memory while they are received.
+    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing.
+    /// The default implementation does not support receiving messages in fragments and therefore ignores the callback
+    /// @param callback Method that should be called on every received fragment, with the topic string of the complete message, the payload data of the fragment,
+    /// the offset of the fragment in the complete payload, the size of the fragment and the size of the complete payload.
+    /// Has to return whether it handles the message, which is only evaluated for the first fragment. If it does not, the implementation may reassemble the message instead
+    /// and pass it to the data callback once it has been received completely or discard it
+    /// @return Whether the implementation supports receiving messages in fragments and will call the given callback or not
+    virtual bool set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function /*callback*/) {
+        return false;
+    }
+
     /// @brief Sets the callback that is called, if we have successfully established a connection with the MQTT broker.
     /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing
     /// @param callback Method that should be called on established MQTT connection
@@ -82,6 +118,23 @@ class IMQTT_Client {
     /// @return Whether the client could establish the connection successfully or not
     virtual bool connect(char const * client_id, char const * user_name, char const * password) = 0;
 
+    /// @brief Sets whether the next call to connect() requests a clean session or asks the server to keep the session of the same client id,
+    /// meaning its subscriptions and with QoS level 1 the messages that arrive while the client is disconnected. Requires a client id that stays the same between connections.
+    /// The default implementation only supports clean sessions
+    /// @param clean_session Whether the server should discard any previous session and not keep the new one once the client disconnects, default = true
+    /// @return Whether the implementation supports the given value and will apply it on the next call to connect()
+    virtual bool set_clean_session(bool clean_session) {
+        return clean_session;
+    }
+
+    /// @brief Whether the server reported in its response to the last established connection, that it still had the session of the previous connection
+    /// and therefore still has all previous subscriptions, only possible if set_clean_session() has been called with false.
+    /// The default implementation can not receive that information and therefore returns false, which causes all topics to be subscribed again
+    /// @return Whether the session of the previous connection is still present on the server
+    virtual bool get_session_present() {
+        return false;
+    }
+
     /// @brief Disconnects from a previously connected server and should release all used resources
     virtual void disconnect() = 0;
 
@@ -97,6 +150,40 @@ class IMQTT_Client {
     /// @return Whether publishing the payload on the given topic was successful or not
     virtual bool publish(char const * topic, uint8_t const * payload, size_t const & length) = 0;
 
+    /// @brief Sends the payload consisting of the given segments over the previously established connection with connect, as one single message.
+    /// The segments are sent in the given order and the receiver can not differentiate the message from one that was published with a contiguous payload.
+    /// The default implementation concatenates all segments into a temporary buffer and forwards it to publish(), implementations should override it if the underlying client
+    /// allows to write the payload in multiple parts (for example PubSubClient with beginPublish(), write() and endPublish()), because that removes the need for the temporary buffer
+    /// @param topic Topic that the message is sent over, where different MQTT topics expect a different kind of payload
+    /// @param segments Pointer to the first element of the array of segments that make up the payload
+    /// @param segment_count Amount of segments in the given array
+    /// @return Whether publishing the payload on the given topic was successful or not
+    virtual bool publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) {
+        if (segments == nullptr) {
+            return false;
+        }
+        else if (segment_count == 1U) {
+            return publish(topic, segments[0].data, segments[0].length);
+        }
+
+        size_t const length = get_segments_length(segments, segment_count);
+        uint8_t * payload = new uint8_t[length];
+        size_t offset = 0U;
+        for (size_t i = 0U; i < segment_count; i++) {
+            if (segments[i].length == 0U) {
+                continue;
+            }
+            memcpy(payload + offset, segments[i].data, segments[i].length);
+            offset += segments[i].length;
+        }
+        bool const result = publish(topic, payload, length);
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] payload;
+        payload = nullptr;
+        return result;
+    }
+
     /// @brief Subscribes to MQTT message on the given topic, which will cause an internal callback to be called for each message received on that topic from the server,
     /// it should then, call the previously configured callback with set_data_callback() with the received data
     /// @param topic Topic we want to receive a notification about if messages are sent by the server
@@ -149,6 +236,19 @@ class IMQTT_Client {
     virtual size_t write(uint8_t const * buffer, size_t const & size) = 0;
 
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  protected:
+    /// @brief Returns the total amount of bytes contained in all the given segments
+    /// @param segments Pointer to the first element of the array of segments that make up the payload
+    /// @param segment_count Amount of segments in the given array
+    /// @return Total length of the payload in bytes
+    static size_t get_segments_length(MQTT_Segment const * segments, size_t const & segment_count) {
+        size_t length = 0U;
+        for (size_t i = 0U; i < segment_count; i++) {
+            length += segments[i].length;
+        }
+        return length;
+    }
 };
 
 #endif // IMQTT_Client_h
@@ -0,0 +1,34 @@
+#ifndef IOTA_Checkpoint_Store_h
+#define IOTA_Checkpoint_Store_h
+
+// Local include.
+#include "Configuration.h"
+#include "DefaultLogger.h"
+
+
+// Forward declaration, allows to pass the interface without having to include the mbedtls headers needed for the checkpoint itself
+struct OTA_Checkpoint;
+
+
+/// @brief Checkpoint store interface that contains the methods a class that persists the progress of an over the air firmware update has to implement.
+/// Allows to resume an update after a disconnect or reboot, the store should therefore persist the checkpoint in non volatile memory,
+/// the library already contains an implementation that uses the Non-Volatile Storage of Espressif IDF and one that uses a file
+class IOTA_Checkpoint_Store {
+  public:
+    /// @brief Loads the previously saved checkpoint
+    /// @param checkpoint Checkpoint the persisted data will be copied into
+    /// @return Whether a complete checkpoint was persisted and loading it was successful or not
+    virtual bool load(OTA_Checkpoint & checkpoint) = 0;
+
+    /// @brief Persists the given checkpoint, overwriting any previously saved checkpoint.
+    /// Should ensure that a failed save does not leave a partially written checkpoint, that could be loaded successfully afterwards
+    /// @param checkpoint Checkpoint that should be persisted
+    /// @return Whether saving the checkpoint was successful or not
+    virtual bool save(OTA_Checkpoint const & checkpoint) = 0;
+
+    /// @brief Erases the previously saved checkpoint, called once the update has finished or the already written data has to be discarded
+    /// @return Whether erasing the checkpoint was successful or not, should be true if there was no checkpoint to erase
+    virtual bool erase() = 0;
+};
+
+#endif // IOTA_Checkpoint_Store_h
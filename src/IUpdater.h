@@ -23,6 +23,24 @@ class IUpdater {
     /// @param total_bytes Amount of bytes in the current firmware packet data
     /// @return Total amount of bytes that were successfully written
     virtual size_t write(uint8_t * payload, size_t const & total_bytes) = 0;
+
+    /// @brief Initalizes the writing of the given data, but continues after the already written bytes of a previous interrupted update instead of starting from the beginning.
+    /// Is called instead of begin, if the update is resumed from a persisted checkpoint, the bytes up to the given offset have to be kept unchanged
+    /// and any bytes after the given offset, that might have been written after the checkpoint was created, have to be discarded.
+    /// Not every implementation is able to resume an update, therefore the default implementation simply returns false, which causes the update to be restarted from the beginning
+    /// @param firmware_size Total size of the data that should be written, is done in multiple packets
+    /// @param offset Amount of bytes that have already been written and should be kept
+    /// @return Whether resuming the update was successful or not
+    virtual bool resume(size_t const & /*firmware_size*/, size_t const & /*offset*/) {
+        return false;
+    }
+
+    /// @brief Gets the value every offset passed to resume has to be a multiple of, checkpoints are therefore only created at offsets that are a multiple of it.
+    /// Updaters writing into flash memory can only continue at the start of a sector, because flash memory can only be erased in complete sectors, default = 1
+    /// @return Alignment every offset passed to resume has to have
+    virtual size_t get_resume_alignment() const {
+        return 1U;
+    }
   
     /// @brief Resets the writing of the given data so it can be restarted with begin
     virtual void reset() = 0;
@@ -0,0 +1,138 @@
+// Header include.
+#include "MD_Checksum.h"
+
+// Library include.
+#include <string.h>
+
+// MBEDTLS Version 3 is a major breaking changes were accessing the internal structures requires the MBEDTLS_PRIVATE macro
+#if MBEDTLS_VERSION_MAJOR < 3
+#define MD_CHECKSUM_PRIVATE(member) member
+#else
+#define MD_CHECKSUM_PRIVATE(member) MBEDTLS_PRIVATE(member)
+#endif // MBEDTLS_VERSION_MAJOR < 3
+
+MD_Checksum::MD_Checksum(mbedtls_md_type_t const & type)
+  : m_type(type)
+{
+    // Nothing to do
+}
+
+MD_Checksum::~MD_Checksum() {
+    stop();
+}
+
+bool MD_Checksum::start() {
+    // Clear the internal structure of any previous attempt, because if we do not the init function will not work correctly
+    stop();
+    // Initialize the context
+    mbedtls_md_init(&m_ctx);
+    // Choose the hash function
+    bool init_result = mbedtls_md_setup(&m_ctx, mbedtls_md_info_from_type(m_type), 0) == 0;
+    // Start the hash
+    init_result = init_result && (mbedtls_md_starts(&m_ctx) == 0);
+    return init_result;
+}
+
+bool MD_Checksum::update(uint8_t const * data, size_t const & length) {
+    return mbedtls_md_update(&m_ctx, data, length) == 0;
+}
+
+bool MD_Checksum::finish(uint8_t * result) {
+    return mbedtls_md_finish(&m_ctx, result) == 0;
+}
+
+void MD_Checksum::stop() {
+    // The hash context has only been allocated if the setup was called, which sets the information about the used hash algorithm.
+    // The hmac context on the other hand is only allocated if hmac was requested in the setup call, which is never the case, therefore it can not be used as an indicator
+    if (m_ctx.MD_CHECKSUM_PRIVATE(md_info) != nullptr) {
+        // Ensures to clean up the mbedtls memory after it has been used
+        mbedtls_md_free(&m_ctx);
+    }
+}
+
+size_t MD_Checksum::get_size() const {
+    return mbedtls_type_to_size(m_type);
+}
+
+size_t MD_Checksum::get_context_size() const {
+    if (m_ctx.MD_CHECKSUM_PRIVATE(md_ctx) == nullptr) {
+        return 0U;
+    }
+    return mbedtls_type_to_context_size(m_type);
+}
+
+bool MD_Checksum::save(uint8_t * context, size_t const & context_size) const {
+    size_t const required_size = get_context_size();
+    if (context == nullptr || required_size == 0U || context_size < required_size) {
+        return false;
+    }
+    mbedtls_md_context_t clone = {};
+    mbedtls_md_init(&clone);
+    bool const success = mbedtls_md_setup(&clone, mbedtls_md_info_from_type(m_type), 0) == 0 && mbedtls_md_clone(&clone, &m_ctx) == 0;
+    if (success) {
+        (void)memcpy(context, clone.MD_CHECKSUM_PRIVATE(md_ctx), required_size);
+    }
+    mbedtls_md_free(&clone);
+    return success;
+}
+
+bool MD_Checksum::restore(uint8_t const * context, size_t const & context_size) {
+    size_t const required_size = mbedtls_type_to_context_size(m_type);
+    if (context == nullptr || required_size == 0U || context_size != required_size || !start()) {
+        return false;
+    }
+    (void)memcpy(m_ctx.MD_CHECKSUM_PRIVATE(md_ctx), context, required_size);
+    return true;
+}
+
+size_t MD_Checksum::mbedtls_type_to_context_size(mbedtls_md_type_t const & type) {
+    switch (type) {
+        case mbedtls_md_type_t::MBEDTLS_MD_MD5:
+            return sizeof(mbedtls_md5_context);
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA1:
+            return sizeof(mbedtls_sha1_context);
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA224: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA256:
+            return sizeof(mbedtls_sha256_context);
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA384: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA512:
+            return sizeof(mbedtls_sha512_context);
+        default:
+            return 0U;
+    }
+}
+
+size_t MD_Checksum::mbedtls_type_to_size(mbedtls_md_type_t const & type) {
+    switch (type) {
+#if MBEDTLS_VERSION_MAJOR < 3
+        case mbedtls_md_type_t::MBEDTLS_MD_MD2: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_MD4:
+#endif // MBEDTLS_VERSION_MAJOR < 3
+        case mbedtls_md_type_t::MBEDTLS_MD_MD5:
+            return 16U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA1: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_RIPEMD160:
+            return 20U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA224:
+            return 28U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA256:
+            return 32U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA384:
+            return 48U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA512:
+            return 64U;
+#if ((MBEDTLS_VERSION_MAJOR == 3 && MBEDTLS_VERSION_MINOR >= 5) || MBEDTLS_VERSION_MAJOR > 3)
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA3_224:
+            return 28U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA3_256:
+            return 32U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA3_384:
+            return 48U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA3_512:
+            return 64U;
+#endif // ((MBEDTLS_VERSION_MAJOR == 3 && MBEDTLS_VERSION_MINOR >= 5) || MBEDTLS_VERSION_MAJOR > 3)
+        case mbedtls_md_type_t::MBEDTLS_MD_NONE: // Fallthrough same behaviour
+        default:
+            return 0U;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef MD_Checksum_h
+#define MD_Checksum_h
+
+// Local includes.
+#include "Configuration.h"
+#include "IChecksum.h"
+
+// Library includes.
+#if THINGSBOARD_USE_MBED_TLS
+#include <mbedtls/md.h>
+#else
+#include <Seeed_mbedtls.h>
+#endif // THINGSBOARD_USE_MBED_TLS
+#include <mbedtls/md5.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+
+/// @brief IChecksum implementation which calculates a message digest of the given type,
+/// wraps around either the Arduino Seeed mbedtls library from Seed Studio (https://github.com/Seeed-Studio/Seeed_Arduino_mbedtls) or the offical ESP Mbed TLS implementation from Mbed TLS (https://github.com/Mbed-TLS/mbedtls), the latter takes precendence if it exists.
+/// This is done because it removes the need to include another library, because the component already exists on the system and we can therefore simply utilize that one.
+/// The ESP Mbed TLS implementationt works with both Espressif IDF v4.X and v5.X, meaning it is version idependent, this is the case
+/// because depending on the used version the implementation automatically adjusts to still initalize correctly.
+/// Documentation about the specific use and caviates of the ESP Mbedt TLS implementation can be found here https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/protocols/mbedtls.html
+class MD_Checksum : public IChecksum {
+  public:
+    /// @brief Constructor
+    /// @param type Supported type of message digest that should be calculated
+    MD_Checksum(mbedtls_md_type_t const & type);
+
+    /// @brief Destructor
+    ~MD_Checksum();
+
+    MD_Checksum(MD_Checksum const &) = delete;
+
+    MD_Checksum & operator=(MD_Checksum const &) = delete;
+
+    bool start() override;
+
+    bool update(uint8_t const * data, size_t const & length) override;
+
+    bool finish(uint8_t * result) override;
+
+    void stop() override;
+
+    size_t get_size() const override;
+
+    /// @brief Gets the size of the serialized context of the started calculation.
+    /// The context is cloned when it is saved, because hardware accelerated implementations only keep the state in the peripheral and write it back into the context when it is cloned.
+    /// Be aware the serialized data is the raw memory of the context, meaning it can only be restored by a device running the same build of the library
+    /// @return Amount of bytes needed to save the context, 0 if no calculation was started or the type does not support saving its context
+    size_t get_context_size() const override;
+
+    bool save(uint8_t * context, size_t const & context_size) const override;
+
+    bool restore(uint8_t const * context, size_t const & context_size) override;
+
+  private:
+    /// @brief Calculates the amount of bytes the internal context of the given message digest type requires
+    /// @param type Supported type of message digest
+    /// @return Amount of bytes of the internal context, 0 if saving the context of the given type is not supported
+    static size_t mbedtls_type_to_context_size(mbedtls_md_type_t const & type);
+
+    /// @brief Calculates the amount of bytes needed for the message digest output.
+    /// Is used because we if we don't calculate the exact amount needed the final hash string representation, will always be filled up with hex 00 to the maximum size of the hash string representation being 129 bytes.
+    /// Which results in hash string representation with a lot of additional 00 at the end, which might make the further processing of those strings fail
+    /// @param type Supported type of message digest
+    /// @return Amount of bytes needed to be allocated by the buffer that will hold the final message digest
+    static size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
+
+    mbedtls_md_type_t    m_type = {}; // Type of the calculated message digest
+    mbedtls_md_context_t m_ctx = {};  // Context used to access the already written bytes and update them latter
+};
+
+#endif // MD_Checksum_h
@@ -0,0 +1,133 @@
+// Header include.
+#include "MQTT_Buffer_Size_Controller.h"
+
+void MQTT_Buffer_Size_Controller::Start(uint16_t const & minimum_size, uint16_t const & maximum_size) {
+    m_minimum_size = minimum_size;
+    m_maximum_size = maximum_size < minimum_size ? minimum_size : maximum_size;
+    m_adaptive = true;
+    m_adaptive_receive_size = m_minimum_size;
+    m_adaptive_send_size = m_minimum_size;
+    m_receive_window_peak = 0U;
+    m_send_window_peak = 0U;
+    m_receive_window_messages = 0U;
+    m_send_window_messages = 0U;
+}
+
+void MQTT_Buffer_Size_Controller::Stop() {
+    m_adaptive = false;
+}
+
+bool MQTT_Buffer_Size_Controller::Is_Adaptive() const {
+    return m_adaptive;
+}
+
+void MQTT_Buffer_Size_Controller::Set_Requested_Sizes(uint16_t const & receive_size, uint16_t const & send_size) {
+    m_requested_receive_size = receive_size;
+    m_requested_send_size = send_size;
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Requested_Receive_Size() const {
+    return m_requested_receive_size;
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Requested_Send_Size() const {
+    return m_requested_send_size;
+}
+
+void MQTT_Buffer_Size_Controller::Message_Received(size_t const & size) {
+    if (!m_adaptive) {
+        return;
+    }
+    Observe(size, m_adaptive_receive_size, m_receive_window_peak, m_receive_window_messages);
+}
+
+void MQTT_Buffer_Size_Controller::Message_Sent(size_t const & size) {
+    if (!m_adaptive) {
+        return;
+    }
+    Observe(size, m_adaptive_send_size, m_send_window_peak, m_send_window_messages);
+}
+
+uint16_t MQTT_Buffer_Size_Controller::Get_Desired_Receive_Size() const {
+    if (!m_adaptive || m_adaptive_receive_size < m_requested_receive_size) {
+        return m_requested_receive_size;
+    }
+    return m_adaptive_receive_size;
+}
+
+uint16_t MQTT_Buffer_Size_Controller::Get_Desired_Send_Size() const {
+    if (!m_adaptive || m_adaptive_send_size < m_requested_send_size) {
+        return m_requested_send_size;
+    }
+    return m_adaptive_send_size;
+}
+
+bool MQTT_Buffer_Size_Controller::Resize_Pending() const {
+    return Get_Desired_Receive_Size() != m_attempted_receive_size || Get_Desired_Send_Size() != m_attempted_send_size;
+}
+
+bool MQTT_Buffer_Size_Controller::Send_Growth_Pending() const {
+    return Get_Desired_Send_Size() > m_attempted_send_size;
+}
+
+void MQTT_Buffer_Size_Controller::Sizes_Applied(uint16_t const & attempted_receive_size, uint16_t const & attempted_send_size, uint16_t const & receive_size, uint16_t const & send_size) {
+    m_attempted_receive_size = attempted_receive_size;
+    m_attempted_send_size = attempted_send_size;
+    m_receive_size = receive_size;
+    m_send_size = send_size;
+    if (receive_size > m_peak_receive_size) {
+        m_peak_receive_size = receive_size;
+    }
+    if (send_size > m_peak_send_size) {
+        m_peak_send_size = send_size;
+    }
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Receive_Size() const {
+    return m_receive_size;
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Send_Size() const {
+    return m_send_size;
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Peak_Receive_Size() const {
+    return m_peak_receive_size;
+}
+
+uint16_t const & MQTT_Buffer_Size_Controller::Get_Peak_Send_Size() const {
+    return m_peak_send_size;
+}
+
+void MQTT_Buffer_Size_Controller::Observe(size_t const & size, uint16_t & adaptive_size, uint16_t & window_peak, uint16_t & window_messages) const {
+    size_t const needed_size = size + BUFFER_SIZE_MESSAGE_OVERHEAD;
+    if (needed_size > adaptive_size) {
+        // Grow immediately, because every further message of that size would otherwise not fit either, the window is restarted so the grown size is kept for atleast a complete window
+        adaptive_size = Round_Up_Power_Of_Two(needed_size);
+        window_peak = 0U;
+        window_messages = 0U;
+        return;
+    }
+    if (needed_size > window_peak) {
+        window_peak = static_cast<uint16_t>(needed_size);
+    }
+    if (++window_messages < BUFFER_SIZE_SHRINK_WINDOW) {
+        return;
+    }
+    // Only shrink if all messages of the window fit into a quarter of the buffer and then only to twice the biggest of them,
+    // the gap between both thresholds prevents alternating between two sizes if the message sizes vary around one of them
+    if (static_cast<size_t>(window_peak) * 4U <= adaptive_size) {
+        uint16_t const shrunk_size = Round_Up_Power_Of_Two(static_cast<size_t>(window_peak) * 2U);
+        adaptive_size = shrunk_size > m_minimum_size ? shrunk_size : m_minimum_size;
+    }
+    window_peak = 0U;
+    window_messages = 0U;
+}
+
+uint16_t MQTT_Buffer_Size_Controller::Round_Up_Power_Of_Two(size_t const & value) const {
+    size_t result = 1U;
+    while (result < value && result < m_maximum_size) {
+        result <<= 1U;
+    }
+    return result > m_maximum_size ? m_maximum_size : static_cast<uint16_t>(result);
+}
@@ -0,0 +1,134 @@
+#ifndef MQTT_Buffer_Size_Controller_h
+#define MQTT_Buffer_Size_Controller_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Additional bytes a buffer needs besides the topic and payload of a message, to hold the MQTT header
+uint16_t constexpr BUFFER_SIZE_MESSAGE_OVERHEAD = 16U;
+// Amount of messages that have to fit into a quarter of the current buffer size, before the buffer is shrunk
+uint16_t constexpr BUFFER_SIZE_SHRINK_WINDOW = 32U;
+
+
+/// @brief Adaptive controller for the size of the receive and send buffer of the MQTT client, decides on the sizes based on the sizes of the observed messages.
+/// A buffer is grown as soon as a message is observed that does not fit into it, to the next power of two that fits the message, capped at the configured maximum.
+/// Shrinking uses hysteresis to not oscillate between two sizes, a buffer is only shrunk once a complete window of messages fit into a quarter of it,
+/// and then only to twice the size of the biggest message in that window, so a message slightly bigger than the ones in the window still fits.
+/// The sizes requested explicitly, for example by the OTA update to fit its chunks, are used as the lower bound, so adaptive sizing never shrinks a buffer below what has been requested.
+/// The controller only decides on the sizes, applying them has to be done at a point where the buffers of the client are not in use, meaning not while a received message is handled
+class MQTT_Buffer_Size_Controller {
+  public:
+    /// @brief Constructs an disabled controller, that always returns the explicitly requested sizes
+    MQTT_Buffer_Size_Controller() = default;
+
+    /// @brief Enables adaptive sizing within the given bounds and resets all measurements, the adaptive sizes start at the minimum size
+    /// @param minimum_size Minimum size in bytes, the controller never decreases a buffer below it
+    /// @param maximum_size Maximum size in bytes, the controller never increases a buffer above it, except if a bigger size has been requested explicitly
+    void Start(uint16_t const & minimum_size, uint16_t const & maximum_size);
+
+    /// @brief Disables adaptive sizing, meaning the explicitly requested sizes are used unchanged
+    void Stop();
+
+    /// @brief Whether the buffer sizes are adjusted to the observed messages
+    /// @return Whether adaptive buffer sizing is enabled
+    bool Is_Adaptive() const;
+
+    /// @brief Sets the sizes that have been requested explicitly, which are the lower bound of the desired sizes
+    /// @param receive_size Requested receive buffer size in bytes
+    /// @param send_size Requested send buffer size in bytes
+    void Set_Requested_Sizes(uint16_t const & receive_size, uint16_t const & send_size);
+
+    /// @brief Gets the receive buffer size that has been requested explicitly
+    /// @return Requested receive buffer size in bytes
+    uint16_t const & Get_Requested_Receive_Size() const;
+
+    /// @brief Gets the send buffer size that has been requested explicitly
+    /// @return Requested send buffer size in bytes
+    uint16_t const & Get_Requested_Send_Size() const;
+
+    /// @brief Informs the controller that a message with the given size has been received
+    /// @param size Amount of bytes in the topic and payload of the message
+    void Message_Received(size_t const & size);
+
+    /// @brief Informs the controller that a message with the given size is sent
+    /// @param size Amount of bytes in the topic and payload of the message
+    void Message_Sent(size_t const & size);
+
+    /// @brief Gets the receive buffer size, which is the bigger of the requested and the adaptive size
+    /// @return Desired receive buffer size in bytes
+    uint16_t Get_Desired_Receive_Size() const;
+
+    /// @brief Gets the send buffer size, which is the bigger of the requested and the adaptive size
+    /// @return Desired send buffer size in bytes
+    uint16_t Get_Desired_Send_Size() const;
+
+    /// @brief Whether the desired sizes differ from the sizes that have been attempted to be applied last.
+    /// Compared against the attempted instead of the applied sizes, so sizes the client failed to allocate are only retried once the desired sizes change, instead of on every loop
+    /// @return Whether the buffers have to be resized
+    bool Resize_Pending() const;
+
+    /// @brief Whether the desired send buffer size is bigger than the send buffer size that has been attempted to be applied last
+    /// @return Whether the send buffer has to be grown
+    bool Send_Growth_Pending() const;
+
+    /// @brief Informs the controller that the given sizes have been attempted to be applied to the client, which sizes the client actually uses afterwards, and updates the peak sizes
+    /// @param attempted_receive_size Receive buffer size in bytes that has been passed to the client
+    /// @param attempted_send_size Send buffer size in bytes that has been passed to the client
+    /// @param receive_size Receive buffer size in bytes the client uses, differs from the attempted size if allocating failed and the client kept its previous buffer
+    /// @param send_size Send buffer size in bytes the client uses, differs from the attempted size if allocating failed and the client kept its previous buffer
+    void Sizes_Applied(uint16_t const & attempted_receive_size, uint16_t const & attempted_send_size, uint16_t const & receive_size, uint16_t const & send_size);
+
+    /// @brief Gets the receive buffer size that has been applied last
+    /// @return Current receive buffer size in bytes
+    uint16_t const & Get_Receive_Size() const;
+
+    /// @brief Gets the send buffer size that has been applied last
+    /// @return Current send buffer size in bytes
+    uint16_t const & Get_Send_Size() const;
+
+    /// @brief Gets the biggest receive buffer size that has been applied since this instance has been created
+    /// @return Peak receive buffer size in bytes
+    uint16_t const & Get_Peak_Receive_Size() const;
+
+    /// @brief Gets the biggest send buffer size that has been applied since this instance has been created
+    /// @return Peak send buffer size in bytes
+    uint16_t const & Get_Peak_Send_Size() const;
+
+  private:
+    /// @brief Adjusts the given adaptive size to the observed message size, grows it immediately if the message does not fit and shrinks it once a complete window of messages fit into a quarter of it
+    /// @param size Amount of bytes in the topic and payload of the message
+    /// @param adaptive_size Adaptive size of the buffer the message is handled with
+    /// @param window_peak Biggest message including the overhead in the current window
+    /// @param window_messages Amount of messages in the current window
+    void Observe(size_t const & size, uint16_t & adaptive_size, uint16_t & window_peak, uint16_t & window_messages) const;
+
+    /// @brief Rounds the given value up to the next power of two, capped at the maximum size
+    /// @param value Value that should be rounded
+    /// @return Smallest power of two that is bigger or equal to the given value, or the maximum size if that is smaller
+    uint16_t Round_Up_Power_Of_Two(size_t const & value) const;
+
+    bool     m_adaptive = {};                  // Whether the buffer sizes are adjusted to the observed messages
+    uint16_t m_minimum_size = {};              // Buffers are never shrunk below this value
+    uint16_t m_maximum_size = {};              // Buffers are never grown above this value
+    uint16_t m_requested_receive_size = {};    // Explicitly requested receive buffer size, lower bound of the desired size
+    uint16_t m_requested_send_size = {};       // Explicitly requested send buffer size, lower bound of the desired size
+    uint16_t m_adaptive_receive_size = {};     // Receive buffer size based on the observed received messages
+    uint16_t m_adaptive_send_size = {};        // Send buffer size based on the observed sent messages
+    uint16_t m_receive_window_peak = {};       // Biggest received message including the overhead in the current shrink window
+    uint16_t m_send_window_peak = {};          // Biggest sent message including the overhead in the current shrink window
+    uint16_t m_receive_window_messages = {};   // Amount of received messages in the current shrink window
+    uint16_t m_send_window_messages = {};      // Amount of sent messages in the current shrink window
+    uint16_t m_attempted_receive_size = {};    // Receive buffer size that has been attempted to be applied last
+    uint16_t m_attempted_send_size = {};       // Send buffer size that has been attempted to be applied last
+    uint16_t m_receive_size = {};              // Receive buffer size that has been applied last
+    uint16_t m_send_size = {};                 // Send buffer size that has been applied last
+    uint16_t m_peak_receive_size = {};         // Biggest receive buffer size that has been applied
+    uint16_t m_peak_send_size = {};            // Biggest send buffer size that has been applied
+};
+
+#endif // MQTT_Buffer_Size_Controller_h
@@ -0,0 +1,323 @@
+// Header include.
+#include "MQTT_Client_Multiplexer.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local include.
+#include "Multiplexed_MQTT_Client.h"
+
+// Library includes.
+#include <algorithm>
+#include <string>
+
+
+/// @brief Whether the given stored credential is the same as the given credential, where nullptr is handled the same as an empty string
+/// @param stored Credential of the current connection
+/// @param credential Credential that should be compared
+/// @return Whether both credentials are the same
+static bool Credential_Matches(std::string const & stored, char const * credential) {
+    return stored == (credential != nullptr ? credential : "");
+}
+
+/// @brief Finds the numeric request id level directly following the first occurence of the given level in the given topic, for example 1 in v1/devices/me/attributes/request/1
+/// @param topic Topic that should be searched, does not have to be null terminated
+/// @param level Level the request id has to follow, either request for published or response for received topics
+/// @param begin Output position of the first character of the request id level
+/// @param end Output position after the last character of the request id level
+/// @param request_id Output parsed request id
+/// @return Whether the topic contains the given level followed by a numeric request id level
+static bool Find_Request_Id(String_View const & topic, char const * level, size_t & begin, size_t & end, size_t & request_id) {
+    String_View const searched_level(level);
+    size_t level_begin = 0U;
+    while (level_begin <= topic.size()) {
+        size_t level_end = level_begin;
+        while (level_end < topic.size() && topic[level_end] != '/') {
+            level_end++;
+        }
+        if (level_end < topic.size() && String_View(topic.data() + level_begin, level_end - level_begin) == searched_level) {
+            begin = level_end + 1U;
+            end = begin;
+            request_id = 0U;
+            while (end < topic.size() && topic[end] >= '0' && topic[end] <= '9') {
+                request_id = request_id * 10U + static_cast<size_t>(topic[end] - '0');
+                end++;
+            }
+            return end > begin && (end == topic.size() || topic[end] == '/');
+        }
+        level_begin = level_end + 1U;
+    }
+    return false;
+}
+
+
+MQTT_Client_Multiplexer::MQTT_Client_Multiplexer(IMQTT_Client & client)
+  : m_client(client)
+  , m_channels()
+  , m_fragment_channels()
+  , m_subscriptions()
+  , m_request_topic()
+  , m_response_topic()
+  , m_payload_copy()
+  , m_delivered_copy()
+  , m_client_id()
+  , m_user_name()
+  , m_password()
+  , m_has_password(false)
+  , m_has_credentials(false)
+  , m_fragments_enabled(false)
+  , m_fragmented_receive(false)
+  , m_connection(0U)
+  , m_unrouted_messages(0U)
+{
+    if (!m_client.set_data_view_callback([this](String_View const & topic, uint8_t * payload, unsigned int length) { On_Message(topic, payload, length); })) {
+        m_client.set_data_callback([this](char * topic, uint8_t * payload, unsigned int length) { On_Message(String_View(topic), payload, length); });
+    }
+    m_client.set_connect_callback([this]() { On_Connect(); });
+}
+
+IMQTT_Client & MQTT_Client_Multiplexer::Get_Client() {
+    return m_client;
+}
+
+size_t MQTT_Client_Multiplexer::Get_Channels() const {
+    return m_channels.size();
+}
+
+size_t MQTT_Client_Multiplexer::Get_Unrouted_Messages() const {
+    return m_unrouted_messages;
+}
+
+size_t MQTT_Client_Multiplexer::Attach(Multiplexed_MQTT_Client & channel) {
+    if (std::find(m_channels.cbegin(), m_channels.cend(), &channel) != m_channels.cend()) {
+        return channel.Get_Request_Id_Slot();
+    }
+    size_t slot = 0U;
+    while (std::any_of(m_channels.cbegin(), m_channels.cend(), [slot](Multiplexed_MQTT_Client const * attached) { return attached->Get_Request_Id_Slot() == slot; })) {
+        slot++;
+    }
+    m_channels.push_back(&channel);
+    return slot;
+}
+
+void MQTT_Client_Multiplexer::Detach(Multiplexed_MQTT_Client & channel) {
+    m_channels.erase(std::remove(m_channels.begin(), m_channels.end(), &channel), m_channels.end());
+    m_fragment_channels.erase(std::remove(m_fragment_channels.begin(), m_fragment_channels.end(), &channel), m_fragment_channels.end());
+    // Topic filters only the detached channel needed are unsubscribed, the remaining channels might still need the others
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
+        char const * const topic = it->c_str();
+        if (std::any_of(m_channels.cbegin(), m_channels.cend(), [topic](Multiplexed_MQTT_Client const * attached) { return attached->Has_Subscription(topic); })) {
+            ++it;
+            continue;
+        }
+        if (m_client.connected()) {
+            (void)m_client.unsubscribe(topic);
+        }
+        it = m_subscriptions.erase(it);
+    }
+    Disconnect();
+    (void)Apply_Buffer_Size();
+}
+
+bool MQTT_Client_Multiplexer::Subscribe(char const * topic) {
+    if (topic == nullptr) {
+        return false;
+    }
+    else if (std::find(m_subscriptions.cbegin(), m_subscriptions.cend(), topic) != m_subscriptions.cend()) {
+        return true;
+    }
+    else if (!m_client.subscribe(topic)) {
+        return false;
+    }
+    m_subscriptions.emplace_back(topic);
+    return true;
+}
+
+bool MQTT_Client_Multiplexer::Unsubscribe(Multiplexed_MQTT_Client const & channel, char const * topic) {
+    if (topic == nullptr) {
+        return false;
+    }
+    else if (std::any_of(m_channels.cbegin(), m_channels.cend(), [&channel, topic](Multiplexed_MQTT_Client const * attached) { return attached != &channel && attached->Has_Subscription(topic); })) {
+        return true;
+    }
+    auto const it = std::find(m_subscriptions.begin(), m_subscriptions.end(), topic);
+    // Not subscribed during the current session, for example because the connection has been established again since, therefore nothing has to be unsubscribed
+    if (it == m_subscriptions.end()) {
+        return true;
+    }
+    m_subscriptions.erase(it);
+    return m_client.unsubscribe(topic);
+}
+
+char const * MQTT_Client_Multiplexer::Translate_Request_Topic(size_t const & slot, char const * topic) {
+    size_t begin = 0U;
+    size_t end = 0U;
+    size_t request_id = 0U;
+    // Channels beyond the supported amount keep the request ids of their ThingsBoard client, their responses might therefore be routed to another channel
+    if (topic == nullptr || slot >= MULTIPLEXER_REQUEST_ID_STRIDE || !Find_Request_Id(String_View(topic), "request", begin, end, request_id)) {
+        return topic;
+    }
+    m_request_topic.assign(topic);
+    m_request_topic.replace(begin, end - begin, std::to_string(request_id * MULTIPLEXER_REQUEST_ID_STRIDE + slot));
+    return m_request_topic.c_str();
+}
+
+bool MQTT_Client_Multiplexer::Connect(Multiplexed_MQTT_Client & channel, char const * client_id, char const * user_name, char const * password) {
+    bool const same_credentials = m_has_credentials && Credential_Matches(m_client_id, client_id) && Credential_Matches(m_user_name, user_name)
+      && m_has_password == (password != nullptr) && Credential_Matches(m_password, password);
+    if (same_credentials && m_client.connected()) {
+        channel.Connected(m_connection);
+        return true;
+    }
+    m_client_id = client_id != nullptr ? client_id : "";
+    m_user_name = user_name != nullptr ? user_name : "";
+    m_password = password != nullptr ? password : "";
+    m_has_password = password != nullptr;
+    m_has_credentials = true;
+    if (m_client.connected()) {
+        m_client.disconnect();
+    }
+    return m_client.connect(client_id, user_name, password);
+}
+
+void MQTT_Client_Multiplexer::Disconnect() {
+    if (std::any_of(m_channels.cbegin(), m_channels.cend(), [](Multiplexed_MQTT_Client const * attached) { return attached->Wants_Connection(); })) {
+        return;
+    }
+    m_client.disconnect();
+}
+
+bool MQTT_Client_Multiplexer::Apply_Buffer_Size() {
+    uint16_t receive_buffer_size = 0U;
+    uint16_t send_buffer_size = 0U;
+    for (Multiplexed_MQTT_Client const * attached : m_channels) {
+        receive_buffer_size = std::max(receive_buffer_size, attached->Get_Requested_Receive_Size());
+        send_buffer_size = std::max(send_buffer_size, attached->Get_Requested_Send_Size());
+    }
+    // Sizes no channel requested are kept, so the default buffer sizes of the client stay in use
+    if (receive_buffer_size == 0U) {
+        receive_buffer_size = m_client.get_receive_buffer_size();
+    }
+    if (send_buffer_size == 0U) {
+        send_buffer_size = m_client.get_send_buffer_size();
+    }
+    if (receive_buffer_size == m_client.get_receive_buffer_size() && send_buffer_size == m_client.get_send_buffer_size()) {
+        return true;
+    }
+    return m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
+}
+
+bool MQTT_Client_Multiplexer::Enable_Fragments() {
+    if (!m_fragments_enabled) {
+        m_fragmented_receive = m_client.set_fragment_callback([this](String_View const & topic, uint8_t * payload, size_t offset, size_t length, size_t total_length) {
+            return On_Fragment(topic, payload, offset, length, total_length);
+        });
+        m_fragments_enabled = true;
+    }
+    return m_fragmented_receive;
+}
+
+size_t MQTT_Client_Multiplexer::Get_Connection() const {
+    return m_connection;
+}
+
+void MQTT_Client_Multiplexer::On_Message(String_View const & topic, uint8_t * payload, unsigned int const & length) {
+    Multiplexed_MQTT_Client * requester = nullptr;
+    if (Translate_Response_Topic(topic, requester)) {
+        if (requester == nullptr) {
+            m_unrouted_messages++;
+            return;
+        }
+        requester->Deliver(String_View(m_response_topic.data(), m_response_topic.size()), payload, length);
+        return;
+    }
+    size_t const receivers = std::count_if(m_channels.cbegin(), m_channels.cend(), [&topic](Multiplexed_MQTT_Client const * attached) { return attached->Is_Subscribed(topic); });
+    if (receivers == 0U) {
+        m_unrouted_messages++;
+        return;
+    }
+    else if (receivers == 1U) {
+        auto const it = std::find_if(m_channels.cbegin(), m_channels.cend(), [&topic](Multiplexed_MQTT_Client const * attached) { return attached->Is_Subscribed(topic); });
+        (*it)->Deliver(topic, payload, length);
+        return;
+    }
+
+    std::string const topic_copy(topic.data(), topic.size());
+    String_View const topic_view(topic_copy.data(), topic_copy.size());
+    m_payload_copy.assign(payload, payload + length);
+    size_t remaining = receivers;
+    // Handlers might subscribe or unsubscribe topics, but never attach or detach channels, therefore the channels are still accessed by index to be safe
+    for (size_t i = 0U; i < m_channels.size() && remaining > 0U; i++) {
+        Multiplexed_MQTT_Client * const attached = m_channels[i];
+        if (!attached->Is_Subscribed(topic_view)) {
+            continue;
+        }
+        remaining--;
+        if (remaining == 0U) {
+            attached->Deliver(topic_view, m_payload_copy.data(), length);
+            continue;
+        }
+        m_delivered_copy = m_payload_copy;
+        attached->Deliver(topic_view, m_delivered_copy.data(), length);
+    }
+}
+
+bool MQTT_Client_Multiplexer::On_Fragment(String_View const & topic, uint8_t * payload, size_t const & offset, size_t const & length, size_t const & total_length) {
+    // Translated for every fragment, because the channel might have received other messages in between, which overwrote the translated topic
+    Multiplexed_MQTT_Client * requester = nullptr;
+    bool const response = Translate_Response_Topic(topic, requester);
+    String_View const delivered_topic = response ? String_View(m_response_topic.data(), m_response_topic.size()) : topic;
+    if (offset == 0U) {
+        m_fragment_channels.clear();
+        if (response) {
+            if (requester != nullptr && requester->Receives_Fragments() && requester->Deliver_Fragment(delivered_topic, payload, offset, length, total_length)) {
+                m_fragment_channels.push_back(requester);
+            }
+            return !m_fragment_channels.empty();
+        }
+        for (Multiplexed_MQTT_Client * const attached : m_channels) {
+            if (attached->Receives_Fragments() && attached->Is_Subscribed(topic) && attached->Deliver_Fragment(topic, payload, offset, length, total_length)) {
+                m_fragment_channels.push_back(attached);
+            }
+        }
+        return !m_fragment_channels.empty();
+    }
+    for (Multiplexed_MQTT_Client * const attached : m_fragment_channels) {
+        (void)attached->Deliver_Fragment(delivered_topic, payload, offset, length, total_length);
+    }
+    return !m_fragment_channels.empty();
+}
+
+bool MQTT_Client_Multiplexer::Translate_Response_Topic(String_View const & topic, Multiplexed_MQTT_Client * & channel) {
+    channel = nullptr;
+    size_t begin = 0U;
+    size_t end = 0U;
+    size_t request_id = 0U;
+    if (!Find_Request_Id(topic, "response", begin, end, request_id)) {
+        return false;
+    }
+    size_t const slot = request_id % MULTIPLEXER_REQUEST_ID_STRIDE;
+    m_response_topic.assign(topic.data(), topic.size());
+    m_response_topic.replace(begin, end - begin, std::to_string(request_id / MULTIPLEXER_REQUEST_ID_STRIDE));
+    String_View const response_topic(m_response_topic.data(), m_response_topic.size());
+    auto const it = std::find_if(m_channels.cbegin(), m_channels.cend(), [slot, &response_topic](Multiplexed_MQTT_Client const * attached) {
+        return attached->Get_Request_Id_Slot() == slot && attached->Is_Subscribed(response_topic);
+    });
+    if (it != m_channels.cend()) {
+        channel = *it;
+    }
+    return true;
+}
+
+void MQTT_Client_Multiplexer::On_Connect() {
+    m_connection++;
+    if (!m_client.get_session_present()) {
+        m_subscriptions.clear();
+    }
+    for (size_t i = 0U; i < m_channels.size(); i++) {
+        if (m_channels[i]->Wants_Connection()) {
+            m_channels[i]->Connected(m_connection);
+        }
+    }
+}
+
+#endif // THINGSBOARD_ENABLE_STL
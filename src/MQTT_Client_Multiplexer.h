@@ -0,0 +1,158 @@
+#ifndef MQTT_Client_Multiplexer_h
+#define MQTT_Client_Multiplexer_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local include.
+#include "IMQTT_Client.h"
+
+// Library includes.
+#include <string>
+#include <vector>
+
+
+class Multiplexed_MQTT_Client;
+
+
+// Amount of channels whose request ids are kept disjoint, the request id a channel publishes is multiplied by this value and offset by the slot of the channel
+constexpr size_t MULTIPLEXER_REQUEST_ID_STRIDE = 16U;
+
+
+/// @brief Shares the single connection of one IMQTT_Client between multiple seperate ThingsBoard clients, for example an instance that provisions the device and one that sends its telemetry,
+/// without having to open a second connection, which with TLS encryption would need another ~40 KB of memory for its buffers and handshake. Each ThingsBoard client is constructed with its own
+/// Multiplexed_MQTT_Client channel, which forwards its requests to the client owned by this class. Received messages are routed to every channel that subscribed a topic filter matching the topic,
+/// except responses to requests published by a channel, which are only routed to that channel. Because every ThingsBoard client counts its request ids from 0, the ids of multiple channels would collide,
+/// therefore each channel is given its own request id space, by rewriting the request id level following the request level of a published topic, for example v1/devices/me/attributes/request/1,
+/// into id * MULTIPLEXER_REQUEST_ID_STRIDE + slot of the channel. The id following the response level of a received topic is translated back, which decides the channel the response is routed to,
+/// and the channel receives the topic with the request id it published. Supports at most MULTIPLEXER_REQUEST_ID_STRIDE channels publishing requests at the same time.
+/// Subscriptions are reference counted, meaning a topic filter is only subscribed on the server by the first channel and only unsubscribed once no channel needs it anymore.
+/// Established connections are forwarded to every channel that requested a connection, so each ThingsBoard client can resubscribe its topics. The connection is only established again if a channel
+/// connects with different credentials than the current connection, for example once the provisioning instance received the credentials of the device, and only closed once no channel needs it anymore.
+/// The receive and send buffer are resized to the biggest size requested by any channel. Calling loop() on any of the channels receives the messages for all of them.
+/// Requires THINGSBOARD_ENABLE_STL, because without it the ThingsBoard client registers a static callback and therefore only supports one instance of the same type
+class MQTT_Client_Multiplexer {
+  public:
+    /// @brief Constructs the multiplexer and registers its callbacks at the given client, the client should therefore not be passed to any ThingsBoard client directly
+    /// @param client MQTT Client implementation whose connection is shared, has to stay valid for as long as this instance exists
+    explicit MQTT_Client_Multiplexer(IMQTT_Client & client);
+
+    MQTT_Client_Multiplexer(MQTT_Client_Multiplexer const &) = delete;
+
+    MQTT_Client_Multiplexer & operator=(MQTT_Client_Multiplexer const &) = delete;
+
+    /// @brief Gets the client whose connection is shared
+    /// @return Shared MQTT Client implementation
+    IMQTT_Client & Get_Client();
+
+    /// @brief Gets the amount of channels, that are currently attached to this instance
+    /// @return Amount of attached channels
+    size_t Get_Channels() const;
+
+    /// @brief Gets the amount of messages, that have been received since this instance has been created, but did not match the subscriptions of any channel and were therefore discarded
+    /// @return Amount of discarded messages
+    size_t Get_Unrouted_Messages() const;
+
+    /// @brief Attaches the given channel, so it receives the messages matching its subscriptions and established connections, called by the constructor of the channel
+    /// @param channel Channel that should be attached
+    /// @return Slot of the request id space of the channel, which is the lowest slot not used by any other attached channel
+    size_t Attach(Multiplexed_MQTT_Client & channel);
+
+    /// @brief Detaches the given channel, releases all its subscriptions and closes the connection if no other channel needs it anymore, called by the destructor of the channel
+    /// @param channel Channel that should be detached
+    void Detach(Multiplexed_MQTT_Client & channel);
+
+    /// @brief Subscribes the given topic filter on the server, if it has not already been subscribed by another channel during the current session
+    /// @param topic Topic filter that should be subscribed
+    /// @return Whether the topic filter is subscribed on the server
+    bool Subscribe(char const * topic);
+
+    /// @brief Unsubscribes the given topic filter on the server, if no channel except the given one still has it subscribed
+    /// @param channel Channel that released the subscription
+    /// @param topic Topic filter that should be unsubscribed
+    /// @return Whether the topic filter is not needed by the given channel anymore
+    bool Unsubscribe(Multiplexed_MQTT_Client const & channel, char const * topic);
+
+    /// @brief Translates the request id of the given topic into the request id space of the given slot, if the topic contains a request level followed by a numeric request id level,
+    /// for example v1/devices/me/attributes/request/1. Topics without a request id, for example /provision/request, are published unchanged and their responses routed to every subscribed channel
+    /// @param slot Slot of the request id space of the channel that publishes the message
+    /// @param topic Topic the message should be published on
+    /// @return Topic the message has to be published on instead, only valid until the next call
+    char const * Translate_Request_Topic(size_t const & slot, char const * topic);
+
+    /// @brief Connects the given channel. If the client is already connected with the same credentials, only the given channel is notified about the established connection,
+    /// if it has not been notified about it yet. Otherwise the client connects with the given credentials, replacing any connection established with other credentials before
+    /// @param channel Channel that requested the connection
+    /// @param client_id Client identification code, that allows to differentiate which MQTT device is sending the traffic to the MQTT broker
+    /// @param user_name Client username that is used to authenticate, who is connecting over MQTT
+    /// @param password Client password that is used to authenticate, who is connecting over MQTT
+    /// @return Whether the client could establish the connection successfully or already had an established connection with the same credentials
+    bool Connect(Multiplexed_MQTT_Client & channel, char const * client_id, char const * user_name, char const * password);
+
+    /// @brief Closes the connection of the client, if no attached channel requests a connection anymore
+    void Disconnect();
+
+    /// @brief Resizes the buffers of the client to the biggest sizes requested by any of the attached channels
+    /// @return Whether allocating the needed memory for the buffer sizes was successful or not
+    bool Apply_Buffer_Size();
+
+    /// @brief Registers the fragment callback at the client, which routes the fragments to the channels the same as complete messages
+    /// @return Whether the client supports receiving messages in fragments
+    bool Enable_Fragments();
+
+    /// @brief Gets the identifier of the currently established connection, which is increased every time the client reports an established connection
+    /// @return Identifier of the established connection
+    size_t Get_Connection() const;
+
+  private:
+    /// @brief Routes the received message to every channel, that has a subscription matching the topic of the message, or only to the channel that published the request it is the response to.
+    /// If multiple channels receive the message, each receives its own copy of the topic and payload, because the payload might be modified while it is handled, for example by zero-copy JSON deserialization,
+    /// and the receive buffer of the client might be reused to publish a response, for example by the PubSubClient
+    /// @param topic Topic the message was received over
+    /// @param payload Payload of the received message
+    /// @param length Amount of bytes in the payload
+    void On_Message(String_View const & topic, uint8_t * payload, unsigned int const & length);
+
+    /// @brief Routes the received fragment to every channel, that has a subscription matching the topic of the message and handles the fragments of it, or only to the channel that published the request it is the response to.
+    /// Which channels handle the message is only decided with the first fragment, following fragments are only passed to those channels
+    /// @param topic Topic the message was received over
+    /// @param payload Payload data of the fragment
+    /// @param offset Offset of the fragment in the complete payload
+    /// @param length Amount of bytes in the fragment
+    /// @param total_length Amount of bytes in the complete payload
+    /// @return Whether any channel handles the message
+    bool On_Fragment(String_View const & topic, uint8_t * payload, size_t const & offset, size_t const & length, size_t const & total_length);
+
+    /// @brief Translates the request id of the given topic back into the request id space of the channel that published the request, if the topic contains a response level followed by a numeric request id level
+    /// @param topic Topic of a received message
+    /// @param channel Channel that published the request and should exclusively receive the message, nullptr if no attached channel uses the slot of the request id or is subscribed to the topic
+    /// @return Whether the topic is the response to a request with a request id, if it is the translated topic is copied into m_response_topic
+    bool Translate_Response_Topic(String_View const & topic, Multiplexed_MQTT_Client * & channel);
+
+    /// @brief Forgets the subscriptions of the previous connection, unless the server still has its session, and notifies every channel that requested a connection
+    void On_Connect();
+
+    IMQTT_Client &                         m_client;                  // Client whose connection is shared
+    std::vector<Multiplexed_MQTT_Client *> m_channels = {};           // Attached channels
+    std::vector<Multiplexed_MQTT_Client *> m_fragment_channels = {};  // Channels that handle the fragments of the currently received message
+    std::vector<std::string>               m_subscriptions = {};      // Topic filters that are currently subscribed on the server
+    std::string                            m_request_topic = {};      // Topic of the last published request, with the request id translated into the request id space of its channel
+    std::string                            m_response_topic = {};     // Topic of the last received response, with the request id translated back into the request id space of its channel
+    std::vector<uint8_t>                   m_payload_copy = {};       // Unmodified copy of the received payload, if it is passed to multiple channels
+    std::vector<uint8_t>                   m_delivered_copy = {};     // Copy of the received payload, passed to every channel except the last one
+    std::string                            m_client_id = {};          // Client id of the current connection
+    std::string                            m_user_name = {};          // Username of the current connection
+    std::string                            m_password = {};           // Password of the current connection
+    bool                                   m_has_password = {};       // Whether the current connection was established with a password
+    bool                                   m_has_credentials = {};    // Whether the client has been connected before and the credentials above are valid
+    bool                                   m_fragments_enabled = {};  // Whether the fragment callback has been registered at the client
+    bool                                   m_fragmented_receive = {}; // Whether the client supports receiving messages in fragments
+    size_t                                 m_connection = {};         // Identifier of the currently established connection
+    size_t                                 m_unrouted_messages = {};  // Amount of received messages, that did not match the subscriptions of any channel
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // MQTT_Client_Multiplexer_h
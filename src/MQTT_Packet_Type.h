@@ -0,0 +1,27 @@
+#ifndef MQTT_Packet_Type_h
+#define MQTT_Packet_Type_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Control packet types of the MQTT 3.1.1 protocol, contained in the upper 4 bits of the first byte of every packet.
+/// See https://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718021 for more information on the meaning of each packet
+enum class MQTT_Packet_Type : uint8_t {
+    CONNECT = 1U,      ///< Client request to connect to the server
+    CONNACK = 2U,      ///< Connect acknowledgment, contains whether the connection was accepted
+    PUBLISH = 3U,      ///< Publish message, sent in both directions
+    PUBACK = 4U,       ///< Publish acknowledgment for messages published with QoS level 1
+    PUBREC = 5U,       ///< Publish received, first part of the QoS level 2 handshake
+    PUBREL = 6U,       ///< Publish release, second part of the QoS level 2 handshake
+    PUBCOMP = 7U,      ///< Publish complete, last part of the QoS level 2 handshake
+    SUBSCRIBE = 8U,    ///< Client subscribe request
+    SUBACK = 9U,       ///< Subscribe acknowledgment, contains the granted QoS level or a failure for every requested topic
+    UNSUBSCRIBE = 10U, ///< Client unsubscribe request
+    UNSUBACK = 11U,    ///< Unsubscribe acknowledgment
+    PINGREQ = 12U,     ///< Keep alive request of the client
+    PINGRESP = 13U,    ///< Keep alive response of the server
+    DISCONNECT = 14U   ///< Client is disconnecting gracefully
+};
+
+#endif // MQTT_Packet_Type_h
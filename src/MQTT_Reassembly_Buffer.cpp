@@ -0,0 +1,95 @@
+// Header include.
+#include "MQTT_Reassembly_Buffer.h"
+
+// Library includes.
+#include <stdlib.h>
+#include <string.h>
+
+
+MQTT_Reassembly_Buffer::MQTT_Reassembly_Buffer(size_t const & max_size)
+  : m_buffer(nullptr)
+  , m_capacity(0U)
+  , m_max_size(max_size)
+  , m_size(0U)
+  , m_received(0U)
+  , m_active(false)
+{
+    // Nothing to do
+}
+
+MQTT_Reassembly_Buffer::~MQTT_Reassembly_Buffer() {
+    free(m_buffer);
+}
+
+void MQTT_Reassembly_Buffer::Set_Max_Size(size_t const & max_size) {
+    m_max_size = max_size;
+}
+
+size_t MQTT_Reassembly_Buffer::Get_Max_Size() const {
+    return m_max_size;
+}
+
+size_t MQTT_Reassembly_Buffer::Get_Capacity() const {
+    return m_capacity;
+}
+
+bool MQTT_Reassembly_Buffer::Begin(size_t const & total_size) {
+    End();
+    if (total_size == 0U || total_size > m_max_size) {
+        return false;
+    }
+    if (total_size > m_capacity) {
+        // Contents do not have to be kept, therefore the previous memory is freed first, which allows the allocation to reuse it
+        free(m_buffer);
+        m_buffer = static_cast<uint8_t *>(malloc(total_size));
+        m_capacity = m_buffer != nullptr ? total_size : 0U;
+        if (m_buffer == nullptr) {
+            return false;
+        }
+    }
+    m_size = total_size;
+    m_received = 0U;
+    m_active = true;
+    return true;
+}
+
+bool MQTT_Reassembly_Buffer::Append(size_t const & offset, uint8_t const * data, size_t const & length) {
+    if (!m_active || offset != m_received || length > m_size - m_received) {
+        return false;
+    }
+    (void)memcpy(m_buffer + offset, data, length);
+    m_received += length;
+    return true;
+}
+
+bool MQTT_Reassembly_Buffer::Is_Active() const {
+    return m_active;
+}
+
+bool MQTT_Reassembly_Buffer::Is_Complete() const {
+    return m_active && m_received == m_size;
+}
+
+uint8_t * MQTT_Reassembly_Buffer::Get_Data() const {
+    return m_buffer;
+}
+
+size_t MQTT_Reassembly_Buffer::Get_Size() const {
+    return m_size;
+}
+
+void MQTT_Reassembly_Buffer::End() {
+    m_active = false;
+    m_size = 0U;
+    m_received = 0U;
+}
+
+bool MQTT_Reassembly_Buffer::Release() {
+    if (m_active) {
+        return false;
+    }
+    free(m_buffer);
+    m_buffer = nullptr;
+    m_capacity = 0U;
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef MQTT_Reassembly_Buffer_h
+#define MQTT_Reassembly_Buffer_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Buffer that the fragments of a received MQTT message, which is bigger than the receive buffer of the client, are copied into until the complete message has been received.
+/// The memory is kept between messages so it can be reused, and is only increased once a message bigger than every previous message is received, up to the configured maximum size.
+/// Because the buffer is only needed while big messages are received, it should be released once no message has been reassembled for a while, see Release()
+class MQTT_Reassembly_Buffer {
+  public:
+    /// @brief Constructs an empty buffer, that does not allocate any memory until the first message is reassembled
+    /// @param max_size Maximum size in bytes a reassembled message may have, bigger messages are discarded instead. 0 disables reassembling messages
+    explicit MQTT_Reassembly_Buffer(size_t const & max_size);
+
+    /// @brief Destructor, frees the memory of the buffer
+    ~MQTT_Reassembly_Buffer();
+
+    MQTT_Reassembly_Buffer(MQTT_Reassembly_Buffer const &) = delete;
+
+    MQTT_Reassembly_Buffer & operator=(MQTT_Reassembly_Buffer const &) = delete;
+
+    /// @brief Sets the maximum size in bytes a reassembled message may have, does not shrink memory that has already been allocated before the buffer is released
+    /// @param max_size Maximum size in bytes a reassembled message may have, bigger messages are discarded instead. 0 disables reassembling messages
+    void Set_Max_Size(size_t const & max_size);
+
+    /// @brief Gets the maximum size in bytes a reassembled message may have
+    /// @return Maximum size in bytes a reassembled message may have
+    size_t Get_Max_Size() const;
+
+    /// @brief Gets the amount of bytes currently allocated for the buffer
+    /// @return Amount of allocated bytes, 0 if the buffer has been released
+    size_t Get_Capacity() const;
+
+    /// @brief Starts reassembling a new message with the given size, discards the message that is currently reassembled if there is any.
+    /// Increases the allocated memory if it can not hold the complete message
+    /// @param total_size Amount of bytes in the complete message
+    /// @return Whether the message can be reassembled, fails if it is bigger than the maximum size or if increasing the allocated memory failed
+    bool Begin(size_t const & total_size);
+
+    /// @brief Copies the given fragment into the buffer, fragments have to be added in order without any gaps
+    /// @param offset Byte offset of the fragment in the complete message, has to be the amount of bytes added so far
+    /// @param data Data of the fragment
+    /// @param length Amount of bytes in the fragment
+    /// @return Whether the fragment was added, fails if no message is reassembled, the offset is not the next expected one or the fragment exceeds the size of the complete message
+    bool Append(size_t const & offset, uint8_t const * data, size_t const & length);
+
+    /// @brief Whether a message is currently reassembled
+    /// @return Whether Begin() has been called and End() has not been called since
+    bool Is_Active() const;
+
+    /// @brief Whether all fragments of the message that is currently reassembled have been added
+    /// @return Whether the message is complete and can be processed
+    bool Is_Complete() const;
+
+    /// @brief Gets the reassembled message, only contains the complete message once Is_Complete() returns true
+    /// @return Pointer to the first byte of the message
+    uint8_t * Get_Data() const;
+
+    /// @brief Gets the amount of bytes in the message that is currently reassembled
+    /// @return Amount of bytes in the complete message
+    size_t Get_Size() const;
+
+    /// @brief Stops reassembling the current message, either because it has been processed or because it is discarded. Keeps the allocated memory for the next message
+    void End();
+
+    /// @brief Frees the allocated memory, if no message is currently reassembled
+    /// @return Whether the memory has been freed, fails if a message is currently reassembled
+    bool Release();
+
+  private:
+    uint8_t *m_buffer = {};   // Memory the fragments of the current message are copied into
+    size_t   m_capacity = {}; // Amount of allocated bytes
+    size_t   m_max_size = {}; // Maximum size in bytes a reassembled message may have
+    size_t   m_size = {};     // Amount of bytes in the message that is currently reassembled
+    size_t   m_received = {}; // Amount of bytes of the current message that have already been added
+    bool     m_active = {};   // Whether a message is currently reassembled
+};
+
+#endif // MQTT_Reassembly_Buffer_h
@@ -0,0 +1,199 @@
+// Header include.
+#include "Multiplexed_MQTT_Client.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local include.
+#include "Helper.h"
+
+// Library include.
+#include <algorithm>
+
+
+Multiplexed_MQTT_Client::Multiplexed_MQTT_Client(MQTT_Client_Multiplexer & multiplexer)
+  : m_multiplexer(multiplexer)
+  , m_received_data_callback()
+  , m_received_data_view_callback()
+  , m_receive_data_views(false)
+  , m_received_fragment_callback()
+  , m_receive_fragments(false)
+  , m_connected_callback()
+  , m_subscriptions()
+  , m_topic()
+  , m_wants_connection(false)
+  , m_connection(0U)
+  , m_receive_buffer_size(0U)
+  , m_send_buffer_size(0U)
+  , m_request_id_slot(MULTIPLEXER_REQUEST_ID_STRIDE)
+{
+    m_request_id_slot = m_multiplexer.Attach(*this);
+}
+
+Multiplexed_MQTT_Client::~Multiplexed_MQTT_Client() {
+    m_wants_connection = false;
+    m_subscriptions.clear();
+    m_multiplexer.Detach(*this);
+}
+
+void Multiplexed_MQTT_Client::set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) {
+    m_received_data_callback.Set_Callback(callback);
+}
+
+bool Multiplexed_MQTT_Client::set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function callback) {
+    m_received_data_view_callback.Set_Callback(callback);
+    m_receive_data_views = callback != nullptr;
+    return true;
+}
+
+bool Multiplexed_MQTT_Client::set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function callback) {
+    m_received_fragment_callback.Set_Callback(callback);
+    m_receive_fragments = callback != nullptr;
+    return m_multiplexer.Enable_Fragments();
+}
+
+void Multiplexed_MQTT_Client::set_connect_callback(Callback<void>::function callback) {
+    m_connected_callback.Set_Callback(callback);
+}
+
+bool Multiplexed_MQTT_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    m_receive_buffer_size = receive_buffer_size;
+    m_send_buffer_size = send_buffer_size;
+    return m_multiplexer.Apply_Buffer_Size();
+}
+
+uint16_t Multiplexed_MQTT_Client::get_receive_buffer_size() {
+    return m_multiplexer.Get_Client().get_receive_buffer_size();
+}
+
+uint16_t Multiplexed_MQTT_Client::get_send_buffer_size() {
+    return m_multiplexer.Get_Client().get_send_buffer_size();
+}
+
+void Multiplexed_MQTT_Client::set_server(char const * domain, uint16_t port) {
+    m_multiplexer.Get_Client().set_server(domain, port);
+}
+
+bool Multiplexed_MQTT_Client::connect(char const * client_id, char const * user_name, char const * password) {
+    m_wants_connection = true;
+    return m_multiplexer.Connect(*this, client_id, user_name, password);
+}
+
+bool Multiplexed_MQTT_Client::set_clean_session(bool clean_session) {
+    return m_multiplexer.Get_Client().set_clean_session(clean_session);
+}
+
+bool Multiplexed_MQTT_Client::get_session_present() {
+    return m_multiplexer.Get_Client().get_session_present();
+}
+
+void Multiplexed_MQTT_Client::disconnect() {
+    m_wants_connection = false;
+    m_multiplexer.Disconnect();
+}
+
+bool Multiplexed_MQTT_Client::loop() {
+    return m_multiplexer.Get_Client().loop();
+}
+
+bool Multiplexed_MQTT_Client::publish(char const * topic, uint8_t const * payload, size_t const & length) {
+    return m_multiplexer.Get_Client().publish(m_multiplexer.Translate_Request_Topic(m_request_id_slot, topic), payload, length);
+}
+
+bool Multiplexed_MQTT_Client::publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) {
+    return m_multiplexer.Get_Client().publish_segments(m_multiplexer.Translate_Request_Topic(m_request_id_slot, topic), segments, segment_count);
+}
+
+bool Multiplexed_MQTT_Client::subscribe(char const * topic) {
+    if (!m_multiplexer.Subscribe(topic)) {
+        return false;
+    }
+    else if (!Has_Subscription(topic)) {
+        m_subscriptions.emplace_back(topic);
+    }
+    return true;
+}
+
+bool Multiplexed_MQTT_Client::unsubscribe(char const * topic) {
+    auto const it = topic != nullptr ? std::find(m_subscriptions.begin(), m_subscriptions.end(), topic) : m_subscriptions.end();
+    if (it == m_subscriptions.end()) {
+        return false;
+    }
+    bool const result = m_multiplexer.Unsubscribe(*this, topic);
+    m_subscriptions.erase(it);
+    return result;
+}
+
+bool Multiplexed_MQTT_Client::connected() {
+    return m_wants_connection && m_multiplexer.Get_Client().connected();
+}
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+bool Multiplexed_MQTT_Client::begin_publish(char const * topic, size_t const & length) {
+    return m_multiplexer.Get_Client().begin_publish(m_multiplexer.Translate_Request_Topic(m_request_id_slot, topic), length);
+}
+
+bool Multiplexed_MQTT_Client::end_publish() {
+    return m_multiplexer.Get_Client().end_publish();
+}
+
+size_t Multiplexed_MQTT_Client::write(uint8_t payload_byte) {
+    return m_multiplexer.Get_Client().write(payload_byte);
+}
+
+size_t Multiplexed_MQTT_Client::write(uint8_t const * buffer, size_t const & size) {
+    return m_multiplexer.Get_Client().write(buffer, size);
+}
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+bool Multiplexed_MQTT_Client::Is_Subscribed(String_View const & topic) const {
+    return std::any_of(m_subscriptions.cbegin(), m_subscriptions.cend(), [&topic](std::string const & filter) { return Helper::topicMatches(String_View(filter.data(), filter.size()), topic); });
+}
+
+bool Multiplexed_MQTT_Client::Has_Subscription(char const * topic) const {
+    return topic != nullptr && std::find(m_subscriptions.cbegin(), m_subscriptions.cend(), topic) != m_subscriptions.cend();
+}
+
+bool Multiplexed_MQTT_Client::Wants_Connection() const {
+    return m_wants_connection;
+}
+
+bool Multiplexed_MQTT_Client::Receives_Fragments() const {
+    return m_receive_fragments;
+}
+
+uint16_t Multiplexed_MQTT_Client::Get_Requested_Receive_Size() const {
+    return m_receive_buffer_size;
+}
+
+uint16_t Multiplexed_MQTT_Client::Get_Requested_Send_Size() const {
+    return m_send_buffer_size;
+}
+
+size_t const & Multiplexed_MQTT_Client::Get_Request_Id_Slot() const {
+    return m_request_id_slot;
+}
+
+void Multiplexed_MQTT_Client::Deliver(String_View const & topic, uint8_t * payload, unsigned int const & length) {
+    if (m_receive_data_views) {
+        m_received_data_view_callback.Call_Callback(topic, payload, length);
+        return;
+    }
+    m_topic.assign(topic.data(), topic.size());
+    m_received_data_callback.Call_Callback(&m_topic[0], payload, length);
+}
+
+bool Multiplexed_MQTT_Client::Deliver_Fragment(String_View const & topic, uint8_t * payload, size_t const & offset, size_t const & length, size_t const & total_length) {
+    return m_received_fragment_callback.Call_Callback(topic, payload, offset, length, total_length);
+}
+
+void Multiplexed_MQTT_Client::Connected(size_t const & connection) {
+    if (m_connection == connection) {
+        return;
+    }
+    m_connection = connection;
+    m_connected_callback.Call_Callback();
+}
+
+#endif // THINGSBOARD_ENABLE_STL
@@ -0,0 +1,152 @@
+#ifndef Multiplexed_MQTT_Client_h
+#define Multiplexed_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "MQTT_Client_Multiplexer.h"
+
+// Library includes.
+#include <string>
+#include <vector>
+
+
+/// @brief MQTT Client interface implementation that represents one of multiple ThingsBoard clients sharing the connection of the client owned by the given MQTT_Client_Multiplexer.
+/// Keeps the callbacks, subscriptions and requested buffer sizes of the ThingsBoard client it is passed to, while publishing, connecting and receiving is forwarded to the shared client.
+/// Messages are only passed to this channel if it subscribed a topic filter matching their topic, which means a topic subscribed by multiple channels is passed to each of them, except responses to requests this channel published, which are only passed to this channel.
+/// Therefore the request ids of published topics are translated into the request id space of this channel and back again in the topics of the received responses.
+/// Connecting with the same credentials as another channel reuses the established connection, whereas disconnecting only closes it, once no other channel is connected anymore
+class Multiplexed_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs the channel and attaches it to the given multiplexer
+    /// @param multiplexer Multiplexer whose client connection is shared, has to stay valid for as long as this instance exists
+    explicit Multiplexed_MQTT_Client(MQTT_Client_Multiplexer & multiplexer);
+
+    /// @brief Destructor, detaches the channel from the multiplexer, which releases its subscriptions and closes the connection if no other channel needs it anymore
+    ~Multiplexed_MQTT_Client();
+
+    Multiplexed_MQTT_Client(Multiplexed_MQTT_Client const &) = delete;
+
+    Multiplexed_MQTT_Client & operator=(Multiplexed_MQTT_Client const &) = delete;
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override;
+
+    bool set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function callback) override;
+
+    bool set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function callback) override;
+
+    void set_connect_callback(Callback<void>::function callback) override;
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override;
+
+    uint16_t get_receive_buffer_size() override;
+
+    uint16_t get_send_buffer_size() override;
+
+    void set_server(char const * domain, uint16_t port) override;
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override;
+
+    bool set_clean_session(bool clean_session) override;
+
+    bool get_session_present() override;
+
+    void disconnect() override;
+
+    bool loop() override;
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
+
+    bool publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) override;
+
+    bool subscribe(char const * topic) override;
+
+    bool unsubscribe(char const * topic) override;
+
+    bool connected() override;
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override;
+
+    bool end_publish() override;
+
+    size_t write(uint8_t payload_byte) override;
+
+    size_t write(uint8_t const * buffer, size_t const & size) override;
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+    /// @brief Whether any topic filter subscribed by this channel matches the given topic
+    /// @param topic Topic of a received message
+    /// @return Whether the message should be passed to this channel
+    bool Is_Subscribed(String_View const & topic) const;
+
+    /// @brief Whether this channel subscribed exactly the given topic filter
+    /// @param topic Topic filter that should be checked
+    /// @return Whether the given topic filter is subscribed by this channel
+    bool Has_Subscription(char const * topic) const;
+
+    /// @brief Whether this channel requested a connection with connect() and did not call disconnect() since
+    /// @return Whether the channel requests a connection
+    bool Wants_Connection() const;
+
+    /// @brief Whether this channel set a fragment callback and therefore receives messages bigger than the receive buffer in fragments
+    /// @return Whether the channel receives fragments
+    bool Receives_Fragments() const;
+
+    /// @brief Gets the size of the receive buffer requested by this channel
+    /// @return Requested receive buffer size
+    uint16_t Get_Requested_Receive_Size() const;
+
+    /// @brief Gets the size of the send buffer requested by this channel
+    /// @return Requested send buffer size
+    uint16_t Get_Requested_Send_Size() const;
+
+    /// @brief Gets the slot of the request id space of this channel, assigned by the multiplexer once the channel is attached
+    /// @return Slot of the request id space
+    size_t const & Get_Request_Id_Slot() const;
+
+    /// @brief Passes a received message to the data callback of this channel
+    /// @param topic Topic the message was received over
+    /// @param payload Payload of the received message
+    /// @param length Amount of bytes in the payload
+    void Deliver(String_View const & topic, uint8_t * payload, unsigned int const & length);
+
+    /// @brief Passes a received fragment to the fragment callback of this channel
+    /// @param topic Topic the message was received over
+    /// @param payload Payload data of the fragment
+    /// @param offset Offset of the fragment in the complete payload
+    /// @param length Amount of bytes in the fragment
+    /// @param total_length Amount of bytes in the complete payload
+    /// @return Whether the channel handles the message, only evaluated for the first fragment
+    bool Deliver_Fragment(String_View const & topic, uint8_t * payload, size_t const & offset, size_t const & length, size_t const & total_length);
+
+    /// @brief Calls the connect callback of this channel, if it has not been called for the given connection yet
+    /// @param connection Identifier of the established connection
+    void Connected(size_t const & connection);
+
+  private:
+    MQTT_Client_Multiplexer &                                              m_multiplexer;                      // Multiplexer whose client connection is shared
+    Callback<void, char *, uint8_t *, unsigned int>                        m_received_data_callback = {};      // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, String_View const &, uint8_t *, unsigned int>           m_received_data_view_callback = {}; // Callback that will be called instead of the data callback, with the topic as a view
+    bool                                                                   m_receive_data_views = {};          // Whether the data view callback has been set and is used instead of the data callback
+    Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t> m_received_fragment_callback = {};  // Callback that will be called for every fragment of a message bigger than the receive buffer
+    bool                                                                   m_receive_fragments = {};           // Whether the fragment callback has been set
+    Callback<void>                                                         m_connected_callback = {};          // Callback that will be called as soon as the shared connection has been established
+    std::vector<std::string>                                               m_subscriptions = {};               // Topic filters subscribed by this channel
+    std::string                                                            m_topic = {};                       // Null terminated copy of the topic passed to the data callback
+    bool                                                                   m_wants_connection = {};            // Whether connect() has been called without a following call to disconnect()
+    size_t                                                                 m_connection = {};                  // Identifier of the last connection the connect callback has been called for
+    uint16_t                                                               m_receive_buffer_size = {};         // Requested size of the receive buffer
+    uint16_t                                                               m_send_buffer_size = {};            // Requested size of the send buffer
+    size_t                                                                 m_request_id_slot = {};             // Slot of the request id space of this channel, request ids are multiplied by MULTIPLEXER_REQUEST_ID_STRIDE and offset by it
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Multiplexed_MQTT_Client_h
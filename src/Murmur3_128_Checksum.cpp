@@ -0,0 +1,155 @@
+// Header include.
+#include "Murmur3_128_Checksum.h"
+
+// Library include.
+#include <string.h>
+
+
+// Constants of the x64_128 variant
+uint64_t constexpr MURMUR3_128_C1 = 0x87C37B91114253D5ULL;
+uint64_t constexpr MURMUR3_128_C2 = 0x4CF5AD432745937FULL;
+size_t constexpr MURMUR3_128_BLOCK_SIZE = 16U;
+
+/// @brief Rotates the given value to the left
+/// @param value Value that should be rotated
+/// @param bits Amount of bits to rotate by, has to be between 1 and 63
+/// @return Rotated value
+static inline uint64_t rotate_left_64(uint64_t const & value, uint8_t const & bits) {
+    return (value << bits) | (value >> (64U - bits));
+}
+
+/// @brief Reads the given amount of bytes as a little endian value, independent of the alignment of the data and the endianness of the device
+/// @param data Pointer to the first byte
+/// @param length Amount of bytes to read, has to be between 0 and 8
+/// @return Little endian value of the given bytes
+static inline uint64_t read_little_endian_64(uint8_t const * data, size_t const & length) {
+    uint64_t value = 0U;
+    for (size_t i = length; i > 0U; i--) {
+        value = (value << 8U) | data[i - 1U];
+    }
+    return value;
+}
+
+/// @brief Finalization mix, forces all bits of a lane to avalanche
+/// @param k Lane that should be mixed
+/// @return Mixed lane
+static inline uint64_t final_mix_64(uint64_t k) {
+    k ^= k >> 33U;
+    k *= 0xFF51AFD7ED558CCDULL;
+    k ^= k >> 33U;
+    k *= 0xC4CEB9FE1A85EC53ULL;
+    k ^= k >> 33U;
+    return k;
+}
+
+bool Murmur3_128_Checksum::start() {
+    m_state = State();
+    return true;
+}
+
+bool Murmur3_128_Checksum::update(uint8_t const * data, size_t const & length) {
+    size_t remaining = length;
+    m_state.total_length += length;
+    // Complete the block started by the previous call first
+    while (m_state.tail_length != 0U && remaining > 0U) {
+        m_state.tail[m_state.tail_length++] = *data++;
+        remaining--;
+        if (m_state.tail_length == MURMUR3_128_BLOCK_SIZE) {
+            Process_Block(m_state.tail);
+            m_state.tail_length = 0U;
+        }
+    }
+    while (remaining >= MURMUR3_128_BLOCK_SIZE) {
+        Process_Block(data);
+        data += MURMUR3_128_BLOCK_SIZE;
+        remaining -= MURMUR3_128_BLOCK_SIZE;
+    }
+    while (remaining > 0U) {
+        m_state.tail[m_state.tail_length++] = *data++;
+        remaining--;
+    }
+    return true;
+}
+
+bool Murmur3_128_Checksum::finish(uint8_t * result) {
+    uint64_t h1 = m_state.h1;
+    uint64_t h2 = m_state.h2;
+    size_t const tail_length = m_state.tail_length;
+    if (tail_length > 8U) {
+        uint64_t k2 = read_little_endian_64(m_state.tail + 8U, tail_length - 8U);
+        k2 *= MURMUR3_128_C2;
+        k2 = rotate_left_64(k2, 33U);
+        k2 *= MURMUR3_128_C1;
+        h2 ^= k2;
+    }
+    if (tail_length > 0U) {
+        uint64_t k1 = read_little_endian_64(m_state.tail, tail_length > 8U ? 8U : tail_length);
+        k1 *= MURMUR3_128_C1;
+        k1 = rotate_left_64(k1, 31U);
+        k1 *= MURMUR3_128_C2;
+        h1 ^= k1;
+    }
+
+    h1 ^= m_state.total_length;
+    h2 ^= m_state.total_length;
+    h1 += h2;
+    h2 += h1;
+    h1 = final_mix_64(h1);
+    h2 = final_mix_64(h2);
+    h1 += h2;
+    h2 += h1;
+    for (size_t i = 0U; i < sizeof(h1); i++) {
+        result[i] = static_cast<uint8_t>(h1 >> (i * 8U));
+        result[sizeof(h1) + i] = static_cast<uint8_t>(h2 >> (i * 8U));
+    }
+    return true;
+}
+
+void Murmur3_128_Checksum::stop() {
+    // Nothing to do
+}
+
+size_t Murmur3_128_Checksum::get_size() const {
+    return MURMUR3_128_BLOCK_SIZE;
+}
+
+size_t Murmur3_128_Checksum::get_context_size() const {
+    return sizeof(m_state);
+}
+
+bool Murmur3_128_Checksum::save(uint8_t * context, size_t const & context_size) const {
+    if (context == nullptr || context_size < sizeof(m_state)) {
+        return false;
+    }
+    (void)memcpy(context, &m_state, sizeof(m_state));
+    return true;
+}
+
+bool Murmur3_128_Checksum::restore(uint8_t const * context, size_t const & context_size) {
+    if (context == nullptr || context_size != sizeof(m_state)) {
+        return false;
+    }
+    (void)memcpy(&m_state, context, sizeof(m_state));
+    return m_state.tail_length < MURMUR3_128_BLOCK_SIZE;
+}
+
+void Murmur3_128_Checksum::Process_Block(uint8_t const * block) {
+    uint64_t k1 = read_little_endian_64(block, 8U);
+    uint64_t k2 = read_little_endian_64(block + 8U, 8U);
+
+    k1 *= MURMUR3_128_C1;
+    k1 = rotate_left_64(k1, 31U);
+    k1 *= MURMUR3_128_C2;
+    m_state.h1 ^= k1;
+    m_state.h1 = rotate_left_64(m_state.h1, 27U);
+    m_state.h1 += m_state.h2;
+    m_state.h1 = (m_state.h1 * 5U) + 0x52DCE729U;
+
+    k2 *= MURMUR3_128_C2;
+    k2 = rotate_left_64(k2, 33U);
+    k2 *= MURMUR3_128_C1;
+    m_state.h2 ^= k2;
+    m_state.h2 = rotate_left_64(m_state.h2, 31U);
+    m_state.h2 += m_state.h1;
+    m_state.h2 = (m_state.h2 * 5U) + 0x38495AB5U;
+}
@@ -0,0 +1,52 @@
+#ifndef Murmur3_128_Checksum_h
+#define Murmur3_128_Checksum_h
+
+// Local includes.
+#include "Configuration.h"
+#include "IChecksum.h"
+
+
+/// @brief IChecksum implementation which calculates the 128 bit MurmurHash3 (x64_128 variant, https://github.com/aappleby/smhasher) with seed 0.
+/// Processes 16 bytes per step as two interleaved 64 bit lanes with only multiplications, rotations and xors, meaning it does not require any tables
+/// and is considerably cheaper per byte than the cryptographic hashes, especially on 64 bit devices.
+/// Bytes that do not fill a complete block yet are kept until the next call to update(), so the data can be split into parts of any size.
+/// The result is printed as the little endian bytes of the first lane followed by the little endian bytes of the second lane, the same as the HashCode of Guava the server calculates the checksum with
+class Murmur3_128_Checksum : public IChecksum {
+  public:
+    /// @brief Constructor
+    Murmur3_128_Checksum() = default;
+
+    bool start() override;
+
+    bool update(uint8_t const * data, size_t const & length) override;
+
+    bool finish(uint8_t * result) override;
+
+    void stop() override;
+
+    size_t get_size() const override;
+
+    size_t get_context_size() const override;
+
+    bool save(uint8_t * context, size_t const & context_size) const override;
+
+    bool restore(uint8_t const * context, size_t const & context_size) override;
+
+  private:
+    /// @brief Intermediate state of the calculation, serialized as raw memory
+    struct State {
+        uint64_t h1 = {};           // First lane of the hash over all complete blocks passed so far
+        uint64_t h2 = {};           // Second lane of the hash over all complete blocks passed so far
+        uint64_t total_length = {}; // Amount of bytes passed so far
+        uint8_t  tail[16U] = {};    // Bytes that do not fill a complete block yet
+        uint8_t  tail_length = {};  // Amount of valid bytes in the tail
+    };
+
+    /// @brief Mixes the given complete block into the hash
+    /// @param block Pointer to the 16 bytes of the block
+    void Process_Block(uint8_t const * block);
+
+    State m_state = {}; // Intermediate state of the calculation
+};
+
+#endif // Murmur3_128_Checksum_h
@@ -0,0 +1,117 @@
+// Header include.
+#include "Murmur3_32_Checksum.h"
+
+// Library include.
+#include <string.h>
+
+
+// Constants of the x86_32 variant
+uint32_t constexpr MURMUR3_32_C1 = 0xCC9E2D51U;
+uint32_t constexpr MURMUR3_32_C2 = 0x1B873593U;
+size_t constexpr MURMUR3_32_BLOCK_SIZE = 4U;
+
+/// @brief Rotates the given value to the left
+/// @param value Value that should be rotated
+/// @param bits Amount of bits to rotate by, has to be between 1 and 31
+/// @return Rotated value
+static inline uint32_t rotate_left_32(uint32_t const & value, uint8_t const & bits) {
+    return (value << bits) | (value >> (32U - bits));
+}
+
+/// @brief Scrambles a single block, or the remaining tail bytes, before it is mixed into the hash
+/// @param k1 Little endian value of the block
+/// @return Scrambled value
+static inline uint32_t scramble_32(uint32_t k1) {
+    k1 *= MURMUR3_32_C1;
+    k1 = rotate_left_32(k1, 15U);
+    k1 *= MURMUR3_32_C2;
+    return k1;
+}
+
+bool Murmur3_32_Checksum::start() {
+    m_state = State();
+    return true;
+}
+
+bool Murmur3_32_Checksum::update(uint8_t const * data, size_t const & length) {
+    size_t remaining = length;
+    m_state.total_length += static_cast<uint32_t>(length);
+    // Complete the block started by the previous call first
+    while (m_state.tail_length != 0U && remaining > 0U) {
+        m_state.tail[m_state.tail_length++] = *data++;
+        remaining--;
+        if (m_state.tail_length == MURMUR3_32_BLOCK_SIZE) {
+            Process_Block(static_cast<uint32_t>(m_state.tail[0]) | (static_cast<uint32_t>(m_state.tail[1]) << 8U) |
+                (static_cast<uint32_t>(m_state.tail[2]) << 16U) | (static_cast<uint32_t>(m_state.tail[3]) << 24U));
+            m_state.tail_length = 0U;
+        }
+    }
+    while (remaining >= MURMUR3_32_BLOCK_SIZE) {
+        Process_Block(static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U) |
+            (static_cast<uint32_t>(data[2]) << 16U) | (static_cast<uint32_t>(data[3]) << 24U));
+        data += MURMUR3_32_BLOCK_SIZE;
+        remaining -= MURMUR3_32_BLOCK_SIZE;
+    }
+    while (remaining > 0U) {
+        m_state.tail[m_state.tail_length++] = *data++;
+        remaining--;
+    }
+    return true;
+}
+
+bool Murmur3_32_Checksum::finish(uint8_t * result) {
+    uint32_t h1 = m_state.h1;
+    uint32_t k1 = 0U;
+    for (uint8_t i = m_state.tail_length; i > 0U; i--) {
+        k1 ^= static_cast<uint32_t>(m_state.tail[i - 1U]) << ((i - 1U) * 8U);
+    }
+    if (m_state.tail_length != 0U) {
+        h1 ^= scramble_32(k1);
+    }
+
+    // Finalization mix forces all bits of the hash to avalanche
+    h1 ^= m_state.total_length;
+    h1 ^= h1 >> 16U;
+    h1 *= 0x85EBCA6BU;
+    h1 ^= h1 >> 13U;
+    h1 *= 0xC2B2AE35U;
+    h1 ^= h1 >> 16U;
+    for (size_t i = 0U; i < sizeof(h1); i++) {
+        result[i] = static_cast<uint8_t>(h1 >> (i * 8U));
+    }
+    return true;
+}
+
+void Murmur3_32_Checksum::stop() {
+    // Nothing to do
+}
+
+size_t Murmur3_32_Checksum::get_size() const {
+    return sizeof(uint32_t);
+}
+
+size_t Murmur3_32_Checksum::get_context_size() const {
+    return sizeof(m_state);
+}
+
+bool Murmur3_32_Checksum::save(uint8_t * context, size_t const & context_size) const {
+    if (context == nullptr || context_size < sizeof(m_state)) {
+        return false;
+    }
+    (void)memcpy(context, &m_state, sizeof(m_state));
+    return true;
+}
+
+bool Murmur3_32_Checksum::restore(uint8_t const * context, size_t const & context_size) {
+    if (context == nullptr || context_size != sizeof(m_state)) {
+        return false;
+    }
+    (void)memcpy(&m_state, context, sizeof(m_state));
+    return m_state.tail_length < MURMUR3_32_BLOCK_SIZE;
+}
+
+void Murmur3_32_Checksum::Process_Block(uint32_t const & block) {
+    m_state.h1 ^= scramble_32(block);
+    m_state.h1 = rotate_left_32(m_state.h1, 13U);
+    m_state.h1 = (m_state.h1 * 5U) + 0xE6546B64U;
+}
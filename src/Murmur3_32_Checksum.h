@@ -0,0 +1,50 @@
+#ifndef Murmur3_32_Checksum_h
+#define Murmur3_32_Checksum_h
+
+// Local includes.
+#include "Configuration.h"
+#include "IChecksum.h"
+
+
+/// @brief IChecksum implementation which calculates the 32 bit MurmurHash3 (x86_32 variant, https://github.com/aappleby/smhasher) with seed 0.
+/// Processes 4 bytes per step with only multiplications, rotations and xors, meaning it does not require any tables and is considerably cheaper per byte than the cryptographic hashes.
+/// Bytes that do not fill a complete block yet are kept until the next call to update(), so the data can be split into parts of any size.
+/// The result is printed as the little endian bytes of the hash, the same as the HashCode of Guava the server calculates the checksum with
+class Murmur3_32_Checksum : public IChecksum {
+  public:
+    /// @brief Constructor
+    Murmur3_32_Checksum() = default;
+
+    bool start() override;
+
+    bool update(uint8_t const * data, size_t const & length) override;
+
+    bool finish(uint8_t * result) override;
+
+    void stop() override;
+
+    size_t get_size() const override;
+
+    size_t get_context_size() const override;
+
+    bool save(uint8_t * context, size_t const & context_size) const override;
+
+    bool restore(uint8_t const * context, size_t const & context_size) override;
+
+  private:
+    /// @brief Intermediate state of the calculation, serialized as raw memory
+    struct State {
+        uint32_t h1 = {};           // Hash over all complete blocks passed so far
+        uint32_t total_length = {}; // Amount of bytes passed so far, the hash only includes the lower 32 bits
+        uint8_t  tail[4U] = {};     // Bytes that do not fill a complete block yet
+        uint8_t  tail_length = {};  // Amount of valid bytes in the tail
+    };
+
+    /// @brief Mixes the given complete block into the hash
+    /// @param block Little endian value of the block
+    void Process_Block(uint32_t const & block);
+
+    State m_state = {}; // Intermediate state of the calculation
+};
+
+#endif // Murmur3_32_Checksum_h
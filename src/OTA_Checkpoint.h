@@ -0,0 +1,35 @@
+#ifndef OTA_Checkpoint_h
+#define OTA_Checkpoint_h
+
+// Local includes.
+#include "HashGenerator.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// caps for cached firmware identity (adjust to your needs)
+static constexpr size_t MAX_FW_TITLE_LEN = 96;
+static constexpr size_t MAX_FW_VERSION_LEN = 48;
+// Identifies a persisted checkpoint and its layout, has to be changed whenever the layout of the structure changes, so outdated checkpoints are ignored
+uint32_t constexpr OTA_CHECKPOINT_MAGIC = 0x54424332U;
+
+
+/// @brief Progress of an over the air firmware update that has been persisted, allows to resume the update after a disconnect or reboot,
+/// instead of having to download the complete firmware binary again. Contains the identity of the firmware binary, which has to be the same for the update to be resumed,
+/// as well as the amount of already written bytes and the serialized context of the hash calculation over exactly those bytes.
+/// Is persisted as raw memory, meaning it can only be restored by a device running the same build of the library
+struct OTA_Checkpoint {
+    uint32_t           magic = {};                               // Always OTA_CHECKPOINT_MAGIC, used to detect uninitalized or outdated persisted checkpoints
+    char               fw_title[MAX_FW_TITLE_LEN] = {};          // Title of the firmware binary that is being downloaded
+    char               fw_version[MAX_FW_VERSION_LEN] = {};      // Version of the firmware binary that is being downloaded
+    char               fw_checksum[FIRMWARE_HASH_SIZE] = {};     // Checksum of the complete firmware binary
+    Checksum_Algorithm fw_checksum_algorithm = {};               // Algorithm type used to hash the firmware binary
+    size_t             fw_size = {};                             // Total size of the firmware binary
+    size_t             written_bytes = {};                       // Amount of bytes of the firmware binary that have been written, before the checkpoint was created
+    size_t             hash_context_size = {};                   // Amount of valid bytes in the serialized hash context
+    uint8_t            hash_context[HASH_CONTEXT_MAX_SIZE] = {}; // Serialized hash context over all written bytes, see HashGenerator::save()
+};
+
+#endif // OTA_Checkpoint_h
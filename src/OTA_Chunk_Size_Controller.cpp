@@ -0,0 +1,155 @@
+// Header include.
+#include "OTA_Chunk_Size_Controller.h"
+
+// Local includes.
+#include "Helper.h"
+
+void OTA_Chunk_Size_Controller::Start(size_t const & chunk_size, size_t const & minimum_chunk_size, size_t const & maximum_chunk_size, uint64_t const & timeout_microseconds) {
+    m_minimum_chunk_size = minimum_chunk_size > 0U ? Round_Down_Power_Of_Two(minimum_chunk_size) : 0U;
+    m_maximum_chunk_size = maximum_chunk_size > 0U ? Round_Down_Power_Of_Two(maximum_chunk_size) : 0U;
+    m_adaptive = m_minimum_chunk_size > 0U && m_minimum_chunk_size < m_maximum_chunk_size;
+    m_chunk_size = chunk_size;
+    if (m_adaptive) {
+        size_t clamped_chunk_size = chunk_size;
+        if (clamped_chunk_size < m_minimum_chunk_size) {
+            clamped_chunk_size = m_minimum_chunk_size;
+        }
+        else if (clamped_chunk_size > m_maximum_chunk_size) {
+            clamped_chunk_size = m_maximum_chunk_size;
+        }
+        m_chunk_size = Round_Down_Power_Of_Two(clamped_chunk_size);
+    }
+    m_timeout = timeout_microseconds;
+    m_growth_blocked = false;
+    m_shrink_pending = false;
+    m_timing = false;
+    m_round_trip_time = 0U;
+    m_previous_goodput = 0U;
+    m_epoch_start_time = Helper::getTimeMicroseconds();
+    m_epoch_written_bytes = 0U;
+    m_epoch_written_chunks = 0U;
+}
+
+bool OTA_Chunk_Size_Controller::Is_Adaptive() const {
+    return m_adaptive;
+}
+
+size_t const & OTA_Chunk_Size_Controller::Get_Chunk_Size() const {
+    return m_chunk_size;
+}
+
+size_t OTA_Chunk_Size_Controller::Get_Desired_Chunk_Size(size_t const & offset, size_t const & request_window) const {
+    if (!m_adaptive) {
+        return m_chunk_size;
+    }
+
+    size_t const smaller_chunk_size = m_chunk_size / 2U;
+    if (m_shrink_pending || m_round_trip_time > (m_timeout / 2U)) {
+        return smaller_chunk_size >= m_minimum_chunk_size ? smaller_chunk_size : m_chunk_size;
+    }
+
+    size_t const bigger_chunk_size = m_chunk_size * 2U;
+    if (m_growth_blocked || bigger_chunk_size > m_maximum_chunk_size || m_epoch_written_chunks < CHUNK_SIZE_SAMPLES || m_round_trip_time == 0U) {
+        return m_chunk_size;
+    }
+    // The server calculates the offset of the chunk by multiplying the index with the size, therefore the offset has to be a multiple of the new size
+    if ((offset % bigger_chunk_size) != 0U) {
+        return m_chunk_size;
+    }
+    // Transmitting a chunk twice the size takes up to twice as long on a bandwidth limited connection, therefore the round trip time is expected to stay below the timeout with some margin
+    if ((m_round_trip_time * 2U) > (m_timeout / 2U)) {
+        return m_chunk_size;
+    }
+    // Bigger chunks increase the receive buffer of the client as well as every slot of the reorder buffer
+    size_t const additional_heap = (bigger_chunk_size - m_chunk_size) * request_window;
+    size_t const free_heap = Helper::getFreeHeapSize();
+    if (free_heap < additional_heap + CHUNK_SIZE_HEAP_RESERVE) {
+        return m_chunk_size;
+    }
+    return bigger_chunk_size;
+}
+
+void OTA_Chunk_Size_Controller::Set_Chunk_Size(size_t const & chunk_size) {
+    if (chunk_size < m_chunk_size) {
+        Block_Growth();
+        m_previous_goodput = 0U;
+    }
+    else if (chunk_size > m_chunk_size) {
+        m_previous_goodput = Get_Goodput();
+    }
+    m_chunk_size = chunk_size;
+    m_shrink_pending = false;
+    m_timing = false;
+    // Round trip time depends on the chunk size, because the transmission time of the chunk itself is included, therefore it has to be measured again
+    m_round_trip_time = 0U;
+    m_epoch_start_time = Helper::getTimeMicroseconds();
+    m_epoch_written_bytes = 0U;
+    m_epoch_written_chunks = 0U;
+}
+
+bool OTA_Chunk_Size_Controller::Align_Chunk_Size(size_t const & offset) {
+    while (m_adaptive && (offset % m_chunk_size) != 0U && (m_chunk_size / 2U) >= m_minimum_chunk_size) {
+        m_chunk_size /= 2U;
+    }
+    return (offset % m_chunk_size) == 0U;
+}
+
+void OTA_Chunk_Size_Controller::Block_Growth() {
+    m_growth_blocked = true;
+}
+
+void OTA_Chunk_Size_Controller::Chunk_Requested(size_t const & offset) {
+    if (m_timing) {
+        return;
+    }
+    m_timing = true;
+    m_timed_offset = offset;
+    m_timed_request_time = Helper::getTimeMicroseconds();
+}
+
+void OTA_Chunk_Size_Controller::Chunk_Received(size_t const & offset) {
+    if (!m_timing || offset != m_timed_offset) {
+        return;
+    }
+    m_timing = false;
+    uint64_t const round_trip_time = Helper::getTimeMicroseconds() - m_timed_request_time;
+    // Smooth the samples the same way the TCP retransmission timer does (RFC 6298), so a single delayed response does not change the chunk size
+    m_round_trip_time = (m_round_trip_time == 0U) ? round_trip_time : ((7U * m_round_trip_time) + round_trip_time) / 8U;
+}
+
+void OTA_Chunk_Size_Controller::Chunk_Written(size_t const & length) {
+    m_epoch_written_bytes += length;
+    m_epoch_written_chunks++;
+    if (!m_adaptive || m_previous_goodput == 0U || m_epoch_written_chunks != CHUNK_SIZE_SAMPLES) {
+        return;
+    }
+    // Decrease the chunk size again if the bigger chunk size has a goodput that is more than 10% worse than the previous smaller chunk size
+    if (Get_Goodput() < (m_previous_goodput - (m_previous_goodput / 10U))) {
+        m_shrink_pending = true;
+    }
+}
+
+void OTA_Chunk_Size_Controller::Request_Timed_Out() {
+    m_timing = false;
+    m_shrink_pending = m_adaptive;
+}
+
+uint64_t const & OTA_Chunk_Size_Controller::Get_Round_Trip_Time() const {
+    return m_round_trip_time;
+}
+
+uint64_t OTA_Chunk_Size_Controller::Get_Goodput() const {
+    uint64_t const elapsed_time = Helper::getTimeMicroseconds() - m_epoch_start_time;
+    if (elapsed_time == 0U) {
+        return 0U;
+    }
+    return (static_cast<uint64_t>(m_epoch_written_bytes) * 1000U * 1000U) / elapsed_time;
+}
+
+size_t OTA_Chunk_Size_Controller::Round_Down_Power_Of_Two(size_t const & value) {
+    size_t power = 1U;
+    while (power <= (value / 2U)) {
+        power *= 2U;
+    }
+    return power;
+}
@@ -0,0 +1,116 @@
+#ifndef OTA_Chunk_Size_Controller_h
+#define OTA_Chunk_Size_Controller_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Amount of chunks that have to be written with the current chunk size, before the measured goodput is seen as representative and the chunk size might be increased
+uint8_t constexpr CHUNK_SIZE_SAMPLES = 4U;
+// Amount of heap memory in bytes that has to remain free after increasing the chunk size, so the remaining system is not starved by the update process
+size_t constexpr CHUNK_SIZE_HEAP_RESERVE = (16U * 1024U);
+// Additional bytes the receive buffer needs besides the chunk itself, to hold the MQTT header and the response topic
+uint16_t constexpr CHUNK_SIZE_BUFFER_OVERHEAD = 128U;
+
+
+/// @brief Adaptive controller for the size of the chunks a firmware binary is requested in, measures the round trip time of single chunk requests and the goodput,
+/// meaning the amount of bytes actually written per second, and decides on the chunk size of the next requests based on that and the available heap memory.
+/// Sizes are always powers of two between the configured bounds, because the server calculates the byte offset of a chunk by multiplying its index with the requested size,
+/// this ensures the already written amount of bytes is always a multiple of the smaller size and therefore a valid offset for the next request, once it is aligned to the bigger one.
+/// The chunk size is doubled as long as the goodput improves and the round trip time stays well below the timeout, and halved if a request timed out,
+/// the round trip time gets close to the timeout or the goodput with the bigger size was worse than with the previous smaller size.
+/// Once the size was decreased, it is never increased again for the same update, to not oscillate on a marginal connection
+class OTA_Chunk_Size_Controller {
+  public:
+    /// @brief Constructs an disabled controller, that always keeps the initally configured chunk size
+    OTA_Chunk_Size_Controller() = default;
+
+    /// @brief Resets all measurements and calculates the initial chunk size, which is the configured chunk size clamped to the given bounds,
+    /// rounded down to the next power of two. If the minimum is not smaller than the maximum, adaptive sizing is disabled and the configured chunk size is used unchanged
+    /// @param chunk_size Configured chunk size in bytes
+    /// @param minimum_chunk_size Minimum chunk size in bytes, the controller never decreases the chunk size below it
+    /// @param maximum_chunk_size Maximum chunk size in bytes, the controller never increases the chunk size above it
+    /// @param timeout_microseconds Timeout in microseconds after which a requested chunk counts as lost, the round trip time has to stay well below it
+    void Start(size_t const & chunk_size, size_t const & minimum_chunk_size, size_t const & maximum_chunk_size, uint64_t const & timeout_microseconds);
+
+    /// @brief Whether the chunk size is adjusted or stays the same for the whole update
+    /// @return Whether adaptive chunk sizing is enabled
+    bool Is_Adaptive() const;
+
+    /// @brief Gets the chunk size all currently outstanding chunks have been requested with
+    /// @return Current chunk size in bytes
+    size_t const & Get_Chunk_Size() const;
+
+    /// @brief Calculates the chunk size the next chunks should be requested with, does not change the current chunk size, that has to be done with Set_Chunk_Size,
+    /// once all outstanding chunks with the current chunk size have been received
+    /// @param offset Byte offset the next chunk will be requested at, once all outstanding chunks have been received.
+    /// An increased chunk size is only returned if this offset is a multiple of it
+    /// @param request_window Maximum amount of outstanding chunks, used to estimate the additional heap memory a bigger chunk size requires
+    /// @return Chunk size in bytes the next chunks should be requested with
+    size_t Get_Desired_Chunk_Size(size_t const & offset, size_t const & request_window) const;
+
+    /// @brief Changes the current chunk size and starts a new goodput measurement for it
+    /// @param chunk_size New chunk size in bytes, has to be a valid result of Get_Desired_Chunk_Size
+    void Set_Chunk_Size(size_t const & chunk_size);
+
+    /// @brief Decreases the chunk size until the given offset is a multiple of it, used when an update is resumed at an offset that might have been written with a different chunk size
+    /// @param offset Byte offset the next chunk will be requested at
+    /// @return Whether the offset is a multiple of the chunk size, if it is not the chunk can not be requested from the server
+    bool Align_Chunk_Size(size_t const & offset);
+
+    /// @brief Prevents the chunk size from being increased for the remaining update, called if the memory needed for a bigger chunk size could not be allocated
+    void Block_Growth();
+
+    /// @brief Informs the controller that the chunk at the given offset has been requested. Only one chunk at a time is timed,
+    /// if no other chunk is currently timed the request time of the given chunk is saved to measure its round trip time once it is received
+    /// @param offset Byte offset of the requested chunk
+    void Chunk_Requested(size_t const & offset);
+
+    /// @brief Informs the controller that the chunk at the given offset has been received, if it was timed the round trip time is updated
+    /// @param offset Byte offset of the received chunk
+    void Chunk_Received(size_t const & offset);
+
+    /// @brief Informs the controller that the given amount of bytes have been written and updates the goodput measurement of the current chunk size
+    /// @param length Amount of written bytes
+    void Chunk_Written(size_t const & length);
+
+    /// @brief Informs the controller that outstanding chunks have not been received in time, causes the chunk size to be decreased and discards the currently timed chunk,
+    /// because it is requested again and it would be impossible to know which of the requests the response belongs to
+    void Request_Timed_Out();
+
+    /// @brief Gets the smoothed round trip time of a single chunk request
+    /// @return Smoothed round trip time in microseconds, 0 if no chunk has been timed yet
+    uint64_t const & Get_Round_Trip_Time() const;
+
+    /// @brief Gets the goodput measured for the current chunk size
+    /// @return Amount of bytes written per second with the current chunk size, 0 if no time has passed yet
+    uint64_t Get_Goodput() const;
+
+  private:
+    /// @brief Rounds the given value down to the next power of two
+    /// @param value Value that should be rounded, has to be bigger than 0
+    /// @return Biggest power of two that is smaller or equal to the given value
+    static size_t Round_Down_Power_Of_Two(size_t const & value);
+
+    bool     m_adaptive = {};              // Whether the chunk size is adjusted or stays the same for the whole update
+    size_t   m_chunk_size = {};            // Chunk size all currently outstanding chunks have been requested with
+    size_t   m_minimum_chunk_size = {};    // Chunk size is never decreased below this value
+    size_t   m_maximum_chunk_size = {};    // Chunk size is never increased above this value
+    uint64_t m_timeout = {};               // Timeout in microseconds after which a requested chunk counts as lost
+    bool     m_growth_blocked = {};        // Whether the chunk size may not be increased anymore for the remaining update
+    bool     m_shrink_pending = {};        // Whether the chunk size should be decreased with the next change
+    bool     m_timing = {};                // Whether a chunk is currently timed
+    size_t   m_timed_offset = {};          // Byte offset of the currently timed chunk
+    uint64_t m_timed_request_time = {};    // Time in microseconds the currently timed chunk was requested at
+    uint64_t m_round_trip_time = {};       // Smoothed round trip time of a single chunk request in microseconds
+    uint64_t m_epoch_start_time = {};      // Time in microseconds the current chunk size was started to be used at
+    size_t   m_epoch_written_bytes = {};   // Amount of bytes written with the current chunk size
+    size_t   m_epoch_written_chunks = {};  // Amount of chunks written with the current chunk size
+    uint64_t m_previous_goodput = {};      // Goodput of the previous smaller chunk size, the bigger chunk size has to atleast reach it, 0 if the size was not increased
+};
+
+#endif // OTA_Chunk_Size_Controller_h
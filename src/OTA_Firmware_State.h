@@ -0,0 +1,12 @@
+#ifndef OTA_Firmware_State_h
+#define OTA_Firmware_State_h
+
+
+// Firmware data keys.
+char constexpr FW_STATE_DOWNLOADING[] = "DOWNLOADING";
+char constexpr FW_STATE_DOWNLOADED[] = "DOWNLOADED";
+char constexpr FW_STATE_UPDATING[] = "UPDATING";
+char constexpr FW_STATE_FAILED[] = "FAILED";
+char constexpr FW_STATE_UPDATED[] = "UPDATED";
+
+#endif // OTA_Firmware_State_h
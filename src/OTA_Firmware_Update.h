@@ -11,10 +11,6 @@
 #include <functional>  // for std::bind
 #endif
 
-// caps for cached firmware identity (adjust to your needs)
-static constexpr size_t MAX_FW_TITLE_LEN = 96;
-static constexpr size_t MAX_FW_VERSION_LEN = 48;
-
 // Keys & messages
 static constexpr uint8_t SHARED_ATTRIBUTE_KEYS_AMOUNT = 5U;
 static constexpr char NO_SHARED_ATTRS_REQUEST_RESPONSE[] =
@@ -35,6 +31,9 @@ static constexpr char CHECKSUM_AGORITM_MD5[] = "MD5";
 static constexpr char CHECKSUM_AGORITM_SHA256[] = "SHA256";
 static constexpr char CHECKSUM_AGORITM_SHA384[] = "SHA384";
 static constexpr char CHECKSUM_AGORITM_SHA512[] = "SHA512";
+static constexpr char CHECKSUM_AGORITM_CRC32[] = "CRC32";
+static constexpr char CHECKSUM_AGORITM_MURMUR3_32[] = "MURMUR3_32";
+static constexpr char CHECKSUM_AGORITM_MURMUR3_128[] = "MURMUR3_128";
 
 static constexpr char NUMBER_PRINTF[] = "%u";
 static constexpr char NO_FW[] = "Missing shared attribute firmware keys. Ensure you assigned an OTA update with binary";
@@ -50,6 +49,7 @@ static constexpr char PAGE_BREAK[] = "=================================";
 static constexpr char NEW_FW[] = "A new Firmware is available:";
 static constexpr char FROM_TOO[] = "(%s) => (%s)";
 static constexpr char DOWNLOADING_FW[] = "Attempting to download over MQTT...";
+static constexpr char DOWNLOADING_FW_HTTP[] = "Attempting to download over HTTP from (%s)...";
 #endif
 
 // ---- MQTT topic formats (runtime-built from device access token) ----
@@ -123,7 +123,7 @@ public:
           , m_deviceProfile(nullptr)
 #if THINGSBOARD_ENABLE_STL
           , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this,
-                            std::placeholders::_1, std::placeholders::_2),
+                            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
                   std::bind(&OTA_Firmware_Update::Firmware_Send_State,
                             this
                             ,
@@ -136,11 +136,14 @@ public:
                             ,
                             this
                   )
+                  ,
+                  std::bind(&OTA_Firmware_Update::Resize_Receive_Buffer, this, std::placeholders::_1)
           )
 #else
     , m_ota(OTA_Firmware_Update::staticPublishChunk,
             OTA_Firmware_Update::staticFirmwareSend,
-            OTA_Firmware_Update::staticUnsubscribe)
+            OTA_Firmware_Update::staticUnsubscribe,
+            OTA_Firmware_Update::staticResizeBuffer)
 #endif
     {
 #if !THINGSBOARD_ENABLE_STL
@@ -193,6 +196,10 @@ public:
     // Expose firmware identity captured from attributes
     char m_fw_title[MAX_FW_TITLE_LEN] = {};
     char m_fw_version[MAX_FW_VERSION_LEN] = {};
+    // Size and checksum captured from attributes, used to download the firmware binary if it can not be applied out of the cache
+    size_t m_fw_size = {};
+    char m_fw_checksum[FIRMWARE_HASH_SIZE] = {};
+    Checksum_Algorithm m_fw_checksum_algorithm = {};
 
     // ---------- start / subscribe ----------
     bool Start_Firmware_Update(OTA_Update_Callback const& callback)
@@ -305,32 +312,45 @@ public:
     // ---------- IAPI_Implementation ----------
     API_Process_Type Get_Process_Type() const override { return API_Process_Type::RAW; }
 
-    void Process_Response(char const* topic, uint8_t* payload, unsigned int length) override
+    void Process_Response(String_View const& topic, uint8_t* payload, unsigned int length) override
     {
         // Serial.println(String("OTA Process_Response: ") + topic);
 
-        char prefix[TOPIC_BUF_SIZE];
-        Build_Response_Prefix(prefix, sizeof(prefix));
+        size_t chunk = 0U;
+        if (!Parse_Response_Chunk(topic, chunk)) return;
 
-        if (strncmp(prefix, topic, strlen(prefix)) != 0) return;
+#ifdef ARDUINO
+        Serial.println(String("OTA chunk=") + chunk);
+#endif // ARDUINO
+        m_ota.Process_Firmware_Packet(chunk, payload, length);
+    }
 
-        char const* chunk_str = topic + strlen(prefix);
-        const unsigned long chunk = strtoul(chunk_str, nullptr, 10);
+    /// @brief Chunks bigger than the receive buffer are written into flash memory and into the hash fragment by fragment while they are received,
+    /// which allows to use big chunks even with a small receive buffer
+    void Process_Response_Fragment(String_View const& topic, uint8_t* payload, size_t const& offset, size_t const& length, size_t const& total_length) override
+    {
+        size_t chunk = 0U;
+        if (!Parse_Response_Chunk(topic, chunk)) return;
 
-        Serial.println(String("OTA chunk=") + chunk);
-        m_ota.Process_Firmware_Packet(static_cast<size_t>(chunk), payload, length);
+        m_ota.Process_Firmware_Fragment(chunk, payload, offset, length, total_length);
     }
 
-    void Process_Json_Response(char const* /*topic*/, JsonDocument const& /*data*/) override
+    /// @brief If responses are received in fragments, the receive buffer is not increased to hold a complete chunk anymore
+    void Set_Fragmented_Receive(bool const& supported) override
+    {
+        m_fragmented_receive = supported;
+    }
+
+    void Process_Json_Response(String_View const& /*topic*/, JsonDocument const& /*data*/) override
     {
         // Serial.println("Process_Json_Response (unused for OTA)");
     }
 
-    bool Compare_Response_Topic(char const* topic) const override
+    bool Compare_Response_Topic(String_View const& topic) const override
     {
         char prefix[TOPIC_BUF_SIZE];
         Build_Response_Prefix(prefix, sizeof(prefix));
-        return strncmp(prefix, topic, strlen(prefix)) == 0;
+        return topic.starts_with(prefix);
     }
 
     bool Unsubscribe() override
@@ -348,9 +368,25 @@ public:
         return Firmware_OTA_Subscribe();
     }
 
+    bool Restore_Topic(bool const & session_present, bool const & /*keep_requests*/) override
+    {
+        // The server still has the subscription if it kept the session, meaning subscribing again would only cause unnecessary traffic
+        return session_present || Resubscribe_Topic();
+    }
+
+    void loop() override
+    {
 #if !THINGSBOARD_USE_ESP_TIMER
-    void loop() override { m_ota.update(); }
+        m_ota.update();
 #endif
+        // firmware binary downloaded over HTTP is advanced one step per call, because downloading it all at once would starve the MQTT client
+        m_ota.Stream_Firmware_Step();
+        // firmware binary applied out of the cache is written one chunk per call as well, it is downloaded instead if the cached firmware binary could not be applied
+        if (m_ota.Cached_Firmware_Step())
+        {
+            Download_Firmware();
+        }
+    }
 
     void Initialize() override
     {
@@ -453,7 +489,12 @@ private:
         return m_unsubscribe_topic_callback.Call_Callback(subscribeTopic);
     }
 
-    bool Publish_Chunk_Request(size_t const& request_id, size_t const& request_chunk)
+    /// @brief Requests the given chunk of the firmware binary, the server returns the bytes starting at the offset request_chunk * chunk_size
+    /// @param request_id Unique identifier connected to the request for OTA firmware update
+    /// @param request_chunk Index of the requested chunk, in units of the given chunk size
+    /// @param chunk_size Size in bytes of the requested chunk, might differ from the configured chunk size if it is adjusted adaptively
+    /// @return Whether publishing the request was successful or not
+    bool Publish_Chunk_Request(size_t const& request_id, size_t const& request_chunk, size_t const& chunk_size)
     {
         (void)request_id; // v3 token-based API doesn't use request_id in the topic
         // Serial.println("Publish_Chunk_Request");
@@ -466,10 +507,8 @@ private:
             return false;
         }
 
-        uint16_t const& chunk_size = m_fw_callback.Get_Chunk_Size();
-
-        char sizeStr[Helper::detectSize(NUMBER_PRINTF, chunk_size)] = {};
-        (void)snprintf(sizeStr, sizeof(sizeStr), NUMBER_PRINTF, chunk_size);
+        char sizeStr[Helper::detectSize(NUMBER_PRINTF, static_cast<unsigned>(chunk_size))] = {};
+        (void)snprintf(sizeStr, sizeof(sizeStr), NUMBER_PRINTF, static_cast<unsigned>(chunk_size));
 
         char topic[Helper::detectSize(FIRMWARE_REQUEST_FMT, m_deviceId, m_fw_title, m_fw_version,
                                       static_cast<unsigned>(request_chunk))] = {};
@@ -539,16 +578,21 @@ private:
             return;
         }
 
-        auto fw_checksum_algorithm = mbedtls_md_type_t{};
+        auto fw_checksum_algorithm = Checksum_Algorithm{};
         if (strncmp(CHECKSUM_AGORITM_MD5, fw_algorithm, strlen(CHECKSUM_AGORITM_MD5)) == 0)
-            fw_checksum_algorithm =
-                MBEDTLS_MD_MD5;
+            fw_checksum_algorithm = Checksum_Algorithm::MD5;
         else if (strncmp(CHECKSUM_AGORITM_SHA256, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA256)) == 0)
-            fw_checksum_algorithm = MBEDTLS_MD_SHA256;
+            fw_checksum_algorithm = Checksum_Algorithm::SHA256;
         else if (strncmp(CHECKSUM_AGORITM_SHA384, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA384)) == 0)
-            fw_checksum_algorithm = MBEDTLS_MD_SHA384;
+            fw_checksum_algorithm = Checksum_Algorithm::SHA384;
         else if (strncmp(CHECKSUM_AGORITM_SHA512, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA512)) == 0)
-            fw_checksum_algorithm = MBEDTLS_MD_SHA512;
+            fw_checksum_algorithm = Checksum_Algorithm::SHA512;
+        else if (strncmp(CHECKSUM_AGORITM_CRC32, fw_algorithm, strlen(CHECKSUM_AGORITM_CRC32)) == 0)
+            fw_checksum_algorithm = Checksum_Algorithm::CRC32;
+        else if (strncmp(CHECKSUM_AGORITM_MURMUR3_32, fw_algorithm, strlen(CHECKSUM_AGORITM_MURMUR3_32)) == 0)
+            fw_checksum_algorithm = Checksum_Algorithm::MURMUR3_32;
+        else if (strncmp(CHECKSUM_AGORITM_MURMUR3_128, fw_algorithm, strlen(CHECKSUM_AGORITM_MURMUR3_128)) == 0)
+            fw_checksum_algorithm = Checksum_Algorithm::MURMUR3_128;
         else
         {
             char message[strlen(FW_CHKS_ALGO_NOT_SUPPORTED) + strlen(fw_algorithm) + 2] = {};
@@ -559,6 +603,40 @@ private:
             return;
         }
 
+        // cache for requests
+        strncpy(m_fw_title, fw_title, sizeof(m_fw_title) - 1);
+        m_fw_title[sizeof(m_fw_title) - 1] = '\0';
+        strncpy(m_fw_version, fw_version, sizeof(m_fw_version) - 1);
+        m_fw_version[sizeof(m_fw_version) - 1] = '\0';
+
+        // cache for downloading the firmware binary, if it can not be applied out of the cache
+        m_fw_size = fw_size;
+        strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum) - 1);
+        m_fw_checksum[sizeof(m_fw_checksum) - 1] = '\0';
+        m_fw_checksum_algorithm = fw_checksum_algorithm;
+
+        // firmware binary has already been downloaded before, it is applied straight out of the cache without requesting a single chunk, advanced by loop().
+        // receive buffer is not increased for it, therefore it does not have to be restored once the update has finished
+        m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
+        m_changed_buffer_size = false;
+        if (m_ota.Apply_Cached_Firmware_Update(m_fw_callback, m_fw_title, m_fw_version, m_fw_size, m_fw_checksum, m_fw_checksum_algorithm))
+        {
+            return;
+        }
+        Download_Firmware();
+    }
+
+    /// @brief Downloads the firmware binary with the title, version, size and checksum received in the last firmware attributes, either over HTTP if the update callback configures a HTTP client,
+    /// or in chunks over MQTT otherwise. Called once the firmware attributes have been received, or once the firmware binary could not be applied out of the cache
+    void Download_Firmware()
+    {
+        // firmware binary is streamed over HTTP instead, neither the chunk topic nor a bigger receive buffer is needed
+        if (m_fw_callback.Get_HTTP_Client() != nullptr)
+        {
+            Stream_Firmware(m_fw_size, m_fw_checksum, m_fw_checksum_algorithm);
+            return;
+        }
+
         // subscribe for chunks for this token
         if (!Firmware_OTA_Subscribe())
         {
@@ -569,31 +647,18 @@ private:
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(PAGE_BREAK);
         Logger::printfln(NEW_FW);
-        char firmware[strlen(FROM_TOO) + strlen(curr_fw_version) + strlen(fw_version) + 3] = {};
-        (void)snprintf(firmware, sizeof(firmware), FROM_TOO, curr_fw_version, fw_version);
+        char const* curr_fw_version = m_fw_callback.Get_Firmware_Version();
+        char firmware[strlen(FROM_TOO) + strlen(curr_fw_version) + strlen(m_fw_version) + 3] = {};
+        (void)snprintf(firmware, sizeof(firmware), FROM_TOO, curr_fw_version, m_fw_version);
         Logger::printfln(firmware);
         Logger::printfln(DOWNLOADING_FW);
 #endif
 
-        // cache for requests
-        strncpy(m_fw_title, fw_title, sizeof(m_fw_title) - 1);
-        m_fw_title[sizeof(m_fw_title) - 1] = '\0';
-        strncpy(m_fw_version, fw_version, sizeof(m_fw_version) - 1);
-        m_fw_version[sizeof(m_fw_version) - 1] = '\0';
-
         // buffer sizing for larger chunks
-        const uint16_t& chunk_size = m_fw_callback.Get_Chunk_Size();
         m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
+        m_changed_buffer_size = false;
 
-        // m_changed_buffer_size = m_previous_buffer_size < chunk_size + 50U;
-        const uint16_t need = chunk_size + 128U; // a bit of margin
-        m_changed_buffer_size = m_previous_buffer_size < need;
-
-        // if (m_changed_buffer_size &&
-        //     !m_set_buffer_size_callback.Call_Callback(chunk_size + 50U, m_get_send_size_callback.Call_Callback()))
-        // {
-        if (m_changed_buffer_size &&
-            !m_set_buffer_size_callback.Call_Callback(need, m_get_send_size_callback.Call_Callback()))
+        if (!Resize_Receive_Buffer(m_fw_callback.Get_Chunk_Size()))
         {
             Logger::printfln(NOT_ENOUGH_RAM);
             // ReSharper disable once CppExpressionWithoutSideEffects
@@ -602,7 +667,69 @@ private:
             return;
         }
 
-        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm);
+        m_ota.Start_Firmware_Update(m_fw_callback, m_fw_title, m_fw_version, m_fw_size, m_fw_checksum, m_fw_checksum_algorithm);
+    }
+
+    /// @brief Downloads the firmware binary with the HTTP client configured in the update callback, from the path created out of the configured format,
+    /// the device id and the received firmware title and version. Only starts the download, which is then advanced by loop()
+    /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
+    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
+    void Stream_Firmware(size_t const& fw_size, char const* fw_checksum, Checksum_Algorithm const& fw_checksum_algorithm)
+    {
+        char const* path_format = m_fw_callback.Get_HTTP_Path_Format();
+        char const* deviceId = m_deviceId && *m_deviceId ? m_deviceId : "unknown";
+        char path[Helper::detectSize(path_format, deviceId, m_fw_title, m_fw_version)] = {};
+        (void)snprintf(path, sizeof(path), path_format, deviceId, m_fw_title, m_fw_version);
+
+        // Receive buffer is not increased for the download, therefore it does not have to be restored once the update has finished
+        m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
+        m_changed_buffer_size = false;
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(DOWNLOADING_FW_HTTP, static_cast<char const*>(path));
+#endif
+        m_ota.Stream_Firmware_Update(m_fw_callback, path, m_fw_title, m_fw_version, fw_size, fw_checksum, fw_checksum_algorithm);
+    }
+
+    /// @brief Increases the internal client receive buffer, if it is not big enough to receive chunks with the given chunk size yet.
+    /// The previous buffer size is restored once the update has finished
+    /// @param chunk_size Size in bytes of the chunks that will be requested
+    /// @return Whether the receive buffer is big enough or increasing it was successful
+    bool Resize_Receive_Buffer(size_t const& chunk_size)
+    {
+        // Chunks bigger than the receive buffer are received in fragments instead, therefore the buffer can keep its size
+        if (m_fragmented_receive)
+        {
+            return true;
+        }
+        size_t const need = chunk_size + CHUNK_SIZE_BUFFER_OVERHEAD; // a bit of margin
+        if (m_get_receive_size_callback.Call_Callback() >= need)
+        {
+            return true;
+        }
+        if (need > UINT16_MAX ||
+            !m_set_buffer_size_callback.Call_Callback(static_cast<uint16_t>(need), m_get_send_size_callback.Call_Callback()))
+        {
+            return false;
+        }
+        m_changed_buffer_size = true;
+        return true;
+    }
+
+    /// @brief Parses the index of the received chunk out of the topic it was received over
+    /// @param topic Topic the chunk was received over, ends with the chunk index. Not necessarily null terminated, the payload might follow directly after it
+    /// @param chunk Variable the parsed chunk index will be copied into
+    /// @return Whether the topic is a firmware response topic of this device or not
+    bool Parse_Response_Chunk(String_View const& topic, size_t& chunk) const
+    {
+        char prefix[TOPIC_BUF_SIZE];
+        Build_Response_Prefix(prefix, sizeof(prefix));
+
+        if (!topic.starts_with(prefix)) return false;
+
+        chunk = Helper::parseRequestId(prefix, topic);
+        return true;
     }
 
     // ----- topic builders -----
@@ -633,9 +760,9 @@ private:
     {
         if (m_subscribedInstance) m_subscribedInstance->Request_Timeout();
     }
-    static bool staticPublishChunk(size_t const& request_id, size_t const& request_chunk)
+    static bool staticPublishChunk(size_t const& request_id, size_t const& request_chunk, size_t const& chunk_size)
     {
-        return m_subscribedInstance ? m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunk) : false;
+        return m_subscribedInstance ? m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunk, chunk_size) : false;
     }
     static bool staticFirmwareSend(char const* current_fw_state, char const* fw_error = nullptr)
     {
@@ -645,6 +772,10 @@ private:
     {
         return m_subscribedInstance ? m_subscribedInstance->Firmware_OTA_Unsubscribe() : false;
     }
+    static bool staticResizeBuffer(size_t const& chunk_size)
+    {
+        return m_subscribedInstance ? m_subscribedInstance->Resize_Receive_Buffer(chunk_size) : false;
+    }
     static OTA_Firmware_Update* m_subscribedInstance;
 #endif
 
@@ -662,6 +793,7 @@ private:
     OTA_Update_Callback m_fw_callback = {};
     uint16_t m_previous_buffer_size = {};
     bool m_changed_buffer_size = {};
+    bool m_fragmented_receive = {}; // Whether chunks bigger than the receive buffer are received in fragments, instead of the receive buffer being increased
     OTA_Handler<Logger> m_ota; // now correctly constructed
 
 #if !THINGSBOARD_ENABLE_DYNAMIC
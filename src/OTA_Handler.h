@@ -7,42 +7,70 @@
 // Local include.
 #include "Callback_Watchdog.h"
 #include "HashGenerator.h"
+#include "OTA_Checkpoint.h"
+#include "OTA_Chunk_Size_Controller.h"
 #include "OTA_Update_Callback.h"
 #include "OTA_Failure_Response.h"
+#include "OTA_Firmware_State.h"
+#include "OTA_Write_Pipeline.h"
+#include "IHTTP_Client.h"
+#include "IFirmware_Cache.h"
 #include "Helper.h"
 
 // Library includes.
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 
-// Firmware data keys.
-char constexpr FW_STATE_DOWNLOADING[] = "DOWNLOADING";
-char constexpr FW_STATE_DOWNLOADED[] = "DOWNLOADED";
-char constexpr FW_STATE_UPDATING[] = "UPDATING";
-char constexpr FW_STATE_FAILED[] = "FAILED";
-char constexpr FW_STATE_UPDATED[] = "UPDATED";
+// HTTP status codes.
+int constexpr HTTP_STATUS_OK = 200;
+int constexpr HTTP_STATUS_PARTIAL_CONTENT = 206;
+
+// Size of the buffer the message of a failed write is copied into, has to fit the longest formatted write error message.
+size_t constexpr WRITE_ERROR_MESSAGE_SIZE = 128U;
+// Chunk offset passed to the failure handling, if every outstanding chunk should be requested again instead of a single one.
+size_t constexpr ALL_OUTSTANDING_CHUNKS = SIZE_MAX;
 
 // Log messages.
 char constexpr OTA_CB_IS_NULL[] = "OTA update callback is NULL, has it been deleted";
 char constexpr UNABLE_TO_REQUEST_CHUNCKS[] = "Unable to request firmware chunk";
-char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u), not the same as requested chunk (%u)";
+char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u) at offset (%u), not in the range of outstanding requested bytes [%u, %u)";
 char constexpr RECEIVED_UNEXPECTED_CHUNK_SIZE[] = "Received chunk size (%u), not the same as expected chunk size (%u)";
+char constexpr CHUNK_CRC_VERIFICATION_FAILED[] = "Calculated CRC32 (%08X) of chunk at offset (%u), not the same as expected CRC32 (%08X)";
+char constexpr FRAGMENTED_CHUNK_INTERRUPTED[] = "Chunk at offset (%u) received in fragments was interrupted after (%u) of (%u) bytes";
 char constexpr ERROR_UPDATE_BEGIN[] =
     "Failed to initalize flash updater, ensure that the partition scheme has two app sections";
 char constexpr ERROR_UPDATE_WRITE[] = "Only wrote (%u) bytes of binary data instead of expected (%u)";
 char constexpr ERROR_UPDATE_END[] = "Error during flash updater not all bytes written";
 char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%s), not the same as expected checksum (%s)";
 char constexpr FW_UPDATE_ABORTED[] = "Firmware update aborted";
+char constexpr REORDER_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate (%u) bytes for the reorder buffer, falling back to requesting one chunk at a time";
+char constexpr UNABLE_TO_RESIZE_BUFFER[] = "Unable to increase buffers for chunk size (%u), keeping chunk size (%u)";
+char constexpr PERSIST_CHECKPOINT_FAILED[] = "Failed to persist checkpoint at offset (%u), update continues without it";
 char constexpr CHUNK_REQUEST_TIMED_OUT[] =
     "Failed to receive requested chunk (%u) in (%llu) us. Internet connection might have been lost";
+char constexpr STREAM_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate (%u) bytes for the firmware download buffer, decrease OTA chunk size";
+char constexpr HTTP_CLIENT_IS_NULL[] = "HTTP client is NULL, has it been deleted";
+char constexpr HTTP_RANGE_REQUEST_FAILED[] = "Failed to request firmware binary starting at offset (%u) over HTTP with error code (%d)";
+char constexpr HTTP_UNEXPECTED_STATUS[] = "Received unexpected HTTP status code (%d) for firmware binary request";
+char constexpr WRITE_PIPELINE_START_FAILED[] = "Failed to start write task with (%u) bytes of slots, falling back to writing chunks directly";
+char constexpr CACHE_ENTRY_WRITE_FAILED[] = "Failed to write firmware binary into the cache, update continues without caching it";
+char constexpr CACHED_FIRMWARE_INVALID[] = "Cached firmware binary could not be read or does not match the expected checksum, downloading it instead";
+char constexpr HTTP_DOWNLOAD_INTERRUPTED[] = "Firmware download over HTTP interrupted after (%u) of (%u) bytes. Internet connection might have been lost";
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr FW_CHUNK[] = "Receive chunk (%u), with size (%u) bytes";
+char constexpr FW_CHUNK_FRAGMENTED[] = "Receive chunk (%u), with size (%u) bytes in fragments";
+char constexpr FW_CHUNK_BUFFERED[] = "Buffered chunk at offset (%u), received before previous chunk at offset (%u)";
+char constexpr FW_UPDATE_RESUMED[] = "Resuming update from checkpoint at offset (%u) of (%u) bytes";
+char constexpr FW_UPDATE_REWOUND[] = "Rewinding update to the last checkpointed block at offset (%u) of (%u) bytes";
+char constexpr FW_RANGE_IGNORED[] = "Server ignored range request, skipping (%u) already written bytes";
+char constexpr FW_CHUNK_SIZE_CHANGED[] = "Changed chunk size from (%u) to (%u) bytes, round trip time (%llu) us, goodput (%llu) bytes/s";
 char constexpr HASH_EXPECTED[] = "Expected checksum: (%s)";
 char constexpr CHECKSUM_VERIFICATION_SUCCESS[] = "Checksum is the same as expected";
 char constexpr FW_UPDATE_SUCCESS[] = "Update success";
+char constexpr FW_UPDATE_FROM_CACHE[] = "Applying firmware binary with checksum (%s) out of the cache";
 #endif // THINGSBOARD_ENABLE_DEBUG
-// Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
-size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
 
 
 /// @brief Handles the complete processing of received binary firmware data, including flashing it onto the device,
@@ -51,206 +79,1352 @@ size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
 template <typename Logger>
 class OTA_Handler
 {
+    /// @brief Slot of the reorder buffer, holds a chunk that has been received before all previous chunks have been written
+    struct Buffered_Chunk
+    {
+        size_t offset = {}; // Byte offset of the buffered chunk in the firmware binary
+        size_t length = {}; // Amount of bytes of binary data of the buffered chunk
+        bool used = {};     // Whether the slot currently holds a chunk or is free
+    };
+
 public:
     /// @brief Constructor
-    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
+    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size,
+    /// the server returns the bytes starting at the offset chunk number * chunk size
     /// @param send_fw_state_callback Callback that is used to send information about the current state of the over the air update
     /// @param finish_callback Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    OTA_Handler(Callback<bool, size_t const&, size_t const&>::function publish_callback,
+    /// @param resize_buffer_callback Callback that is used to ensure the internal client buffer is big enough to receive chunks with the given chunk size, before the chunk size is increased
+    OTA_Handler(Callback<bool, size_t const&, size_t const&, size_t const&>::function publish_callback,
                 Callback<bool, char const* const, char const* const>::function send_fw_state_callback,
-                Callback<bool>::function finish_callback)
+                Callback<bool>::function finish_callback,
+                Callback<bool, size_t const&>::function resize_buffer_callback)
         : m_fw_callback(nullptr)
           , m_publish_callback(publish_callback)
           , m_send_fw_state_callback(send_fw_state_callback)
           , m_finish_callback(finish_callback)
+          , m_resize_buffer_callback(resize_buffer_callback)
           , m_fw_size(0U)
           , m_fw_checksum()
           , m_fw_checksum_algorithm()
           , m_hash()
           , m_total_chunks(0U)
-          , m_requested_chunks(0U)
+          , m_chunk_size_controller()
+          , m_written_bytes(0U)
+          , m_next_request_offset(0U)
+          , m_request_window(1U)
+          , m_reorder_slots(nullptr)
+          , m_reorder_buffer(nullptr)
+          , m_reorder_chunk_size(0U)
+          , m_fragment_slot(nullptr)
+          , m_fragment_offset(0U)
+          , m_fragment_size(0U)
+          , m_fragment_received(0U)
+          , m_fragment_crc(0U)
+          , m_fragment_receiving(false)
           , m_retries(0U)
+          , m_request_retries(nullptr)
+          , m_furthest_request_offset(0U)
+          , m_furthest_written_bytes(0U)
+          , m_streaming(false)
+          , m_http_client(nullptr)
+          , m_stream_buffer(nullptr)
+          , m_stream_buffer_size(0U)
+          , m_stream_path(nullptr)
+          , m_range_requested(false)
+          , m_skipped_bytes(0U)
+          , m_buffered_bytes(0U)
+          , m_last_received_time(0U)
+          , m_firmware_cache(nullptr)
+          , m_cache_filling(false)
+          , m_applying_cache(false)
           , m_watchdog(std::bind(&OTA_Handler::Handle_Request_Timeout, this))
     {
-        // Nothing to do
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~OTA_Handler()
+    {
+        // Write task has to be stopped first, because it accesses the updater, the hash and the checkpoint of this instance
+        m_write_pipeline.Stop();
+        Free_Reorder_Buffer();
+        Free_Stream_Buffer();
+    }
+
+    /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
+    /// If a checkpoint store is configured and it contains a checkpoint of the same firmware binary, the update is resumed after the already written bytes instead
+    /// @param fw_callback Callback method that contains configuration information, about the over the air update
+    /// @param fw_title Title of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_version Version of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
+    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
+    void Start_Firmware_Update(OTA_Update_Callback const& fw_callback, char const* fw_title, char const* fw_version,
+                               size_t const& fw_size, char const* fw_checksum,
+                               Checksum_Algorithm const& fw_checksum_algorithm)
+    {
+        Prepare_Firmware_Update(fw_callback, fw_title, fw_version, fw_size, fw_checksum, fw_checksum_algorithm);
+        const size_t chunk = m_fw_callback->Get_Chunk_Size();
+
+#ifdef ARDUINO
+        Serial.println(
+            "Start_Firmware_Update :: Chunk size: " + String(m_fw_size) + ", Total chunks : " + String(m_total_chunks));
+#endif // ARDUINO
+
+        m_chunk_size_controller.Start(chunk, m_fw_callback->Get_Minimum_Chunk_Size(), m_fw_callback->Get_Maximum_Chunk_Size(), m_fw_callback->Get_Timeout());
+        // The internal client buffer has only been increased to fit the configured chunk size, therefore a bigger initial chunk size has to be prepared first
+        size_t const initial_chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        if (initial_chunk_size > chunk && !m_resize_buffer_callback.Call_Callback(initial_chunk_size))
+        {
+            Logger::printfln(UNABLE_TO_RESIZE_BUFFER, initial_chunk_size, chunk);
+            m_chunk_size_controller.Start(chunk, 0U, 0U, m_fw_callback->Get_Timeout());
+        }
+        Allocate_Reorder_Buffer();
+        Start_Write_Pipeline(m_chunk_size_controller.Get_Chunk_Size());
+        m_furthest_request_offset = 0U;
+
+        if (!Resume_Firmware_Update())
+        {
+            Request_First_Firmware_Packet();
+        }
+        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
+    }
+
+    /// @brief Starts the firmware update and downloads the complete firmware binary with a single GET request over the HTTP client configured in the given callback,
+    /// instead of requesting it in chunks. The received bytes are written into flash memory and into the hash function the moment the buffer with the configured chunk size is full,
+    /// which keeps flash writes, checkpoints and progress reports identical to the chunked download. If the connection is interrupted, the download is continued with a range request
+    /// starting after the already written bytes, which counts as a retry. If a checkpoint store is configured and it contains a checkpoint of the same firmware binary, the download starts after the checkpoint instead.
+    /// Only prepares the download and returns immediately, because it is started from inside the MQTT callback that received the firmware attributes and blocking there would starve the MQTT client.
+    /// The download itself is advanced by calling Stream_Firmware_Step() periodically instead, which is done by the loop() method of the ThingsBoard client
+    /// @param fw_callback Callback method that contains configuration information, about the over the air update
+    /// @param url_path Path of the firmware binary on the server the HTTP client has been constructed for, is copied and therefore does not have to stay valid after this method returns
+    /// @param fw_title Title of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_version Version of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
+    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
+    void Stream_Firmware_Update(OTA_Update_Callback const& fw_callback, char const* url_path, char const* fw_title, char const* fw_version,
+                                size_t const& fw_size, char const* fw_checksum,
+                                Checksum_Algorithm const& fw_checksum_algorithm)
+    {
+        Prepare_Firmware_Update(fw_callback, fw_title, fw_version, fw_size, fw_checksum, fw_checksum_algorithm);
+        m_streaming = true;
+        m_http_client = m_fw_callback->Get_HTTP_Client();
+        if (m_http_client == nullptr)
+        {
+            Logger::printfln(HTTP_CLIENT_IS_NULL);
+            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, HTTP_CLIENT_IS_NULL);
+        }
+        // Chunk size is only used as the size of the buffer the received bytes are collected in, therefore adjusting it adaptively is not required
+        m_stream_buffer_size = m_fw_callback->Get_Chunk_Size();
+        m_chunk_size_controller.Start(m_stream_buffer_size, 0U, 0U, m_fw_callback->Get_Timeout());
+        size_t const url_path_size = strlen(url_path) + 1U;
+        // Path is kept in the same allocation directly after the buffer, because it has to outlive the MQTT callback the download has been started from
+        m_stream_buffer = static_cast<uint8_t*>(malloc(m_stream_buffer_size + url_path_size));
+        if (m_stream_buffer == nullptr)
+        {
+            char message[Helper::detectSize(STREAM_BUFFER_ALLOCATION_FAILED, m_stream_buffer_size)] = {};
+            (void)snprintf(message, sizeof(message), STREAM_BUFFER_ALLOCATION_FAILED, m_stream_buffer_size);
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, message);
+        }
+        m_stream_path = reinterpret_cast<char*>(m_stream_buffer + m_stream_buffer_size);
+        (void)memcpy(m_stream_path, url_path, url_path_size);
+        Start_Write_Pipeline(m_stream_buffer_size);
+
+        if (!Restore_Checkpoint())
+        {
+            Reset_Firmware_Update();
+            m_retries = m_fw_callback->Get_Chunk_Retries();
+        }
+        m_furthest_written_bytes = m_written_bytes;
+        m_range_requested = false;
+        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
+        m_http_client->set_keep_alive(true);
+    }
+
+    /// @brief Advances the firmware download started with Stream_Firmware_Update() by a single step, which either sends the range request for the bytes following the already written bytes,
+    /// reads the next part of the response body, writing the buffer once it is full, or finishes the update once the complete firmware binary has been written.
+    /// Each step waits at most the short implementation specific time the HTTP client waits for bytes to arrive, meaning the MQTT client keeps being serviced between the steps.
+    /// Does nothing if no firmware binary is currently downloaded over HTTP
+    void Stream_Firmware_Step()
+    {
+        if (!m_streaming || m_stream_buffer == nullptr)
+        {
+            return;
+        }
+        else if (m_written_bytes >= m_fw_size)
+        {
+            Finish_Firmware_Update();
+        }
+        else if (!m_range_requested)
+        {
+            Request_Firmware_Range();
+        }
+        else
+        {
+            Read_Firmware_Range();
+        }
+        // Buffer is not needed anymore once the update either finished or failed, restarting the update after an invalid checksum keeps streaming instead
+        if (!m_streaming)
+        {
+            Free_Stream_Buffer();
+        }
+    }
+
+    /// @brief Starts applying the firmware update straight out of the firmware cache configured in the given callback, if it contains the firmware binary with the given checksum.
+    /// The cached firmware binary is read in chunks of the configured chunk size and written into flash memory and into the hash function the same as downloaded chunks, but without requesting any of them.
+    /// Only opens the cached firmware binary and returns immediately, because it is started from inside the MQTT callback that received the firmware attributes and blocking there would starve the MQTT client.
+    /// The cached firmware binary is written by calling Cached_Firmware_Step() periodically instead, which is done by the loop() method of the ThingsBoard client
+    /// @param fw_callback Callback method that contains configuration information, about the over the air update
+    /// @param fw_title Title of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_version Version of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_size Complete size of the firmware binary that will be flashed onto this device
+    /// @param fw_checksum Checksum of the complete firmware binary, used to find the cached firmware binary and should be the same as the actually written data in the end
+    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
+    /// @return Whether the update is applied out of the cache, false if the firmware binary has to be downloaded instead
+    bool Apply_Cached_Firmware_Update(OTA_Update_Callback const& fw_callback, char const* fw_title, char const* fw_version,
+                                      size_t const& fw_size, char const* fw_checksum,
+                                      Checksum_Algorithm const& fw_checksum_algorithm)
+    {
+        // Cached firmware binary of a previous update might still be open, which has to be closed before another entry of the same cache can be opened
+        Close_Cached_Firmware();
+        IFirmware_Cache* firmware_cache = fw_callback.Get_Firmware_Cache();
+        if (firmware_cache == nullptr || !firmware_cache->open_entry(fw_checksum, fw_checksum_algorithm, fw_size))
+        {
+            return false;
+        }
+        Prepare_Firmware_Update(fw_callback, fw_title, fw_version, fw_size, fw_checksum, fw_checksum_algorithm);
+        // Buffer of the download over HTTP is used to read the cached firmware binary, because both never happen at the same time
+        m_stream_buffer_size = m_fw_callback->Get_Chunk_Size();
+        m_stream_buffer = static_cast<uint8_t*>(malloc(m_stream_buffer_size));
+        if (m_stream_buffer == nullptr)
+        {
+            Logger::printfln(STREAM_BUFFER_ALLOCATION_FAILED, m_stream_buffer_size);
+            m_stream_buffer_size = 0U;
+            firmware_cache->close_entry();
+            return false;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_UPDATE_FROM_CACHE, m_fw_checksum);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        // Prevents the flashed chunks from being written into a new entry of the same cache they are read out of
+        m_applying_cache = true;
+        Reset_Firmware_Update();
+        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
+        return true;
+    }
+
+    /// @brief Advances the firmware update started with Apply_Cached_Firmware_Update() by a single step, which either writes the next chunk of the cached firmware binary
+    /// or verifies the checksum and finishes the update once the complete cached firmware binary has been written.
+    /// If the cached firmware binary can not be read or does not match the expected checksum, the entry is removed and the already written data is discarded, so the firmware binary can be downloaded instead.
+    /// Does nothing if no firmware binary is currently applied out of the cache
+    /// @return Whether the cached firmware binary could not be applied and the firmware binary has to be downloaded instead
+    bool Cached_Firmware_Step()
+    {
+        if (!m_applying_cache || m_stream_buffer == nullptr)
+        {
+            return false;
+        }
+        else if (m_written_bytes < m_fw_size)
+        {
+            size_t const remaining_bytes = m_fw_size - m_written_bytes;
+            size_t const read_bytes = remaining_bytes < m_stream_buffer_size ? remaining_bytes : m_stream_buffer_size;
+            bool const valid_entry = m_firmware_cache->read_entry(m_written_bytes, m_stream_buffer, read_bytes) == read_bytes;
+            if (!valid_entry || !Flash_Firmware_Packet(m_written_bytes, m_stream_buffer, read_bytes))
+            {
+                return Discard_Cached_Firmware(!valid_entry);
+            }
+            m_written_bytes += read_bytes;
+            size_t const written_chunks = m_written_bytes >= m_fw_size ? m_total_chunks : m_written_bytes / m_stream_buffer_size;
+            // Update might be cancelled during the progress callback, which closes the cached firmware binary and handles the failure when it is stopped
+            m_fw_callback->Call_Progress_Callback(written_chunks, m_total_chunks);
+            return false;
+        }
+        Close_Cached_Firmware();
+
+        char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
+        (void)m_hash.finish(calculated_checksum);
+        if (strncmp(m_fw_checksum, calculated_checksum, strlen(m_fw_checksum)) != 0)
+        {
+            return Discard_Cached_Firmware(true);
+        }
+        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADED, "");
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(CHECKSUM_VERIFICATION_SUCCESS);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        if (!m_fw_updater->end())
+        {
+            // Cached firmware binary itself has been verified, therefore the entry is kept and the download is attempted with its retries instead
+            Logger::printfln(ERROR_UPDATE_END);
+            return Discard_Cached_Firmware(false);
+        }
+        Complete_Firmware_Update();
+        return false;
+    }
+
+    /// @brief Stops the firmware update completly and informs that user that the update has failed because it has been aborted, ongoing communication is discarded.
+    /// Be aware the written partition is not erased so the already written binary firmware data still remains in the flash partition,
+    /// shouldn't really matter, because if we start the update process again the partition will be overwritten anyway and a partially written firmware will not be bootable
+    void Stop_Firmware_Update()
+    {
+        // Serial.println("Stop_Firmware_Update called");
+
+        m_watchdog.detach();
+        m_write_pipeline.Stop();
+        m_fw_updater->reset();
+        Free_Reorder_Buffer();
+        Close_Cached_Firmware();
+        Free_Stream_Buffer();
+        m_streaming = false;
+        Logger::printfln(FW_UPDATE_ABORTED);
+        Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, FW_UPDATE_ABORTED);
+        m_fw_callback = nullptr;
+    }
+
+    /// @brief Uses the given firmware packet data and process it. Starting with writing the given amount of bytes of the packet data into flash memory and
+    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file.
+    /// If the chunk was received before all previous chunks have been handled, because multiple chunks are requested at once, it is instead copied into the reorder buffer
+    /// and only written once all previous chunks have been written, this ensures flash writes and hash updates stay strictly sequential.
+    /// If the write pipeline is enabled, the chunk is only copied into it and written by a separate task, so the next chunks can be requested immediately
+    /// @param current_chunk Index of the chunk we recieved the binary data for, in units of the chunk size all outstanding chunks have been requested with
+    /// @param payload Firmware packet data of the current chunk
+    /// @param total_bytes Amount of bytes in the current firmware packet data
+    void Process_Firmware_Packet(size_t const& current_chunk, uint8_t* payload, size_t const& total_bytes)
+    {
+#ifdef ARDUINO
+        Serial.println(
+            "Process_Firmware_Packet called: " + String(current_chunk) + ", total_bytes: " + String(total_bytes));
+#endif // ARDUINO
+
+        // Remaining fragments of a chunk that was received in fragments will never arrive, because messages are never interleaved
+        if (!Discard_Fragmented_Firmware_Packet())
+        {
+            return;
+        }
+        size_t offset = 0U;
+        if (!Accept_Firmware_Packet(current_chunk, total_bytes, offset))
+        {
+            return;
+        }
+        // Corrupted chunks are requested again individually, instead of waiting for the timeout to request every outstanding chunk again
+        uint32_t calculated_crc = 0U;
+        uint32_t expected_crc = 0U;
+        if (!Received_Valid_Chunk_CRC(offset, payload, total_bytes, calculated_crc, expected_crc))
+        {
+            char message[Helper::detectSize(CHUNK_CRC_VERIFICATION_FAILED, calculated_crc, offset, expected_crc)] = {};
+            (void)snprintf(message, sizeof(message), CHUNK_CRC_VERIFICATION_FAILED, calculated_crc, offset, expected_crc);
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message, offset);
+        }
+
+        m_watchdog.detach();
+        m_chunk_size_controller.Chunk_Received(offset);
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        if (offset != m_written_bytes)
+        {
+            Buffer_Firmware_Packet(offset, payload, total_bytes);
+            // Receiving any outstanding chunk counts as progress, therefore the timeout is restarted for the remaining outstanding chunks
+            m_watchdog.once(m_fw_callback->Get_Timeout());
+            return;
+        }
+
+        if (!Write_Firmware_Packet(offset, payload, total_bytes))
+        {
+            return;
+        }
+        Handle_Written_Firmware_Packet();
+    }
+
+    /// @brief Uses the given fragment of a firmware packet, that is bigger than the receive buffer of the client and is therefore received in multiple parts.
+    /// If the chunk is the oldest outstanding chunk, every fragment is written directly into flash memory and into the hash function while it is received, without the complete chunk ever being held in memory.
+    /// Because the CRC32 of the chunk can only be verified once all fragments have been received, a corrupted or interrupted chunk rewinds the update to the last checkpointed block.
+    /// If the chunk was received before all previous chunks have been handled instead, the fragments are assembled in a free slot of the reorder buffer and the chunk is handled once it is complete.
+    /// Fragments have to be passed in order and must not be interleaved with the fragments of other chunks, complete messages can be passed as a single fragment
+    /// @param current_chunk Index of the chunk we recieved the fragment for, in units of the chunk size all outstanding chunks have been requested with
+    /// @param payload Binary data of the current fragment
+    /// @param fragment_offset Byte offset of the current fragment in the chunk
+    /// @param length Amount of bytes in the current fragment
+    /// @param total_bytes Amount of bytes in the complete firmware packet data of the current chunk
+    void Process_Firmware_Fragment(size_t const& current_chunk, uint8_t* payload, size_t const& fragment_offset, size_t const& length, size_t const& total_bytes)
+    {
+        if (fragment_offset == 0U && length == total_bytes)
+        {
+            return Process_Firmware_Packet(current_chunk, payload, total_bytes);
+        }
+        else if (fragment_offset == 0U)
+        {
+            if (!Begin_Fragmented_Firmware_Packet(current_chunk, total_bytes))
+            {
+                return;
+            }
+        }
+        // Fragments of a chunk that has been ignored or discarded are ignored as well
+        else if (!m_fragment_receiving || fragment_offset != m_fragment_received || total_bytes != m_fragment_size)
+        {
+            return;
+        }
+        if (length > total_bytes - fragment_offset)
+        {
+            return;
+        }
+
+        m_fragment_crc = Helper::calculateCRC32(payload, length, m_fragment_crc);
+        if (m_fragment_slot != nullptr)
+        {
+            (void)memcpy(Get_Buffered_Chunk_Data(*m_fragment_slot) + fragment_offset, payload, length);
+        }
+        else if (!Write_Firmware_Data(m_fragment_offset + fragment_offset, payload, length))
+        {
+            m_fragment_receiving = false;
+            return Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, m_write_error);
+        }
+        m_fragment_received += length;
+
+        // Receiving any fragment counts as progress, therefore the timeout is restarted while the remaining fragments are received
+        m_watchdog.detach();
+        if (m_fragment_received < m_fragment_size)
+        {
+            m_watchdog.once(m_fw_callback->Get_Timeout());
+            return;
+        }
+        m_fragment_receiving = false;
+        Complete_Fragmented_Firmware_Packet();
+    }
+
+#if !THINGSBOARD_USE_ESP_TIMER
+    /// @brief Used to update the watchdog timer which uses a simple software time in the background. Ensure to call recently often for higher precision.
+    /// Meaning the timer is actually triggered closer to the specified waiting time
+    void update()
+    {
+        m_watchdog.update();
+    }
+#endif // !THINGSBOARD_USE_ESP_TIMER
+
+private:
+    /// @brief Converts the index of the received chunk into its byte offset and checks whether it is outstanding and has the expected size.
+    /// Short chunks are requested again individually, instead of waiting for the timeout to request every outstanding chunk again
+    /// @param current_chunk Index of the chunk we recieved the binary data for, in units of the chunk size all outstanding chunks have been requested with
+    /// @param total_bytes Amount of bytes in the firmware packet data of the current chunk
+    /// @param offset Variable the byte offset of the chunk will be copied into
+    /// @return Whether the chunk should be handled, if it should not it has been ignored or the failure has already been handled
+    bool Accept_Firmware_Packet(size_t const& current_chunk, size_t const& total_bytes, size_t& offset)
+    {
+        // Ensure the multiplication can not overflow for invalid chunk indices, all valid offsets are smaller than the firmware size
+        size_t const chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        offset = current_chunk <= (m_fw_size / chunk_size) ? current_chunk * chunk_size : m_fw_size;
+        if (offset < m_written_bytes || offset >= m_next_request_offset)
+        {
+            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, offset, m_written_bytes, m_next_request_offset);
+            return false;
+        }
+        size_t expected_chunk_size = 0U;
+        if (!Received_Valid_Chunk_Size(offset, total_bytes, expected_chunk_size))
+        {
+            char message[Helper::detectSize(RECEIVED_UNEXPECTED_CHUNK_SIZE, total_bytes, expected_chunk_size)] = {};
+            (void)snprintf(message, sizeof(message), RECEIVED_UNEXPECTED_CHUNK_SIZE, total_bytes, expected_chunk_size);
+            Logger::printfln(message);
+            Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message, offset);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Starts receiving the chunk with the given index in fragments, if it is the oldest outstanding chunk its fragments are written directly,
+    /// otherwise they are assembled in a free slot of the reorder buffer. If there is no free slot the chunk is ignored and requested again once the timeout occurs
+    /// @param current_chunk Index of the chunk we recieved the first fragment for
+    /// @param total_bytes Amount of bytes in the complete firmware packet data of the current chunk
+    /// @return Whether the fragments of the chunk should be handled, if they should not the chunk has been ignored or the failure has already been handled
+    bool Begin_Fragmented_Firmware_Packet(size_t const& current_chunk, size_t const& total_bytes)
+    {
+        if (!Discard_Fragmented_Firmware_Packet())
+        {
+            return false;
+        }
+        size_t offset = 0U;
+        if (!Accept_Firmware_Packet(current_chunk, total_bytes, offset))
+        {
+            return false;
+        }
+
+        Buffered_Chunk* slot = nullptr;
+        if (offset != m_written_bytes)
+        {
+            slot = Find_Buffered_Chunk(offset) == nullptr ? Find_Free_Buffered_Chunk() : nullptr;
+            if (slot == nullptr)
+            {
+                return false;
+            }
+        }
+        // Fragments are written in this context, therefore all chunks still waiting in the write task have to be written first
+        else if (!m_write_pipeline.Flush())
+        {
+            Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, m_write_error);
+            return false;
+        }
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_CHUNK_FRAGMENTED, current_chunk, total_bytes);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_fragment_receiving = true;
+        m_fragment_offset = offset;
+        m_fragment_size = total_bytes;
+        m_fragment_received = 0U;
+        m_fragment_crc = 0U;
+        m_fragment_slot = slot;
+        return true;
+    }
+
+    /// @brief Handles the chunk whose fragments have all been received, by verifying its CRC32 and then either continuing with the following chunks if it has been written directly
+    /// or marking its slot of the reorder buffer as used if it has been assembled there
+    void Complete_Fragmented_Firmware_Packet()
+    {
+        size_t const offset = m_fragment_offset;
+        uint32_t expected_crc = 0U;
+        if (m_fw_callback->Get_Expected_Chunk_CRC(offset, m_fragment_size, expected_crc) && expected_crc != m_fragment_crc)
+        {
+            char message[Helper::detectSize(CHUNK_CRC_VERIFICATION_FAILED, m_fragment_crc, offset, expected_crc)] = {};
+            (void)snprintf(message, sizeof(message), CHUNK_CRC_VERIFICATION_FAILED, m_fragment_crc, offset, expected_crc);
+            Logger::printfln(message);
+            if (m_fragment_slot != nullptr)
+            {
+                return Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message, offset);
+            }
+            // Corrupted bytes have already been written into flash memory and into the hash
+            return Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, message);
+        }
+        m_chunk_size_controller.Chunk_Received(offset);
+
+        if (m_fragment_slot != nullptr)
+        {
+            m_fragment_slot->offset = offset;
+            m_fragment_slot->length = m_fragment_size;
+            m_fragment_slot->used = true;
+            m_fragment_slot = nullptr;
+            m_watchdog.once(m_fw_callback->Get_Timeout());
+            return;
+        }
+
+        Save_Checkpoint(offset + m_fragment_size);
+        m_written_bytes = offset + m_fragment_size;
+        m_chunk_size_controller.Chunk_Written(m_fragment_size);
+        Handle_Written_Firmware_Packet();
+    }
+
+    /// @brief Discards the chunk that is currently received in fragments, because its remaining fragments will never arrive.
+    /// Fragments assembled in the reorder buffer are simply dropped, fragments that have already been written directly are contained in flash memory and in the hash though,
+    /// therefore the update has to be rewound to the last checkpointed block
+    /// @return Whether the update can continue as is, if it can not the failure has already been handled
+    bool Discard_Fragmented_Firmware_Packet()
+    {
+        if (!m_fragment_receiving)
+        {
+            return true;
+        }
+        m_fragment_receiving = false;
+        if (m_fragment_slot != nullptr)
+        {
+            m_fragment_slot = nullptr;
+            return true;
+        }
+        char message[Helper::detectSize(FRAGMENTED_CHUNK_INTERRUPTED, m_fragment_offset, m_fragment_received, m_fragment_size)] = {};
+        (void)snprintf(message, sizeof(message), FRAGMENTED_CHUNK_INTERRUPTED, m_fragment_offset, m_fragment_received, m_fragment_size);
+        Logger::printfln(message);
+        Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, message);
+        return false;
+    }
+
+    /// @brief Writes all directly following chunks, that have been received out of order previously and are therefore already waiting in the reorder buffer,
+    /// reports the progress and requests the next chunks. Has to be called once the oldest outstanding chunk has been written
+    void Handle_Written_Firmware_Packet()
+    {
+        Buffered_Chunk* buffered_chunk = Find_Buffered_Chunk(m_written_bytes);
+        while (buffered_chunk != nullptr)
+        {
+            buffered_chunk->used = false;
+            if (!Write_Firmware_Packet(buffered_chunk->offset, Get_Buffered_Chunk_Data(*buffered_chunk), buffered_chunk->length))
+            {
+                return;
+            }
+            buffered_chunk = Find_Buffered_Chunk(m_written_bytes);
+        }
+
+        // Progress is reported in units of the configured chunk size, so it stays comparable even if the actual chunk size is adjusted adaptively
+        size_t const written_chunks = m_written_bytes >= m_fw_size ? m_total_chunks : m_written_bytes / m_fw_callback->Get_Chunk_Size();
+        m_fw_callback->Call_Progress_Callback(written_chunks, m_total_chunks);
+
+        // Ensure to check if the update was cancelled during the progress callback,
+        // if it was the callback variable was reset and there is no need to request the next firmware packet
+        if (m_fw_callback == nullptr)
+        {
+            Logger::printfln(OTA_CB_IS_NULL);
+            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
+        }
+        Request_Next_Firmware_Packet();
+    }
+
+    /// @brief Initalizes the configuration and the identity of the firmware binary, that is shared between downloading the firmware binary in chunks and as a stream
+    /// @param fw_callback Callback method that contains configuration information, about the over the air update
+    /// @param fw_title Title of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_version Version of the firmware binary, used to decide if a persisted checkpoint belongs to the same firmware binary
+    /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
+    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
+    void Prepare_Firmware_Update(OTA_Update_Callback const& fw_callback, char const* fw_title, char const* fw_version,
+                                 size_t const& fw_size, char const* fw_checksum,
+                                 Checksum_Algorithm const& fw_checksum_algorithm)
+    {
+        // Write task of a previous update might still be running and accesses the checkpoint, the hash and the updater
+        m_write_pipeline.Stop();
+        // Pending cache entry of a previous update that was never finished belongs to a different firmware binary
+        Abort_Cache_Entry();
+        Close_Cached_Firmware();
+        // Download of a previous update over HTTP might not have been finished yet
+        Free_Stream_Buffer();
+        m_fw_callback = &fw_callback;
+        m_fw_size = fw_size;
+        m_streaming = false;
+        m_firmware_cache = m_fw_callback->Get_Firmware_Cache();
+
+        // m_total_chunks = (m_fw_size / m_fw_callback->Get_Chunk_Size()) + 1U;
+        const size_t chunk = m_fw_callback->Get_Chunk_Size();
+        m_total_chunks = (m_fw_size + chunk - 1U) / chunk; // ceil division
+
+        (void)strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum));
+        m_fw_checksum_algorithm = fw_checksum_algorithm;
+        m_fw_updater = m_fw_callback->Get_Updater();
+
+        m_checkpoint = OTA_Checkpoint();
+        m_checkpoint.magic = OTA_CHECKPOINT_MAGIC;
+        (void)strncpy(m_checkpoint.fw_title, fw_title, sizeof(m_checkpoint.fw_title) - 1U);
+        (void)strncpy(m_checkpoint.fw_version, fw_version, sizeof(m_checkpoint.fw_version) - 1U);
+        (void)strncpy(m_checkpoint.fw_checksum, m_fw_checksum, sizeof(m_checkpoint.fw_checksum) - 1U);
+        m_checkpoint.fw_checksum_algorithm = m_fw_checksum_algorithm;
+        m_checkpoint.fw_size = m_fw_size;
+    }
+
+    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the chunk size the outstanding chunks have been requested with,
+    /// which is the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default, unless it is adjusted adaptively
+    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
+    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
+    /// @param offset Byte offset of the chunk we recieved the binary data for
+    /// @param received_chunk_size Size in bytes of the received chunk
+    /// @param expected_chunk_size Variable the expected chunk size for the given chunk will be copied into
+    /// @return Whether the received chunk has the expected size or not
+    bool Received_Valid_Chunk_Size(size_t const& offset, size_t const& received_chunk_size, size_t& expected_chunk_size) const
+    {
+        size_t const remaining_bytes = m_fw_size - offset;
+        size_t const chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        expected_chunk_size = remaining_bytes < chunk_size ? remaining_bytes : chunk_size;
+        return received_chunk_size == expected_chunk_size;
+    }
+
+    /// @brief Checks whether the CRC32 of the received chunk matches the expected CRC32 provided by the OTA_Update_Callback, which allows to detect a corrupted chunk directly after it has been received,
+    /// instead of only with the checksum of the complete firmware binary once every chunk has been written. Chunks whose expected CRC32 is not known are always treated as valid
+    /// @param offset Byte offset of the chunk we recieved the binary data for
+    /// @param payload Firmware packet data of the received chunk
+    /// @param total_bytes Amount of bytes in the received firmware packet data
+    /// @param calculated_crc Variable the calculated CRC32 of the received chunk will be copied into
+    /// @param expected_crc Variable the expected CRC32 of the received chunk will be copied into
+    /// @return Whether the received chunk has the expected CRC32 or its expected CRC32 is not known
+    bool Received_Valid_Chunk_CRC(size_t const& offset, uint8_t const* payload, size_t const& total_bytes, uint32_t& calculated_crc, uint32_t& expected_crc) const
+    {
+        if (!m_fw_callback->Get_Expected_Chunk_CRC(offset, total_bytes, expected_crc))
+        {
+            return true;
+        }
+        calculated_crc = Helper::calculateCRC32(payload, total_bytes);
+        return calculated_crc == expected_crc;
+    }
+
+    /// @brief Writes the given firmware chunk into flash memory and into the hash function or copies it into the write pipeline if it is running,
+    /// has to be called in strictly sequential order of the chunks
+    /// @param offset Byte offset of the chunk we want to write the binary data for, has to be the amount of bytes that have already been written
+    /// @param payload Firmware packet data of the given chunk
+    /// @param total_bytes Amount of bytes in the given firmware packet data
+    /// @return Whether writing the chunk was successful or not, if it was not the failure has already been handled
+    bool Write_Firmware_Packet(size_t const& offset, uint8_t* payload, size_t const& total_bytes)
+    {
+        bool const written = m_write_pipeline.Is_Running() ? m_write_pipeline.Enqueue(offset, payload, total_bytes) : Flash_Firmware_Packet(offset, payload, total_bytes);
+        if (!written)
+        {
+            // If a previous chunk failed to be written by the write task, the message has already been copied before the pipeline reported the failure.
+            // Only the bytes written after the last checkpointed block are discarded, if the updater supports continuing from there
+            Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, m_write_error);
+            return false;
+        }
+        m_written_bytes = offset + total_bytes;
+        m_chunk_size_controller.Chunk_Written(total_bytes);
+        return true;
+    }
+
+    /// @brief Writes the given firmware chunk into flash memory and into the hash function and persists a checkpoint if necessary, has to be called in strictly sequential order of the chunks.
+    /// Is called in the context of the write task if the write pipeline is running, therefore it only accesses the updater, the hash and the checkpoint and leaves handling failures to the caller
+    /// @param offset Byte offset of the chunk we want to write the binary data for
+    /// @param payload Firmware packet data of the given chunk
+    /// @param total_bytes Amount of bytes in the given firmware packet data
+    /// @return Whether writing the chunk was successful or not, if it was not the error message has been copied into m_write_error
+    bool Flash_Firmware_Packet(size_t const& offset, uint8_t* payload, size_t const& total_bytes)
+    {
+        if (!Write_Firmware_Data(offset, payload, total_bytes))
+        {
+            return false;
+        }
+        Save_Checkpoint(offset + total_bytes);
+        return true;
+    }
+
+    /// @brief Writes the given binary data into flash memory, into the hash function and into the firmware cache, without persisting a checkpoint,
+    /// so chunks received in fragments are only checkpointed once they are complete. Has to be called in strictly sequential order of the binary data
+    /// @param offset Byte offset of the binary data in the firmware binary
+    /// @param payload Binary data that should be written
+    /// @param total_bytes Amount of bytes in the given binary data
+    /// @return Whether writing the binary data was successful or not, if it was not the error message has been copied into m_write_error
+    bool Write_Firmware_Data(size_t const& offset, uint8_t* payload, size_t const& total_bytes)
+    {
+        if (offset == 0U)
+        {
+            // Initialize Flash
+            if (!m_fw_updater->begin(m_fw_size))
+            {
+                Logger::printfln(ERROR_UPDATE_BEGIN);
+                (void)strncpy(m_write_error, ERROR_UPDATE_BEGIN, sizeof(m_write_error) - 1U);
+                return false;
+            }
+            Begin_Cache_Entry();
+        }
+
+        // Write received binary data to flash partition
+        size_t const written_bytes = m_fw_updater->write(payload, total_bytes);
+        if (written_bytes != total_bytes)
+        {
+            (void)snprintf(m_write_error, sizeof(m_write_error), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
+            Logger::printfln(m_write_error);
+            return false;
+        }
+
+        // Update value only if writing to flash was a success, result is ignored,
+        // because it can only fail if the input parameters are invalid
+        (void)m_hash.update(payload, total_bytes);
+        Write_Cache_Entry(payload, total_bytes);
+        return true;
+    }
+
+    /// @brief Starts filling a new entry of the firmware cache, if it is configured and the firmware binary is not applied out of the cache itself.
+    /// Is only called once the firmware binary is written from the beginning, a resumed update is not cached, because the previously written bytes are not available anymore
+    void Begin_Cache_Entry()
+    {
+        m_cache_filling = !m_applying_cache && m_firmware_cache != nullptr &&
+            m_firmware_cache->begin_entry(m_fw_checksum, m_fw_checksum_algorithm, m_fw_size);
+    }
+
+    /// @brief Writes the given firmware chunk into the entry of the firmware cache that is currently filled.
+    /// Failing to write into the cache does not fail the update, instead the entry is discarded and the update continues without caching the firmware binary
+    /// @param payload Firmware packet data of the given chunk
+    /// @param total_bytes Amount of bytes in the given firmware packet data
+    void Write_Cache_Entry(uint8_t const* payload, size_t const& total_bytes)
+    {
+        if (!m_cache_filling || m_firmware_cache->write_entry(payload, total_bytes))
+        {
+            return;
+        }
+        Logger::printfln(CACHE_ENTRY_WRITE_FAILED);
+        Abort_Cache_Entry();
+    }
+
+    /// @brief Completes the entry of the firmware cache that is currently filled, has to be called once the checksum of the complete firmware binary has been verified
+    void Complete_Cache_Entry()
+    {
+        if (!m_cache_filling)
+        {
+            return;
+        }
+        m_cache_filling = false;
+        (void)m_firmware_cache->end_entry();
+    }
+
+    /// @brief Discards the entry of the firmware cache that is currently filled, because the already written data has been discarded or the update failed
+    void Abort_Cache_Entry()
+    {
+        if (!m_cache_filling)
+        {
+            return;
+        }
+        m_cache_filling = false;
+        m_firmware_cache->abort_entry();
+    }
+
+    /// @brief Starts the write pipeline if it is enabled, so received chunks are written by a separate task.
+    /// If starting fails, because there is not enough heap memory or the platform does not support it, chunks are simply written directly instead
+    /// @param slot_size Size in bytes every slot has to be able to hold
+    void Start_Write_Pipeline(size_t const& slot_size)
+    {
+        uint8_t const depth = m_fw_callback->Get_Write_Pipeline_Depth();
+        if (depth == 0U)
+        {
+            return;
+        }
+        if (!m_write_pipeline.Start(depth, slot_size, m_fw_callback->Get_Write_Pipeline_Core(),
+                                    std::bind(&OTA_Handler::Flash_Firmware_Packet, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)))
+        {
+            Logger::printfln(WRITE_PIPELINE_START_FAILED, depth * slot_size);
+        }
+    }
+
+    /// @brief Copies the given firmware chunk into a free slot of the reorder buffer, so it can be written once all previous chunks have been written.
+    /// Chunks that are already buffered are ignored, because they might be received twice if they were requested again after a timeout
+    /// @param offset Byte offset of the chunk we recieved the binary data for
+    /// @param payload Firmware packet data of the given chunk
+    /// @param total_bytes Amount of bytes in the given firmware packet data
+    void Buffer_Firmware_Packet(size_t const& offset, uint8_t const* payload, size_t const& total_bytes)
+    {
+        if (Find_Buffered_Chunk(offset) != nullptr)
+        {
+            return;
+        }
+        Buffered_Chunk* buffered_chunk = Find_Free_Buffered_Chunk();
+        if (buffered_chunk == nullptr)
+        {
+            return;
+        }
+        buffered_chunk->offset = offset;
+        buffered_chunk->length = total_bytes;
+        buffered_chunk->used = true;
+        (void)memcpy(Get_Buffered_Chunk_Data(*buffered_chunk), payload, total_bytes);
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_CHUNK_BUFFERED, offset, m_written_bytes);
+#endif // THINGSBOARD_ENABLE_DEBUG
     }
 
-    /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
-    /// @param fw_callback Callback method that contains configuration information, about the over the air update
-    /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
-    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
-    /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
-    void Start_Firmware_Update(OTA_Update_Callback const& fw_callback, size_t const& fw_size, char const* fw_checksum,
-                               mbedtls_md_type_t const& fw_checksum_algorithm)
+    /// @brief Searches the reorder buffer for a slot that does not hold a chunk and is not used to assemble the fragments of a chunk either
+    /// @return Pointer to the free slot or nullptr if all slots are used or there is no reorder buffer
+    Buffered_Chunk* Find_Free_Buffered_Chunk()
     {
-        m_fw_callback = &fw_callback;
-        m_fw_size = fw_size;
+        for (size_t i = 0U; m_reorder_slots != nullptr && i < m_request_window - 1U; i++)
+        {
+            Buffered_Chunk& buffered_chunk = m_reorder_slots[i];
+            if (!buffered_chunk.used && &buffered_chunk != m_fragment_slot)
+            {
+                return &buffered_chunk;
+            }
+        }
+        return nullptr;
+    }
 
-        // m_total_chunks = (m_fw_size / m_fw_callback->Get_Chunk_Size()) + 1U;
-        const size_t chunk = m_fw_callback->Get_Chunk_Size();
-        m_total_chunks = (m_fw_size + chunk - 1U) / chunk; // ceil division
+    /// @brief Searches the reorder buffer for the given chunk
+    /// @param offset Byte offset of the chunk we want to find
+    /// @return Pointer to the slot containing the given chunk or nullptr if it has not been buffered
+    Buffered_Chunk* Find_Buffered_Chunk(size_t const& offset)
+    {
+        for (size_t i = 0U; m_reorder_slots != nullptr && i < m_request_window - 1U; i++)
+        {
+            Buffered_Chunk& buffered_chunk = m_reorder_slots[i];
+            if (buffered_chunk.used && buffered_chunk.offset == offset)
+            {
+                return &buffered_chunk;
+            }
+        }
+        return nullptr;
+    }
 
-        Serial.println(
-            "Start_Firmware_Update :: Chunk size: " + String(m_fw_size) + ", Total chunks : " + String(m_total_chunks));
+    /// @brief Returns the memory the binary data of the given slot of the reorder buffer is saved into
+    /// @param buffered_chunk Slot of the reorder buffer
+    /// @return Pointer to the first byte of the binary data of the given slot
+    uint8_t* Get_Buffered_Chunk_Data(Buffered_Chunk const& buffered_chunk) const
+    {
+        size_t const index = &buffered_chunk - m_reorder_slots;
+        return m_reorder_buffer + (index * m_reorder_chunk_size);
+    }
 
-        (void)strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum));
-        m_fw_checksum_algorithm = fw_checksum_algorithm;
-        m_fw_updater = m_fw_callback->Get_Updater();
-        Request_First_Firmware_Packet();
-        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
+    /// @brief Allocates the reorder buffer, which can hold all but one of the chunks that are requested at once, because the oldest outstanding chunk is always written directly,
+    /// together with the remaining retries of every chunk that can be requested at once.
+    /// If allocating the memory fails, the update simply falls back to requesting one chunk at a time, which does not require any additional memory
+    void Allocate_Reorder_Buffer()
+    {
+        Free_Reorder_Buffer();
+        uint8_t const request_window = m_fw_callback->Get_Request_Window();
+        m_request_window = request_window > 1U ? request_window : 1U;
+        // Requesting more chunks at once than the firmware binary consists of would only waste memory
+        if (m_total_chunks > 0U && m_request_window > m_total_chunks)
+        {
+            m_request_window = m_total_chunks;
+        }
+        if (m_request_window <= 1U)
+        {
+            return;
+        }
+
+        size_t const slots = m_request_window - 1U;
+        m_reorder_chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        size_t const buffer_size = slots * m_reorder_chunk_size;
+        m_reorder_slots = static_cast<Buffered_Chunk*>(malloc(slots * sizeof(Buffered_Chunk)));
+        m_reorder_buffer = static_cast<uint8_t*>(malloc(buffer_size));
+        m_request_retries = static_cast<uint8_t*>(malloc(m_request_window * sizeof(uint8_t)));
+        if (m_reorder_slots == nullptr || m_reorder_buffer == nullptr || m_request_retries == nullptr)
+        {
+            Logger::printfln(REORDER_BUFFER_ALLOCATION_FAILED, buffer_size);
+            Free_Reorder_Buffer();
+            return;
+        }
+        // Slots are only granted retries once a chunk is requested in them, failures before that abort the update the same as if the retries were exhausted
+        (void)memset(m_request_retries, 0, m_request_window * sizeof(uint8_t));
+        Clear_Reorder_Buffer();
     }
 
-    /// @brief Stops the firmware update completly and informs that user that the update has failed because it has been aborted, ongoing communication is discarded.
-    /// Be aware the written partition is not erased so the already written binary firmware data still remains in the flash partition,
-    /// shouldn't really matter, because if we start the update process again the partition will be overwritten anyway and a partially written firmware will not be bootable
-    void Stop_Firmware_Update()
+    /// @brief Increases the size of every slot of the reorder buffer, so it can hold chunks with the given chunk size, may only be called while no chunks are buffered
+    /// @param chunk_size Chunk size in bytes every slot has to be able to hold
+    /// @return Whether the slots can hold chunks with the given size, if increasing fails the previous buffer is kept unchanged
+    bool Resize_Reorder_Buffer(size_t const& chunk_size)
     {
-        // Serial.println("Stop_Firmware_Update called");
+        if (m_reorder_buffer == nullptr || chunk_size <= m_reorder_chunk_size)
+        {
+            return true;
+        }
+        uint8_t* reorder_buffer = static_cast<uint8_t*>(realloc(m_reorder_buffer, (m_request_window - 1U) * chunk_size));
+        if (reorder_buffer == nullptr)
+        {
+            return false;
+        }
+        m_reorder_buffer = reorder_buffer;
+        m_reorder_chunk_size = chunk_size;
+        return true;
+    }
 
-        m_watchdog.detach();
-        m_fw_updater->reset();
-        Logger::printfln(FW_UPDATE_ABORTED);
-        Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, FW_UPDATE_ABORTED);
-        m_fw_callback = nullptr;
+    /// @brief Marks all slots of the reorder buffer as unused, discarding any buffered chunks
+    void Clear_Reorder_Buffer()
+    {
+        // Remaining fragments of a chunk belong to the discarded data as well, no matter if they would be assembled in a slot or written directly
+        m_fragment_receiving = false;
+        m_fragment_slot = nullptr;
+        for (size_t i = 0U; m_reorder_slots != nullptr && i < m_request_window - 1U; i++)
+        {
+            m_reorder_slots[i] = Buffered_Chunk();
+        }
     }
 
-    /// @brief Uses the given firmware packet data and process it. Starting with writing the given amount of bytes of the packet data into flash memory and
-    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file
-    /// @param current_chunk Index of the chunk we recieved the binary data for
-    /// @param payload Firmware packet data of the current chunk
-    /// @param total_bytes Amount of bytes in the current firmware packet data
-    void Process_Firmware_Packet(size_t const& current_chunk, uint8_t* payload, size_t const& total_bytes)
+    /// @brief Frees the memory of the reorder buffer and falls back to requesting one chunk at a time
+    void Free_Reorder_Buffer()
     {
-        Serial.println(
-            "Process_Firmware_Packet called: " + String(current_chunk) + ", total_bytes: " + String(total_bytes));
+        m_fragment_receiving = false;
+        m_fragment_slot = nullptr;
+        free(m_reorder_slots);
+        m_reorder_slots = nullptr;
+        free(m_reorder_buffer);
+        m_reorder_buffer = nullptr;
+        free(m_request_retries);
+        m_request_retries = nullptr;
+        m_reorder_chunk_size = 0U;
+        m_request_window = 1U;
+    }
+
+    /// @brief Returns the remaining retries of the request slot the chunk with the given offset is requested in. Outstanding chunks always have consecutive offsets
+    /// and there are never more of them than the request window, therefore every outstanding chunk has its own slot. If only one chunk is requested at once there is only a single slot
+    /// @param offset Byte offset of the chunk, has to be a multiple of the current chunk size
+    /// @return Reference to the remaining retries of the chunk
+    uint8_t& Get_Request_Retries(size_t const& offset)
+    {
+        if (m_request_retries == nullptr)
+        {
+            return m_retries;
+        }
+        return m_request_retries[(offset / m_chunk_size_controller.Get_Chunk_Size()) % m_request_window];
+    }
 
-        if (current_chunk != m_requested_chunks)
+    /// @brief Frees the buffer the streamed firmware binary is collected in together with the copied path and closes the connection of the HTTP client, if it has been allocated
+    void Free_Stream_Buffer()
+    {
+        if (m_stream_buffer == nullptr)
         {
-            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_requested_chunks);
             return;
         }
-        size_t expected_chunk_size = 0U;
-        if (!Received_Valid_Chunk_Size(total_bytes, expected_chunk_size))
+        // Connection might still be receiving the response body, which would otherwise be read as the response to the next request
+        if (m_range_requested && m_http_client != nullptr)
+        {
+            m_http_client->stop();
+        }
+        m_range_requested = false;
+        free(m_stream_buffer);
+        m_stream_buffer = nullptr;
+        m_stream_path = nullptr;
+        m_stream_buffer_size = 0U;
+    }
+
+    /// @brief Closes the cached firmware binary that is currently applied and frees the buffer it is read into, does nothing if no firmware binary is applied out of the cache
+    void Close_Cached_Firmware()
+    {
+        if (!m_applying_cache)
         {
-            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, expected_chunk_size, total_bytes);
             return;
         }
+        m_applying_cache = false;
+        m_firmware_cache->close_entry();
+        Free_Stream_Buffer();
+    }
+
+    /// @brief Discards the data already written out of the cached firmware binary, so the firmware binary can be downloaded instead
+    /// @param invalid_entry Whether the cached firmware binary could not be read or did not match the expected checksum and should therefore be removed from the cache
+    /// @return Always true, because the firmware binary has to be downloaded instead
+    bool Discard_Cached_Firmware(bool const& invalid_entry)
+    {
+        Close_Cached_Firmware();
+        if (invalid_entry)
+        {
+            Logger::printfln(CACHED_FIRMWARE_INVALID);
+            m_firmware_cache->remove_entry(m_fw_checksum, m_fw_checksum_algorithm);
+        }
+        Reset_Firmware_Update();
+        return true;
+    }
 
-        m_watchdog.detach();
+    /// @brief Sends a range request for the firmware binary starting after the already written bytes, the response body is then read by the following steps
+    void Request_Firmware_Range()
+    {
+        int const error = m_http_client->get_range(m_stream_path, m_written_bytes);
+        if (error != 0)
+        {
+            m_http_client->stop();
+            char message[Helper::detectSize(HTTP_RANGE_REQUEST_FAILED, m_written_bytes, error)] = {};
+            (void)snprintf(message, sizeof(message), HTTP_RANGE_REQUEST_FAILED, m_written_bytes, error);
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
+        }
+
+        // Servers that do not support range requests respond with the complete firmware binary instead, in that case the already written bytes are simply skipped
+        m_skipped_bytes = 0U;
+        int const status = m_http_client->get_response_status_code();
+        if (status == HTTP_STATUS_OK)
+        {
+            m_skipped_bytes = m_written_bytes;
 #if THINGSBOARD_ENABLE_DEBUG
-        Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
+            if (m_skipped_bytes != 0U)
+            {
+                Logger::printfln(FW_RANGE_IGNORED, m_skipped_bytes);
+            }
 #endif // THINGSBOARD_ENABLE_DEBUG
+        }
+        else if (status != HTTP_STATUS_PARTIAL_CONTENT)
+        {
+            m_http_client->stop();
+            char message[Helper::detectSize(HTTP_UNEXPECTED_STATUS, status)] = {};
+            (void)snprintf(message, sizeof(message), HTTP_UNEXPECTED_STATUS, status);
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
+        }
+        m_range_requested = true;
+        m_buffered_bytes = 0U;
+        m_last_received_time = Helper::getTimeMicroseconds();
+    }
 
-        if (current_chunk == 0U)
+    /// @brief Reads the next part of the response body of the previously sent range request and writes the buffer once it is full.
+    /// Bytes that do not fill the complete buffer when the connection is interrupted are discarded and received again with the next range request
+    void Read_Firmware_Range()
+    {
+        size_t const remaining_bytes = m_fw_size - m_written_bytes;
+        size_t expected_bytes = remaining_bytes < m_stream_buffer_size ? remaining_bytes : m_stream_buffer_size;
+        if (m_skipped_bytes != 0U)
         {
-            // Initialize Flash
-            if (!m_fw_updater->begin(m_fw_size))
+            expected_bytes = m_skipped_bytes < m_stream_buffer_size ? m_skipped_bytes : m_stream_buffer_size;
+        }
+        int const read_bytes = m_http_client->read_response_body(m_stream_buffer + m_buffered_bytes, expected_bytes - m_buffered_bytes);
+        uint64_t const current_time = Helper::getTimeMicroseconds();
+        if (read_bytes < 0 || (read_bytes == 0 && (current_time - m_last_received_time) > m_fw_callback->Get_Timeout()))
+        {
+            m_http_client->stop();
+            m_range_requested = false;
+            char message[Helper::detectSize(HTTP_DOWNLOAD_INTERRUPTED, m_written_bytes, m_fw_size)] = {};
+            (void)snprintf(message, sizeof(message), HTTP_DOWNLOAD_INTERRUPTED, m_written_bytes, m_fw_size);
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
+        }
+        else if (read_bytes == 0)
+        {
+            return;
+        }
+        m_last_received_time = current_time;
+
+        if (m_skipped_bytes != 0U)
+        {
+            m_skipped_bytes -= read_bytes;
+            return;
+        }
+        m_buffered_bytes += read_bytes;
+        if (m_buffered_bytes < expected_bytes)
+        {
+            return;
+        }
+        size_t const buffered_bytes = m_buffered_bytes;
+        m_buffered_bytes = 0U;
+        if (!Write_Firmware_Stream(m_stream_buffer, buffered_bytes))
+        {
+            // The remaining response body belongs to the previous offset, therefore the connection has to be closed before the next range request can be sent.
+            // Update might have been stopped during the progress callback, which already closed the connection and freed the buffer
+            if (m_range_requested)
             {
-                Logger::printfln(ERROR_UPDATE_BEGIN);
-                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+                m_http_client->stop();
+                m_range_requested = false;
             }
+            return;
         }
+        // Complete response body has been read, therefore the kept alive connection can be reused if the update has to be restarted after an invalid checksum
+        if (m_written_bytes >= m_fw_size)
+        {
+            m_range_requested = false;
+        }
+    }
 
-        // Write received binary data to flash partition
-        size_t const written_bytes = m_fw_updater->write(payload, total_bytes);
-        if (written_bytes != total_bytes)
+    /// @brief Writes the given received bytes of the firmware binary directly after the already written bytes, persists a checkpoint if necessary and reports the progress
+    /// @param payload Received binary data of the firmware binary
+    /// @param total_bytes Amount of bytes in the given binary data
+    /// @return Whether writing was successful and the update is still running, if it is not the failure has already been handled
+    bool Write_Firmware_Stream(uint8_t* payload, size_t const& total_bytes)
+    {
+        uint32_t calculated_crc = 0U;
+        uint32_t expected_crc = 0U;
+        if (!Received_Valid_Chunk_CRC(m_written_bytes, payload, total_bytes, calculated_crc, expected_crc))
         {
-            char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, total_bytes)] = {};
-            (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
+            // Range request that follows starts at the already written bytes, which requests the corrupted bytes again
+            char message[Helper::detectSize(CHUNK_CRC_VERIFICATION_FAILED, calculated_crc, m_written_bytes, expected_crc)] = {};
+            (void)snprintf(message, sizeof(message), CHUNK_CRC_VERIFICATION_FAILED, calculated_crc, m_written_bytes, expected_crc);
             Logger::printfln(message);
-            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
+            return false;
+        }
+        if (!Write_Firmware_Packet(m_written_bytes, payload, total_bytes))
+        {
+            return false;
         }
 
-        // Update value only if writing to flash was a success, result is ignored,
-        // because it can only fail if the input parameters are invalid
-        (void)m_hash.update(payload, total_bytes);
-
-        m_requested_chunks = current_chunk + 1;
-        m_fw_callback->Call_Progress_Callback(m_requested_chunks, m_total_chunks);
+        size_t const written_chunks = m_written_bytes >= m_fw_size ? m_total_chunks : m_written_bytes / m_fw_callback->Get_Chunk_Size();
+        m_fw_callback->Call_Progress_Callback(written_chunks, m_total_chunks);
 
-        // Ensure to check if the update was cancelled during the progress callback,
-        // if it was the callback variable was reset and there is no need to request the next firmware packet
+        // Ensure to check if the update was cancelled during the progress callback, the failure has already been handled when it was stopped
         if (m_fw_callback == nullptr)
         {
-            Logger::printfln(OTA_CB_IS_NULL);
-            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
+            return false;
         }
 
-        // Reset retries as the current chunk has been downloaded and handled successfully
-        m_retries = m_fw_callback->Get_Chunk_Retries();
+        // Reset retries only if bytes have been written that were never written before, because writing the same bytes again after the update has been restarted is no progress
+        // and would otherwise cause a firmware binary with an invalid checksum to be downloaded again indefinitely
+        if (m_written_bytes > m_furthest_written_bytes)
+        {
+            m_furthest_written_bytes = m_written_bytes;
+            m_retries = m_fw_callback->Get_Chunk_Retries();
+        }
+        return true;
+    }
+
+    /// @brief Resumes the firmware update from the persisted checkpoint, if it belongs to the same firmware binary and the updater and hash calculation can be continued from it,
+    /// and then requests the firmware chunks following the already written bytes
+    /// @return Whether the update was resumed, if it was not the update has to be started from the beginning instead
+    bool Resume_Firmware_Update()
+    {
+        if (!Restore_Checkpoint())
+        {
+            return false;
+        }
         Request_Next_Firmware_Packet();
+        return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Used to update the watchdog timer which uses a simple software time in the background. Ensure to call recently often for higher precision.
-    /// Meaning the timer is actually triggered closer to the specified waiting time
-    void update()
+    /// @brief Restores the progress of the firmware update from the persisted checkpoint, if it belongs to the same firmware binary and the updater and hash calculation can be continued from it
+    /// @return Whether the progress was restored, if it was not the update has to be started from the beginning instead
+    bool Restore_Checkpoint()
     {
-        m_watchdog.update();
+        IOTA_Checkpoint_Store* checkpoint_store = m_fw_callback->Get_Checkpoint_Store();
+        if (checkpoint_store == nullptr)
+        {
+            return false;
+        }
+
+        OTA_Checkpoint checkpoint = {};
+        if (!checkpoint_store->load(checkpoint) || !Is_Same_Firmware(checkpoint))
+        {
+            return false;
+        }
+        m_checkpoint = checkpoint;
+        if (!Continue_From_Checkpoint())
+        {
+            return false;
+        }
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_UPDATE_RESUMED, m_written_bytes, m_fw_size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_retries = m_fw_callback->Get_Chunk_Retries();
+        return true;
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
-private:
-    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
-    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
-    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
-    /// @param received_chunk_size Size in bytes of the received chunk
-    /// @param expected_chunk_size Variable the expected chunk size for the currently requested chunk will be copied into
-    /// @return Whether the received chunk has the expected size or not
-    bool Received_Valid_Chunk_Size(size_t const& received_chunk_size, size_t& expected_chunk_size)
+    /// @brief Rewinds the firmware update to the last block boundary the hash state has been checkpointed at, instead of restarting it from the beginning,
+    /// if the updater supports continuing from there. Discards every byte written after the block boundary, including chunks still waiting in the write pipeline.
+    /// The hash state is checkpointed in memory every checkpoint interval, even if no checkpoint store is configured to persist it
+    /// @return Whether the update was rewound, if it was not it has to be restarted from the beginning instead
+    bool Rewind_Firmware_Update()
     {
-        // Serial.println("Received_Valid_Chunk_Size called");
+        m_write_pipeline.Cancel();
+        // Bytes already written into the cache entry after the block boundary can not be discarded, therefore the remaining update is not cached
+        Abort_Cache_Entry();
+        if (!Continue_From_Checkpoint())
+        {
+            return false;
+        }
 
-        // bool const is_last_chunk = m_requested_chunks + 1 >= m_total_chunks;
-        // if (is_last_chunk) {
-        //     size_t const last_chunk_expected_size = m_fw_size % m_fw_callback->Get_Chunk_Size();
-        //     expected_chunk_size = last_chunk_expected_size;
-        //     return received_chunk_size == last_chunk_expected_size;
-        // }
-        // expected_chunk_size = m_fw_callback->Get_Chunk_Size();
-        // return received_chunk_size == m_fw_callback->Get_Chunk_Size();
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_UPDATE_REWOUND, m_written_bytes, m_fw_size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
 
-        bool const is_last_chunk = (m_requested_chunks + 1U) >= m_total_chunks;
-        if (is_last_chunk)
+    /// @brief Continues the updater and the hash calculation from the block boundary contained in the current checkpoint and discards all outstanding chunks
+    /// @return Whether the progress was restored, if it was not the update has to be started from the beginning instead
+    bool Continue_From_Checkpoint()
+    {
+        size_t const offset = m_checkpoint.written_bytes;
+        // The offset has to be a multiple of the chunk size, because the server calculates the offset by multiplying the requested chunk index with the chunk size,
+        // range requests when streaming the firmware binary can start at any offset instead
+        if (offset == 0U || offset >= m_fw_size || (!m_streaming && !m_chunk_size_controller.Align_Chunk_Size(offset)))
         {
-            size_t const mod = m_fw_size % m_fw_callback->Get_Chunk_Size();
-            expected_chunk_size = (mod == 0U) ? m_fw_callback->Get_Chunk_Size() : mod;
-            return received_chunk_size == expected_chunk_size;
+            return false;
+        }
+        if (!m_fw_updater->resume(m_fw_size, offset))
+        {
+            return false;
+        }
+        if (!m_hash.restore(m_checkpoint.fw_checksum_algorithm, m_checkpoint.hash_context, m_checkpoint.hash_context_size))
+        {
+            m_fw_updater->reset();
+            return false;
+        }
+        m_written_bytes = offset;
+        m_next_request_offset = offset;
+        m_checkpoint_offset = offset;
+        Clear_Reorder_Buffer();
+        m_watchdog.detach();
+        return true;
+    }
+
+    /// @brief Checks whether the given persisted checkpoint belongs to the firmware binary that is currently being downloaded
+    /// @param checkpoint Checkpoint that has been loaded from the checkpoint store
+    /// @return Whether title, version, checksum, checksum algorithm and size are the same
+    bool Is_Same_Firmware(OTA_Checkpoint const& checkpoint) const
+    {
+        return strncmp(checkpoint.fw_title, m_checkpoint.fw_title, sizeof(checkpoint.fw_title)) == 0 &&
+            strncmp(checkpoint.fw_version, m_checkpoint.fw_version, sizeof(checkpoint.fw_version)) == 0 &&
+            strncmp(checkpoint.fw_checksum, m_checkpoint.fw_checksum, sizeof(checkpoint.fw_checksum)) == 0 &&
+            checkpoint.fw_checksum_algorithm == m_checkpoint.fw_checksum_algorithm &&
+            checkpoint.fw_size == m_checkpoint.fw_size;
+    }
+
+    /// @brief Checkpoints the current progress in memory, so a failed write only rewinds the update to this block boundary,
+    /// and persists it into the checkpoint store if it is configured, once atleast the configured interval of bytes has been written since the previous checkpoint
+    /// and the written bytes are a multiple of the resume alignment of the updater.
+    /// Has to be called directly after writing, because the serialized hash context has to contain exactly the written bytes
+    /// @param written_bytes Amount of bytes that have actually been written into flash memory and into the hash function
+    void Save_Checkpoint(size_t const& written_bytes)
+    {
+        // Checkpoints at offsets the updater can not resume from would only be rejected once the update is resumed or rewound, therefore the following aligned offset is used instead
+        if (written_bytes >= m_fw_size || (written_bytes - m_checkpoint_offset) < m_fw_callback->Get_Checkpoint_Interval() || (written_bytes % m_fw_updater->get_resume_alignment()) != 0U)
+        {
+            return;
+        }
+        // Offset is updated even if persisting fails, to not attempt to persist the checkpoint again for every following chunk
+        m_checkpoint_offset = written_bytes;
+        m_checkpoint.written_bytes = written_bytes;
+        m_checkpoint.hash_context_size = m_hash.get_context_size();
+        bool const saved = m_hash.save(m_checkpoint.hash_context, sizeof(m_checkpoint.hash_context));
+        if (!saved)
+        {
+            // Hash state does not contain the written bytes, therefore the update can not be rewound to this block boundary
+            m_checkpoint.written_bytes = 0U;
+        }
+        IOTA_Checkpoint_Store* checkpoint_store = m_fw_callback->Get_Checkpoint_Store();
+        if (checkpoint_store != nullptr && (!saved || !checkpoint_store->save(m_checkpoint)))
+        {
+            Logger::printfln(PERSIST_CHECKPOINT_FAILED, written_bytes);
+        }
+    }
+
+    /// @brief Erases the persisted checkpoint, because the update has finished or the already written data has to be discarded
+    void Erase_Checkpoint()
+    {
+        m_checkpoint_offset = 0U;
+        m_checkpoint.written_bytes = 0U;
+        IOTA_Checkpoint_Store* checkpoint_store = m_fw_callback->Get_Checkpoint_Store();
+        if (checkpoint_store != nullptr)
+        {
+            (void)checkpoint_store->erase();
         }
-        expected_chunk_size = m_fw_callback->Get_Chunk_Size();
-        return received_chunk_size == expected_chunk_size;
     }
 
-    /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunk
+    /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunks
     void Request_First_Firmware_Packet()
     {
+#ifdef ARDUINO
         Serial.println("Request_First_Firmware_Packet called");
+#endif // ARDUINO
 
-        m_requested_chunks = 0U;
-        m_retries = m_fw_callback->Get_Chunk_Retries();
+        Reset_Firmware_Update();
+        Request_Next_Firmware_Packet();
+    }
+
+    /// @brief Discards all already written data and restarts the needed components, so the firmware binary can be written from the beginning
+    void Reset_Firmware_Update()
+    {
+        // Chunks still waiting in the write pipeline belong to the discarded data
+        m_write_pipeline.Cancel();
+        Abort_Cache_Entry();
+        Erase_Checkpoint();
+        m_written_bytes = 0U;
+        m_next_request_offset = 0U;
+        Clear_Reorder_Buffer();
         // Hash start result is ignored, because it can only fail if the input parameters are invalid
         (void)m_hash.start(m_fw_checksum_algorithm);
         m_watchdog.detach();
         m_fw_updater->reset();
-        Request_Next_Firmware_Packet();
     }
 
-    /// @brief Requests the next firmware chunk of the OTA firmware if there are any left
-    /// and starts the timer that ensures we request the same chunk again if we have not received a response yet
+    /// @brief Requests the next firmware chunks of the OTA firmware if there are any left, until the request window is full again,
+    /// and starts the timer that ensures we request the outstanding chunks again if we have not received a response yet.
+    /// If the chunk size should be adjusted, no further chunks are requested until all outstanding chunks have been received,
+    /// because the received chunk index can only be converted into a byte offset if all outstanding chunks have been requested with the same chunk size
     void Request_Next_Firmware_Packet()
     {
+#ifdef ARDUINO
         Serial.println("Request_Next_Firmware_Packet called");
+#endif // ARDUINO
 
         // Check if we have already requested and handled the last remaining chunk
-        if (m_requested_chunks >= m_total_chunks)
+        if (m_written_bytes >= m_fw_size)
         {
             Finish_Firmware_Update();
             return;
         }
 
-        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_requested_chunks))
+        size_t desired_chunk_size = m_chunk_size_controller.Get_Desired_Chunk_Size(m_next_request_offset, m_request_window);
+        if (desired_chunk_size != m_chunk_size_controller.Get_Chunk_Size() && m_next_request_offset == m_written_bytes)
         {
-            Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
+            Change_Chunk_Size(desired_chunk_size);
+            desired_chunk_size = m_chunk_size_controller.Get_Desired_Chunk_Size(m_next_request_offset, m_request_window);
+        }
+
+        size_t const chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        bool const draining = desired_chunk_size != chunk_size;
+        while (!draining && m_next_request_offset < m_fw_size && m_next_request_offset < m_written_bytes + (m_request_window * chunk_size))
+        {
+            // Retries are only granted to chunks that have never been requested before, chunks requested again after the update has been rewound or restarted
+            // keep the remaining retries of their slot, otherwise a failure that repeats every time would restart the update indefinitely
+            if (m_next_request_offset >= m_furthest_request_offset)
+            {
+                Get_Request_Retries(m_next_request_offset) = m_fw_callback->Get_Chunk_Retries();
+                m_furthest_request_offset = m_next_request_offset + chunk_size;
+            }
+            Request_Firmware_Packet(m_next_request_offset);
+            m_next_request_offset += chunk_size;
         }
 
         // Watchdog gets started no matter if publishing request was successful or not in hopes,
@@ -260,13 +1434,67 @@ private:
         m_watchdog.once(m_fw_callback->Get_Timeout());
     }
 
+    /// @brief Requests all outstanding firmware chunks again, that have not been received yet. Chunks that have already been received out of order,
+    /// are not requested again, because they are already waiting in the reorder buffer
+    void Request_Outstanding_Firmware_Packets()
+    {
+        size_t const chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        for (size_t offset = m_written_bytes; offset < m_next_request_offset; offset += chunk_size)
+        {
+            if (Find_Buffered_Chunk(offset) != nullptr)
+            {
+                continue;
+            }
+            Request_Firmware_Packet(offset);
+        }
+        Request_Next_Firmware_Packet();
+    }
+
+    /// @brief Requests the firmware chunk at the given offset from the server, with the current chunk size
+    /// @param offset Byte offset of the chunk we want to request, has to be a multiple of the current chunk size
+    void Request_Firmware_Packet(size_t const& offset)
+    {
+        size_t const chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        m_chunk_size_controller.Chunk_Requested(offset);
+        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), offset / chunk_size, chunk_size))
+        {
+            Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
+        }
+    }
+
+    /// @brief Changes the chunk size the next chunks are requested with, may only be called while no chunks are outstanding.
+    /// Increasing the chunk size additionally requires the internal client buffer and the reorder buffer to be increased,
+    /// if that fails the current chunk size is kept and it is not attempted to be increased again for the remaining update
+    /// @param chunk_size Chunk size in bytes the next chunks should be requested with
+    void Change_Chunk_Size(size_t const& chunk_size)
+    {
+        size_t const previous_chunk_size = m_chunk_size_controller.Get_Chunk_Size();
+        if (chunk_size > previous_chunk_size && (!m_resize_buffer_callback.Call_Callback(chunk_size) || !Resize_Reorder_Buffer(chunk_size) || !m_write_pipeline.Resize(chunk_size)))
+        {
+            Logger::printfln(UNABLE_TO_RESIZE_BUFFER, chunk_size, previous_chunk_size);
+            m_chunk_size_controller.Block_Growth();
+            return;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_CHUNK_SIZE_CHANGED, previous_chunk_size, chunk_size, m_chunk_size_controller.Get_Round_Trip_Time(), m_chunk_size_controller.Get_Goodput());
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_chunk_size_controller.Set_Chunk_Size(chunk_size);
+    }
+
     /// @brief Completes the firmware update, which consists of checking the complete hash of the firmware binary if the initally received value,
     /// both should be the same and if that is not the case that means that we received invalid firmware binary data and have to restart the update.
     /// If checking the hash was successfull we attempt to finish flashing the ota partition and then inform the user that the update was successfull
     void Finish_Firmware_Update()
     {
+#ifdef ARDUINO
         Serial.println("Finish_Firmware_Update called");
+#endif // ARDUINO
 
+        // All chunks have been received, but the write task might still be writing the last of them
+        if (!m_write_pipeline.Flush())
+        {
+            return Handle_Failure(Rewind_Firmware_Update() ? OTA_Failure_Response::RETRY_CHUNK : OTA_Failure_Response::RETRY_UPDATE, m_write_error);
+        }
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADED, "");
 
         char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
@@ -285,12 +1513,24 @@ private:
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(CHECKSUM_VERIFICATION_SUCCESS);
 #endif // THINGSBOARD_ENABLE_DEBUG
+        // Downloaded firmware binary has been verified, therefore it can be applied out of the cache the next time, even if ending the update fails
+        Complete_Cache_Entry();
 
         if (!m_fw_updater->end())
         {
             Logger::printfln(ERROR_UPDATE_END);
             return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_END);
         }
+        Complete_Firmware_Update();
+    }
+
+    /// @brief Releases the components needed while writing and informs the user that the update was successfull, has to be called once the updater has been ended successfully
+    void Complete_Firmware_Update()
+    {
+        m_write_pipeline.Stop();
+        Free_Reorder_Buffer();
+        Erase_Checkpoint();
+        m_streaming = false;
 
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(FW_UPDATE_SUCCESS);
@@ -302,34 +1542,71 @@ private:
     }
 
     /// @brief Handles errors with the received failure response so that the firmware update can regenerate from any possible issue.
-    /// Will only execute the given failure response as long as there are still retries remaining, if there are not any further issue will cause the update to be aborted
+    /// Will only execute the given failure response as long as there are still retries remaining, if there are not any further issue will cause the update to be aborted.
+    /// Retries are counted per request slot, a failure of a single chunk uses the retries of that chunk and every other failure uses the retries of the oldest outstanding chunk,
+    /// because it is the chunk that keeps the update from progressing. Streaming the firmware binary uses a single counter instead
     /// @param failure_response Possible response to a failure that the method should handle
     /// @param error_message Error message that should be printed if we abort the update
-    void Handle_Failure(OTA_Failure_Response const& failure_response, char const* error_message)
+    /// @param chunk_offset Byte offset of the single chunk that should be requested again if the chunk is retried, default = ALL_OUTSTANDING_CHUNKS
+    void Handle_Failure(OTA_Failure_Response const& failure_response, char const* error_message, size_t const& chunk_offset = ALL_OUTSTANDING_CHUNKS)
     {
+#ifdef ARDUINO
         Serial.println("Handle_Failure called");
+#endif // ARDUINO
 
-        if (m_retries <= 0)
+        uint8_t& retries = m_streaming ? m_retries : Get_Request_Retries(chunk_offset != ALL_OUTSTANDING_CHUNKS ? chunk_offset : m_written_bytes);
+        if (retries <= 0)
         {
+            // Already written data is only kept for a later resume, if the failure did not invalidate it
+            if (failure_response == OTA_Failure_Response::RETRY_UPDATE)
+            {
+                Erase_Checkpoint();
+            }
+            m_write_pipeline.Stop();
+            Abort_Cache_Entry();
+            Free_Reorder_Buffer();
+            m_streaming = false;
             (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
             m_fw_callback->Call_Callback(false);
             (void)m_finish_callback.Call_Callback();
             return;
         }
 
-        // Decrease the amount of retries of downloads for the current chunk,
-        // reset as soon as the next chunk has been received and handled successfully
-        m_retries--;
+        // Decrease the amount of retries of downloads for the failed chunk,
+        // reset once its request slot is used for a chunk that has never been requested before
+        retries--;
 
         switch (failure_response)
         {
+        // The streamed download requests the following bytes itself, as long as the update is still running
         case OTA_Failure_Response::RETRY_CHUNK:
-            Request_Next_Firmware_Packet();
+            if (m_streaming)
+            {
+                break;
+            }
+            else if (chunk_offset != ALL_OUTSTANDING_CHUNKS)
+            {
+                // Every other outstanding chunk is still expected to arrive, therefore the timeout is restarted for all of them
+                m_watchdog.detach();
+                Request_Firmware_Packet(chunk_offset);
+                m_watchdog.once(m_fw_callback->Get_Timeout());
+                break;
+            }
+            Request_Outstanding_Firmware_Packets();
             break;
         case OTA_Failure_Response::RETRY_UPDATE:
+            if (m_streaming)
+            {
+                Reset_Firmware_Update();
+                break;
+            }
             Request_First_Firmware_Packet();
             break;
         case OTA_Failure_Response::RETRY_NOTHING:
+            m_write_pipeline.Stop();
+            Abort_Cache_Entry();
+            Free_Reorder_Buffer();
+            m_streaming = false;
             (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
             m_fw_callback->Call_Callback(false);
             (void)m_finish_callback.Call_Callback();
@@ -343,35 +1620,77 @@ private:
     /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time
     void Handle_Request_Timeout()
     {
+#ifdef ARDUINO
         Serial.println("Handle_Request_Timeout called");
+#endif // ARDUINO
 
         uint64_t const& timeout = m_fw_callback->Get_Timeout();
-        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
-        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
+        size_t const current_chunk = m_written_bytes / m_chunk_size_controller.Get_Chunk_Size();
+        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, current_chunk, timeout)] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, current_chunk, timeout);
         Logger::printfln(message);
+        m_chunk_size_controller.Request_Timed_Out();
+        // Fragments of a chunk that have already been written directly require the update to be rewound, which already handles the failure
+        if (!Discard_Fragmented_Firmware_Packet())
+        {
+            return;
+        }
         Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
     }
 
     const OTA_Update_Callback* m_fw_callback = {};
     // Callback method that contains configuration information, about the over the air update
-    Callback<bool, size_t const&, size_t const&> m_publish_callback = {};
-    // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
+    Callback<bool, size_t const&, size_t const&, size_t const&> m_publish_callback = {};
+    // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size
     Callback<bool, char const* const, char const* const> m_send_fw_state_callback = {};
     // Callback that is used to send information about the current state of the over the air update
     Callback<bool> m_finish_callback = {};
     // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
+    Callback<bool, size_t const&> m_resize_buffer_callback = {};
+    // Callback that is used to ensure the internal client buffer is big enough to receive chunks with the given chunk size
     size_t m_fw_size = {};
     // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
     char m_fw_checksum[FIRMWARE_HASH_SIZE] = {};
     // Checksum of the complete firmware binary, should be the same as the actually written data in the end
-    mbedtls_md_type_t m_fw_checksum_algorithm = {}; // Algorithm type used to hash the firmware binary
+    Checksum_Algorithm m_fw_checksum_algorithm = {}; // Algorithm type used to hash the firmware binary
     IUpdater* m_fw_updater = {};
     // Interface implementation that writes received firmware binary data onto the given device
     HashGenerator m_hash = {}; // Class instance that allows to generate a hash from received firmware binary data
-    size_t m_total_chunks = {}; // Total amount of chunks that need to be received to get the complete firmware binary
-    size_t m_requested_chunks = {}; // Amount of successfully requested and received firmware binary chunks
+    size_t m_total_chunks = {}; // Total amount of chunks with the configured chunk size that need to be received to get the complete firmware binary, used to report the progress
+    OTA_Chunk_Size_Controller m_chunk_size_controller = {}; // Decides on the chunk size the firmware binary is requested in, adjusts it adaptively if enabled
+    size_t m_written_bytes = {}; // Amount of successfully received bytes of the firmware binary, that have been written or copied into the write pipeline, byte offset of the oldest outstanding chunk
+    size_t m_next_request_offset = {}; // Byte offset of the next chunk that has not been requested yet, all chunks between m_written_bytes and this offset are outstanding
+    size_t m_request_window = {}; // Maximum amount of outstanding chunks, 1 if the reorder buffer has not been allocated
+    Buffered_Chunk* m_reorder_slots = {}; // Slots of the reorder buffer, holding chunks that have been received before all previous chunks have been written
+    uint8_t* m_reorder_buffer = {}; // Binary data of the slots of the reorder buffer, each slot can hold one complete chunk
+    size_t m_reorder_chunk_size = {}; // Size in bytes of every slot of the reorder buffer
+    Buffered_Chunk* m_fragment_slot = {}; // Slot of the reorder buffer the fragments of the current chunk are assembled in or nullptr if they are written directly
+    size_t m_fragment_offset = {}; // Byte offset of the chunk that is currently received in fragments
+    size_t m_fragment_size = {}; // Amount of bytes in the complete chunk that is currently received in fragments
+    size_t m_fragment_received = {}; // Amount of bytes of the chunk that is currently received in fragments, that have already been received
+    uint32_t m_fragment_crc = {}; // CRC32 of the fragments of the current chunk, that have already been received
+    bool m_fragment_receiving = {}; // Whether a chunk is currently received in fragments and further fragments of it are expected
+    OTA_Checkpoint m_checkpoint = {}; // Identity of the firmware binary and progress that is persisted into the checkpoint store
+    size_t m_checkpoint_offset = {}; // Amount of written bytes when the previous checkpoint was persisted
+    OTA_Write_Pipeline m_write_pipeline = {}; // Writes received chunks in a separate task if enabled, so the next chunks can be received while the previous ones are written
+    char m_write_error[WRITE_ERROR_MESSAGE_SIZE] = {}; // Message of the most recent failed write, copied by the context that wrote the chunk
     uint8_t m_retries = {};
-    // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
+    // Amount of request retries we attempt for the chunk if only one chunk is requested at once or for the streamed download, increasing makes the connection more stable
+    uint8_t* m_request_retries = {}; // Remaining retries of every request slot, indexed by chunk index modulo the request window, nullptr if only one chunk is requested at once
+    size_t m_furthest_request_offset = {}; // Byte offset following the furthest chunk that has been requested, retries are only reset when requesting chunks beyond it
+    size_t m_furthest_written_bytes = {}; // Highest amount of written bytes reached while streaming, retries are only reset once it increases
+    bool m_streaming = {}; // Whether the firmware binary is currently downloaded as a stream over HTTP instead of in chunks, cleared once the update finished or failed
+    IHTTP_Client* m_http_client = {}; // HTTP client the firmware binary is currently downloaded with
+    uint8_t* m_stream_buffer = {}; // Buffer the streamed bytes are collected in until it is full, followed by the copied path of the firmware binary, nullptr if no download is running
+    size_t m_stream_buffer_size = {}; // Size in bytes of the buffer the streamed bytes are collected in, excluding the copied path
+    char* m_stream_path = {}; // Copied path of the firmware binary on the server, stored directly after the buffer
+    bool m_range_requested = {}; // Whether a range request has been sent and its response body is currently read
+    size_t m_skipped_bytes = {}; // Remaining already written bytes that have to be skipped, because the server ignored the range request
+    size_t m_buffered_bytes = {}; // Amount of bytes currently collected in the buffer
+    uint64_t m_last_received_time = {}; // Timestamp in microseconds the last bytes of the response body have been received at
+    IFirmware_Cache* m_firmware_cache = {}; // Firmware cache the downloaded firmware binary is written into and cached firmware binaries are applied out of, nullptr if disabled
+    bool m_cache_filling = {}; // Whether the written firmware binary is currently written into a new entry of the firmware cache as well
+    bool m_applying_cache = {}; // Whether the firmware binary is currently applied out of the firmware cache, which must not fill a new entry
     Callback_Watchdog m_watchdog = {};
     // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
 };
@@ -1,7 +1,7 @@
 // Header include.
 #include "OTA_Update_Callback.h"
 
-OTA_Update_Callback::OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback, Callback<void>::function update_starting_callback, uint8_t chunk_retries, uint16_t chunk_size, uint64_t const & timeout_microseconds)
+OTA_Update_Callback::OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback, Callback<void>::function update_starting_callback, uint8_t chunk_retries, uint16_t chunk_size, uint64_t const & timeout_microseconds, uint8_t request_window)
   : Callback(finished_callback)
   , m_current_fw_title(current_fw_title)
   , m_current_fw_version(current_fw_version)
@@ -11,6 +11,7 @@ OTA_Update_Callback::OTA_Update_Callback(char const * current_fw_title, char con
   , m_chunk_retries(chunk_retries)
   , m_chunk_size(chunk_size)
   , m_timeout_microseconds(timeout_microseconds)
+  , m_request_window(request_window)
 {
     // Nothing to do
 }
@@ -86,3 +87,95 @@ uint64_t const & OTA_Update_Callback::Get_Timeout() const {
 void OTA_Update_Callback::Set_Timeout(const uint64_t & timeout_microseconds) {
     m_timeout_microseconds = timeout_microseconds;
 }
+
+uint8_t OTA_Update_Callback::Get_Request_Window() const {
+    return m_request_window;
+}
+
+void OTA_Update_Callback::Set_Request_Window(uint8_t request_window) {
+    m_request_window = request_window;
+}
+
+uint16_t OTA_Update_Callback::Get_Minimum_Chunk_Size() const {
+    return m_minimum_chunk_size;
+}
+
+void OTA_Update_Callback::Set_Minimum_Chunk_Size(uint16_t minimum_chunk_size) {
+    m_minimum_chunk_size = minimum_chunk_size;
+}
+
+uint16_t OTA_Update_Callback::Get_Maximum_Chunk_Size() const {
+    return m_maximum_chunk_size;
+}
+
+void OTA_Update_Callback::Set_Maximum_Chunk_Size(uint16_t maximum_chunk_size) {
+    m_maximum_chunk_size = maximum_chunk_size;
+}
+
+IOTA_Checkpoint_Store * OTA_Update_Callback::Get_Checkpoint_Store() const {
+    return m_checkpoint_store;
+}
+
+void OTA_Update_Callback::Set_Checkpoint_Store(IOTA_Checkpoint_Store * checkpoint_store) {
+    m_checkpoint_store = checkpoint_store;
+}
+
+size_t const & OTA_Update_Callback::Get_Checkpoint_Interval() const {
+    return m_checkpoint_interval;
+}
+
+void OTA_Update_Callback::Set_Checkpoint_Interval(size_t const & checkpoint_interval) {
+    m_checkpoint_interval = checkpoint_interval;
+}
+
+bool OTA_Update_Callback::Get_Expected_Chunk_CRC(size_t const & offset, size_t const & length, uint32_t & expected_crc) const {
+    // Callback is called directly instead of wrapping it, because not setting it is the default and should not print a message for every received chunk
+    if (!m_chunk_crc_callback) {
+        return false;
+    }
+    return m_chunk_crc_callback(offset, length, expected_crc);
+}
+
+void OTA_Update_Callback::Set_Chunk_CRC_Callback(Callback<bool, size_t const &, size_t const &, uint32_t &>::function chunk_crc_callback) {
+    m_chunk_crc_callback = chunk_crc_callback;
+}
+
+IFirmware_Cache * OTA_Update_Callback::Get_Firmware_Cache() const {
+    return m_firmware_cache;
+}
+
+void OTA_Update_Callback::Set_Firmware_Cache(IFirmware_Cache * firmware_cache) {
+    m_firmware_cache = firmware_cache;
+}
+
+IHTTP_Client * OTA_Update_Callback::Get_HTTP_Client() const {
+    return m_http_client;
+}
+
+void OTA_Update_Callback::Set_HTTP_Client(IHTTP_Client * http_client) {
+    m_http_client = http_client;
+}
+
+char const * OTA_Update_Callback::Get_HTTP_Path_Format() const {
+    return m_http_path_format;
+}
+
+void OTA_Update_Callback::Set_HTTP_Path_Format(char const * http_path_format) {
+    m_http_path_format = http_path_format;
+}
+
+uint8_t OTA_Update_Callback::Get_Write_Pipeline_Depth() const {
+    return m_write_pipeline_depth;
+}
+
+void OTA_Update_Callback::Set_Write_Pipeline_Depth(uint8_t write_pipeline_depth) {
+    m_write_pipeline_depth = write_pipeline_depth;
+}
+
+int8_t OTA_Update_Callback::Get_Write_Pipeline_Core() const {
+    return m_write_pipeline_core;
+}
+
+void OTA_Update_Callback::Set_Write_Pipeline_Core(int8_t write_pipeline_core) {
+    m_write_pipeline_core = write_pipeline_core;
+}
@@ -6,12 +6,22 @@
 
 // Local includes.
 #include "IUpdater.h"
+#include "IOTA_Checkpoint_Store.h"
+#include "IHTTP_Client.h"
+#include "IFirmware_Cache.h"
+#include "OTA_Write_Pipeline.h"
 
 
 // OTA default values.
 uint8_t constexpr CHUNK_RETRIES = 12U;
 uint16_t constexpr CHUNK_SIZE = (4U * 1024U);
 uint64_t constexpr REQUEST_TIMEOUT = (5U * 1000U * 1000U);
+uint8_t constexpr REQUEST_WINDOW = 1U;
+size_t constexpr CHECKPOINT_INTERVAL = (64U * 1024U);
+uint8_t constexpr WRITE_PIPELINE_DEPTH = 0U;
+// Path of the firmware binary on the HTTP(S) server, formatted with the device id, the firmware title and the firmware version, in that order.
+// Matches the firmware endpoint of the ThingsBoard HTTP device API, where the device access token is used in place of the device id
+char constexpr HTTP_FIRMWARE_PATH_FMT[] = "/api/v1/%s/firmware?title=%s&version=%s";
 
 
 /// @brief Over the air firmware update callback wrapper,
@@ -45,7 +55,10 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     // because the whole chunk is saved into the heap before it can be processed and is then erased again after it has been used, default = CHUNK_SIZE
     /// @param timeout Maximum amount of time in microseconds for the OTA firmware update for each seperate chunk,
     /// until that chunk counts as a timeout, retries is then subtraced by one and the download is retried, default = REQUEST_TIMEOUT
-    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT);
+    /// @param request_window Maximum amount of chunks that are requested from the server at once, without having received them yet.
+    /// Increasing allows to hide the round trip time of each request on high latency connections, but requires to allocate (request_window - 1) * chunk_size additional bytes on the heap,
+    /// to buffer chunks that were received out of order until all previous chunks have been written, default = REQUEST_WINDOW (stop-and-wait, one chunk at a time)
+    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT, uint8_t request_window = REQUEST_WINDOW);
 
     /// @brief Gets the current firmware title, used to decide if an OTA firmware update is already installed and therefore should not be downladed,
     /// this is only done if the title of the update and the current firmware title are the same because if they are not then this firmware is meant for another device type
@@ -143,6 +156,123 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param timeout_microseconds Timeout time until we expect a response from the server
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
+    /// @brief Gets the maximum amount of chunks that are requested from the server at once, without having received them yet.
+    /// Chunks that are received out of order are buffered until all previous chunks have been written, meaning flash writes and hash updates stay strictly sequential
+    /// @return Maximum amount of outstanding chunk requests
+    uint8_t Get_Request_Window() const;
+
+    /// @brief Sets the maximum amount of chunks that are requested from the server at once, without having received them yet.
+    /// Increasing allows to hide the round trip time of each request on high latency connections, until the available bandwidth is saturated,
+    /// but requires to allocate (request_window - 1) * chunk_size additional bytes on the heap, to buffer chunks that were received out of order
+    /// @param request_window Maximum amount of outstanding chunk requests, 0 is treated the same as 1
+    void Set_Request_Window(uint8_t request_window);
+
+    /// @brief Gets the minimum size of the chunks that the firmware binary data will be split into, if the chunk size is adjusted adaptively
+    /// @return Minimum chunk size in bytes, 0 if adaptive chunk sizing is disabled
+    uint16_t Get_Minimum_Chunk_Size() const;
+
+    /// @brief Sets the minimum size of the chunks that the firmware binary data will be split into, if the chunk size is adjusted adaptively.
+    /// Adaptive chunk sizing is only enabled if both the minimum and the maximum chunk size are set and the minimum is smaller than the maximum,
+    /// the initial chunk size is then the configured chunk size clamped to the bounds, and decreased if requests time out or increased if the measured goodput improves and enough heap memory is available.
+    /// Both bounds are rounded down to a power of two, because the server calculates the offset of a chunk by multiplying its index with the requested size
+    /// @param minimum_chunk_size Minimum chunk size in bytes, 0 disables adaptive chunk sizing
+    void Set_Minimum_Chunk_Size(uint16_t minimum_chunk_size);
+
+    /// @brief Gets the maximum size of the chunks that the firmware binary data will be split into, if the chunk size is adjusted adaptively
+    /// @return Maximum chunk size in bytes, 0 if adaptive chunk sizing is disabled
+    uint16_t Get_Maximum_Chunk_Size() const;
+
+    /// @brief Sets the maximum size of the chunks that the firmware binary data will be split into, if the chunk size is adjusted adaptively.
+    /// The internal client buffer is increased to fit the chunk size, the moment the chunk size is increased, and reset to its previous size once the update has finished
+    /// @param maximum_chunk_size Maximum chunk size in bytes, 0 disables adaptive chunk sizing
+    void Set_Maximum_Chunk_Size(uint16_t maximum_chunk_size);
+
+    /// @brief Gets the checkpoint store implementation, used to persist the progress of the update so it can be resumed after a disconnect or reboot
+    /// @return Checkpoint store implementation, nullptr if the progress is not persisted
+    IOTA_Checkpoint_Store * Get_Checkpoint_Store() const;
+
+    /// @brief Sets the checkpoint store implementation, used to persist the progress of the update so it can be resumed after a disconnect or reboot.
+    /// If the same firmware is offered again, the update continues after the last persisted checkpoint instead of downloading the complete firmware binary again,
+    /// as long as the updater implementation supports resuming as well, see IUpdater::resume()
+    /// @param checkpoint_store Checkpoint store implementation, nullptr disables persisting the progress
+    void Set_Checkpoint_Store(IOTA_Checkpoint_Store * checkpoint_store);
+
+    /// @brief Gets the amount of bytes that are written between persisting two checkpoints
+    /// @return Amount of bytes between two checkpoints
+    size_t const & Get_Checkpoint_Interval() const;
+
+    /// @brief Sets the amount of bytes that are written between persisting two checkpoints.
+    /// Decreasing reduces the amount of data that has to be downloaded again after an interruption, but causes more writes to the non volatile memory of the checkpoint store
+    /// @param checkpoint_interval Amount of bytes between two checkpoints, default = CHECKPOINT_INTERVAL
+    void Set_Checkpoint_Interval(size_t const & checkpoint_interval);
+
+    /// @brief Gets the expected CRC32 of the chunk with the given offset and length, from the callback set with Set_Chunk_CRC_Callback()
+    /// @param offset Byte offset of the chunk in the firmware binary
+    /// @param length Amount of bytes in the chunk
+    /// @param expected_crc Variable the expected CRC32 of the chunk will be copied into
+    /// @return Whether the expected CRC32 of the chunk is known, false if no callback has been set or the callback does not know the given chunk
+    bool Get_Expected_Chunk_CRC(size_t const & offset, size_t const & length, uint32_t & expected_crc) const;
+
+    /// @brief Sets the callback that provides the expected CRC32 of every received chunk, for example out of a manifest that was published alongside the firmware binary.
+    /// Allows to detect a corrupted chunk directly after it has been received, in which case only that chunk is requested again, instead of only detecting it with the checksum of the complete firmware binary,
+    /// which requires to download the complete firmware binary again. The chunks are requested with the configured chunk size, therefore adaptive chunk sizing should be disabled
+    /// if the manifest only contains the CRC32 for chunks of a fixed size. The checksum of the complete firmware binary is still verified in the end
+    /// @param chunk_crc_callback Callback that is called with the offset and the length of the received chunk and has to copy the expected CRC32 of it into the last argument,
+    /// returns false if the expected CRC32 of the chunk is not known, in which case the chunk is not verified, nullptr disables verifying chunks
+    void Set_Chunk_CRC_Callback(Callback<bool, size_t const &, size_t const &, uint32_t &>::function chunk_crc_callback);
+
+    /// @brief Gets the firmware cache implementation, used to store downloaded firmware binaries locally and apply them again without downloading them
+    /// @return Firmware cache implementation, nullptr if firmware binaries are not cached
+    IFirmware_Cache * Get_Firmware_Cache() const;
+
+    /// @brief Sets the firmware cache implementation, used to store downloaded firmware binaries locally and apply them again without downloading them.
+    /// If the offered firmware binary is already cached with the same checksum, it is written into the updater straight out of the cache and no chunk is requested at all.
+    /// Otherwise the downloaded firmware binary is additionally written into the cache and only kept once its checksum has been verified.
+    /// If the cached firmware binary can not be read or does not match its checksum, the entry is removed and the firmware binary is downloaded as usual instead
+    /// @param firmware_cache Firmware cache implementation, nullptr disables caching firmware binaries
+    void Set_Firmware_Cache(IFirmware_Cache * firmware_cache);
+
+    /// @brief Gets the HTTP client implementation the firmware binary is downloaded with, instead of requesting it in chunks over MQTT
+    /// @return HTTP client implementation, nullptr if the firmware binary is downloaded over MQTT
+    IHTTP_Client * Get_HTTP_Client() const;
+
+    /// @brief Sets the HTTP client implementation the firmware binary is downloaded with, instead of requesting it in chunks over MQTT.
+    /// The shared attributes describing the firmware are still received over MQTT, but the firmware binary itself is then streamed with a single GET request over one keep-alive connection,
+    /// which avoids the round trip per chunk and the need to increase the internal MQTT receive buffer to fit the chunks.
+    /// Interrupted downloads are continued with a range request starting after the already written bytes. The client has to support IHTTP_Client::get_range() and IHTTP_Client::read_response_body(),
+    /// and has to be constructed for the server serving the firmware binary. The download is advanced by the loop() method of the ThingsBoard client, which therefore has to be called periodically until the update has finished or failed
+    /// @param http_client HTTP client implementation, nullptr downloads the firmware binary in chunks over MQTT
+    void Set_HTTP_Client(IHTTP_Client * http_client);
+
+    /// @brief Gets the format of the path the firmware binary is downloaded from, if it is downloaded over HTTP
+    /// @return Format string of the path
+    char const * Get_HTTP_Path_Format() const;
+
+    /// @brief Sets the format of the path the firmware binary is downloaded from, if it is downloaded over HTTP.
+    /// The format string is passed the device id, the firmware title and the firmware version, in that order, all of them as strings
+    /// @param http_path_format Format string of the path, has to stay valid as long as the update is running, default = HTTP_FIRMWARE_PATH_FMT
+    void Set_HTTP_Path_Format(char const * http_path_format);
+
+    /// @brief Gets the amount of received chunks that can be waiting to be written by the separate write task at once
+    /// @return Amount of slots of the write pipeline, 0 if chunks are written directly in the context that received them
+    uint8_t Get_Write_Pipeline_Depth() const;
+
+    /// @brief Sets the amount of received chunks that can be waiting to be written by the separate write task at once.
+    /// If enabled, received chunks are copied into the pipeline and the next chunks are requested immediately, while a separate task writes them into flash memory and into the hash function,
+    /// which removes the latency of erasing and writing the flash memory from every round trip. Requires to allocate depth * chunk_size additional bytes on the heap and either FreeRTOS or std::thread support,
+    /// if either is not available the chunks are simply written directly instead. 2 allows to receive the next chunk while the previous one is written, 3 additionally hides an occasional slow sector erase
+    /// @param write_pipeline_depth Amount of slots of the write pipeline, 0 writes chunks directly in the context that received them, default = WRITE_PIPELINE_DEPTH
+    void Set_Write_Pipeline_Depth(uint8_t write_pipeline_depth);
+
+    /// @brief Gets the core the task that writes the received chunks is pinned to
+    /// @return Core of the write task, WRITE_PIPELINE_NO_AFFINITY if it may run on any core
+    int8_t Get_Write_Pipeline_Core() const;
+
+    /// @brief Sets the core the task that writes the received chunks is pinned to, only has an effect on multi core FreeRTOS targets like the ESP32.
+    /// Pinning it to the core that does not run the network stack allows receiving and writing to run truly in parallel
+    /// @param write_pipeline_core Core of the write task, default = WRITE_PIPELINE_NO_AFFINITY
+    void Set_Write_Pipeline_Core(int8_t write_pipeline_core);
+
   private:
     char const                                     *m_current_fw_title = {};        // Current firmware title of device
     char const                                     *m_current_fw_version = {};      // Current firmware version of device
@@ -153,6 +283,17 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     uint8_t                                        m_chunk_retries = {};            // Maximum amount of retries for a single chunk to be downloaded and flashed successfully
     uint16_t                                       m_chunk_size = {};               // Size of chunks the firmware data will be split into
     uint64_t                                       m_timeout_microseconds = {};     // How long we wait for each chunck to arrive before declaring it as failed
+    uint8_t                                        m_request_window = {};           // Maximum amount of chunks that are requested at once without having been received yet
+    uint16_t                                       m_minimum_chunk_size = {};       // Minimum size of chunks if the chunk size is adjusted adaptively
+    uint16_t                                       m_maximum_chunk_size = {};       // Maximum size of chunks if the chunk size is adjusted adaptively
+    IOTA_Checkpoint_Store                          *m_checkpoint_store = {};        // Checkpoint store implementation used to persist the progress of the update
+    size_t                                         m_checkpoint_interval = CHECKPOINT_INTERVAL; // Amount of bytes written between persisting two checkpoints
+    Callback<bool, size_t const &, size_t const &, uint32_t &>::function m_chunk_crc_callback = {}; // Callback that provides the expected CRC32 of every received chunk
+    IFirmware_Cache                                *m_firmware_cache = {};          // Firmware cache implementation used to store and apply already downloaded firmware binaries
+    IHTTP_Client                                   *m_http_client = {};             // HTTP client implementation used to download the firmware binary instead of MQTT
+    char const                                     *m_http_path_format = HTTP_FIRMWARE_PATH_FMT; // Format of the path the firmware binary is downloaded from over HTTP
+    uint8_t                                        m_write_pipeline_depth = WRITE_PIPELINE_DEPTH; // Amount of received chunks that can be waiting to be written by the write task
+    int8_t                                         m_write_pipeline_core = WRITE_PIPELINE_NO_AFFINITY; // Core the write task is pinned to
 };
 
 #endif // OTA_Update_Callback_h
@@ -0,0 +1,320 @@
+// Header include.
+#include "OTA_Write_Pipeline.h"
+
+// Local include.
+#include "Helper.h"
+
+// Library includes.
+#include <stdlib.h>
+#include <string.h>
+
+
+#if THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+// Index passed to the worker task instead of a slot, to signal it to stop
+size_t constexpr STOP_INDEX = SIZE_MAX;
+#endif // THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+#if THINGSBOARD_USE_FREERTOS
+// Name of the worker task, shown in FreeRTOS task lists
+char constexpr WRITE_PIPELINE_TASK_NAME[] = "tb_ota_write";
+#endif // THINGSBOARD_USE_FREERTOS
+
+OTA_Write_Pipeline::~OTA_Write_Pipeline() {
+    Stop();
+}
+
+#if THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+
+bool OTA_Write_Pipeline::Start(size_t const & slot_count, size_t const & slot_size, int8_t const & core, Callback<bool, size_t const &, uint8_t *, size_t const &>::function write_callback) {
+    Stop();
+    if (slot_count == 0U || slot_size == 0U) {
+        return false;
+    }
+    m_write_callback.Set_Callback(write_callback);
+    m_slot_count = slot_count;
+    m_slot_size = slot_size;
+    m_failed = false;
+    m_cancelled = false;
+    m_slots = static_cast<Slot *>(malloc(slot_count * sizeof(Slot)));
+    m_buffer = static_cast<uint8_t *>(malloc(slot_count * slot_size));
+#if THINGSBOARD_USE_FREERTOS
+    // Filled slots need room for the additional stop index, even if all slots are filled
+    m_free_slots = xQueueCreate(slot_count, sizeof(size_t));
+    m_filled_slots = xQueueCreate(slot_count + 1U, sizeof(size_t));
+    m_stopped = xSemaphoreCreateBinary();
+    if (m_slots == nullptr || m_buffer == nullptr || m_free_slots == nullptr || m_filled_slots == nullptr || m_stopped == nullptr) {
+        Free_Resources();
+        return false;
+    }
+#else
+    if (m_slots == nullptr || m_buffer == nullptr) {
+        Free_Resources();
+        return false;
+    }
+#endif // THINGSBOARD_USE_FREERTOS
+    for (size_t index = 0U; index < slot_count; index++) {
+        m_slots[index] = Slot();
+        Give_Free_Slot(index);
+    }
+
+#if THINGSBOARD_USE_FREERTOS
+    // Same priority as the task receiving the chunks, so both alternate instead of the worker starving the network stack or the other way around
+    UBaseType_t const priority = uxTaskPriorityGet(nullptr);
+#ifdef ESP8266
+    (void)core;
+    BaseType_t const result = xTaskCreate(OTA_Write_Pipeline::Run_Task, WRITE_PIPELINE_TASK_NAME, WRITE_PIPELINE_STACK_SIZE, this, priority, nullptr);
+#else
+    BaseType_t const result = xTaskCreatePinnedToCore(OTA_Write_Pipeline::Run_Task, WRITE_PIPELINE_TASK_NAME, WRITE_PIPELINE_STACK_SIZE, this, priority, nullptr, core < 0 ? tskNO_AFFINITY : core);
+#endif // ESP8266
+    if (result != pdPASS) {
+        Free_Resources();
+        return false;
+    }
+#else
+    (void)core;
+    m_thread = std::thread(&OTA_Write_Pipeline::Run, this);
+#endif // THINGSBOARD_USE_FREERTOS
+    m_running = true;
+    return true;
+}
+
+void OTA_Write_Pipeline::Stop() {
+    if (!m_running) {
+        return;
+    }
+    Cancel();
+    Give_Filled_Slot(STOP_INDEX);
+#if THINGSBOARD_USE_FREERTOS
+    (void)xSemaphoreTake(m_stopped, portMAX_DELAY);
+#else
+    m_thread.join();
+#endif // THINGSBOARD_USE_FREERTOS
+    m_running = false;
+    Free_Resources();
+}
+
+bool OTA_Write_Pipeline::Is_Running() const {
+    return m_running;
+}
+
+bool OTA_Write_Pipeline::Resize(size_t const & slot_size) {
+    if (!m_running || slot_size <= m_slot_size) {
+        return true;
+    }
+    // Slots can only be moved while the worker task is not accessing any of them
+    if (!Flush()) {
+        return false;
+    }
+    uint8_t * buffer = static_cast<uint8_t *>(realloc(m_buffer, m_slot_count * slot_size));
+    if (buffer == nullptr) {
+        return false;
+    }
+    m_buffer = buffer;
+    m_slot_size = slot_size;
+    return true;
+}
+
+bool OTA_Write_Pipeline::Enqueue(size_t const & offset, uint8_t const * payload, size_t const & length, uint64_t const & timeout_microseconds) {
+    if (!m_running || m_failed || length > m_slot_size) {
+        return false;
+    }
+    size_t index = 0U;
+    if (!Take_Free_Slot(timeout_microseconds, index)) {
+        return false;
+    }
+    // Writing might have failed while waiting for the free slot, the chunk would be discarded anyway
+    if (m_failed) {
+        Give_Free_Slot(index);
+        return false;
+    }
+    m_slots[index].offset = offset;
+    m_slots[index].length = length;
+    (void)memcpy(m_buffer + (index * m_slot_size), payload, length);
+    Give_Filled_Slot(index);
+    return true;
+}
+
+bool OTA_Write_Pipeline::Flush(uint64_t const & timeout_microseconds) {
+    if (!m_running) {
+        return true;
+    }
+    // Every slot is only returned once it has been written, therefore owning all of them means nothing is waiting to be written anymore
+    uint64_t const start = Helper::getTimeMicroseconds();
+    size_t held_slots = 0U;
+    for (; held_slots < m_slot_count; held_slots++) {
+        uint64_t remaining = 0U;
+        if (timeout_microseconds != 0U) {
+            uint64_t const elapsed = Helper::getTimeMicroseconds() - start;
+            if (elapsed >= timeout_microseconds) {
+                break;
+            }
+            remaining = timeout_microseconds - elapsed;
+        }
+        size_t index = 0U;
+        if (!Take_Free_Slot(remaining, index)) {
+            break;
+        }
+        m_slots[index].held = true;
+    }
+    // Only the held slots can be returned, the others might still be written by the worker task
+    for (size_t index = 0U; index < m_slot_count; index++) {
+        if (m_slots[index].held) {
+            m_slots[index].held = false;
+            Give_Free_Slot(index);
+        }
+    }
+    return held_slots == m_slot_count && !m_failed;
+}
+
+bool OTA_Write_Pipeline::Has_Failed() const {
+    return m_failed;
+}
+
+void OTA_Write_Pipeline::Cancel() {
+    m_cancelled = true;
+    (void)Flush();
+    m_cancelled = false;
+    m_failed = false;
+}
+
+void OTA_Write_Pipeline::Run() {
+    for (;;) {
+        size_t const index = Take_Filled_Slot();
+        if (index == STOP_INDEX) {
+            break;
+        }
+        Slot const & slot = m_slots[index];
+        if (!m_failed && !m_cancelled && !m_write_callback.Call_Callback(slot.offset, m_buffer + (index * m_slot_size), slot.length)) {
+            m_failed = true;
+        }
+        Give_Free_Slot(index);
+    }
+}
+
+bool OTA_Write_Pipeline::Take_Free_Slot(uint64_t const & timeout_microseconds, size_t & index) {
+#if THINGSBOARD_USE_FREERTOS
+    // Rounded up, so a timeout shorter than a tick still waits instead of only polling the queue
+    TickType_t const ticks = timeout_microseconds == 0U ? portMAX_DELAY : pdMS_TO_TICKS((timeout_microseconds + 999U) / 1000U) + 1U;
+    return xQueueReceive(m_free_slots, &index, ticks) == pdTRUE;
+#else
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto const slot_free = [this] { return !m_free_slots.empty(); };
+    if (timeout_microseconds == 0U) {
+        m_free_condition.wait(lock, slot_free);
+    }
+    else if (!m_free_condition.wait_for(lock, std::chrono::microseconds(timeout_microseconds), slot_free)) {
+        return false;
+    }
+    index = m_free_slots.front();
+    m_free_slots.pop_front();
+    return true;
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+void OTA_Write_Pipeline::Give_Free_Slot(size_t const & index) {
+#if THINGSBOARD_USE_FREERTOS
+    (void)xQueueSend(m_free_slots, &index, portMAX_DELAY);
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free_slots.push_back(index);
+    }
+    m_free_condition.notify_one();
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+size_t OTA_Write_Pipeline::Take_Filled_Slot() {
+    size_t index = 0U;
+#if THINGSBOARD_USE_FREERTOS
+    (void)xQueueReceive(m_filled_slots, &index, portMAX_DELAY);
+#else
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_filled_condition.wait(lock, [this] { return !m_filled_slots.empty(); });
+    index = m_filled_slots.front();
+    m_filled_slots.pop_front();
+#endif // THINGSBOARD_USE_FREERTOS
+    return index;
+}
+
+void OTA_Write_Pipeline::Give_Filled_Slot(size_t const & index) {
+#if THINGSBOARD_USE_FREERTOS
+    (void)xQueueSend(m_filled_slots, &index, portMAX_DELAY);
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_filled_slots.push_back(index);
+    }
+    m_filled_condition.notify_one();
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+void OTA_Write_Pipeline::Free_Resources() {
+    free(m_slots);
+    m_slots = nullptr;
+    free(m_buffer);
+    m_buffer = nullptr;
+    m_slot_count = 0U;
+    m_slot_size = 0U;
+#if THINGSBOARD_USE_FREERTOS
+    if (m_free_slots != nullptr) {
+        vQueueDelete(m_free_slots);
+        m_free_slots = nullptr;
+    }
+    if (m_filled_slots != nullptr) {
+        vQueueDelete(m_filled_slots);
+        m_filled_slots = nullptr;
+    }
+    if (m_stopped != nullptr) {
+        vSemaphoreDelete(m_stopped);
+        m_stopped = nullptr;
+    }
+#else
+    m_free_slots.clear();
+    m_filled_slots.clear();
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+#if THINGSBOARD_USE_FREERTOS
+void OTA_Write_Pipeline::Run_Task(void * parameter) {
+    OTA_Write_Pipeline * pipeline = static_cast<OTA_Write_Pipeline *>(parameter);
+    pipeline->Run();
+    (void)xSemaphoreGive(pipeline->m_stopped);
+    vTaskDelete(nullptr);
+}
+#endif // THINGSBOARD_USE_FREERTOS
+
+#else
+
+bool OTA_Write_Pipeline::Start(size_t const & /*slot_count*/, size_t const & /*slot_size*/, int8_t const & /*core*/, Callback<bool, size_t const &, uint8_t *, size_t const &>::function /*write_callback*/) {
+    // Neither FreeRTOS nor std::thread are supported, therefore chunks have to be written in the context that received them instead
+    return false;
+}
+
+void OTA_Write_Pipeline::Stop() {
+    // Nothing to do
+}
+
+bool OTA_Write_Pipeline::Is_Running() const {
+    return false;
+}
+
+bool OTA_Write_Pipeline::Resize(size_t const & /*slot_size*/) {
+    return true;
+}
+
+bool OTA_Write_Pipeline::Enqueue(size_t const & /*offset*/, uint8_t const * /*payload*/, size_t const & /*length*/, uint64_t const & /*timeout_microseconds*/) {
+    return false;
+}
+
+bool OTA_Write_Pipeline::Flush(uint64_t const & /*timeout_microseconds*/) {
+    return true;
+}
+
+bool OTA_Write_Pipeline::Has_Failed() const {
+    return false;
+}
+
+void OTA_Write_Pipeline::Cancel() {
+    // Nothing to do
+}
+
+#endif // THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
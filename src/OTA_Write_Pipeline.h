@@ -0,0 +1,153 @@
+#ifndef OTA_Write_Pipeline_h
+#define OTA_Write_Pipeline_h
+
+// Local includes.
+#include "Configuration.h"
+#include "Callback.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#if THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+#include <atomic>
+#endif // THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+#if THINGSBOARD_USE_FREERTOS
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#elif THINGSBOARD_USE_STD_THREAD
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif // THINGSBOARD_USE_FREERTOS
+
+
+// Stack size of the task that writes the firmware chunks, has to fit the hash calculation, the flash write of the updater implementation and persisting checkpoints.
+// Is in bytes on Espressif IDF, other FreeRTOS ports might expect the size in words instead
+uint32_t constexpr WRITE_PIPELINE_STACK_SIZE = (4U * 1024U);
+// Core the task that writes the firmware chunks is pinned to, if it may run on any core
+int8_t constexpr WRITE_PIPELINE_NO_AFFINITY = -1;
+
+
+/// @brief Ring of slots that received firmware chunks are copied into, which are then written in strictly sequential order by a separate worker task,
+/// so that the next chunks can already be requested and received while the previous chunks are still being written into flash memory and into the hash function.
+/// Uses a FreeRTOS task if THINGSBOARD_USE_FREERTOS is set, which can be pinned to a specific core, or a std::thread if THINGSBOARD_USE_STD_THREAD is set.
+/// If neither is supported on the current platform, starting the pipeline simply fails and the chunks have to be written directly instead.
+/// If writing a chunk fails, every following chunk is discarded without being written and the failure is reported the next time a chunk is added or the pipeline is flushed
+class OTA_Write_Pipeline {
+  public:
+    /// @brief Constructs a stopped pipeline, that has to be started before chunks can be added
+    OTA_Write_Pipeline() = default;
+
+    /// @brief Destructor, stops the worker task and frees all slots
+    ~OTA_Write_Pipeline();
+
+    /// @brief Allocates the slots and starts the worker task, that calls the given callback for every added chunk. Stops the previously started worker task first, if there is any
+    /// @param slot_count Amount of chunks that can be waiting to be written at once, adding a chunk while all slots are in use blocks until the oldest chunk has been written
+    /// @param slot_size Size in bytes every slot has to be able to hold, has to be atleast the size of the biggest added chunk
+    /// @param core Core the worker task is pinned to on multi core FreeRTOS targets, ignored otherwise. WRITE_PIPELINE_NO_AFFINITY allows it to run on any core
+    /// @param write_callback Callback that is called in the context of the worker task with the byte offset, the data and the length of each added chunk, in the order they have been added.
+    /// Has to return whether writing the chunk was successful
+    /// @return Whether the pipeline has been started, fails if neither FreeRTOS nor std::thread are supported or if allocating the slots or starting the worker task failed
+    bool Start(size_t const & slot_count, size_t const & slot_size, int8_t const & core, Callback<bool, size_t const &, uint8_t *, size_t const &>::function write_callback);
+
+    /// @brief Discards all chunks that have not been written yet, waits for the chunk that is currently being written, stops the worker task and frees all slots
+    void Stop();
+
+    /// @brief Whether the pipeline has been started and chunks can be added
+    /// @return Whether the worker task is running
+    bool Is_Running() const;
+
+    /// @brief Waits until all added chunks have been written and then increases the size of every slot, so it can hold chunks with the given size
+    /// @param slot_size Size in bytes every slot has to be able to hold
+    /// @return Whether the slots can hold chunks with the given size, if increasing fails or writing a previous chunk failed the previous size is kept unchanged
+    bool Resize(size_t const & slot_size);
+
+    /// @brief Copies the given chunk into the next free slot, so it is written by the worker task once all previously added chunks have been written.
+    /// Blocks until a slot is free, if all slots are in use
+    /// @param offset Byte offset of the chunk in the firmware binary
+    /// @param payload Firmware packet data of the chunk, does not have to stay valid after this method returns
+    /// @param length Amount of bytes in the firmware packet data, has to fit into a slot
+    /// @param timeout_microseconds Maximum time in microseconds to wait for a free slot, 0 waits until a slot is free, default = 0
+    /// @return Whether the chunk was added, fails if writing a previous chunk failed, in that case the pipeline has to be cancelled before chunks can be added again,
+    /// or if no slot became free before the timeout expired, because the worker task is still writing the previous chunks
+    bool Enqueue(size_t const & offset, uint8_t const * payload, size_t const & length, uint64_t const & timeout_microseconds = 0U);
+
+    /// @brief Waits until all added chunks have been written
+    /// @param timeout_microseconds Maximum time in microseconds to wait, 0 waits until all chunks have been written, default = 0
+    /// @return Whether all added chunks have been written successfully before the timeout expired
+    bool Flush(uint64_t const & timeout_microseconds = 0U);
+
+    /// @brief Whether writing an added chunk failed since the pipeline has been started or cancelled the last time
+    /// @return Whether the write callback returned false for any chunk
+    bool Has_Failed() const;
+
+    /// @brief Discards all chunks that have not been written yet, waits for the chunk that is currently being written and resets a previous write failure,
+    /// afterwards the pipeline is empty and new chunks can be added again
+    void Cancel();
+
+  private:
+#if THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+    /// @brief Position and size of the chunk held by a slot
+    struct Slot {
+        size_t offset = {}; // Byte offset of the chunk in the firmware binary
+        size_t length = {}; // Amount of bytes of binary data of the chunk
+        bool   held = {};   // Whether the slot is free but held by Flush(), while it waits for the remaining slots
+    };
+
+    /// @brief Writes the added chunks in order until it receives the index that signals the worker task to stop
+    void Run();
+
+    /// @brief Blocks until a slot is free and removes it from the free slots
+    /// @param timeout_microseconds Maximum time in microseconds to wait for a free slot, 0 waits until a slot is free
+    /// @param index Index of the free slot
+    /// @return Whether a slot became free before the timeout expired
+    bool Take_Free_Slot(uint64_t const & timeout_microseconds, size_t & index);
+
+    /// @brief Returns the given slot to the free slots
+    /// @param index Index of the slot that is not used anymore
+    void Give_Free_Slot(size_t const & index);
+
+    /// @brief Blocks until a slot has been filled and removes it from the filled slots
+    /// @return Index of the filled slot or the stop index
+    size_t Take_Filled_Slot();
+
+    /// @brief Appends the given slot to the filled slots, so it is written by the worker task
+    /// @param index Index of the slot that has been filled or the stop index
+    void Give_Filled_Slot(size_t const & index);
+
+    /// @brief Frees all slots and the synchronization primitives
+    void Free_Resources();
+
+#if THINGSBOARD_USE_FREERTOS
+    /// @brief Entry point of the FreeRTOS worker task
+    /// @param parameter Pointer to the pipeline instance the task belongs to
+    static void Run_Task(void * parameter);
+#endif // THINGSBOARD_USE_FREERTOS
+
+    Callback<bool, size_t const &, uint8_t *, size_t const &> m_write_callback = {}; // Callback that is called for every added chunk in the context of the worker task
+    Slot                                                     *m_slots = {};          // Position and size of the chunk held by every slot
+    uint8_t                                                  *m_buffer = {};         // Binary data of the slots, each slot can hold one complete chunk
+    size_t                                                   m_slot_count = {};      // Amount of slots
+    size_t                                                   m_slot_size = {};       // Size in bytes every slot can hold
+    bool                                                     m_running = {};         // Whether the worker task is running
+    std::atomic<bool>                                        m_failed = {};          // Whether writing a chunk failed, following chunks are discarded until the pipeline is cancelled
+    std::atomic<bool>                                        m_cancelled = {};       // Whether chunks that have not been written yet should be discarded
+#if THINGSBOARD_USE_FREERTOS
+    QueueHandle_t                                            m_free_slots = {};      // Indices of the slots that can be filled
+    QueueHandle_t                                            m_filled_slots = {};    // Indices of the slots that have to be written, in the order they have been filled
+    SemaphoreHandle_t                                        m_stopped = {};         // Given by the worker task right before it deletes itself
+#else
+    std::deque<size_t>                                       m_free_slots = {};      // Indices of the slots that can be filled
+    std::deque<size_t>                                       m_filled_slots = {};    // Indices of the slots that have to be written, in the order they have been filled
+    std::mutex                                               m_mutex = {};           // Guards both slot queues
+    std::condition_variable                                  m_free_condition = {};  // Notified once a slot has been returned to the free slots
+    std::condition_variable                                  m_filled_condition = {}; // Notified once a slot has been appended to the filled slots
+    std::thread                                              m_thread = {};          // Worker thread writing the added chunks
+#endif // THINGSBOARD_USE_FREERTOS
+#endif // THINGSBOARD_USE_FREERTOS || THINGSBOARD_USE_STD_THREAD
+};
+
+#endif // OTA_Write_Pipeline_h
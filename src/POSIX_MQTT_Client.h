@@ -0,0 +1,1102 @@
+#ifndef POSIX_MQTT_Client_h
+#define POSIX_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_POSIX_SOCKETS
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "MQTT_Packet_Type.h"
+
+// Library includes.
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Default receive and send buffer size, used until set_buffer_size() is called, the same default as the PubSubClient uses
+constexpr uint16_t POSIX_MQTT_DEFAULT_BUFFER_SIZE = 256U;
+// Default keep alive timeout in seconds, ThingsBoard marks devices as inactive if it does not receive any packet for 300 seconds with the default configuration
+constexpr uint16_t POSIX_MQTT_DEFAULT_KEEP_ALIVE_TIMEOUT = 60U;
+// Default time in milliseconds that connecting, waiting for the CONNACK and sending a single packet may take, before the operation is aborted
+constexpr uint16_t POSIX_MQTT_DEFAULT_NETWORK_TIMEOUT = 10U * 1000U;
+// Capacity of the receive ring buffer as a multiple of the receive buffer size, allows the I/O thread to keep receiving the next packets while loop() is still handling the previous ones
+constexpr size_t POSIX_MQTT_RING_BUFFER_FACTOR = 2U;
+// Maximum size of the topic of a message bigger than the receive buffer including the null termination, copied because the topic is released from the ring buffer before the payload is received completely
+constexpr size_t POSIX_MQTT_FRAGMENT_TOPIC_MAX_SIZE = 128U;
+// Maximum value of the remaining length field in the fixed header of any MQTT packet, encoded in at most 4 bytes with 7 bits each
+constexpr size_t POSIX_MQTT_MAX_REMAINING_LENGTH = 268435455U;
+// Maximum size of the fixed header (1 byte packet type and flags, up to 4 bytes remaining length) plus a 2 byte packet identifier or topic length
+constexpr size_t POSIX_MQTT_MAX_HEADER_SIZE = 7U;
+// Flags passed to sendmsg(), prevents the process from being terminated with SIGPIPE if the server closed the connection, on platforms that support it
+#ifdef MSG_NOSIGNAL
+constexpr int POSIX_MQTT_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int POSIX_MQTT_SEND_FLAGS = 0;
+#endif // MSG_NOSIGNAL
+constexpr char POSIX_MQTT_RESOLVE_FAILED[] = "Resolving server (%s) failed with error (%s)";
+constexpr char POSIX_MQTT_CONNECT_FAILED[] = "Connecting to server (%s:%u) failed";
+constexpr char POSIX_MQTT_CONNECTION_REFUSED[] = "Server refused connection with return code (%u)";
+constexpr char POSIX_MQTT_CONNECTION_LOST[] = "Connection to server lost with error (%s)";
+constexpr char POSIX_MQTT_KEEP_ALIVE_EXPIRED[] = "Server did not respond within keep alive timeout of (%u) seconds";
+constexpr char POSIX_MQTT_MALFORMED_PACKET[] = "Received malformed packet";
+constexpr char POSIX_MQTT_SUBSCRIBE_REJECTED[] = "Server rejected subscription with packet identifier (%u)";
+constexpr char POSIX_MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char POSIX_MQTT_SEND_EXCEEDS_BUFFER[] = "Amount of data to send (%u) is bigger than current send buffer size (%u), increase accordingly";
+constexpr char POSIX_MQTT_FRAGMENT_TOPIC_TOO_LONG[] = "Topic of message bigger than the receive buffer is longer than (%u) bytes, message is discarded";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char POSIX_MQTT_CONNECTED[] = "Connected to server (%s:%u)";
+constexpr char POSIX_MQTT_RESIZED_RING_BUFFER[] = "Resized receive ring buffer to (%u) bytes";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief MQTT Client interface implementation that speaks MQTT 3.1.1 directly over a non-blocking POSIX TCP socket, without any additional library.
+/// Allows to run the same application logic on Linux gateways or to benchmark and profile the library on a workstation against a local broker.
+/// Receiving is done by an own I/O thread, which waits with poll() for the socket and reads the received data with readv() directly into a ring buffer,
+/// without copying it into an intermediate buffer first. The I/O thread additionally sends the PINGREQ control packets to keep the connection alive.
+/// The received messages are then passed to the data callback from within loop(), meaning the callbacks are called in the same thread as with the Arduino_MQTT_Client
+/// and the ThingsBoard client does not need to be thread safe. The topic and payload are passed directly out of the ring buffer, only messages that wrap around the end of the ring buffer
+/// are copied into a linear buffer once. Messages are published with a single sendmsg() call, which scatters the header, topic and every payload segment directly from the given memory.
+/// Does not support encrypted connections, all messages are sent with QoS level 0 and received with QoS level 0, or QoS level 1 if persistent sessions are requested with set_clean_session()
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class POSIX_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation, that does not allocate the receive buffer or open the socket until set_buffer_size() or connect() is called
+    POSIX_MQTT_Client()
+      : m_received_data_callback()
+      , m_received_data_view_callback()
+      , m_receive_data_views(false)
+      , m_received_fragment_callback()
+      , m_receive_fragments(false)
+      , m_fragment_topic()
+      , m_fragment_topic_length(0U)
+      , m_forwarding_fragments(false)
+      , m_fragment_received(0U)
+      , m_fragment_size(0U)
+      , m_skip_remaining(0U)
+      , m_dropped_messages(0U)
+      , m_connected_callback()
+      , m_server_domain()
+      , m_server_port(0U)
+      , m_keep_alive_timeout(POSIX_MQTT_DEFAULT_KEEP_ALIVE_TIMEOUT)
+      , m_clean_session(true)
+      , m_session_present(false)
+      , m_network_timeout(POSIX_MQTT_DEFAULT_NETWORK_TIMEOUT)
+      , m_receive_buffer_size(POSIX_MQTT_DEFAULT_BUFFER_SIZE)
+      , m_send_buffer_size(POSIX_MQTT_DEFAULT_BUFFER_SIZE)
+      , m_ring_buffer(nullptr)
+      , m_ring_capacity(0U)
+      , m_linear_buffer(nullptr)
+      , m_linear_size(0U)
+      , m_pending_ring_buffer(nullptr)
+      , m_pending_linear_buffer(nullptr)
+      , m_pending_linear_size(0U)
+      , m_ring_head(0U)
+      , m_ring_tail(0U)
+      , m_ring_mutex()
+      , m_receive_paused(false)
+      , m_socket(-1)
+      , m_wake_pipe{-1, -1}
+      , m_io_thread()
+      , m_stop_io(false)
+      , m_connected(false)
+      , m_connection_generation(0U)
+      , m_send_mutex()
+      , m_last_send(0)
+      , m_packet_id(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, disconnects gracefully if still connected and frees the receive buffer
+    ~POSIX_MQTT_Client() {
+        close_connection(true);
+        free_buffers();
+    }
+
+    POSIX_MQTT_Client(POSIX_MQTT_Client const &) = delete;
+
+    POSIX_MQTT_Client & operator=(POSIX_MQTT_Client const &) = delete;
+
+    /// @brief Sets the keep alive timeout in seconds, the I/O thread sends a PINGREQ control packet once nothing has been sent for that long,
+    /// and closes the connection if nothing has been received for that long after the PINGREQ has been sent. Applied on the next call to connect().
+    /// The default timeout value ThingsBoard expectes to receive any message including a keep alive to not show the device as inactive can be found here https://thingsboard.io/docs/user-guide/install/config/#mqtt-server-parameters
+    /// under the transport.sessions.inactivity_timeout section and is 300 seconds. Meaning a value bigger than 300 seconds with the default config defeats the purpose of the keep alive alltogether
+    /// @param keep_alive_timeout_seconds Timeout until we send another PINGREQ control packet to the broker, 0 disables the keep alive mechanism, default = POSIX_MQTT_DEFAULT_KEEP_ALIVE_TIMEOUT (60 seconds)
+    void set_keep_alive_timeout(uint16_t keep_alive_timeout_seconds) {
+        m_keep_alive_timeout = keep_alive_timeout_seconds;
+    }
+
+    /// @brief Sets the amount of time in millseconds that establishing the connection, waiting for the CONNACK of the server and sending a single packet may take,
+    /// before the operation is aborted. Sending a packet only has to wait if the send buffer of the socket is full, once a packet could only be sent partially
+    /// the connection is closed, because the server could otherwise not differentiate the remaining bytes from the next packet
+    /// @param network_timeout_milliseconds Time in milliseconds that we wait until we abort the network operation, default = POSIX_MQTT_DEFAULT_NETWORK_TIMEOUT (10 seconds)
+    void set_network_timeout(uint16_t network_timeout_milliseconds) {
+        m_network_timeout = network_timeout_milliseconds;
+    }
+
+    /// @brief Gets the amount of messages, that have been discarded since this instance has been created,
+    /// because they were bigger than the receive buffer and were not handled by the fragment callback
+    /// @return Amount of discarded messages
+    size_t get_dropped_messages() const {
+        return m_dropped_messages;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_callback.Set_Callback(callback);
+    }
+
+    /// @brief The topic of a received message is not null terminated in the ring buffer, once this callback has been set it is passed directly as a view,
+    /// instead of being moved by one byte to append the null termination and passed to the callback set with set_data_callback()
+    bool set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_view_callback.Set_Callback(callback);
+        m_receive_data_views = true;
+        return true;
+    }
+
+    /// @brief Messages bigger than the receive buffer are passed in multiple parts, each containing the payload that has been received into the ring buffer since the last part,
+    /// once this callback has been set those parts are forwarded instead of discarding the message
+    bool set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function callback) override {
+        m_received_fragment_callback.Set_Callback(callback);
+        m_receive_fragments = true;
+        return true;
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connected_callback.Set_Callback(callback);
+    }
+
+    /// @brief Topics are subscribed with QoS level 1 instead of 0 while persistent sessions are requested, because the server only keeps messages for a disconnected client,
+    /// that have been published with atleast QoS level 1 on topics that were subscribed with atleast QoS level 1
+    bool set_clean_session(bool clean_session) override {
+        m_clean_session = clean_session;
+        return true;
+    }
+
+    bool get_session_present() override {
+        return m_session_present;
+    }
+
+    /// @brief The send buffer size only limits the size of messages sent with publish(), because the messages are sent directly from the passed memory without being copied into a buffer.
+    /// While connected, the ring buffer is allocated directly but only replaces the previous one once loop() is called the next time and is not handling a received message,
+    /// because the previous ring buffer is still accessed by the I/O thread and may still contain the message that is currently handled
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        if (receive_buffer_size == 0U) {
+            return false;
+        }
+        m_send_buffer_size = send_buffer_size;
+        if (receive_buffer_size == m_linear_size && m_pending_ring_buffer == nullptr) {
+            m_receive_buffer_size = receive_buffer_size;
+            return true;
+        }
+        free(m_pending_ring_buffer);
+        free(m_pending_linear_buffer);
+        m_pending_ring_buffer = static_cast<uint8_t *>(malloc(POSIX_MQTT_RING_BUFFER_FACTOR * receive_buffer_size));
+        m_pending_linear_buffer = static_cast<uint8_t *>(malloc(receive_buffer_size));
+        m_pending_linear_size = receive_buffer_size;
+        if (m_pending_ring_buffer == nullptr || m_pending_linear_buffer == nullptr) {
+            free(m_pending_ring_buffer);
+            free(m_pending_linear_buffer);
+            m_pending_ring_buffer = nullptr;
+            m_pending_linear_buffer = nullptr;
+            m_pending_linear_size = 0U;
+            return false;
+        }
+        m_receive_buffer_size = receive_buffer_size;
+        if (!m_io_thread.joinable()) {
+            apply_pending_buffers();
+        }
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        m_server_domain = domain != nullptr ? domain : "";
+        m_server_port = port;
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        // Ensure a previous connection is closed and its I/O thread has stopped, before the ring buffer is reset and reused for the new connection
+        close_connection(true);
+        m_session_present = false;
+        m_ring_head = 0U;
+        m_ring_tail = 0U;
+        if (m_linear_size == 0U && !set_buffer_size(m_receive_buffer_size, m_send_buffer_size)) {
+            return false;
+        }
+        apply_pending_buffers();
+        if (!open_socket()) {
+            Logger::printfln(POSIX_MQTT_CONNECT_FAILED, m_server_domain.c_str(), m_server_port);
+            return false;
+        }
+        if (!send_connect(client_id, user_name, password) || !receive_connack()) {
+            close_socket();
+            return false;
+        }
+        if (pipe(m_wake_pipe) != 0) {
+            close_socket();
+            return false;
+        }
+        (void)fcntl(m_wake_pipe[0], F_SETFL, O_NONBLOCK);
+        (void)fcntl(m_wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+        m_receive_paused = false;
+        m_skip_remaining = 0U;
+        m_forwarding_fragments = false;
+        m_stop_io = false;
+        m_connected = true;
+        m_io_thread = std::thread(&POSIX_MQTT_Client::io_loop, this);
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(POSIX_MQTT_CONNECTED, m_server_domain.c_str(), m_server_port);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_connected_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        close_connection(true);
+    }
+
+    bool loop() override {
+        // Messages that have been received before the connection was lost are still handled, because they have already been completely received into the ring buffer
+        process_received_packets();
+        return m_connected;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        size_t const topic_length = topic != nullptr ? strlen(topic) : 0U;
+        size_t const remaining_length = 2U + topic_length + length;
+        size_t const packet_size = 1U + get_remaining_length_size(remaining_length) + remaining_length;
+        if (packet_size > m_send_buffer_size) {
+            Logger::printfln(POSIX_MQTT_SEND_EXCEEDS_BUFFER, packet_size, m_send_buffer_size);
+            return false;
+        }
+        MQTT_Segment const segment = {payload, length};
+        return send_publish(topic, &segment, 1U, length);
+    }
+
+    /// @brief Every segment is passed as its own element of the scatter array to sendmsg(), meaning the payload is never concatenated
+    /// and is additionally not restricted to the send buffer size, the same as with the Arduino_MQTT_Client
+    bool publish_segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) override {
+        if (segments == nullptr) {
+            return false;
+        }
+        return send_publish(topic, segments, segment_count, get_segments_length(segments, segment_count));
+    }
+
+    bool subscribe(char const * topic) override {
+        if (!connected() || topic == nullptr) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        uint16_t const packet_id = get_next_packet_id();
+        uint8_t header[POSIX_MQTT_MAX_HEADER_SIZE + 2U] = {};
+        // Packet identifier, topic length and topic followed by the requested QoS level
+        size_t header_length = encode_fixed_header(header, MQTT_Packet_Type::SUBSCRIBE, 0x02U, 2U + 2U + topic_length + 1U);
+        header_length = encode_uint16(header, header_length, packet_id);
+        header_length = encode_uint16(header, header_length, topic_length);
+        uint8_t qos = m_clean_session ? 0U : 1U;
+        iovec packet[3U] = {{header, header_length}, {const_cast<char *>(topic), topic_length}, {&qos, sizeof(qos)}};
+        return send_packet(packet, 3U);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        if (!connected() || topic == nullptr) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        uint16_t const packet_id = get_next_packet_id();
+        uint8_t header[POSIX_MQTT_MAX_HEADER_SIZE + 2U] = {};
+        size_t header_length = encode_fixed_header(header, MQTT_Packet_Type::UNSUBSCRIBE, 0x02U, 2U + 2U + topic_length);
+        header_length = encode_uint16(header, header_length, packet_id);
+        header_length = encode_uint16(header, header_length, topic_length);
+        iovec packet[2U] = {{header, header_length}, {const_cast<char *>(topic), topic_length}};
+        return send_packet(packet, 2U);
+    }
+
+    bool connected() override {
+        return m_connected;
+    }
+
+  private:
+    /// @brief Gets the current time of the monotonic clock, used for the keep alive mechanism and the network timeout
+    /// @return Milliseconds since an unspecified point in time
+    static int64_t get_time_milliseconds() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// @brief Gets the amount of bytes needed to encode the given remaining length in the fixed header
+    /// @param remaining_length Amount of bytes following the fixed header
+    /// @return Amount of bytes of the variable length encoding, between 1 and 4
+    static size_t get_remaining_length_size(size_t remaining_length) {
+        size_t size = 1U;
+        while (remaining_length > 127U) {
+            remaining_length /= 128U;
+            size++;
+        }
+        return size;
+    }
+
+    /// @brief Writes the fixed header of a packet into the given buffer, which has to be atleast 5 bytes big
+    /// @param buffer Buffer the fixed header is written into
+    /// @param type Type of the packet
+    /// @param flags Flags contained in the lower 4 bits of the first byte
+    /// @param remaining_length Amount of bytes following the fixed header
+    /// @return Amount of bytes written into the buffer
+    static size_t encode_fixed_header(uint8_t * buffer, MQTT_Packet_Type const & type, uint8_t const & flags, size_t remaining_length) {
+        size_t length = 0U;
+        buffer[length++] = (static_cast<uint8_t>(type) << 4U) | flags;
+        do {
+            uint8_t encoded_byte = remaining_length % 128U;
+            remaining_length /= 128U;
+            if (remaining_length > 0U) {
+                encoded_byte |= 128U;
+            }
+            buffer[length++] = encoded_byte;
+        } while (remaining_length > 0U);
+        return length;
+    }
+
+    /// @brief Writes the given value in network byte order into the given buffer
+    /// @param buffer Buffer the value is written into
+    /// @param offset Offset in the buffer the value is written at
+    /// @param value Value that should be written
+    /// @return Offset directly after the written value
+    static size_t encode_uint16(uint8_t * buffer, size_t offset, size_t const & value) {
+        buffer[offset++] = static_cast<uint8_t>(value >> 8U);
+        buffer[offset++] = static_cast<uint8_t>(value);
+        return offset;
+    }
+
+    /// @brief Gets the next packet identifier for a SUBSCRIBE or UNSUBSCRIBE packet, 0 is not a valid packet identifier and therefore skipped
+    /// @return Packet identifier
+    uint16_t get_next_packet_id() {
+        uint16_t packet_id = ++m_packet_id;
+        if (packet_id == 0U) {
+            packet_id = ++m_packet_id;
+        }
+        return packet_id;
+    }
+
+    /// @brief Resolves the configured server and establishes the TCP connection with the first resolved address that accepts it, within the network timeout
+    /// @return Whether the connection has been established
+    bool open_socket() {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        char port[6U] = {};
+        (void)snprintf(port, sizeof(port), "%u", m_server_port);
+        addrinfo * addresses = nullptr;
+        int const error = getaddrinfo(m_server_domain.c_str(), port, &hints, &addresses);
+        if (error != 0) {
+            Logger::printfln(POSIX_MQTT_RESOLVE_FAILED, m_server_domain.c_str(), gai_strerror(error));
+            return false;
+        }
+        for (addrinfo const * address = addresses; address != nullptr; address = address->ai_next) {
+            int const socket_fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (socket_fd < 0) {
+                continue;
+            }
+            (void)fcntl(socket_fd, F_SETFL, fcntl(socket_fd, F_GETFL, 0) | O_NONBLOCK);
+            if (::connect(socket_fd, address->ai_addr, address->ai_addrlen) == 0 || (errno == EINPROGRESS && wait_for_socket(socket_fd, POLLOUT, get_time_milliseconds() + m_network_timeout))) {
+                int socket_error = 0;
+                socklen_t socket_error_length = sizeof(socket_error);
+                if (getsockopt(socket_fd, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_length) == 0 && socket_error == 0) {
+                    m_socket = socket_fd;
+                    break;
+                }
+            }
+            (void)close(socket_fd);
+        }
+        freeaddrinfo(addresses);
+        if (m_socket < 0) {
+            return false;
+        }
+        // Every message is sent with a single sendmsg() call, therefore delaying small packets to combine them with the following ones only increases the latency
+        int enable = 1;
+        (void)setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+#ifdef SO_NOSIGPIPE
+        (void)setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif // SO_NOSIGPIPE
+        return true;
+    }
+
+    /// @brief Waits until the given event occurs on the given socket or the deadline has passed
+    /// @param socket_fd Socket that should be waited for
+    /// @param events Events that should be waited for, either POLLIN or POLLOUT
+    /// @param deadline Time in milliseconds of the monotonic clock until which we wait
+    /// @return Whether the event occured before the deadline
+    static bool wait_for_socket(int const & socket_fd, short const & events, int64_t const & deadline) {
+        pollfd descriptor = {socket_fd, events, 0};
+        while (true) {
+            int64_t const timeout = deadline - get_time_milliseconds();
+            if (timeout <= 0) {
+                return false;
+            }
+            int const result = poll(&descriptor, 1U, static_cast<int>(timeout));
+            if (result > 0) {
+                return true;
+            }
+            else if (result < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Sends the CONNECT packet with a clean session and the configured keep alive timeout
+    /// @param client_id Client identification code, an empty client identifier lets the server assign one
+    /// @param user_name Client username, not sent if it is nullptr
+    /// @param password Client password, not sent if it or the username is nullptr
+    /// @return Whether the packet has been sent
+    bool send_connect(char const * client_id, char const * user_name, char const * password) {
+        size_t const client_id_length = client_id != nullptr ? strlen(client_id) : 0U;
+        size_t const user_name_length = user_name != nullptr ? strlen(user_name) : 0U;
+        size_t const password_length = password != nullptr ? strlen(password) : 0U;
+        // MQTT 3.1.1 only allows sending a password together with a username
+        bool const send_user_name = user_name != nullptr;
+        bool const send_password = send_user_name && password != nullptr;
+
+        uint8_t flags = m_clean_session ? 0x02U : 0x00U;
+        size_t remaining_length = 10U + 2U + client_id_length;
+        if (send_user_name) {
+            flags |= 0x80U;
+            remaining_length += 2U + user_name_length;
+        }
+        if (send_password) {
+            flags |= 0x40U;
+            remaining_length += 2U + password_length;
+        }
+
+        uint8_t header[POSIX_MQTT_MAX_HEADER_SIZE + 10U] = {};
+        size_t header_length = encode_fixed_header(header, MQTT_Packet_Type::CONNECT, 0U, remaining_length);
+        // Protocol name "MQTT" and protocol level 4, which is MQTT 3.1.1
+        static uint8_t constexpr PROTOCOL[] = {0x00U, 0x04U, 'M', 'Q', 'T', 'T', 0x04U};
+        (void)memcpy(header + header_length, PROTOCOL, sizeof(PROTOCOL));
+        header_length += sizeof(PROTOCOL);
+        header[header_length++] = flags;
+        header_length = encode_uint16(header, header_length, m_keep_alive_timeout);
+        header_length = encode_uint16(header, header_length, client_id_length);
+
+        uint8_t user_name_header[2U] = {};
+        uint8_t password_header[2U] = {};
+        (void)encode_uint16(user_name_header, 0U, user_name_length);
+        (void)encode_uint16(password_header, 0U, password_length);
+        iovec packet[6U] = {{header, header_length}, {const_cast<char *>(client_id), client_id_length}};
+        size_t count = 2U;
+        if (send_user_name) {
+            packet[count++] = {user_name_header, sizeof(user_name_header)};
+            packet[count++] = {const_cast<char *>(user_name), user_name_length};
+        }
+        if (send_password) {
+            packet[count++] = {password_header, sizeof(password_header)};
+            packet[count++] = {const_cast<char *>(password), password_length};
+        }
+        return send_packet(packet, count);
+    }
+
+    /// @brief Waits for the CONNACK packet of the server, before the I/O thread is started. Reads exactly the 4 bytes of the packet,
+    /// so any message the server sends directly afterwards is received into the ring buffer by the I/O thread
+    /// @return Whether the server accepted the connection within the network timeout
+    bool receive_connack() {
+        int64_t const deadline = get_time_milliseconds() + m_network_timeout;
+        uint8_t response[4U] = {};
+        size_t received = 0U;
+        while (received < sizeof(response)) {
+            if (!wait_for_socket(m_socket, POLLIN, deadline)) {
+                return false;
+            }
+            ssize_t const result = recv(m_socket, response + received, sizeof(response) - received, 0);
+            if (result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                return false;
+            }
+            else if (result > 0) {
+                received += result;
+            }
+        }
+        if (response[0U] != (static_cast<uint8_t>(MQTT_Packet_Type::CONNACK) << 4U) || response[1U] != 2U) {
+            Logger::printfln(POSIX_MQTT_MALFORMED_PACKET);
+            return false;
+        }
+        else if (response[3U] != 0U) {
+            Logger::printfln(POSIX_MQTT_CONNECTION_REFUSED, response[3U]);
+            return false;
+        }
+        // Session present flag is the lowest bit of the acknowledge flags, the server always clears it if a clean session was requested
+        m_session_present = (response[2U] & 0x01U) != 0U;
+        return true;
+    }
+
+    /// @brief Sends a PUBLISH packet with QoS level 0, the header, topic and every segment of the payload are each passed as their own element to sendmsg()
+    /// @param topic Topic that the message is sent over
+    /// @param segments Pointer to the first element of the array of segments that make up the payload
+    /// @param segment_count Amount of segments in the given array
+    /// @param length Total amount of bytes in all segments
+    /// @return Whether the packet has been sent completely
+    bool send_publish(char const * topic, MQTT_Segment const * segments, size_t const & segment_count, size_t const & length) {
+        if (!connected() || topic == nullptr) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        size_t const remaining_length = 2U + topic_length + length;
+        if (topic_length > UINT16_MAX || remaining_length > POSIX_MQTT_MAX_REMAINING_LENGTH) {
+            return false;
+        }
+        uint8_t header[POSIX_MQTT_MAX_HEADER_SIZE] = {};
+        size_t header_length = encode_fixed_header(header, MQTT_Packet_Type::PUBLISH, 0U, remaining_length);
+        header_length = encode_uint16(header, header_length, topic_length);
+
+        iovec packet[segment_count + 2U] = {};
+        packet[0U] = {header, header_length};
+        packet[1U] = {const_cast<char *>(topic), topic_length};
+        size_t count = 2U;
+        for (size_t i = 0U; i < segment_count; i++) {
+            if (segments[i].length == 0U) {
+                continue;
+            }
+            packet[count++] = {const_cast<uint8_t *>(segments[i].data), segments[i].length};
+        }
+        return send_packet(packet, count);
+    }
+
+    /// @brief Sends the given parts of a packet with as few sendmsg() calls as possible, is called from the thread calling publish() as well as the I/O thread, therefore sending is locked.
+    /// If the send buffer of the socket is full, waits until it has space again or the network timeout has passed
+    /// @param packet Parts of the packet that should be sent, is modified to keep track of the remaining bytes
+    /// @param count Amount of parts in the packet
+    /// @return Whether the packet has been sent completely
+    bool send_packet(iovec * packet, size_t count) {
+        std::lock_guard<std::mutex> lock(m_send_mutex);
+        if (m_socket < 0) {
+            return false;
+        }
+        int64_t const deadline = get_time_milliseconds() + m_network_timeout;
+        bool partially_sent = false;
+        while (count > 0U) {
+            msghdr message = {};
+            message.msg_iov = packet;
+            message.msg_iovlen = count;
+            ssize_t sent = sendmsg(m_socket, &message, POSIX_MQTT_SEND_FLAGS);
+            if (sent < 0) {
+                if (errno == EINTR || ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(m_socket, POLLOUT, deadline))) {
+                    continue;
+                }
+                // A partially sent packet can not be continued, because the server would interpret the following packet as the remaining bytes of this one
+                if (partially_sent || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    connection_lost(strerror(errno));
+                }
+                return false;
+            }
+            partially_sent = true;
+            // Skip all parts that have been sent completely and adjust the part that has only been sent partially
+            while (count > 0U && static_cast<size_t>(sent) >= packet->iov_len) {
+                sent -= packet->iov_len;
+                packet++;
+                count--;
+            }
+            if (count > 0U) {
+                packet->iov_base = static_cast<uint8_t *>(packet->iov_base) + sent;
+                packet->iov_len -= sent;
+            }
+        }
+        m_last_send = get_time_milliseconds();
+        return true;
+    }
+
+    /// @brief Marks the connection as lost and shuts the socket down, which wakes up any call that is still waiting for the socket.
+    /// The socket itself is only closed by close_connection(), once the I/O thread has stopped using it
+    /// @param error Reason the connection has been lost
+    void connection_lost(char const * error) {
+        if (m_connected.exchange(false)) {
+            Logger::printfln(POSIX_MQTT_CONNECTION_LOST, error);
+        }
+        (void)shutdown(m_socket, SHUT_RDWR);
+    }
+
+    /// @brief Wakes up the I/O thread if it is waiting in poll(), so it notices that it should stop or that space has been released in the ring buffer
+    void wake_io_thread() {
+        uint8_t const signal = 0U;
+        (void)write(m_wake_pipe[1U], &signal, sizeof(signal));
+    }
+
+    /// @brief Stops the I/O thread and closes the socket, the ring buffer is kept for the next connection
+    /// @param send_disconnect Whether to send a DISCONNECT packet before closing the socket, if the client is still connected
+    void close_connection(bool const & send_disconnect) {
+        if (send_disconnect && m_connected) {
+            uint8_t packet_data[2U] = {static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::DISCONNECT) << 4U), 0U};
+            iovec packet = {packet_data, sizeof(packet_data)};
+            (void)send_packet(&packet, 1U);
+        }
+        m_connected = false;
+        if (m_io_thread.joinable()) {
+            m_stop_io = true;
+            wake_io_thread();
+            m_io_thread.join();
+        }
+        close_socket();
+        // Messages that are still contained in the ring buffer belong to the closed connection and must not be handled anymore,
+        // the generation allows loop() to notice that the connection has been closed by one of the callbacks it called
+        m_connection_generation++;
+        m_skip_remaining = 0U;
+        m_forwarding_fragments = false;
+    }
+
+    /// @brief Closes the socket and the pipe used to wake the I/O thread
+    void close_socket() {
+        std::lock_guard<std::mutex> lock(m_send_mutex);
+        if (m_socket >= 0) {
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+        for (int & pipe_fd : m_wake_pipe) {
+            if (pipe_fd >= 0) {
+                (void)close(pipe_fd);
+                pipe_fd = -1;
+            }
+        }
+    }
+
+    /// @brief Replaces the ring buffer with the one allocated by set_buffer_size(), copies the received data that has not been handled yet to the start of the new ring buffer.
+    /// Has to be called from the thread calling loop() while no received message is handled, because the handled message points into the ring buffer
+    void apply_pending_buffers() {
+        if (m_pending_ring_buffer == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_ring_mutex);
+        size_t const head = m_ring_head;
+        size_t const unhandled = m_ring_tail - head;
+        size_t const pending_capacity = POSIX_MQTT_RING_BUFFER_FACTOR * m_pending_linear_size;
+        // Shrinking the ring buffer below the amount of data that has not been handled yet would lose that data, therefore we wait until it has been handled
+        if (unhandled > pending_capacity) {
+            return;
+        }
+        for (size_t i = 0U; i < unhandled; i++) {
+            m_pending_ring_buffer[i] = m_ring_buffer[(head + i) % m_ring_capacity];
+        }
+        free(m_ring_buffer);
+        free(m_linear_buffer);
+        m_ring_buffer = m_pending_ring_buffer;
+        m_ring_capacity = pending_capacity;
+        m_linear_buffer = m_pending_linear_buffer;
+        m_linear_size = m_pending_linear_size;
+        m_pending_ring_buffer = nullptr;
+        m_pending_linear_buffer = nullptr;
+        m_pending_linear_size = 0U;
+        m_ring_head = 0U;
+        m_ring_tail = unhandled;
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(POSIX_MQTT_RESIZED_RING_BUFFER, m_ring_capacity);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        if (m_receive_paused.exchange(false)) {
+            wake_io_thread();
+        }
+    }
+
+    /// @brief Frees the current and the pending receive buffers
+    void free_buffers() {
+        free(m_ring_buffer);
+        free(m_linear_buffer);
+        free(m_pending_ring_buffer);
+        free(m_pending_linear_buffer);
+        m_ring_buffer = nullptr;
+        m_linear_buffer = nullptr;
+        m_pending_ring_buffer = nullptr;
+        m_pending_linear_buffer = nullptr;
+        m_ring_capacity = 0U;
+        m_linear_size = 0U;
+        m_pending_linear_size = 0U;
+    }
+
+    /// @brief Entry point of the I/O thread, waits with poll() until data has been received or the keep alive timeout requires sending a PINGREQ.
+    /// Data is read with readv() directly into the free space of the ring buffer, which may wrap around the end of the buffer and therefore consist of two parts.
+    /// Once the ring buffer is full, the socket is not read anymore until loop() has handled some of the received messages, which lets the TCP flow control slow down the server
+    void io_loop() {
+        int64_t const keep_alive = static_cast<int64_t>(m_keep_alive_timeout) * 1000;
+        bool ping_outstanding = false;
+        int64_t ping_sent = 0;
+        m_last_send = get_time_milliseconds();
+
+        while (!m_stop_io) {
+            bool const receive = has_free_space();
+            int timeout = -1;
+            if (keep_alive > 0) {
+                int64_t const deadline = ping_outstanding ? ping_sent + keep_alive : m_last_send + keep_alive;
+                int64_t const remaining = deadline - get_time_milliseconds();
+                timeout = remaining > 0 ? static_cast<int>(remaining) : 0;
+            }
+            // Negative file descriptors are ignored by poll(), which prevents it from returning immediately if the server closed the connection while the ring buffer is full
+            pollfd descriptors[2U] = {{receive ? m_socket : -1, POLLIN, 0}, {m_wake_pipe[0U], POLLIN, 0}};
+            int const result = poll(descriptors, 2U, timeout);
+            if (result < 0 && errno != EINTR) {
+                connection_lost(strerror(errno));
+                break;
+            }
+            if (result > 0 && (descriptors[1U].revents & POLLIN) != 0) {
+                uint8_t signal = 0U;
+                while (read(m_wake_pipe[0U], &signal, sizeof(signal)) > 0) {
+                    // Nothing to do
+                }
+            }
+            if (result > 0 && descriptors[0U].revents != 0) {
+                ssize_t const received = receive_into_ring_buffer();
+                if (received == 0) {
+                    connection_lost("closed by server");
+                    break;
+                }
+                else if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    connection_lost(strerror(errno));
+                    break;
+                }
+                else if (received > 0) {
+                    // Any received data proves that the server is still reachable, not only the PINGRESP
+                    ping_outstanding = false;
+                }
+            }
+            if (keep_alive <= 0 || m_stop_io) {
+                continue;
+            }
+            int64_t const now = get_time_milliseconds();
+            if (ping_outstanding && now - ping_sent >= keep_alive) {
+                Logger::printfln(POSIX_MQTT_KEEP_ALIVE_EXPIRED, m_keep_alive_timeout);
+                connection_lost("keep alive expired");
+                break;
+            }
+            else if (!ping_outstanding && now - m_last_send >= keep_alive) {
+                uint8_t packet_data[2U] = {static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::PINGREQ) << 4U), 0U};
+                iovec packet = {packet_data, sizeof(packet_data)};
+                if (!send_packet(&packet, 1U)) {
+                    connection_lost("sending keep alive timed out");
+                    break;
+                }
+                ping_outstanding = true;
+                ping_sent = now;
+            }
+        }
+    }
+
+    /// @brief Checks whether the ring buffer has free space the I/O thread can receive into, if it does not the I/O thread is marked as paused,
+    /// so that the next time loop() releases space in the ring buffer it wakes the I/O thread up again
+    /// @return Whether the ring buffer has free space
+    bool has_free_space() {
+        std::lock_guard<std::mutex> lock(m_ring_mutex);
+        if (m_ring_tail - m_ring_head < m_ring_capacity) {
+            return true;
+        }
+        m_receive_paused = true;
+        // Space might have been released after the check but before the I/O thread was marked as paused, in which case loop() did not wake it up
+        return m_ring_tail - m_ring_head < m_ring_capacity;
+    }
+
+    /// @brief Reads the received data directly into the free space of the ring buffer, locked so that loop() can not replace the ring buffer at the same time
+    /// @return Amount of bytes received, 0 if the server closed the connection and a negative value if an error occured
+    ssize_t receive_into_ring_buffer() {
+        std::lock_guard<std::mutex> lock(m_ring_mutex);
+        size_t const tail = m_ring_tail;
+        size_t const free_space = m_ring_capacity - (tail - m_ring_head);
+        if (free_space == 0U) {
+            errno = EAGAIN;
+            return -1;
+        }
+        size_t const offset = tail % m_ring_capacity;
+        size_t const first_length = free_space < m_ring_capacity - offset ? free_space : m_ring_capacity - offset;
+        iovec free_parts[2U] = {{m_ring_buffer + offset, first_length}, {m_ring_buffer, free_space - first_length}};
+        ssize_t const received = readv(m_socket, free_parts, free_space > first_length ? 2U : 1U);
+        if (received > 0) {
+            m_ring_tail = tail + received;
+        }
+        return received;
+    }
+
+    /// @brief Gets the byte at the given position of the received data in the ring buffer
+    /// @param position Position of the byte, counted since the ring buffer has last been reset
+    /// @return Byte at the given position
+    uint8_t get_ring_byte(size_t const & position) const {
+        return m_ring_buffer[position % m_ring_capacity];
+    }
+
+    /// @brief Marks the given amount of bytes at the start of the received data as handled, which allows the I/O thread to receive into them again
+    /// @param length Amount of bytes that have been handled
+    void release_ring_buffer(size_t const & length) {
+        m_ring_head = m_ring_head + length;
+        if (m_receive_paused.exchange(false)) {
+            wake_io_thread();
+        }
+    }
+
+    /// @brief Handles all packets that have been received completely into the ring buffer, as well as the received parts of a message bigger than the receive buffer
+    void process_received_packets() {
+        size_t const generation = m_connection_generation;
+        while (m_connection_generation == generation) {
+            apply_pending_buffers();
+            size_t const head = m_ring_head;
+            size_t const available = m_ring_tail - head;
+            if (m_skip_remaining > 0U) {
+                if (available == 0U) {
+                    return;
+                }
+                process_skipped_part(head, available);
+                continue;
+            }
+
+            // Fixed header consists of the packet type and flags, followed by the remaining length in a variable length encoding of 1 to 4 bytes
+            size_t header_length = 1U;
+            size_t remaining_length = 0U;
+            size_t multiplier = 1U;
+            bool header_complete = false;
+            while (header_length < available && header_length <= 4U) {
+                uint8_t const encoded_byte = get_ring_byte(head + header_length);
+                remaining_length += (encoded_byte & 127U) * multiplier;
+                multiplier *= 128U;
+                header_length++;
+                if ((encoded_byte & 128U) == 0U) {
+                    header_complete = true;
+                    break;
+                }
+            }
+            if (!header_complete) {
+                if (header_length > 4U) {
+                    Logger::printfln(POSIX_MQTT_MALFORMED_PACKET);
+                    connection_lost("malformed packet");
+                }
+                return;
+            }
+
+            size_t const packet_size = header_length + remaining_length;
+            if (packet_size > m_linear_size) {
+                if (!begin_skipped_packet(head, available, header_length, remaining_length)) {
+                    return;
+                }
+                continue;
+            }
+            else if (available < packet_size) {
+                return;
+            }
+
+            // Packets are passed directly out of the ring buffer, only packets wrapping around its end have to be copied to be contiguous
+            size_t const offset = head % m_ring_capacity;
+            uint8_t * packet = m_ring_buffer + offset;
+            if (offset + packet_size > m_ring_capacity) {
+                size_t const first_length = m_ring_capacity - offset;
+                (void)memcpy(m_linear_buffer, m_ring_buffer + offset, first_length);
+                (void)memcpy(m_linear_buffer + first_length, m_ring_buffer, packet_size - first_length);
+                packet = m_linear_buffer;
+            }
+            handle_packet(packet, header_length, remaining_length);
+            // Handling the packet might have closed the connection and therefore reset the ring buffer
+            if (m_connection_generation != generation) {
+                return;
+            }
+            release_ring_buffer(packet_size);
+        }
+    }
+
+    /// @brief Handles a packet that has been received completely
+    /// @param packet Contiguous packet including the fixed header
+    /// @param header_length Amount of bytes in the fixed header
+    /// @param remaining_length Amount of bytes following the fixed header
+    void handle_packet(uint8_t * packet, size_t const & header_length, size_t const & remaining_length) {
+        MQTT_Packet_Type const type = static_cast<MQTT_Packet_Type>(packet[0U] >> 4U);
+        uint8_t * const variable_header = packet + header_length;
+        switch (type) {
+            case MQTT_Packet_Type::PUBLISH: {
+                uint8_t const qos = (packet[0U] >> 1U) & 0x03U;
+                size_t const topic_length = remaining_length >= 2U ? (static_cast<size_t>(variable_header[0U]) << 8U) | variable_header[1U] : SIZE_MAX;
+                size_t const variable_header_length = 2U + topic_length + (qos > 0U ? 2U : 0U);
+                if (topic_length == SIZE_MAX || variable_header_length > remaining_length) {
+                    Logger::printfln(POSIX_MQTT_MALFORMED_PACKET);
+                    break;
+                }
+                if (qos == 1U) {
+                    send_puback(variable_header + 2U + topic_length);
+                }
+                handle_data(reinterpret_cast<char *>(variable_header + 2U), topic_length, variable_header + variable_header_length, remaining_length - variable_header_length);
+                break;
+            }
+            case MQTT_Packet_Type::SUBACK:
+                // Every requested topic is answered with the granted QoS level or 0x80 if the subscription has been rejected
+                for (size_t i = 2U; i < remaining_length; i++) {
+                    if (variable_header[i] == 0x80U) {
+                        Logger::printfln(POSIX_MQTT_SUBSCRIBE_REJECTED, (static_cast<size_t>(variable_header[0U]) << 8U) | variable_header[1U]);
+                    }
+                }
+                break;
+            default:
+                // Nothing to do, the PINGRESP is already handled by the I/O thread and UNSUBACK does not contain any information
+                break;
+        }
+    }
+
+    /// @brief Acknowledges a message received with QoS level 1, which the server only sends if it does not respect the QoS level 0 we subscribed with
+    /// @param packet_id Pointer to the packet identifier of the received message in network byte order
+    void send_puback(uint8_t const * packet_id) {
+        uint8_t packet_data[4U] = {static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::PUBACK) << 4U), 2U, packet_id[0U], packet_id[1U]};
+        iovec packet = {packet_data, sizeof(packet_data)};
+        (void)send_packet(&packet, 1U);
+    }
+
+    /// @brief Passes the complete received message to the data callback, directly with the topic as a view if that callback has been set.
+    /// Otherwise the topic is moved by one byte into the already handled topic length field, so it can be null terminated without overwriting the payload or copying it
+    /// @param topic Topic the message was received over, not null terminated and directly preceded by the 2 byte topic length
+    /// @param topic_length Amount of characters in the topic
+    /// @param payload Payload of the message
+    /// @param length Amount of bytes in the payload
+    void handle_data(char * topic, size_t const & topic_length, uint8_t * payload, size_t const & length) {
+        if (m_receive_data_views) {
+            m_received_data_view_callback.Call_Callback(String_View(topic, topic_length), payload, length);
+            return;
+        }
+        char * const terminated_topic = topic - 1U;
+        (void)memmove(terminated_topic, topic, topic_length);
+        terminated_topic[topic_length] = '\0';
+        m_received_data_callback.Call_Callback(terminated_topic, payload, length);
+    }
+
+    /// @brief Starts skipping a packet that is bigger than the receive buffer. For messages the variable header is handled first,
+    /// and the topic is copied so the received parts of the payload can be forwarded to the fragment callback, before they are released from the ring buffer
+    /// @param head Position of the first byte of the packet
+    /// @param available Amount of bytes of the packet that have been received so far
+    /// @param header_length Amount of bytes in the fixed header
+    /// @param remaining_length Amount of bytes following the fixed header
+    /// @return Whether the packet is now skipped, false if the variable header has not been received completely yet
+    bool begin_skipped_packet(size_t const & head, size_t const & available, size_t const & header_length, size_t const & remaining_length) {
+        m_fragment_received = 0U;
+        m_forwarding_fragments = false;
+        if (static_cast<MQTT_Packet_Type>(get_ring_byte(head) >> 4U) != MQTT_Packet_Type::PUBLISH) {
+            Logger::printfln(POSIX_MQTT_DATA_EXCEEDS_BUFFER, header_length + remaining_length, m_linear_size);
+            m_fragment_size = header_length + remaining_length;
+            m_skip_remaining = m_fragment_size;
+            return true;
+        }
+        if (available < header_length + 2U) {
+            return false;
+        }
+        uint8_t const qos = (get_ring_byte(head) >> 1U) & 0x03U;
+        size_t const topic_length = (static_cast<size_t>(get_ring_byte(head + header_length)) << 8U) | get_ring_byte(head + header_length + 1U);
+        size_t const variable_header_length = 2U + topic_length + (qos > 0U ? 2U : 0U);
+        if (topic_length >= sizeof(m_fragment_topic) || variable_header_length > remaining_length) {
+            Logger::printfln(POSIX_MQTT_FRAGMENT_TOPIC_TOO_LONG, sizeof(m_fragment_topic) - 1U);
+            m_dropped_messages++;
+            m_fragment_size = header_length + remaining_length;
+            m_skip_remaining = m_fragment_size;
+            return true;
+        }
+        else if (available < header_length + variable_header_length) {
+            return false;
+        }
+        for (size_t i = 0U; i < topic_length; i++) {
+            m_fragment_topic[i] = static_cast<char>(get_ring_byte(head + header_length + 2U + i));
+        }
+        m_fragment_topic[topic_length] = '\0';
+        m_fragment_topic_length = topic_length;
+        if (qos == 1U) {
+            uint8_t const packet_id[2U] = {get_ring_byte(head + header_length + 2U + topic_length), get_ring_byte(head + header_length + 3U + topic_length)};
+            send_puback(packet_id);
+        }
+        m_fragment_size = remaining_length - variable_header_length;
+        m_skip_remaining = m_fragment_size;
+        m_forwarding_fragments = m_receive_fragments;
+        if (!m_forwarding_fragments) {
+            Logger::printfln(POSIX_MQTT_DATA_EXCEEDS_BUFFER, header_length + remaining_length, m_linear_size);
+            m_dropped_messages++;
+        }
+        release_ring_buffer(header_length + variable_header_length);
+        return true;
+    }
+
+    /// @brief Handles the contiguous received part of a packet that is skipped, because it is bigger than the receive buffer.
+    /// Forwards it to the fragment callback if the callback handles the message, which is decided with the first part, and discards it otherwise
+    /// @param head Position of the first received byte of the part
+    /// @param available Amount of bytes that have been received so far
+    void process_skipped_part(size_t const & head, size_t const & available) {
+        size_t const offset = head % m_ring_capacity;
+        size_t length = m_ring_capacity - offset;
+        if (available < length) {
+            length = available;
+        }
+        if (m_skip_remaining < length) {
+            length = m_skip_remaining;
+        }
+        size_t const generation = m_connection_generation;
+        if (m_forwarding_fragments) {
+            bool const handled = m_received_fragment_callback.Call_Callback(String_View(m_fragment_topic, m_fragment_topic_length), m_ring_buffer + offset, m_fragment_received, length, m_fragment_size);
+            if (m_fragment_received == 0U && !handled) {
+                Logger::printfln(POSIX_MQTT_DATA_EXCEEDS_BUFFER, m_fragment_size, m_linear_size);
+                m_dropped_messages++;
+                m_forwarding_fragments = false;
+            }
+            // Handling the part might have closed the connection and therefore reset the ring buffer
+            if (m_connection_generation != generation) {
+                return;
+            }
+        }
+        m_fragment_received += length;
+        m_skip_remaining -= length;
+        release_ring_buffer(length);
+    }
+
+    Callback<void, char *, uint8_t *, unsigned int> m_received_data_callback = {}; // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, String_View const &, uint8_t *, unsigned int> m_received_data_view_callback = {}; // Callback that will be called as soon as the mqtt client receives any data, with the topic as a view
+    bool                                            m_receive_data_views = {};     // Whether received messages are passed to the callback with the topic as a view instead of the one with a null terminated topic
+    Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t> m_received_fragment_callback = {}; // Callback that will be called for every part of a message bigger than the receive buffer
+    bool                                            m_receive_fragments = {};      // Whether parts of messages bigger than the receive buffer are offered to the fragment callback, before they are discarded
+    char                                            m_fragment_topic[POSIX_MQTT_FRAGMENT_TOPIC_MAX_SIZE] = {}; // Topic of the message bigger than the receive buffer that is currently skipped
+    size_t                                          m_fragment_topic_length = {};  // Amount of characters in the topic of the message that is currently skipped
+    bool                                            m_forwarding_fragments = {};   // Whether the parts of the skipped message are forwarded to the fragment callback instead of being discarded
+    size_t                                          m_fragment_received = {};      // Amount of bytes of the skipped message that have already been handled
+    size_t                                          m_fragment_size = {};          // Amount of bytes in the payload of the skipped message, or the complete packet if it is not a message
+    size_t                                          m_skip_remaining = {};         // Amount of bytes of the skipped packet that still have to be handled, 0 if no packet is skipped
+    size_t                                          m_dropped_messages = {};       // Amount of messages bigger than the receive buffer that have been discarded
+    Callback<void>                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
+    std::string                                     m_server_domain = {};          // Server instance name the client connects to
+    uint16_t                                        m_server_port = {};            // Port the client connects to
+    uint16_t                                        m_keep_alive_timeout = {};     // Keep alive timeout in seconds sent in the CONNECT packet, 0 disables the keep alive mechanism
+    bool                                            m_clean_session = {};          // Whether the CONNECT packet requests a clean session
+    bool                                            m_session_present = {};        // Whether the CONNACK of the last established connection reported that the previous session was still present
+    uint16_t                                        m_network_timeout = {};        // Time in milliseconds network operations may take before they are aborted
+    uint16_t                                        m_receive_buffer_size = {};    // Receive buffer size requested with set_buffer_size(), might not have been applied to the ring buffer yet
+    uint16_t                                        m_send_buffer_size = {};       // Maximum size of a packet sent with publish()
+    uint8_t                                        *m_ring_buffer = {};            // Ring buffer the I/O thread receives into and loop() handles the received packets from
+    size_t                                          m_ring_capacity = {};          // Amount of bytes in the ring buffer
+    uint8_t                                        *m_linear_buffer = {};          // Buffer packets wrapping around the end of the ring buffer are copied into, to be contiguous
+    size_t                                          m_linear_size = {};            // Amount of bytes in the linear buffer, which is the maximum size of a packet that is handled completely
+    uint8_t                                        *m_pending_ring_buffer = {};    // Ring buffer allocated by set_buffer_size(), that replaces the current one the next time loop() is called
+    uint8_t                                        *m_pending_linear_buffer = {};  // Linear buffer allocated by set_buffer_size(), that replaces the current one together with the ring buffer
+    size_t                                          m_pending_linear_size = {};    // Amount of bytes in the pending linear buffer
+    std::atomic<size_t>                             m_ring_head;                   // Position of the first received byte that has not been handled by loop() yet, only written by the thread calling loop()
+    std::atomic<size_t>                             m_ring_tail;                   // Position after the last received byte, only written by the I/O thread, except when the ring buffer is reset or replaced
+    std::mutex                                      m_ring_mutex;                  // Locks the ring buffer while the I/O thread receives into it, so loop() can replace it
+    std::atomic<bool>                               m_receive_paused;              // Whether the I/O thread stopped receiving because the ring buffer is full and has to be woken up once space is released
+    int                                             m_socket = {};                 // File descriptor of the connected socket, -1 if not connected
+    int                                             m_wake_pipe[2U] = {};          // Pipe that is written to wake the I/O thread up while it is waiting in poll()
+    std::thread                                     m_io_thread;                   // Thread that receives into the ring buffer and sends the PINGREQ control packets
+    std::atomic<bool>                               m_stop_io;                     // Whether the I/O thread should stop
+    std::atomic<bool>                               m_connected;                   // Whether the connection has been established and has not been closed or lost since
+    size_t                                          m_connection_generation = {};  // Incremented whenever the connection is closed, allows loop() to notice that a callback closed the connection
+    std::mutex                                      m_send_mutex;                  // Locks the socket while sending, because publish() and the I/O thread may send at the same time
+    std::atomic<int64_t>                            m_last_send;                   // Time in milliseconds of the monotonic clock the last packet has been sent completely
+    std::atomic<uint16_t>                           m_packet_id;                   // Last packet identifier used for a SUBSCRIBE or UNSUBSCRIBE packet
+};
+
+#endif // THINGSBOARD_USE_POSIX_SOCKETS
+
+#endif // POSIX_MQTT_Client_h
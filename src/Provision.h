@@ -95,11 +95,11 @@ class Provision : public IAPI_Implementation {
         return API_Process_Type::JSON;
     }
 
-    void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
+    void Process_Response(String_View const & topic, uint8_t * payload, unsigned int length) override {
         // Nothing to do
     }
 
-    void Process_Json_Response(char const * topic, JsonDocument const & data) override {
+    void Process_Json_Response(String_View const & topic, JsonDocument const & data) override {
         m_provision_callback.Stop_Timeout_Timer();
         m_provision_callback.Call_Callback(data);
         // Unsubscribe from the provision response topic,
@@ -107,8 +107,8 @@ class Provision : public IAPI_Implementation {
         (void)Provision_Unsubscribe();
     }
 
-    bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(PROV_RESPONSE_TOPIC, topic, strlen(PROV_RESPONSE_TOPIC) + 1) == 0;
+    bool Compare_Response_Topic(String_View const & topic) const override {
+        return topic == String_View(PROV_RESPONSE_TOPIC, sizeof(PROV_RESPONSE_TOPIC) - 1U);
     }
 
     bool Unsubscribe() override {
@@ -0,0 +1,77 @@
+// Header include.
+#include "Reconnect_Backoff.h"
+
+// Local includes.
+#include "Helper.h"
+
+Reconnect_Backoff::Reconnect_Backoff()
+  : m_minimum_delay(RECONNECT_DEFAULT_MINIMUM_DELAY)
+  , m_maximum_delay(RECONNECT_DEFAULT_MAXIMUM_DELAY)
+  , m_random_state(1U)
+  , m_attempts(0U)
+  , m_delay(0U)
+  , m_scheduled(false)
+  , m_next_attempt(0U)
+{
+    // Nothing to do
+}
+
+void Reconnect_Backoff::Set_Delays(uint32_t const & minimum_delay_ms, uint32_t const & maximum_delay_ms) {
+    m_minimum_delay = minimum_delay_ms;
+    m_maximum_delay = maximum_delay_ms < minimum_delay_ms ? minimum_delay_ms : maximum_delay_ms;
+}
+
+void Reconnect_Backoff::Set_Seed(uint32_t const & seed) {
+    m_random_state = seed != 0U ? seed : 1U;
+}
+
+bool Reconnect_Backoff::Is_Scheduled() const {
+    return m_scheduled;
+}
+
+void Reconnect_Backoff::Schedule() {
+    // Double the delay for every failed attempt, the comparison against half the maximum ensures the doubling can never overflow
+    uint32_t delay = m_minimum_delay;
+    for (uint32_t i = 1U; i < m_attempts && delay < m_maximum_delay; i++) {
+        delay = delay > m_maximum_delay / 2U ? m_maximum_delay : delay * 2U;
+    }
+    if (m_attempts == 0U) {
+        // Spread the first attempt over the complete minimum delay, because that is the moment all devices disconnected by the same event are synchronized
+        m_delay = Get_Random() % (delay + 1U);
+    }
+    else {
+        // Keep atleast half the delay, so the delay actually grows with every failed attempt
+        m_delay = delay - (Get_Random() % (delay / 2U + 1U));
+    }
+    m_next_attempt = Helper::getTimeMicroseconds() + static_cast<uint64_t>(m_delay) * 1000U;
+    m_scheduled = true;
+}
+
+bool Reconnect_Backoff::Is_Due() const {
+    return m_scheduled && Helper::getTimeMicroseconds() >= m_next_attempt;
+}
+
+void Reconnect_Backoff::Attempted() {
+    m_attempts++;
+    m_scheduled = false;
+}
+
+void Reconnect_Backoff::Reset() {
+    m_attempts = 0U;
+    m_scheduled = false;
+}
+
+uint32_t const & Reconnect_Backoff::Get_Attempts() const {
+    return m_attempts;
+}
+
+uint32_t const & Reconnect_Backoff::Get_Delay() const {
+    return m_delay;
+}
+
+uint32_t Reconnect_Backoff::Get_Random() {
+    m_random_state ^= m_random_state << 13U;
+    m_random_state ^= m_random_state >> 17U;
+    m_random_state ^= m_random_state << 5U;
+    return m_random_state;
+}
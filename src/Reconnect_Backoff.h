@@ -0,0 +1,75 @@
+#ifndef Reconnect_Backoff_h
+#define Reconnect_Backoff_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Default delay in milliseconds the first reconnect attempt is spread over and the following delays are doubled from
+uint32_t constexpr RECONNECT_DEFAULT_MINIMUM_DELAY = 1000U;
+// Default delay in milliseconds the doubled delays between reconnect attempts are capped at
+uint32_t constexpr RECONNECT_DEFAULT_MAXIMUM_DELAY = (5U * 60U * 1000U);
+
+
+/// @brief Schedules reconnect attempts with a jittered exponential backoff, so that a lot of devices that lost their connection at the same time, for example because the broker restarted,
+/// neither reconnect all at the same moment nor keep retrying in lockstep. The first attempt is delayed by a random time between 0 and the minimum delay,
+/// every following attempt by a random time between half and the full delay, which starts at the minimum delay and is doubled for every failed attempt until it reaches the maximum delay.
+/// The random values are generated with a xorshift generator, which has to be seeded with a value that differs between devices, for example derived from the client id and the current time
+class Reconnect_Backoff {
+  public:
+    /// @brief Constructs a backoff with the default delays and no scheduled attempt
+    Reconnect_Backoff();
+
+    /// @brief Sets the bounds of the delay between reconnect attempts, does not change an already scheduled attempt
+    /// @param minimum_delay_ms Delay in milliseconds the first attempt is spread over and the following delays are doubled from
+    /// @param maximum_delay_ms Delay in milliseconds the doubled delays are capped at, is raised to the minimum delay if it is smaller
+    void Set_Delays(uint32_t const & minimum_delay_ms, uint32_t const & maximum_delay_ms);
+
+    /// @brief Seeds the random generator the jitter is calculated with
+    /// @param seed Seed of the random generator, 0 is replaced with 1 because the generator would only ever return 0 otherwise
+    void Set_Seed(uint32_t const & seed);
+
+    /// @brief Whether the time of the next attempt has been calculated already
+    /// @return Whether an attempt is scheduled
+    bool Is_Scheduled() const;
+
+    /// @brief Calculates the time of the next attempt from the current time and the amount of attempts made since the last Reset()
+    void Schedule();
+
+    /// @brief Whether the time of the scheduled attempt has been reached
+    /// @return Whether an attempt is scheduled and should be made now
+    bool Is_Due() const;
+
+    /// @brief Informs the backoff that the scheduled attempt has been made, which increases the delay of the next attempt, that then has to be scheduled with Schedule()
+    void Attempted();
+
+    /// @brief Resets the amount of attempts and removes the scheduled attempt, called once the connection has been established
+    void Reset();
+
+    /// @brief Gets the amount of attempts made since the last Reset()
+    /// @return Amount of made attempts
+    uint32_t const & Get_Attempts() const;
+
+    /// @brief Gets the delay of the last scheduled attempt
+    /// @return Delay in milliseconds between scheduling and the time of the attempt
+    uint32_t const & Get_Delay() const;
+
+  private:
+    /// @brief Generates the next random value with the xorshift generator
+    /// @return Random value
+    uint32_t Get_Random();
+
+    uint32_t m_minimum_delay = {};  // Delay in milliseconds the first attempt is spread over and the following delays are doubled from
+    uint32_t m_maximum_delay = {};  // Delay in milliseconds the doubled delays are capped at
+    uint32_t m_random_state = {};   // State of the xorshift generator
+    uint32_t m_attempts = {};       // Amount of attempts made since the last reset
+    uint32_t m_delay = {};          // Delay in milliseconds of the last scheduled attempt
+    bool     m_scheduled = {};      // Whether the time of the next attempt has been calculated already
+    uint64_t m_next_attempt = {};   // Time in microseconds the scheduled attempt should be made at
+};
+
+#endif // Reconnect_Backoff_h
@@ -0,0 +1,17 @@
+#ifndef Request_Reconnect_Policy_h
+#define Request_Reconnect_Policy_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Possible ways to handle single-event requests (Attribute Request, Client-Side RPC), whose response has not been received yet, once the connection to the server has been established again.
+/// Keeping a request only makes sense if its response can still arrive, which is the case if the session has been kept by the server, because it then still has the subscription
+/// and delivers the response queued while the client was disconnected, or if the server answered after the connection was established again
+enum class Request_Reconnect_Policy : uint8_t {
+    DISCARD,                 ///< Unsubscribes and removes all pending requests, they will have to be sent again by the user
+    KEEP_IF_SESSION_PRESENT, ///< Keeps all pending requests if the server reported that it still had the session of the previous connection and discards them otherwise
+    KEEP                     ///< Always keeps all pending requests and subscribes their response topics again if the session was not kept, they are still removed by their timeout if no response arrives
+};
+
+#endif // Request_Reconnect_Policy_h
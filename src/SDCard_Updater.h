@@ -7,6 +7,15 @@
 // Local include.
 #include <IUpdater.h>
 
+// Library include.
+#include <stdio.h>
+#ifdef __has_include
+#  if __has_include(<unistd.h>)
+#    include <unistd.h>
+#    define THINGSBOARD_SDCARD_UPDATER_TRUNCATE 1
+#  endif
+#endif
+
 constexpr char OPEN_FILE_FAILED[] = "Failed to open file (%s), ensure path is correct and SD card exist and is initalized";
 
 
@@ -32,6 +41,28 @@ class SDCard_Updater : public IUpdater {
         return true;
     }
   
+    bool resume(size_t const & /*firmware_size*/, size_t const & offset) override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool const seeked = fseek(file, 0, SEEK_END) == 0;
+        long const file_size = ftell(file);
+        fclose(file);
+        if (!seeked || file_size < 0 || static_cast<size_t>(file_size) < offset) {
+            return false;
+        }
+        if (static_cast<size_t>(file_size) == offset) {
+            return true;
+        }
+#ifdef THINGSBOARD_SDCARD_UPDATER_TRUNCATE
+        // Bytes written after the checkpoint was created have to be discarded, because they are requested and appended again
+        return truncate(m_path, static_cast<off_t>(offset)) == 0;
+#else
+        return false;
+#endif // THINGSBOARD_SDCARD_UPDATER_TRUNCATE
+    }
+
     size_t write(uint8_t * payload, size_t const & total_bytes) override {
         FILE* file = fopen(m_path, "a");
         if (file == nullptr) {
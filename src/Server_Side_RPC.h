@@ -20,9 +20,6 @@ static constexpr char RPC_SUBSCRIBE_FMT[] = "sensor/%s/request/+";
 static constexpr char RPC_REQUEST_PREFIX_FMT[] = "sensor/%s/request/";
 static constexpr char RPC_RESPONSE_FMT[] = "sensor/%s/response/%u";
 
-// Shared, safe stack buffer for topics (avoid VLAs)
-static constexpr size_t TOPIC_BUF_SIZE = 256;
-
 // Log messages.
 static constexpr char RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -113,13 +110,13 @@ public:
 
     API_Process_Type Get_Process_Type() const override { return API_Process_Type::JSON; }
 
-    void Process_Response(char const* /*topic*/, uint8_t* /*payload*/, unsigned int /*length*/) override
+    void Process_Response(String_View const& /*topic*/, uint8_t* /*payload*/, unsigned int /*length*/) override
     {
         // Nothing to do for raw payload here.
         // Serial.println("RPC Process_Response called");
     }
 
-    void Process_Json_Response(char const* topic, JsonDocument const& data) override
+    void Process_Json_Response(String_View const& topic, JsonDocument const& data) override
     {
         // Serial.println("RPC Process_Json_Response called");
 
@@ -199,11 +196,11 @@ public:
         }
     }
 
-    bool Compare_Response_Topic(char const* topic) const override
+    bool Compare_Response_Topic(String_View const& topic) const override
     {
         char reqPrefix[TOPIC_BUF_SIZE];
         Build_Request_Prefix(reqPrefix, sizeof(reqPrefix));
-        return strncmp(reqPrefix, topic, strlen(reqPrefix)) == 0;
+        return topic.starts_with(reqPrefix);
     }
 
     bool Unsubscribe() override { return RPC_Unsubscribe(); }
@@ -223,6 +220,12 @@ public:
         return true;
     }
 
+    bool Restore_Topic(bool const & session_present, bool const & keep_requests) override
+    {
+        // The server still has the subscription if it kept the session, meaning subscribing again would only cause unnecessary traffic
+        return session_present || Resubscribe_Topic();
+    }
+
 #if !THINGSBOARD_USE_ESP_TIMER
     void loop() override
     {
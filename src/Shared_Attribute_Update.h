@@ -115,17 +115,19 @@ public:
         return API_Process_Type::JSON;
     }
 
-    void Process_Response(char const* /*topic*/, uint8_t* /*payload*/, unsigned int /*length*/) override
+    void Process_Response(String_View const& /*topic*/, uint8_t* /*payload*/, unsigned int /*length*/) override
     {
         // Nothing to do
     }
 
-    void Process_Json_Response(char const* /*topic*/, JsonDocument const& data) override
+    void Process_Json_Response(String_View const& /*topic*/, JsonDocument const& data) override
     {
         // Serial.println("Shared_Attributes :: Process_Json_Response 1");
         // Debug: print the received JSON document
+#ifdef ARDUINO
         serializeJsonPretty(data, Serial);
         Serial.println();
+#endif // ARDUINO
 
         auto object = data.as<JsonObjectConst>();
         if (object.containsKey(SHARED_RESPONSE_KEY))
@@ -212,14 +214,14 @@ public:
         }
     }
 
-    bool Compare_Response_Topic(char const* topic) const override
+    bool Compare_Response_Topic(String_View const& topic) const override
     {
         char built[128];
         if (!Build_Attribute_Topic(built, sizeof(built)))
         {
             return false;
         }
-        return strncmp(built, topic, strlen(built) + 1) == 0;
+        return topic == String_View(built);
     }
 
     bool Unsubscribe() override
@@ -248,6 +250,12 @@ public:
         return true;
     }
 
+    bool Restore_Topic(bool const & session_present, bool const & keep_requests) override
+    {
+        // The server still has the subscription if it kept the session, meaning subscribing again would only cause unnecessary traffic
+        return session_present || Resubscribe_Topic();
+    }
+
 #if !THINGSBOARD_USE_ESP_TIMER
     void loop() override
     {
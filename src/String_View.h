@@ -0,0 +1,124 @@
+#ifndef String_View_h
+#define String_View_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <string.h>
+#if THINGSBOARD_ENABLE_STL && __cplusplus >= 201703L
+#include <string_view>
+#endif // THINGSBOARD_ENABLE_STL && __cplusplus >= 201703L
+
+
+/// @brief Non owning view of a string with a known length, which does not have to be null terminated.
+/// Allows to pass the topic of a received message directly out of the receive buffer of the MQTT client, instead of copying it only to append the null termination,
+/// and allows to compare topics by their length first, before comparing their contents.
+/// Can be implicitly constructed from and converted into std::string_view on boards that support the C++ STL with C++17 or later.
+/// Because the viewed string is not necessarily null terminated, it has to be printed with "%.*s" and the size and data as arguments
+class String_View {
+  public:
+    /// @brief Constructs an empty view
+    constexpr String_View()
+      : m_data(nullptr)
+      , m_size(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs a view of the given amount of characters, the string does not have to be null terminated
+    /// @param data Pointer to the first character of the string
+    /// @param size Amount of characters in the string
+    constexpr String_View(char const * data, size_t const & size)
+      : m_data(data)
+      , m_size(size)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs a view of the given null terminated string, allows to keep passing null terminated strings everywhere a view is expected.
+    /// Calculates the length of the string once, so every following comparison can compare the length first
+    /// @param data Pointer to the null terminated string, nullptr is handled as an empty string
+    String_View(char const * data)
+      : m_data(data)
+      , m_size(data != nullptr ? strlen(data) : 0U)
+    {
+        // Nothing to do
+    }
+
+#if THINGSBOARD_ENABLE_STL && __cplusplus >= 201703L
+    /// @brief Constructs a view of the same characters as the given std::string_view
+    /// @param view View the characters are taken from
+    constexpr String_View(std::string_view const & view)
+      : m_data(view.data())
+      , m_size(view.size())
+    {
+        // Nothing to do
+    }
+
+    /// @brief Converts into a std::string_view of the same characters
+    constexpr operator std::string_view() const {
+        return std::string_view(m_data, m_size);
+    }
+#endif // THINGSBOARD_ENABLE_STL && __cplusplus >= 201703L
+
+    /// @brief Gets the pointer to the first character, the string is not necessarily null terminated
+    /// @return Pointer to the first character
+    constexpr char const * data() const {
+        return m_data;
+    }
+
+    /// @brief Gets the amount of characters in the view
+    /// @return Amount of characters
+    constexpr size_t size() const {
+        return m_size;
+    }
+
+    /// @brief Gets whether the view does not contain any characters
+    /// @return Whether the view is empty
+    constexpr bool empty() const {
+        return m_size == 0U;
+    }
+
+    /// @brief Gets the character at the given index, does not check whether the index is inside of the view
+    /// @param index Index of the character
+    /// @return Character at the given index
+    constexpr char operator[](size_t const & index) const {
+        return m_data[index];
+    }
+
+    /// @brief Creates a view of the remaining characters after the given index
+    /// @param position Index of the first character of the created view, positions bigger than the size result in an empty view
+    /// @return View of the remaining characters
+    String_View substr(size_t const & position) const {
+        return position < m_size ? String_View(m_data + position, m_size - position) : String_View(m_data + m_size, 0U);
+    }
+
+    /// @brief Whether the view starts with the given string, compares the length first
+    /// @param prefix String the view has to start with
+    /// @return Whether the first characters are the same as the given string
+    bool starts_with(String_View const & prefix) const {
+        return prefix.m_size <= m_size && (prefix.m_size == 0U || memcmp(m_data, prefix.m_data, prefix.m_size) == 0);
+    }
+
+    /// @brief Whether the view contains exactly the same characters as the given string, compares the length first
+    /// @param other String that should be compared
+    /// @return Whether both contain the same characters
+    bool operator==(String_View const & other) const {
+        return m_size == other.m_size && (m_size == 0U || memcmp(m_data, other.m_data, m_size) == 0);
+    }
+
+    /// @brief Whether the view does not contain exactly the same characters as the given string
+    /// @param other String that should be compared
+    /// @return Whether the characters differ
+    bool operator!=(String_View const & other) const {
+        return !(*this == other);
+    }
+
+  private:
+    char const *m_data = {}; // Pointer to the first character, not necessarily null terminated
+    size_t      m_size = {}; // Amount of characters in the view
+};
+
+#endif // String_View_h
@@ -1,6 +1,9 @@
 // Header include.
 #include "Telemetry.h"
 
+// Library includes.
+#include <string.h>
+
 Telemetry::Telemetry()
   : m_type(DataType::TYPE_NONE)
   , m_key(nullptr)
@@ -28,3 +31,26 @@ Telemetry::Telemetry(char const * key, char const * value)
 bool Telemetry::IsEmpty() const {
     return (m_key == nullptr) && m_type == DataType::TYPE_NONE;
 }
+
+bool Telemetry::HasSameValue(Telemetry const & other) const {
+    if (m_type != other.m_type) {
+        return false;
+    }
+    switch (m_type) {
+        case DataType::TYPE_BOOL:
+            return m_value.boolean == other.m_value.boolean;
+        case DataType::TYPE_INT:
+            return m_value.integer == other.m_value.integer;
+        case DataType::TYPE_REAL:
+            return m_value.real == other.m_value.real;
+        case DataType::TYPE_STR:
+            if (m_value.str == nullptr || other.m_value.str == nullptr) {
+                return m_value.str == other.m_value.str;
+            }
+            return strcmp(m_value.str, other.m_value.str) == 0;
+        default:
+            // Nothing to do
+            break;
+    }
+    return true;
+}
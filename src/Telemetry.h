@@ -74,6 +74,13 @@ class Telemetry {
     /// @return Whether there is any data in this record or not
     bool IsEmpty() const;
 
+    /// @brief Whether the given record contains the same type and value as this record, the keys are not compared.
+    /// String values are compared by content and not by the address of the underlying pointer,
+    /// allows to skip sending a value that did not change since it was last sent
+    /// @param other Record we want to compare our value with
+    /// @return Whether both records contain the same value or not
+    bool HasSameValue(Telemetry const & other) const;
+
     /// @brief Serializes a key-value pair or a value, depending on the constructor used
     /// @tparam TSource Source class that the given key value pair or a value, should be copied into
     /// @param source Data source that should contain the key value pair or a value
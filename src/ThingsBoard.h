@@ -6,6 +6,9 @@
 #include "IAPI_Implementation.h"
 #include "IMQTT_Client.h"
 #include "DefaultLogger.h"
+#include "MQTT_Buffer_Size_Controller.h"
+#include "Reconnect_Backoff.h"
+#include "Request_Reconnect_Policy.h"
 #include "Telemetry.h"
 
 // Library includes.
@@ -26,10 +29,12 @@ char constexpr MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (
 char constexpr HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_DEBUG
-char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over topic (%s)";
+char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over topic (%.*s)";
 char constexpr ALLOCATING_JSON[] = "Allocated internal JsonDocument for MQTT server response with size (%u)";
 char constexpr SEND_MESSAGE[] = "Sending data to server over topic (%s) with data (%s)";
 char constexpr SEND_SERIALIZED[] = "Hidden, because json data is bigger than buffer, therefore showing in console is skipped";
+char constexpr SEND_SEGMENTS[] = "Sending data to server over topic (%s) consisting of (%u) segments";
+char constexpr RECONNECT_SCHEDULED[] = "Scheduled reconnect attempt (%u) in (%u) ms";
 #endif // THINGSBOARD_ENABLE_DEBUG
 // Claim topics.
 char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
@@ -118,7 +123,22 @@ class ThingsBoardSized {
        , m_max_response_size(max_response_size)
 #endif // THINGSBOARD_ENABLE_DYNAMIC
       , m_api_implementations(args...)
+      , m_persistent_session(false)
+      , m_request_reconnect_policy(Request_Reconnect_Policy::DISCARD)
+      , m_auto_reconnect(false)
+      , m_reconnect_allowed(false)
+      , m_reconnect_access_token(nullptr)
+      , m_reconnect_client_id(nullptr)
+      , m_reconnect_password(nullptr)
+      , m_reconnect_backoff()
+      , m_buffer_size_controller()
+      , m_handling_message(false)
     {
+#if THINGSBOARD_ENABLE_STL
+        m_fragmented_receive = m_client.set_fragment_callback(std::bind(&ThingsBoardSized::onMQTTFragment, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+#else
+        m_fragmented_receive = m_client.set_fragment_callback(ThingsBoardSized::onStaticMQTTFragment);
+#endif // THINGSBOARD_ENABLE_STL
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
@@ -128,15 +148,21 @@ class ThingsBoardSized {
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+            api->Set_Fragmented_Receive(m_fragmented_receive);
             api->Initialize();
         }
         (void)setBufferSize(receive_buffer_size, send_buffer_size);
         // Initialize callback.
 #if THINGSBOARD_ENABLE_STL
-        m_client.set_data_callback(std::bind(&ThingsBoardSized::onMQTTMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        // Clients that can not pass the topic as a view, pass it as a null terminated string instead, whose length is then calculated once
+        if (!m_client.set_data_view_callback(std::bind(&ThingsBoardSized::onMQTTMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3))) {
+            m_client.set_data_callback(std::bind(&ThingsBoardSized::onMQTTStringMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        }
         m_client.set_connect_callback(std::bind(&ThingsBoardSized::Resubscribe_Topics, this));
 #else
-        m_client.set_data_callback(ThingsBoardSized::onStaticMQTTMessage);
+        if (!m_client.set_data_view_callback(ThingsBoardSized::onStaticMQTTMessage)) {
+            m_client.set_data_callback(ThingsBoardSized::onStaticMQTTStringMessage);
+        }
         m_client.set_connect_callback(ThingsBoardSized::staticMQTTConnect);
         m_subscribedInstance = this;
 #endif // THINGSBOARD_ENABLE_STL
@@ -192,12 +218,52 @@ class ThingsBoardSized {
     /// So if the available heap memory is a problem on the board it might be useful to enable the THINGSBOARD_ENABLE_STREAM_UTILS option.
     /// This can be done by simply using Arduino as the framework and installing the StreamUtils (https://github.com/bblanchon/ArduinoStreamUtils) library
     /// @return Whether allocating the needed memory for the given buffer sizes was successful or not
+    /// If adaptive buffer sizing has been enabled with setAdaptiveBufferSize(), the given sizes are the lower bound of the adaptive sizes instead
     bool setBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
-        bool const result = m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
-        if (!result) {
-            Logger::printfln(UNABLE_TO_ALLOCATE_BUFFER);
+        m_buffer_size_controller.Set_Requested_Sizes(receive_buffer_size, send_buffer_size);
+        return applyBufferSize(m_buffer_size_controller.Get_Desired_Receive_Size(), m_buffer_size_controller.Get_Desired_Send_Size());
+    }
+
+    /// @brief Enables or disables adjusting the buffer sizes of the underlying network client to the size of the sent and received messages, see MQTT_Buffer_Size_Controller for more information.
+    /// Allows to pass small buffer sizes to the constructor and to only allocate bigger buffers while bigger messages are actually sent or received, instead of for the whole lifetime of the application.
+    /// A send buffer that is too small is grown before the message is sent, unless the message is sent from within a callback handling a received message, in which case it is grown in the next call to loop() instead.
+    /// Received messages can only be observed once they have been received, therefore the receive buffer is always grown in the next call to loop(), after a message has been received
+    /// that nearly exceeded it, or that was bigger and had to be reassembled by the client. Shrinking is always done in loop(), because the buffers are not in use there
+    /// @param enable Whether to adjust the buffer sizes to the observed messages, disabling it restores the sizes passed to setBufferSize(), default = false
+    /// @param minimum_size Minimum size in bytes the buffers are shrunk to, the sizes passed to setBufferSize() are always kept as the lower bound though
+    /// @param maximum_size Maximum size in bytes the buffers are grown to
+    void setAdaptiveBufferSize(bool enable, uint16_t minimum_size, uint16_t maximum_size) {
+        if (enable) {
+            m_buffer_size_controller.Start(minimum_size, maximum_size);
         }
-        return result;
+        else {
+            m_buffer_size_controller.Stop();
+        }
+        (void)applyBufferSize(m_buffer_size_controller.Get_Desired_Receive_Size(), m_buffer_size_controller.Get_Desired_Send_Size());
+    }
+
+    /// @brief Gets the receive buffer size that has been applied to the underlying network client last
+    /// @return Current receive buffer size in bytes
+    uint16_t getCurrentReceiveBufferSize() const {
+        return m_buffer_size_controller.Get_Receive_Size();
+    }
+
+    /// @brief Gets the send buffer size that has been applied to the underlying network client last
+    /// @return Current send buffer size in bytes
+    uint16_t getCurrentSendBufferSize() const {
+        return m_buffer_size_controller.Get_Send_Size();
+    }
+
+    /// @brief Gets the biggest receive buffer size that has been applied to the underlying network client since this instance has been created
+    /// @return Peak receive buffer size in bytes
+    uint16_t getPeakReceiveBufferSize() const {
+        return m_buffer_size_controller.Get_Peak_Receive_Size();
+    }
+
+    /// @brief Gets the biggest send buffer size that has been applied to the underlying network client since this instance has been created
+    /// @return Peak send buffer size in bytes
+    uint16_t getPeakSendBufferSize() const {
+        return m_buffer_size_controller.Get_Peak_Send_Size();
     }
 
     /// @brief Clears all currently subscribed callbacks and unsubscribed from all
@@ -216,9 +282,55 @@ class ThingsBoardSized {
         }
     }
 
+    /// @brief Sets whether the connection asks the server to keep the session once the device disconnects, instead of starting with a clean session on every connect.
+    /// If the server reports that it still has the session once the connection is established again, the permanent subscriptions (Server-side RPC, Shared Attribute Update, OTA) are not subscribed again,
+    /// which prevents a flood of SUBSCRIBE packets if a lot of devices reconnect at the same time. Requires a client id that stays the same between connections, which is the case for the default client id (access token).
+    /// Has to be called before connect() and whether the session was kept is only known if the underlying MQTT client supports reading the session present flag, see IMQTT_Client::get_session_present()
+    /// @param persistent Whether the server should keep the session of this device while it is disconnected, default = false
+    /// @return Whether the underlying MQTT client supports the given value
+    bool setPersistentSession(bool persistent) {
+        bool const result = m_client.set_clean_session(!persistent);
+        m_persistent_session = persistent && result;
+        return result;
+    }
+
+    /// @brief Sets how pending single-event requests (Attribute Request, Client-side RPC), whose response has not been received yet, are handled once the connection is established again.
+    /// See Request_Reconnect_Policy for the possible values, kept requests are still removed by their timeout if their response does not arrive
+    /// @param policy Policy pending requests are handled with, default = Request_Reconnect_Policy::DISCARD
+    void setRequestReconnectPolicy(Request_Reconnect_Policy policy) {
+        m_request_reconnect_policy = policy;
+    }
+
+    /// @brief Enables or disables automatically reconnecting with the arguments passed to the last successful call to connect() in loop(), once the connection has been lost.
+    /// Attempts are scheduled with a jittered exponential backoff, see Reconnect_Backoff for more information, which prevents devices that lost the connection at the same time from retrying in lockstep.
+    /// Because the arguments are not copied, the strings passed to connect() have to stay valid for as long as automatic reconnecting is enabled.
+    /// Clients that already reconnect internally, like the Espressif_MQTT_Client, should have that mechanism disabled with set_disable_auto_reconnect(true), to not reconnect twice
+    /// @param enable Whether to reconnect automatically, default = false
+    /// @param minimum_delay_ms Delay in milliseconds the first attempt is spread over and the following delays are doubled from, default = RECONNECT_DEFAULT_MINIMUM_DELAY (1000)
+    /// @param maximum_delay_ms Delay in milliseconds the doubled delays between attempts are capped at, default = RECONNECT_DEFAULT_MAXIMUM_DELAY (300000)
+    void setAutoReconnect(bool enable, uint32_t minimum_delay_ms = RECONNECT_DEFAULT_MINIMUM_DELAY, uint32_t maximum_delay_ms = RECONNECT_DEFAULT_MAXIMUM_DELAY) {
+        m_auto_reconnect = enable;
+        m_reconnect_backoff.Set_Delays(minimum_delay_ms, maximum_delay_ms);
+        m_reconnect_backoff.Reset();
+    }
+
+    /// @brief Gets the amount of automatic reconnect attempts that have been made since the connection was lost, 0 while the connection is established
+    /// @return Amount of made reconnect attempts
+    uint32_t getReconnectAttempts() const {
+        return m_reconnect_backoff.Get_Attempts();
+    }
+
+    /// @brief Whether the server reported that it still had the session of the previous connection, when the current connection was established.
+    /// Is always false if persistent sessions have not been enabled with setPersistentSession()
+    /// @return Whether the session of the previous connection was still present
+    bool getSessionPresent() {
+        return m_persistent_session && m_client.get_session_present();
+    }
+
     /// @brief Connects to the specified ThingsBoard server over the given port as the given device.
     /// If there are still active server-side RPC or Shared Attribute subscriptions, the aforementioned topics will be resubscribed automatically.
     /// Additionally internal vectors are kept the same so any permanent subscriptions, does not need to be resubscribed by calling the appropriate subscribe methods again.
+    /// If automatic reconnecting has been enabled with setAutoReconnect(), the passed strings are kept and used for the reconnect attempts, meaning they have to stay valid
     /// @param host ThingsBoard server instance we want to connect to
     /// @param access_token Access token that connects this device with a created device on the ThingsBoard server,
     /// can be "provision", if the device creates itself instead. See https://thingsboard.io/docs/user-guide/device-provisioning/?mqttprovisioning=without#provision-device-apis for more information, default = PROV_ACCESS_TOKEN ("provision")
@@ -232,11 +344,19 @@ class ThingsBoardSized {
             return false;
         }
         m_client.set_server(host, port);
-        return connectToHost(access_token, Helper::stringIsNullorEmpty(client_id) ? access_token : client_id, Helper::stringIsNullorEmpty(password) ? nullptr : password);
+        m_reconnect_access_token = access_token;
+        m_reconnect_client_id = Helper::stringIsNullorEmpty(client_id) ? access_token : client_id;
+        m_reconnect_password = Helper::stringIsNullorEmpty(password) ? nullptr : password;
+        m_reconnect_allowed = true;
+        // Seeded with the client id additionally to the time, because devices started by the same event might have nearly identical uptimes
+        m_reconnect_backoff.Set_Seed(hashClientId(m_reconnect_client_id) ^ static_cast<uint32_t>(Helper::getTimeMicroseconds()));
+        m_reconnect_backoff.Reset();
+        return connectToHost(m_reconnect_access_token, m_reconnect_client_id, m_reconnect_password);
     }
 
-    /// @brief Disconnects any connection that has been established already
+    /// @brief Disconnects any connection that has been established already, additionally stops automatically reconnecting until connect() is called again
     void disconnect() {
+        m_reconnect_allowed = false;
         m_client.disconnect();
     }
 
@@ -248,21 +368,26 @@ class ThingsBoardSized {
     }
 
     /// @brief Receives / sends any outstanding messages from and to the MQTT broker.
-    /// Additionally when not being able to use the ESP Timer, it updates the internal timeout timers
+    /// Additionally it advances work of the API implementations that is done outside of the callbacks of the MQTT client, like downloading the firmware binary over HTTP,
+    /// when not being able to use the ESP Timer, it updates the internal timeout timers and if automatic reconnecting is enabled, it attempts to reconnect once the scheduled delay has passed
     /// @return Whether sending or receiving the oustanding the messages was successful or not
     bool loop() {
-#if !THINGSBOARD_USE_ESP_TIMER
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
             api->loop();
         }
-#endif // !THINGSBOARD_USE_ESP_TIMER
+        reconnectIfDue();
+        // Buffers are not in use outside of the client loop, therefore this is the point pending changes can be applied at safely
+        if (m_buffer_size_controller.Resize_Pending()) {
+            (void)applyBufferSize(m_buffer_size_controller.Get_Desired_Receive_Size(), m_buffer_size_controller.Get_Desired_Send_Size());
+        }
         return m_client.loop();
     }
 
-    /// @brief Attempts to send key value pairs from custom source over the given topic to the server
+    /// @brief Attempts to send key value pairs from custom source over the given topic to the server.
+    /// The serialized json is sent with Send_Segments(), which allows clients that support it to write it directly into the network instead of copying it into their send buffer first
     /// @param topic Topic we want to send the data over
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
@@ -298,11 +423,12 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
         if (json_size > getMaximumStackSize()) {
             char* json = new char[json_size]();
-            if (serializeJson(source, json, json_size) < json_size - 1) {
+            size_t const length = serializeJson(source, json, json_size);
+            if (length < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
             }
             else {
-                result = Send_Json_String(topic, json);
+                result = Send_Serialized_Json(topic, json, length);
             }
             // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
             // and set the pointer to null so we do not have a dangling reference.
@@ -311,11 +437,12 @@ class ThingsBoardSized {
         }
         else {
             char json[json_size] = {};
-            if (serializeJson(source, json, json_size) < json_size - 1) {
+            size_t const length = serializeJson(source, json, json_size);
+            if (length < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
                 return result;
             }
-            result = Send_Json_String(topic, json);
+            result = Send_Serialized_Json(topic, json, length);
         }
 
         return result;
@@ -330,8 +457,9 @@ class ThingsBoardSized {
             return false;
         }
 
-        uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
         size_t const json_size = strlen(json);
+        Message_Sent(topic, json_size);
+        uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
 
         if (current_send_buffer_size < json_size) {
             Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, json_size);
@@ -344,6 +472,27 @@ class ThingsBoardSized {
         return m_client.publish(topic, reinterpret_cast<uint8_t const *>(json), json_size);
     }
 
+    /// @brief Attempts to send the payload consisting of the given segments over the given topic to the server, as one single message.
+    /// Allows to send payloads that consist of multiple seperate buffers, without having to first concatenate them into one contiguous buffer
+    /// @param topic Topic we want to send the data over
+    /// @param segments Pointer to the first element of the array of segments that make up the payload, the data is not copied and has to stay valid until this method returns
+    /// @param segment_count Amount of segments in the given array
+    /// @return Whether sending the data was successful or not
+    bool Send_Segments(char const * topic, MQTT_Segment const * segments, size_t const & segment_count) {
+        if (segments == nullptr || segment_count == 0U) {
+            return false;
+        }
+        size_t payload_size = 0U;
+        for (size_t i = 0U; i < segment_count; i++) {
+            payload_size += segments[i].length;
+        }
+        Message_Sent(topic, payload_size);
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_SEGMENTS, topic, segment_count);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return m_client.publish_segments(topic, segments, segment_count);
+    }
+
     /// @brief Copies a non-owning pointer to the given API implementation, into the local data container.
     /// Ensure the actual variable is kept alive for as long as the instance of this class
     /// @param api Additional API that we want to be handled
@@ -359,6 +508,7 @@ class ThingsBoardSized {
 #else
         api.Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+        api.Set_Fragmented_Receive(m_fragmented_receive);
         api.Initialize();
         m_api_implementations.push_back(&api);
     }
@@ -390,6 +540,7 @@ class ThingsBoardSized {
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+            api->Set_Fragmented_Receive(m_fragmented_receive);
             api->Initialize();
         }
         m_api_implementations.insert(m_api_implementations.end(), first, last);
@@ -461,6 +612,16 @@ class ThingsBoardSized {
         return Send_Json_String(TELEMETRY_TOPIC, json);
     }
 
+    /// @brief Attempts to send custom json telemetry, that consists of the given segments, which are sent in order without being concatenated first.
+    /// Useful for payloads with a static prefix and suffix and only a small dynamic part in between.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @param segments Pointer to the first element of the array of segments that make up the json payload
+    /// @param segment_count Amount of segments in the given array
+    /// @return Whether sending the data was successful or not
+    bool sendTelemetrySegments(MQTT_Segment const * segments, size_t const & segment_count) {
+        return Send_Segments(TELEMETRY_TOPIC, segments, segment_count);
+    }
+
     /// @brief Attempts to send telemetry key value pairs from custom source to the server.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param source JsonDocument containing our json key value pairs we want to send,
@@ -516,6 +677,15 @@ class ThingsBoardSized {
         return Send_Json_String(ATTRIBUTE_TOPIC, json);
     }
 
+    /// @brief Attempts to send custom json attributes, that consists of the given segments, which are sent in order without being concatenated first.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @param segments Pointer to the first element of the array of segments that make up the json payload
+    /// @param segment_count Amount of segments in the given array
+    /// @return Whether sending the data was successful or not
+    bool sendAttributeSegments(MQTT_Segment const * segments, size_t const & segment_count) {
+        return Send_Segments(ATTRIBUTE_TOPIC, segments, segment_count);
+    }
+
     /// @brief Attempts to send attribute key value pairs from custom source to the server.
     /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
     /// @param source JsonDocument containing our json key value pairs we want to send,
@@ -557,16 +727,32 @@ class ThingsBoardSized {
         return m_max_stack;
     }
 
-    /// @brief Returns the current receive buffer size of the underlying client interface
+    /// @brief Applies the given buffer sizes to the underlying client interface and informs the buffer size controller about the applied sizes
+    /// @param receive_buffer_size Maximum amount of data that can be received by this device at once
+    /// @param send_buffer_size Maximum amount of data that can be sent from this device at once
+    /// @return Whether allocating the needed memory for the given buffer sizes was successful or not
+    bool applyBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+        bool const result = m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
+        if (!result) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_BUFFER);
+        }
+        // The client might have kept its previous buffers if allocating failed, therefore the sizes it actually uses are saved as well as the attempted sizes,
+        // so the failed allocation is only retried once the desired sizes change instead of on every loop
+        m_buffer_size_controller.Sizes_Applied(receive_buffer_size, send_buffer_size, m_client.get_receive_buffer_size(), m_client.get_send_buffer_size());
+        return result;
+    }
+
+    /// @brief Returns the current receive buffer size of the underlying client interface, or the explicitly requested size if adaptive buffer sizing is enabled,
+    /// because API implementations use it to restore the size after they increased it temporarily, which would otherwise prevent the adaptive size from ever shrinking below it
     /// @return Current internal send buffer size
     uint16_t getClientReceiveBufferSize() {
-        return m_client.get_receive_buffer_size();
+        return m_buffer_size_controller.Is_Adaptive() ? m_buffer_size_controller.Get_Requested_Receive_Size() : m_client.get_receive_buffer_size();
     }
 
-    /// @brief Returns the current send buffer size of the underlying client interface
+    /// @brief Returns the current send buffer size of the underlying client interface, or the explicitly requested size if adaptive buffer sizing is enabled
     /// @return Current internal receive buffer size
     uint16_t getClientSendBufferSize() {
-        return m_client.get_send_buffer_size();
+        return m_buffer_size_controller.Is_Adaptive() ? m_buffer_size_controller.Get_Requested_Send_Size() : m_client.get_send_buffer_size();
     }
 
     /// @brief Subscribes the given topic with the underlying client interface
@@ -617,15 +803,78 @@ class ThingsBoardSized {
     /// @brief Resubscribes to topics that establish a permanent connection with MQTT, meaning they may receive more than one event over their lifetime,
     /// whereas other events that are only ever called once and then deleted after they have been handled are not resubscribed.
     /// Only the topics that establish a permanent connection are resubscribed, because all not yet received data is discard on the MQTT broker,
-    // once we establish a connection again. This is the case because we connect with the cleanSession attribute set to true.
-    // Therefore we can also clear the buffer of all non-permanent topics.
+    /// once we establish a connection again, if we connect with the cleanSession attribute set to true. Therefore we can also clear the buffer of all non-permanent topics,
+    /// unless the request reconnect policy keeps them. If the server still has the session of the previous connection nothing has to be subscribed again
     void Resubscribe_Topics() {
+        bool const session_present = getSessionPresent();
+        bool const keep_requests = m_request_reconnect_policy == Request_Reconnect_Policy::KEEP || (m_request_reconnect_policy == Request_Reconnect_Policy::KEEP_IF_SESSION_PRESENT && session_present);
         // Results are ignored, because the important part of clearing internal data structures always succeeds
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
-            (void)api->Resubscribe_Topic();
+            (void)api->Restore_Topic(session_present, keep_requests);
+        }
+    }
+
+    /// @brief Attempts to reconnect with the arguments of the last call to connect(), if automatic reconnecting is enabled, the connection has been lost and the scheduled delay has passed.
+    /// The first time the lost connection is noticed only the attempt is scheduled, the success of an attempt is only decided once the client reports the connection as established,
+    /// because some clients connect asynchronously in their own task
+    void reconnectIfDue() {
+        if (!m_auto_reconnect || !m_reconnect_allowed) {
+            return;
+        }
+        else if (m_client.connected()) {
+            m_reconnect_backoff.Reset();
+            return;
+        }
+        else if (!m_reconnect_backoff.Is_Scheduled()) {
+            m_reconnect_backoff.Schedule();
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RECONNECT_SCHEDULED, m_reconnect_backoff.Get_Attempts() + 1U, m_reconnect_backoff.Get_Delay());
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+        else if (!m_reconnect_backoff.Is_Due()) {
+            return;
+        }
+        m_reconnect_backoff.Attempted();
+        (void)connectToHost(m_reconnect_access_token, m_reconnect_client_id, m_reconnect_password);
+    }
+
+    /// @brief Calculates the FNV-1a hash of the given client id, used to seed the jitter of the reconnect attempts differently on every device
+    /// @param client_id Null terminated client id
+    /// @return Hash of the client id
+    static uint32_t hashClientId(char const * client_id) {
+        uint32_t hash = 2166136261U;
+        for (; client_id != nullptr && *client_id != '\0'; client_id++) {
+            hash ^= static_cast<uint8_t>(*client_id);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    /// @brief Sends the json that has already been serialized by Send_Json() as a single segment with Send_Segments(), instead of with Send_Json_String().
+    /// Allows clients that write the segments directly into the network (Arduino_MQTT_Client) to skip copying the payload into their internal send buffer,
+    /// which additionally means the payload is not restricted to the send buffer size. Other clients simply forward the single segment to publish()
+    /// @param topic Topic we want to send the data over
+    /// @param json Serialized json, has to stay valid until this method returns
+    /// @param length Amount of bytes in the serialized json, without the null terminator
+    /// @return Whether sending the data was successful or not
+    bool Send_Serialized_Json(char const * topic, char const * json, size_t const & length) {
+        MQTT_Segment const segment = { reinterpret_cast<uint8_t const *>(json), length };
+        return Send_Segments(topic, &segment, 1U);
+    }
+
+    /// @brief Informs the buffer size controller about a message that is sent and grows the send buffer if the message would not fit into it.
+    /// The receive buffer might still be in use while a received message is handled, therefore only the send buffer is grown and only if no message is handled,
+    /// because some clients reallocate both buffers even if only one of them changes
+    /// @param topic Topic the message is sent over
+    /// @param payload_size Amount of bytes in the payload of the message
+    void Message_Sent(char const * topic, size_t const & payload_size) {
+        m_buffer_size_controller.Message_Sent(strlen(topic) + payload_size);
+        if (!m_handling_message && m_buffer_size_controller.Send_Growth_Pending()) {
+            (void)applyBufferSize(m_buffer_size_controller.Get_Receive_Size(), m_buffer_size_controller.Get_Desired_Send_Size());
         }
     }
 
@@ -704,13 +953,25 @@ class ThingsBoardSized {
     /// Because if this happens and we then send data it is possible for the system to overwrite the memory region that contained the previous response.
     /// Therefore we simply assume that either the used MQTT client, has seperate input and output buffers
     /// or that the receiving of data is not executed on a seperate FreeRTOS tasks to other sends
-    /// @param topic Previously subscribed topic, we got the response over
+    /// @param topic Previously subscribed topic, we got the response over, not necessarily null terminated
+    /// @param payload Payload that was sent over the cloud and received over the given topic
+    /// @param length Total length of the received payload
+    void onMQTTMessage(String_View const & topic, uint8_t * payload, unsigned int length) {
+        m_buffer_size_controller.Message_Received(topic.size() + length);
+        // Payload points into the receive buffer, which therefore may not be resized until the message has been handled
+        m_handling_message = true;
+        handleMQTTMessage(topic, payload, length);
+        m_handling_message = false;
+    }
+
+    /// @brief Processes a received publish message, by either passing the raw bytes or the deserialized json to all API implementations that handle responses on the given topic
+    /// @param topic Previously subscribed topic, we got the response over, not necessarily null terminated
     /// @param payload Payload that was sent over the cloud and received over the given topic
     /// @param length Total length of the received payload
-    void onMQTTMessage(char * topic, uint8_t * payload, unsigned int length) {
+    void handleMQTTMessage(String_View const & topic, uint8_t * payload, unsigned int length) {
 
 #if THINGSBOARD_ENABLE_DEBUG
-        Logger::printfln(RECEIVE_MESSAGE, length, topic);
+        Logger::printfln(RECEIVE_MESSAGE, length, static_cast<int>(topic.size()), topic.data());
         // Serial.print("[TB] MQTT Response: " + String(topic) + " - ");
         // Serial.println(String((const char*)payload).substring(0, length));
 #endif // THINGSBOARD_ENABLE_DEBUG
@@ -790,8 +1051,10 @@ class ThingsBoardSized {
         // See https://arduinojson.org/v6/doc/deserialization/ for more info on ArduinoJson deserialization
         DeserializationError const error = deserializeJson(json_buffer, payload, length);
         if (error) {
+#ifdef ARDUINO
             Serial.print("Invalid JSON payload: ");
             Serial.println(String((const char*)payload).substring(0, length));
+#endif // ARDUINO
             Logger::printfln(UNABLE_TO_DE_SERIALIZE_JSON, error.c_str());
             return;
         }
@@ -823,14 +1086,65 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STL
     }
 
+    /// @brief MQTT callback that will be called if a publish message is received from the server, by clients that pass the topic as a null terminated string
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Payload that was sent over the cloud and received over the given topic
+    /// @param length Total length of the received payload
+    void onMQTTStringMessage(char * topic, uint8_t * payload, unsigned int length) {
+        onMQTTMessage(String_View(topic), payload, length);
+    }
+
+    /// @brief MQTT callback that will be called for every fragment of a publish message received from the server, that is bigger than the receive buffer of the client.
+    /// Fragments are only forwarded to API implementations that process the response as raw bytes, because json can only be deserialized once the complete payload has been received.
+    /// Responses on any other topic are left to the client, which either reassembles them and passes them to onMQTTMessage() or discards them
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Fragment of the payload that was sent over the cloud and received over the given topic
+    /// @param offset Byte offset of the fragment in the complete payload
+    /// @param length Length of the received fragment
+    /// @param total_length Total length of the complete payload
+    /// @return Whether the fragment has been forwarded to atleast one API implementation
+    bool onMQTTFragment(String_View const & topic, uint8_t * payload, size_t offset, size_t length, size_t total_length) {
+#if THINGSBOARD_ENABLE_DEBUG
+        if (offset == 0U) {
+            Logger::printfln(RECEIVE_MESSAGE, total_length, static_cast<int>(topic.size()), topic.data());
+        }
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        bool processed_response_as_raw = false;
+        m_handling_message = true;
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+            api->Process_Response_Fragment(topic, payload, offset, length, total_length);
+            processed_response_as_raw = true;
+        }
+        m_handling_message = false;
+        return processed_response_as_raw;
+    }
+
 #if !THINGSBOARD_ENABLE_STL
-    static void onStaticMQTTMessage(char * topic, uint8_t * payload, unsigned int length) {
+    static bool onStaticMQTTFragment(String_View const & topic, uint8_t * payload, size_t offset, size_t length, size_t total_length) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->onMQTTFragment(topic, payload, offset, length, total_length);
+    }
+
+    static void onStaticMQTTMessage(String_View const & topic, uint8_t * payload, unsigned int length) {
         if (m_subscribedInstance == nullptr) {
             return;
         }
         m_subscribedInstance->onMQTTMessage(topic, payload, length);
     }
 
+    static void onStaticMQTTStringMessage(char * topic, uint8_t * payload, unsigned int length) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->onMQTTStringMessage(topic, payload, length);
+    }
+
     static void staticMQTTConnect() {
         if (m_subscribedInstance == nullptr) {
             return;
@@ -909,6 +1223,7 @@ class ThingsBoardSized {
 
     IMQTT_Client&                                   m_client = {};              // MQTT client instance.
     size_t                                          m_max_stack = {};           // Maximum stack size we allocate at once.
+    bool                                            m_fragmented_receive = {};  // Whether the client passes messages bigger than its receive buffer in fragments, instead of discarding them
     size_t                                          m_request_id = {};          // Internal id used to differentiate which request should receive which response for certain API calls. Can send 4'294'967'296 requests before wrapping back to 0
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     size_t                                          m_buffering_size = {};      // Buffering size used to serialize directly into client.
@@ -919,6 +1234,16 @@ class ThingsBoardSized {
     size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
     Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
 #endif // !THINGSBOARD_ENABLE_DYNAMIC                
+    bool                                            m_persistent_session = {};  // Whether the server has been asked to keep the session while the device is disconnected
+    Request_Reconnect_Policy                        m_request_reconnect_policy = {}; // How pending single-event requests are handled once the connection is established again
+    bool                                            m_auto_reconnect = {};      // Whether loop() automatically reconnects once the connection has been lost
+    bool                                            m_reconnect_allowed = {};   // Whether connect() has been called and disconnect() has not been called since, only then automatic reconnecting is done
+    char const *                                    m_reconnect_access_token = {}; // Access token passed to the last call to connect(), used for the reconnect attempts
+    char const *                                    m_reconnect_client_id = {}; // Client id passed to the last call to connect() or the access token if none was passed, used for the reconnect attempts
+    char const *                                    m_reconnect_password = {};  // Password passed to the last call to connect(), used for the reconnect attempts
+    Reconnect_Backoff                               m_reconnect_backoff;        // Schedules the automatic reconnect attempts with a jittered exponential backoff
+    MQTT_Buffer_Size_Controller                     m_buffer_size_controller;   // Decides on the buffer sizes of the client based on the requested sizes and the observed messages
+    bool                                            m_handling_message = {};    // Whether a received message is currently handled, meaning its payload still points into the receive buffer
 };
 
 #if !THINGSBOARD_ENABLE_STL
@@ -147,7 +147,11 @@ class Vector {
             m_capacity = (m_capacity == 0) ? 1 : 2 * m_capacity;
             T* new_elements = new T[m_capacity]();
             if (m_elements != nullptr) {
-                memcpy(new_elements, m_elements, m_size * sizeof(T));
+                // Copy assign instead of memcpy, because elements that own memory themselves (String) would otherwise be freed twice,
+                // once when the old elements are deleted and once when the copied elements are deleted
+                for (size_t i = 0; i < m_size; ++i) {
+                    new_elements[i] = m_elements[i];
+                }
                 delete[] m_elements;
             }
             m_elements = new_elements;
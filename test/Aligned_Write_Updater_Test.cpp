@@ -0,0 +1,172 @@
+// Writes firmware binaries with random sizes in chunks with random sizes into an Aligned_Write_Updater with a random block size and records every write into the wrapped updater.
+// Covers every write into the wrapped updater starting at a multiple of the block size and being a multiple of the block size except for the last one,
+// the unaligned tail of the firmware binary only being written once the update is ended, the write count matching the writes into the wrapped updater
+// and a failing write into the wrapped updater being reported to the caller instead of silently dropping the buffered bytes
+
+// Local includes.
+#include "Aligned_Write_Updater.h"
+
+// Library includes.
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+
+// Amount of random firmware binaries written
+constexpr size_t TEST_ITERATIONS = 100U;
+// Range the exponent of the power of two block size is chosen from
+constexpr size_t MIN_BLOCK_SIZE_EXPONENT = 4U;
+constexpr size_t MAX_BLOCK_SIZE_EXPONENT = 12U;
+// Range the size of the firmware binaries is chosen from
+constexpr size_t MIN_FIRMWARE_SIZE = 1U;
+constexpr size_t MAX_FIRMWARE_SIZE = 65536U;
+// Maximum size of the chunks in blocks, allows chunks that are smaller than, the same as or multiple times bigger than a block
+constexpr size_t MAX_CHUNK_BLOCKS = 3U;
+
+
+/// @brief Updater that keeps the written firmware binary in memory, records the offset and size of every write and optionally fails the write with the given index
+class Recording_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param failing_write Index of the write that fails, SIZE_MAX if no write fails
+    explicit Recording_Updater(size_t const & failing_write)
+      : m_failing_write(failing_write)
+    {
+        // Nothing to do
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_writes.clear();
+        m_size = firmware_size;
+        m_ended = false;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        if (m_writes.size() == m_failing_write) {
+            m_writes.push_back({ m_data.size(), 0U });
+            return 0U;
+        }
+        m_writes.push_back({ m_data.size(), total_bytes });
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        m_ended = true;
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+    /// @brief Offset and size of every write, in the order they have been made
+    std::vector<std::pair<size_t, size_t>> const & Get_Writes() const {
+        return m_writes;
+    }
+
+    bool Is_Ended() const {
+        return m_ended;
+    }
+
+  private:
+    size_t                                 m_failing_write = {}; // Index of the write that fails
+    std::vector<uint8_t>                   m_data = {};          // Written firmware binary
+    std::vector<std::pair<size_t, size_t>> m_writes = {};        // Offset and size of every write
+    size_t                                 m_size = {};          // Size of the firmware binary passed to begin()
+    bool                                   m_ended = {};         // Whether end() has been called since begin()
+};
+
+
+/// @brief Whether every recorded write starts at a multiple of the block size and is a multiple of the block size, the last write may be smaller if it is the tail of the firmware binary
+/// @param writes Offset and size of every write into the wrapped updater
+/// @param block_size Size of the aligned blocks
+/// @param tail_allowed Whether the last write may be smaller than a block
+/// @return Whether all writes are aligned
+static bool Writes_Aligned(std::vector<std::pair<size_t, size_t>> const & writes, size_t const & block_size, bool const & tail_allowed) {
+    for (size_t index = 0U; index < writes.size(); index++) {
+        bool const last = index + 1U == writes.size();
+        if (writes[index].first % block_size != 0U || (writes[index].second % block_size != 0U && !(last && tail_allowed))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param iteration Iteration the check was run in
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t const & iteration, size_t & failures) {
+    if (!passed) {
+        printf("Check failed in iteration (%zu): %s\n", iteration, message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(36U);
+    std::uniform_int_distribution<size_t> exponent_distribution(MIN_BLOCK_SIZE_EXPONENT, MAX_BLOCK_SIZE_EXPONENT);
+    std::uniform_int_distribution<size_t> firmware_size_distribution(MIN_FIRMWARE_SIZE, MAX_FIRMWARE_SIZE);
+    size_t failures = 0U;
+
+    for (size_t iteration = 1U; iteration <= TEST_ITERATIONS; iteration++) {
+        size_t const block_size = static_cast<size_t>(1U) << exponent_distribution(random);
+        std::vector<uint8_t> firmware(firmware_size_distribution(random));
+        for (uint8_t & byte : firmware) {
+            byte = static_cast<uint8_t>(random());
+        }
+        std::uniform_int_distribution<size_t> chunk_size_distribution(1U, block_size * MAX_CHUNK_BLOCKS);
+
+        // Chunks with random sizes are only written in complete blocks, while the update is in progress
+        Recording_Updater target(SIZE_MAX);
+        Aligned_Write_Updater<> aligned(target, block_size);
+        Check(aligned.begin(firmware.size()), "beginning the update", iteration, failures);
+        bool written = true;
+        for (size_t offset = 0U; offset < firmware.size();) {
+            size_t const remaining = firmware.size() - offset;
+            size_t const drawn_size = chunk_size_distribution(random);
+            size_t const chunk_size = drawn_size < remaining ? drawn_size : remaining;
+            size_t const written_bytes = aligned.write(firmware.data() + offset, chunk_size);
+            written = written && written_bytes == chunk_size;
+            offset += chunk_size;
+        }
+        size_t const tail = firmware.size() % block_size;
+        Check(written, "accepting every chunk", iteration, failures);
+        Check(Writes_Aligned(target.Get_Writes(), block_size, false) && target.Get_Data().size() == firmware.size() - tail,
+          "writing only complete aligned blocks while the update is in progress", iteration, failures);
+
+        // Ending the update writes the unaligned tail as the last, smaller write
+        size_t const writes_before_end = target.Get_Writes().size();
+        Check(aligned.end() && target.Is_Ended() && target.Get_Data() == firmware, "writing the complete firmware binary once the update is ended", iteration, failures);
+        Check(Writes_Aligned(target.Get_Writes(), block_size, true), "writing every block aligned except for the tail", iteration, failures);
+        Check(target.Get_Writes().size() == writes_before_end + (tail != 0U ? 1U : 0U) && (tail == 0U || target.Get_Writes().back().second == tail),
+          "flushing only the unaligned tail when the update is ended", iteration, failures);
+        Check(aligned.Get_Write_Count() == target.Get_Writes().size() && aligned.Get_Write_Count() <= (firmware.size() + block_size - 1U) / block_size,
+          "counting every write into the wrapped updater, never more than one per block", iteration, failures);
+    }
+
+    // Failing write into the wrapped updater is reported instead of being dropped with the buffered bytes
+    size_t const block_size = static_cast<size_t>(1U) << MIN_BLOCK_SIZE_EXPONENT;
+    std::vector<uint8_t> firmware(block_size * 4U, 0xA5U);
+    Recording_Updater failing_target(1U);
+    Aligned_Write_Updater<> failing(failing_target, block_size);
+    Check(failing.begin(firmware.size()), "beginning the failing update", 0U, failures);
+    bool reported = false;
+    for (size_t offset = 0U; offset < firmware.size(); offset += block_size / 2U) {
+        reported = failing.write(firmware.data() + offset, block_size / 2U) != block_size / 2U || reported;
+    }
+    Check(reported && failing.Get_Write_Count() >= 2U, "reporting the failed write into the wrapped updater", 0U, failures);
+
+    printf("%zu failures in %zu iterations\n", failures, TEST_ITERATIONS);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// Measures the throughput of every checksum algorithm the HashGenerator supports, comparing the CRC32 and Murmur3 implementations of the library against the Mbed TLS digests.
+// Every algorithm is first checked against a known checksum, then the checksum of a synthetic firmware binary is calculated in chunks and compared against the checksum calculated in one call.
+// Throughput is measured in hashed bytes per second, the firmware binary is hashed in chunks of the default OTA chunk size, the same as during an update
+
+// Local includes.
+#include "HashGenerator.h"
+#include "OTA_Update_Callback.h"
+
+// Library includes.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+
+// Size of the synthetic firmware binary
+constexpr size_t FIRMWARE_SIZE = 1024U * 1024U;
+// Amount of times the checksum of the firmware binary is calculated for every algorithm
+constexpr size_t BENCHMARK_REPETITIONS = 20U;
+
+
+/// @brief Checksum algorithm with a known checksum of a short message, the Murmur3 and CRC32 checksums are in the byte order the server sends them in
+struct Benchmark_Algorithm {
+    char const         *name;     // Name of the algorithm printed in the result
+    Checksum_Algorithm algorithm; // Algorithm that is measured
+    char const         *message;  // Message the known checksum has been calculated from
+    char const         *checksum; // Known checksum of the message
+};
+
+constexpr Benchmark_Algorithm ALGORITHMS[] = {
+    { "MD5", Checksum_Algorithm::MD5, "abc", "900150983cd24fb0d6963f7d28e17f72" },
+    { "SHA256", Checksum_Algorithm::SHA256, "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "SHA384", Checksum_Algorithm::SHA384, "abc", "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7" },
+    { "SHA512", Checksum_Algorithm::SHA512, "abc", "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f" },
+    { "CRC32", Checksum_Algorithm::CRC32, "123456789", "2639f4cb" },
+    { "MURMUR3_32", Checksum_Algorithm::MURMUR3_32, "hello", "47fa8b24" },
+    { "MURMUR3_128", Checksum_Algorithm::MURMUR3_128, "hello", "029bbd41b3a7d8cb191dae486a901e5b" }
+};
+
+
+/// @brief Calculates the checksum of the given data, passing it to the hash generator in chunks of the given size
+/// @param algorithm Algorithm the checksum is calculated with
+/// @param data Data the checksum is calculated from
+/// @param length Amount of bytes of the data
+/// @param chunk_size Size of the chunks the data is passed in
+/// @param checksum Output string the checksum is copied into, has to be FIRMWARE_HASH_SIZE bytes big
+/// @return Whether calculating the checksum was successful or not
+static bool Calculate_Checksum(Checksum_Algorithm const & algorithm, uint8_t const * data, size_t const & length, size_t const & chunk_size, char * checksum) {
+    HashGenerator hash;
+    bool valid = hash.start(algorithm);
+    for (size_t offset = 0U; offset < length && valid; offset += chunk_size) {
+        valid = hash.update(data + offset, length - offset < chunk_size ? length - offset : chunk_size);
+    }
+    return valid && hash.finish(checksum);
+}
+
+int main() {
+    std::mt19937 rng(41U);
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (auto & byte : firmware) {
+        byte = rng();
+    }
+    int result = 0;
+    printf("algorithm   | throughput\n");
+    for (auto const & algorithm : ALGORITHMS) {
+        char known[FIRMWARE_HASH_SIZE] = {};
+        char chunked[FIRMWARE_HASH_SIZE] = {};
+        char single[FIRMWARE_HASH_SIZE] = {};
+        bool valid = Calculate_Checksum(algorithm.algorithm, reinterpret_cast<uint8_t const *>(algorithm.message), strlen(algorithm.message), 1U, known) && strcmp(known, algorithm.checksum) == 0;
+        valid = valid && Calculate_Checksum(algorithm.algorithm, firmware.data(), firmware.size(), firmware.size(), single);
+        auto const start = std::chrono::steady_clock::now();
+        for (size_t repetition = 0U; repetition < BENCHMARK_REPETITIONS && valid; repetition++) {
+            valid = Calculate_Checksum(algorithm.algorithm, firmware.data(), firmware.size(), CHUNK_SIZE, chunked) && strcmp(chunked, single) == 0;
+        }
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!valid) {
+            printf("%-11s | calculated checksum is invalid\n", algorithm.name);
+            result = 1;
+            continue;
+        }
+        printf("%-11s | %7.1f MB/s\n", algorithm.name, (firmware.size() * BENCHMARK_REPETITIONS) / seconds / 1e6);
+    }
+    return result;
+}
@@ -0,0 +1,201 @@
+// Reconstructs randomly generated firmware binaries with the Delta_Updater out of ENDSLEY/BSDIFF43 binary patches created against randomly generated running firmware binaries.
+// Every patch is applied with multiple window sizes and received in randomly sized parts, the same as it would be when downloaded in chunks
+
+// Local includes.
+#include "Delta_Updater.h"
+#include "File_Firmware_Source.h"
+#include "HashGenerator.h"
+
+// Library includes.
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+
+// File the running firmware binary is written into, so it can be read by the File_Firmware_Source
+constexpr char RUNNING_FIRMWARE_PATH[] = "Delta_Updater_Test_running.bin";
+// Amount of randomly generated firmware binaries and patches
+constexpr size_t TEST_ITERATIONS = 50U;
+// Window sizes every patch is applied with
+constexpr size_t WINDOW_SIZES[] = { 1U, 7U, 512U, DELTA_WINDOW_SIZE };
+
+
+/// @brief Updater that keeps the written firmware binary in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        m_reset = false;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+        m_reset = true;
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+    bool Was_Reset() const {
+        return m_reset;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {};  // Written firmware binary
+    size_t               m_size = {};  // Size of the firmware binary passed to begin()
+    bool                 m_reset = {}; // Whether reset() has been called since begin()
+};
+
+
+/// @brief Appends the given integer in the sign-magnitude encoding of bsdiff
+/// @param patch Patch the encoded integer is appended to
+/// @param value Integer that should be encoded
+static void Append_Integer(std::vector<uint8_t> & patch, int64_t const & value) {
+    uint64_t magnitude = value < 0 ? -value : value;
+    for (size_t i = 0U; i < DELTA_PATCH_INTEGER_SIZE; i++) {
+        patch.push_back(magnitude & 0xFFU);
+        magnitude >>= 8U;
+    }
+    if (value < 0) {
+        patch.back() |= 0x80U;
+    }
+}
+
+/// @brief Creates a random patch against the given running firmware binary, consisting of control blocks with random diff and extra lengths and seek offsets,
+/// which can seek outside of the running firmware binary as well, the same as patches created by bsdiff
+/// @param rng Random number generator
+/// @param running Running firmware binary the patch is created against
+/// @param reconstructed Firmware binary the patch reconstructs
+/// @return Created patch
+static std::vector<uint8_t> Create_Patch(std::mt19937 & rng, std::vector<uint8_t> const & running, std::vector<uint8_t> & reconstructed) {
+    std::vector<uint8_t> body = {};
+    reconstructed.clear();
+    int64_t running_offset = 0;
+    size_t const blocks = rng() % 30U + 1U;
+    for (size_t block = 0U; block < blocks; block++) {
+        size_t const diff_length = rng() % 3000U;
+        size_t const extra_length = rng() % 500U + (block == blocks - 1U ? 1U : 0U);
+        int64_t const seek = static_cast<int64_t>(rng() % 10001U) - 5000;
+        Append_Integer(body, diff_length);
+        Append_Integer(body, extra_length);
+        Append_Integer(body, seek);
+        for (size_t i = 0U; i < diff_length; i++) {
+            // Mostly unchanged bytes, the same as in a real patch of a slightly changed firmware binary
+            uint8_t const diff = rng() % 4U == 0U ? rng() : 0U;
+            int64_t const position = running_offset + i;
+            uint8_t const old_byte = position >= 0 && position < static_cast<int64_t>(running.size()) ? running[position] : 0U;
+            body.push_back(diff);
+            reconstructed.push_back(old_byte + diff);
+        }
+        for (size_t i = 0U; i < extra_length; i++) {
+            uint8_t const extra = rng();
+            body.push_back(extra);
+            reconstructed.push_back(extra);
+        }
+        running_offset += diff_length + seek;
+    }
+
+    std::vector<uint8_t> patch(DELTA_PATCH_MAGIC, DELTA_PATCH_MAGIC + DELTA_PATCH_MAGIC_SIZE);
+    Append_Integer(patch, reconstructed.size());
+    patch.insert(patch.end(), body.begin(), body.end());
+    return patch;
+}
+
+/// @brief Applies the given patch with the given window size, writing it in randomly sized parts
+/// @param rng Random number generator
+/// @param patch Patch that should be applied
+/// @param window_size Window size of the delta updater
+/// @param target_checksum Expected checksum of the reconstructed firmware binary
+/// @param reconstructed Firmware binary the updater wrote
+/// @param target_reset Whether the updater the firmware binary is reconstructed into has been reset
+/// @return Whether applying the patch and verifying the checksum succeeded
+static bool Apply_Patch(std::mt19937 & rng, std::vector<uint8_t> & patch, size_t const & window_size, char const * target_checksum, std::vector<uint8_t> & reconstructed, bool & target_reset) {
+    Memory_Updater target;
+    File_Firmware_Source<> source(RUNNING_FIRMWARE_PATH);
+    Delta_Updater<> updater(target, source, window_size);
+    updater.Set_Target_Checksum(target_checksum, Checksum_Algorithm::CRC32);
+    if (!updater.begin(patch.size())) {
+        return false;
+    }
+    size_t offset = 0U;
+    while (offset < patch.size()) {
+        size_t length = rng() % 700U + 1U;
+        length = length < patch.size() - offset ? length : patch.size() - offset;
+        if (updater.write(patch.data() + offset, length) != length) {
+            return false;
+        }
+        offset += length;
+    }
+    bool const result = updater.end();
+    reconstructed = target.Get_Data();
+    target_reset = target.Was_Reset();
+    return result;
+}
+
+int main() {
+    std::mt19937 rng(33U);
+    size_t failures = 0U;
+    for (size_t iteration = 0U; iteration < TEST_ITERATIONS; iteration++) {
+        std::vector<uint8_t> running(rng() % 20000U);
+        for (auto & byte : running) {
+            byte = rng();
+        }
+        FILE * file = fopen(RUNNING_FIRMWARE_PATH, "wb");
+        if (file == nullptr || fwrite(running.data(), 1U, running.size(), file) != running.size()) {
+            printf("Writing the running firmware binary failed\n");
+            return 1;
+        }
+        (void)fclose(file);
+
+        std::vector<uint8_t> expected = {};
+        std::vector<uint8_t> patch = Create_Patch(rng, running, expected);
+        HashGenerator hash;
+        (void)hash.start(Checksum_Algorithm::CRC32);
+        (void)hash.update(expected.data(), expected.size());
+        char expected_checksum[FIRMWARE_HASH_SIZE] = {};
+        (void)hash.finish(expected_checksum);
+
+        for (size_t const window_size : WINDOW_SIZES) {
+            std::vector<uint8_t> reconstructed = {};
+            bool target_reset = false;
+            if (!Apply_Patch(rng, patch, window_size, expected_checksum, reconstructed, target_reset) || reconstructed != expected) {
+                printf("Iteration (%zu) with window size (%zu) did not reconstruct the firmware binary\n", iteration, window_size);
+                failures++;
+            }
+        }
+
+        // Truncated patches and patches applied to a different running firmware binary have to be rejected
+        std::vector<uint8_t> reconstructed = {};
+        bool target_reset = false;
+        std::vector<uint8_t> truncated(patch.begin(), patch.end() - 1);
+        if (Apply_Patch(rng, truncated, DELTA_WINDOW_SIZE, expected_checksum, reconstructed, target_reset)) {
+            printf("Iteration (%zu) accepted a truncated patch\n", iteration);
+            failures++;
+        }
+        char const wrong_checksum[] = "00000000";
+        if (Apply_Patch(rng, patch, DELTA_WINDOW_SIZE, wrong_checksum, reconstructed, target_reset)) {
+            printf("Iteration (%zu) accepted a firmware binary with a different checksum\n", iteration);
+            failures++;
+        }
+        // Rejected firmware binary must not be left behind in the target updater, for example as an open OTA partition
+        else if (!target_reset) {
+            printf("Iteration (%zu) did not reset the target updater after the checksum did not match\n", iteration);
+            failures++;
+        }
+    }
+    (void)remove(RUNNING_FIRMWARE_PATH);
+    printf("%zu failures in %zu iterations\n", failures, TEST_ITERATIONS);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// Writes a firmware binary chunk by chunk into a Fan_Out_Updater, whose sinks are each written with their own write queue.
+// Covers a sink that fails while writing and a sink that writes far slower than the write timeout, which both have to be excluded from the update,
+// without delaying the writes into the remaining healthy sinks by more than the write timeout or keeping them from receiving the complete firmware binary
+
+// Local includes.
+#include "Fan_Out_Updater.h"
+
+// Library includes.
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Size of the written firmware binary and of the chunks it is written in
+constexpr size_t FIRMWARE_SIZE = 32768U;
+constexpr size_t CHUNK_SIZE = 1024U;
+// Amount of chunks every sink can fall behind in its write queue
+constexpr size_t QUEUE_DEPTH = 2U;
+// Time in microseconds a sink may take to accept the next chunk into its full queue
+constexpr uint64_t WRITE_TIMEOUT_US = 20000U;
+// Time in microseconds the slow sink takes for every write, far longer than the write timeout
+constexpr uint64_t SLOW_WRITE_US = 300000U;
+// Additional time in microseconds a single write into the fan out updater may take above the write timeout, accounts for the scheduling of the host
+constexpr uint64_t WRITE_SLACK_US = 50000U;
+// Index of the chunk the failing sink fails to write
+constexpr size_t FAILING_CHUNK = 3U;
+// Names of the child devices the sinks belong to
+constexpr char HEALTHY_DEVICE[] = "healthy";
+constexpr char FAILING_DEVICE[] = "failing";
+constexpr char SLOW_DEVICE[] = "slow";
+constexpr char SECOND_HEALTHY_DEVICE[] = "second_healthy";
+
+
+/// @brief Updater that keeps the written firmware binary in memory, optionally fails to write the chunk with the given index or takes the given time for every write
+class Memory_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param failing_chunk Index of the chunk whose write fails, SIZE_MAX if no write fails
+    /// @param write_delay_us Time in microseconds every write takes
+    Memory_Updater(size_t const & failing_chunk, uint64_t const & write_delay_us)
+      : m_failing_chunk(failing_chunk)
+      , m_write_delay(write_delay_us)
+    {
+        // Nothing to do
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        m_writes = 0U;
+        m_ended = false;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        std::this_thread::sleep_for(std::chrono::microseconds(m_write_delay));
+        if (m_writes++ == m_failing_chunk) {
+            return 0U;
+        }
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        m_ended = true;
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+    bool Is_Ended() const {
+        return m_ended;
+    }
+
+  private:
+    size_t               m_failing_chunk = {}; // Index of the chunk whose write fails
+    uint64_t             m_write_delay = {};   // Time in microseconds every write takes
+    std::vector<uint8_t> m_data = {};          // Written firmware binary
+    size_t               m_size = {};          // Size of the firmware binary passed to begin()
+    size_t               m_writes = {};        // Amount of writes since begin()
+    bool                 m_ended = {};         // Whether end() has been called since begin()
+};
+
+/// @brief Last firmware state and error reported for a child device
+struct Reported_State {
+    std::string device_name; // Name of the child device
+    std::string state;       // Last reported firmware state
+    std::string error;       // Error reported with the last firmware state
+};
+
+
+/// @brief Gets the last firmware state reported for the child device with the given name
+/// @param states Firmware states reported for every child device
+/// @param device_name Name of the child device
+/// @return Last reported firmware state, empty if no state has been reported
+static Reported_State Get_State(std::vector<Reported_State> const & states, char const * device_name) {
+    for (Reported_State const & state : states) {
+        if (state.device_name == device_name) {
+            return state;
+        }
+    }
+    return Reported_State();
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(38U);
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (uint8_t & byte : firmware) {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    size_t failures = 0U;
+    std::vector<Reported_State> states = {};
+    Fan_Out_Updater<> fan_out([&states](char const * device_name, char const * state, char const * error) {
+        for (Reported_State & reported : states) {
+            if (reported.device_name == device_name) {
+                reported.state = state;
+                reported.error = error;
+                return true;
+            }
+        }
+        states.push_back({ device_name, state, error });
+        return true;
+    });
+    fan_out.Set_Write_Timeout(WRITE_TIMEOUT_US);
+    fan_out.Set_Sink_Queue(QUEUE_DEPTH, CHUNK_SIZE);
+    Memory_Updater healthy(SIZE_MAX, 0U);
+    Memory_Updater failing(FAILING_CHUNK, 0U);
+    Memory_Updater slow(SIZE_MAX, SLOW_WRITE_US);
+    Memory_Updater second_healthy(SIZE_MAX, 0U);
+    Check(fan_out.Add_Sink(HEALTHY_DEVICE, healthy) && fan_out.Add_Sink(FAILING_DEVICE, failing) && fan_out.Add_Sink(SLOW_DEVICE, slow) &&
+      fan_out.Add_Sink(SECOND_HEALTHY_DEVICE, second_healthy), "adding the sinks", failures);
+    Check(fan_out.begin(firmware.size()), "beginning the update", failures);
+    Check(!fan_out.Add_Sink(HEALTHY_DEVICE, healthy), "rejecting sinks added while the update is in progress", failures);
+
+    // Neither the failing nor the slow sink may delay a single write by more than the write timeout
+    uint64_t slowest_write = 0U;
+    bool written = true;
+    for (size_t offset = 0U; offset < firmware.size(); offset += CHUNK_SIZE) {
+        uint64_t const start = Helper::getTimeMicroseconds();
+        written = fan_out.write(firmware.data() + offset, CHUNK_SIZE) == CHUNK_SIZE && written;
+        slowest_write = std::max(slowest_write, Helper::getTimeMicroseconds() - start);
+    }
+    Check(written, "writing every chunk while atleast one sink is still active", failures);
+    Check(slowest_write <= WRITE_TIMEOUT_US + WRITE_SLACK_US, "not delaying any write by more than the write timeout", failures);
+    printf("Slowest write took (%llu) microseconds\n", static_cast<unsigned long long>(slowest_write));
+    Check(fan_out.end(), "ending the update with the healthy sinks", failures);
+
+    // Healthy sinks received the complete firmware binary, the failing and slow sinks are excluded with the matching error
+    Check(healthy.Is_Ended() && healthy.Get_Data() == firmware, "writing the complete firmware into the first healthy sink", failures);
+    Check(second_healthy.Is_Ended() && second_healthy.Get_Data() == firmware, "writing the complete firmware into the second healthy sink", failures);
+    Check(!failing.Is_Ended() && !slow.Is_Ended(), "not ending the update of the excluded sinks", failures);
+    Check(fan_out.Get_Failed_Sink_Count() == 2U && !fan_out.Is_Sink_Failed(0U) && fan_out.Is_Sink_Failed(1U) && fan_out.Is_Sink_Failed(2U) && !fan_out.Is_Sink_Failed(3U),
+      "excluding only the failing and the slow sink", failures);
+    Reported_State const failing_state = Get_State(states, FAILING_DEVICE);
+    Check(failing_state.state == FW_STATE_FAILED && failing_state.error == FAN_OUT_SINK_WRITE_FAILED, "reporting the write failure of the failing sink", failures);
+    Reported_State const slow_state = Get_State(states, SLOW_DEVICE);
+    Check(slow_state.state == FW_STATE_FAILED && slow_state.error == FAN_OUT_SINK_WRITE_TOO_SLOW, "reporting the exceeded write timeout of the slow sink", failures);
+    Check(Get_State(states, HEALTHY_DEVICE).state == FW_STATE_UPDATED && Get_State(states, SECOND_HEALTHY_DEVICE).state == FW_STATE_UPDATED, "reporting the healthy sinks as updated", failures);
+    Check(fan_out.Add_Sink(HEALTHY_DEVICE, healthy), "allowing to add sinks once the update ended", failures);
+
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
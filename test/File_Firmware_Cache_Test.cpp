@@ -0,0 +1,275 @@
+// Fills, reads and evicts entries of the File_Firmware_Cache in a temporary directory and checks the files it leaves behind.
+// Covers hits and misses, the pending file only replacing the entry file once the entry is completed, and the eviction of the least recently used entries once the size limit is reached.
+// Additionally downloads a firmware binary over the ThingsBoard_Emulator into the cache and applies it out of the cache with a second update, which has to be written in steps by loop() without requesting any chunk
+
+// Local includes.
+#include "Attribute_Request.h"
+#include "File_Firmware_Cache.h"
+#include "HashGenerator.h"
+#include "Loopback_MQTT_Client.h"
+#include "OTA_Firmware_Update.h"
+#include "ThingsBoard.h"
+#include "ThingsBoard_Emulator.h"
+
+// Library includes.
+#include <array>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+// Size of every cached firmware binary and maximum size of the cache, which therefore fits exactly three entries
+constexpr size_t ENTRY_SIZE = 1000U;
+constexpr size_t CACHE_SIZE = 3U * ENTRY_SIZE;
+// Algorithm the checksums of the cached firmware binaries are calculated with
+constexpr Checksum_Algorithm ENTRY_ALGORITHM = Checksum_Algorithm::SHA256;
+// Time in microseconds the firmware update may take at most, before it is considered as failed
+constexpr uint64_t UPDATE_TIMEOUT_US = 10000000U;
+// Receive and send buffer size of the client
+constexpr uint16_t CLIENT_BUFFER_SIZE = 512U;
+// Identifier of the emulated device, used in the topics of the firmware chunks
+constexpr char DEVICE_ID[] = "Cache_Device";
+// Title and version of the firmware the device is currently running, and version of the firmware served by the emulator
+constexpr char FIRMWARE_TITLE[] = "cached";
+constexpr char CURRENT_VERSION[] = "1.0.0";
+constexpr char UPDATED_VERSION[] = "1.1.0";
+// Size of the served firmware binary and of the chunks it is downloaded and read out of the cache in
+constexpr size_t FIRMWARE_SIZE = 20000U;
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 1024U;
+
+
+/// @brief Updater that keeps the written firmware binary in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {}; // Written firmware binary
+    size_t               m_size = {}; // Size of the firmware binary passed to begin()
+};
+
+/// @brief Attribute request of the emulated device, implements the device identity the API implementations of this library require
+class Device_Attribute_Request : public Attribute_Request<1U, 2U> {
+  public:
+    char const * GetDeviceId() override {
+        return DEVICE_ID;
+    }
+
+    void SetDeviceId(char const * /*device_id*/) override {
+        // Nothing to do
+    }
+
+    char const * GetDeviceProfile() override {
+        return "";
+    }
+
+    void SetDeviceProfile(char const * /*device_profile*/) override {
+        // Nothing to do
+    }
+};
+
+
+/// @brief Creates a firmware binary of the given size, whose content depends on the given seed
+/// @param seed Seed the content is derived from, different seeds result in different checksums
+/// @param size Size of the firmware binary in bytes
+/// @param checksum Output buffer the SHA256 checksum of the firmware binary is copied into
+/// @return Created firmware binary
+static std::vector<uint8_t> Create_Firmware(uint32_t const & seed, size_t const & size, char (&checksum)[FIRMWARE_HASH_SIZE]) {
+    std::vector<uint8_t> firmware(size);
+    for (size_t i = 0U; i < firmware.size(); i++) {
+        firmware[i] = static_cast<uint8_t>((i * 31U) ^ (i >> 7U) ^ (seed * 97U));
+    }
+    HashGenerator hash;
+    (void)hash.start(ENTRY_ALGORITHM);
+    (void)hash.update(firmware.data(), firmware.size());
+    (void)hash.finish(checksum);
+    return firmware;
+}
+
+/// @brief Whether a file with the given name exists inside of the given directory
+/// @param directory Path to the directory
+/// @param name Name of the file
+/// @return Whether the file exists
+static bool File_Exists(std::string const & directory, char const * name) {
+    return access((directory + "/" + name).c_str(), F_OK) == 0;
+}
+
+/// @brief Fills a complete entry into the given cache
+/// @param cache Cache the entry should be filled into
+/// @param firmware Firmware binary that should be cached
+/// @param checksum Checksum of the firmware binary
+/// @return Whether the entry was completed
+static bool Fill_Entry(File_Firmware_Cache<> & cache, std::vector<uint8_t> const & firmware, char const * checksum) {
+    return cache.begin_entry(checksum, ENTRY_ALGORITHM, firmware.size()) && cache.write_entry(firmware.data(), firmware.size()) && cache.end_entry();
+}
+
+/// @brief Opens the entry with the given checksum and reads it completely, which marks it as the most recently used entry
+/// @param cache Cache the entry should be read out of
+/// @param firmware Firmware binary the entry should contain
+/// @param checksum Checksum of the firmware binary
+/// @return Whether the entry exists and contains the given firmware binary
+static bool Read_Entry(File_Firmware_Cache<> & cache, std::vector<uint8_t> const & firmware, char const * checksum) {
+    if (!cache.open_entry(checksum, ENTRY_ALGORITHM, firmware.size())) {
+        return false;
+    }
+    std::vector<uint8_t> data(firmware.size());
+    bool const read = cache.read_entry(0U, data.data(), data.size()) == data.size();
+    cache.close_entry();
+    return read && data == firmware;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+/// @brief Downloads the firmware binary served by the given emulator with the given cache configured,
+/// which either fills a new entry or applies the cached firmware binary if it is already contained
+/// @param broker Broker the emulator serving the firmware binary has been registered at
+/// @param cache Cache the firmware binary is written into or applied out of
+/// @param firmware Expected firmware binary
+/// @param progress_loops Amount of loop() calls the progress callback has been called in
+/// @return Whether the update succeeded and wrote the expected firmware binary
+static bool Update_Firmware(Loopback_MQTT_Broker & broker, File_Firmware_Cache<> & cache, std::vector<uint8_t> const & firmware, size_t & progress_loops) {
+    Loopback_MQTT_Client<> client(broker);
+    OTA_Firmware_Update<> ota;
+    Device_Attribute_Request attribute_request;
+    std::array<IAPI_Implementation *, 2U> const apis = {&ota, &attribute_request};
+    ThingsBoardSized<> tb(client, CLIENT_BUFFER_SIZE, CLIENT_BUFFER_SIZE, Default_Max_Stack_Size, apis);
+    ota.SetDeviceId(DEVICE_ID);
+    if (!tb.connect("localhost", "token")) {
+        return false;
+    }
+
+    Memory_Updater updater;
+    int update_result = -1;
+    bool progressed = false;
+    OTA_Update_Callback update_callback(FIRMWARE_TITLE, CURRENT_VERSION, &updater, [&](bool const & success) { update_result = success ? 1 : 0; },
+      [&](size_t const & /*current*/, size_t const & /*total*/) { progressed = true; }, nullptr, 5U, FIRMWARE_CHUNK_SIZE);
+    update_callback.Set_Firmware_Cache(&cache);
+    if (!ota.Start_Firmware_Update(update_callback)) {
+        return false;
+    }
+    progress_loops = 0U;
+    uint64_t const start = Helper::getTimeMicroseconds();
+    while (update_result < 0 && Helper::getTimeMicroseconds() - start < UPDATE_TIMEOUT_US) {
+        progressed = false;
+        (void)tb.loop();
+        progress_loops += progressed ? 1U : 0U;
+    }
+    return update_result == 1 && updater.Get_Data() == firmware;
+}
+
+int main() {
+    char directory_template[] = "/tmp/File_Firmware_Cache_Test_XXXXXX";
+    char const * created_directory = mkdtemp(directory_template);
+    if (created_directory == nullptr) {
+        printf("Failed to create the temporary cache directory\n");
+        return 1;
+    }
+    std::string const directory = created_directory;
+    size_t failures = 0U;
+
+    std::array<char[FIRMWARE_HASH_SIZE], 5U> checksums = {};
+    std::vector<std::vector<uint8_t>> firmwares = {};
+    for (size_t i = 0U; i < checksums.size(); i++) {
+        firmwares.push_back(Create_Firmware(i + 1U, ENTRY_SIZE, checksums[i]));
+    }
+    {
+        File_Firmware_Cache<> cache(directory.c_str(), CACHE_SIZE);
+        Check(!cache.open_entry(checksums[0U], ENTRY_ALGORITHM, ENTRY_SIZE), "missing an entry of the empty cache", failures);
+
+        // Pending file only replaces the entry file once the entry is completed, an aborted entry leaves no file behind
+        Check(cache.begin_entry(checksums[0U], ENTRY_ALGORITHM, ENTRY_SIZE) && cache.write_entry(firmwares[0U].data(), ENTRY_SIZE), "filling the first entry", failures);
+        Check(File_Exists(directory, FIRMWARE_CACHE_PENDING_FILE) && !cache.open_entry(checksums[0U], ENTRY_ALGORITHM, ENTRY_SIZE), "keeping the filled entry in the pending file", failures);
+        Check(cache.end_entry() && !File_Exists(directory, FIRMWARE_CACHE_PENDING_FILE), "renaming the pending file once the entry is completed", failures);
+        Check(Read_Entry(cache, firmwares[0U], checksums[0U]), "hitting the completed entry", failures);
+        Check(!cache.open_entry(checksums[0U], ENTRY_ALGORITHM, ENTRY_SIZE + 1U), "missing the entry with a different size", failures);
+        Check(!cache.open_entry(checksums[0U], Checksum_Algorithm::MD5, ENTRY_SIZE), "missing the entry with a different checksum algorithm", failures);
+        Check(cache.begin_entry(checksums[1U], ENTRY_ALGORITHM, ENTRY_SIZE) && cache.write_entry(firmwares[1U].data(), ENTRY_SIZE / 2U), "filling half of the second entry", failures);
+        cache.abort_entry();
+        Check(!File_Exists(directory, FIRMWARE_CACHE_PENDING_FILE) && !cache.open_entry(checksums[1U], ENTRY_ALGORITHM, ENTRY_SIZE), "discarding the aborted entry", failures);
+        Check(!cache.begin_entry(checksums[1U], ENTRY_ALGORITHM, CACHE_SIZE + 1U), "rejecting an entry bigger than the cache", failures);
+
+        // Reading the first entry marks it as the most recently used entry, therefore the second entry is evicted first once the cache is full
+        Check(Fill_Entry(cache, firmwares[1U], checksums[1U]) && Fill_Entry(cache, firmwares[2U], checksums[2U]), "filling the cache completely", failures);
+        Check(Read_Entry(cache, firmwares[0U], checksums[0U]), "hitting the first entry in the full cache", failures);
+        Check(Fill_Entry(cache, firmwares[3U], checksums[3U]), "filling an entry into the full cache", failures);
+        Check(!cache.open_entry(checksums[1U], ENTRY_ALGORITHM, ENTRY_SIZE), "evicting the least recently used entry", failures);
+        Check(Read_Entry(cache, firmwares[0U], checksums[0U]) && Read_Entry(cache, firmwares[2U], checksums[2U]) && Read_Entry(cache, firmwares[3U], checksums[3U]),
+          "keeping the more recently used entries", failures);
+        // Order is now first, third, fourth entry from the least to the most recently used
+        Check(Fill_Entry(cache, firmwares[4U], checksums[4U]) && !cache.open_entry(checksums[0U], ENTRY_ALGORITHM, ENTRY_SIZE), "evicting the next least recently used entry", failures);
+        cache.remove_entry(checksums[2U], ENTRY_ALGORITHM);
+        Check(!cache.open_entry(checksums[2U], ENTRY_ALGORITHM, ENTRY_SIZE), "removing an entry", failures);
+    }
+    {
+        // Index is persisted in the directory, therefore a new instance still contains the remaining entries
+        File_Firmware_Cache<> cache(directory.c_str(), CACHE_SIZE);
+        Check(Read_Entry(cache, firmwares[3U], checksums[3U]) && Read_Entry(cache, firmwares[4U], checksums[4U]), "hitting the entries with a new instance", failures);
+        cache.remove_entry(checksums[3U], ENTRY_ALGORITHM);
+        cache.remove_entry(checksums[4U], ENTRY_ALGORITHM);
+    }
+
+    // First update downloads the firmware binary and caches it, the second update applies it out of the cache without requesting a single chunk,
+    // one chunk per loop() call, so the MQTT client keeps being serviced while the cached firmware binary is written
+    char checksum[FIRMWARE_HASH_SIZE] = {};
+    std::vector<uint8_t> const firmware = Create_Firmware(0U, FIRMWARE_SIZE, checksum);
+    Loopback_MQTT_Broker broker;
+    ThingsBoard_Emulator emulator(broker);
+    emulator.Set_Firmware(FIRMWARE_TITLE, UPDATED_VERSION, firmware.data(), firmware.size());
+    emulator.Set_Shared_Attribute(FW_TITLE_KEY, (std::string("\"") + FIRMWARE_TITLE + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_VER_KEY, (std::string("\"") + UPDATED_VERSION + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_KEY, (std::string("\"") + checksum + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_ALGO_KEY, (std::string("\"") + CHECKSUM_AGORITM_SHA256 + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_SIZE_KEY, std::to_string(firmware.size()).c_str());
+    File_Firmware_Cache<> cache(directory.c_str(), FIRMWARE_SIZE);
+    size_t progress_loops = 0U;
+    Check(Update_Firmware(broker, cache, firmware, progress_loops) && emulator.Get_Firmware_Chunk_Requests() > 0U, "downloading the firmware binary into the cache", failures);
+    size_t const chunk_requests = emulator.Get_Firmware_Chunk_Requests();
+    size_t const chunks = (FIRMWARE_SIZE + FIRMWARE_CHUNK_SIZE - 1U) / FIRMWARE_CHUNK_SIZE;
+    Check(Update_Firmware(broker, cache, firmware, progress_loops) && emulator.Get_Firmware_Chunk_Requests() == chunk_requests, "applying the firmware binary out of the cache", failures);
+    Check(progress_loops == chunks, "writing one chunk of the cached firmware binary per loop() call", failures);
+
+    // Cached firmware binary that does not match its checksum anymore is removed and downloaded instead
+    char name[FIRMWARE_CACHE_MAX_NAME_SIZE] = {};
+    (void)snprintf(name, sizeof(name), FIRMWARE_CACHE_ENTRY_FILE_FMT, static_cast<int>(ENTRY_ALGORITHM), checksum);
+    FILE * entry = fopen((directory + "/" + name).c_str(), "r+b");
+    Check(entry != nullptr && fputc(firmware.front() ^ 0xFF, entry) != EOF && fclose(entry) == 0, "corrupting the cached firmware binary", failures);
+    Check(Update_Firmware(broker, cache, firmware, progress_loops) && emulator.Get_Firmware_Chunk_Requests() > chunk_requests, "downloading the firmware binary after the cached one was invalid", failures);
+    cache.remove_entry(checksum, ENTRY_ALGORITHM);
+
+    (void)remove((directory + "/" + FIRMWARE_CACHE_INDEX_FILE).c_str());
+    (void)rmdir(directory.c_str());
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
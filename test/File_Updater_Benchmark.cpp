@@ -0,0 +1,93 @@
+// Measures the throughput of writing a firmware binary into a file with the SDCard_Updater, which opens and closes the file for every chunk,
+// compared to the File_Updater with every sync policy, which keeps the file open and writes aligned blocks.
+// Every updater receives the same firmware binary in chunks of multiple sizes, including sizes that are not a multiple of the write buffer size.
+// Throughput is measured in written bytes per second from begin until end, which includes synchronizing the file onto the storage medium if the sync policy requires it
+
+// Local includes.
+#include "File_Updater.h"
+#include "OTA_Update_Callback.h"
+#include "SDCard_Updater.h"
+
+// Library includes.
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+
+// File the firmware binary is written into, the benchmark measures the file system of the current working directory
+constexpr char FIRMWARE_PATH[] = "File_Updater_Benchmark.bin";
+// Size of the firmware binary
+constexpr size_t FIRMWARE_SIZE = 4U * 1024U * 1024U;
+// Sizes of the chunks the firmware binary is written in, the default OTA chunk size and sizes a negotiated or adaptively adjusted chunk size might have
+constexpr size_t WRITE_CHUNK_SIZES[] = { 512U, 1000U, CHUNK_SIZE };
+// Amount of times the firmware binary is written for every updater and chunk size
+constexpr size_t BENCHMARK_REPETITIONS = 3U;
+
+
+/// @brief Reads the written file and compares it against the expected firmware binary
+/// @param expected Firmware binary that should have been written
+/// @return Whether the file contains exactly the expected firmware binary
+static bool Verify_File(std::vector<uint8_t> const & expected) {
+    FILE * file = fopen(FIRMWARE_PATH, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> written(expected.size() + 1U);
+    size_t const read_bytes = fread(written.data(), 1U, written.size(), file);
+    (void)fclose(file);
+    written.resize(read_bytes);
+    return written == expected;
+}
+
+/// @brief Writes the firmware binary into the given updater in chunks of the given size and prints the measured throughput
+/// @param name Name of the updater printed in the result
+/// @param updater Updater the firmware binary is written into
+/// @param firmware Firmware binary that should be written
+/// @param chunk_size Size of the chunks the firmware binary is written in
+/// @param keeps_file Whether the updater keeps the file once the update is ended, allowing to verify the written firmware binary
+/// @return Whether every update succeeded and wrote the complete firmware binary
+static bool Benchmark(char const * name, IUpdater & updater, std::vector<uint8_t> & firmware, size_t const & chunk_size, bool const & keeps_file) {
+    bool valid = true;
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t repetition = 0U; repetition < BENCHMARK_REPETITIONS && valid; repetition++) {
+        valid = updater.begin(firmware.size());
+        for (size_t offset = 0U; offset < firmware.size() && valid; offset += chunk_size) {
+            size_t const length = firmware.size() - offset < chunk_size ? firmware.size() - offset : chunk_size;
+            valid = updater.write(firmware.data() + offset, length) == length;
+        }
+        valid = valid && updater.end();
+    }
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    valid = valid && (!keeps_file || Verify_File(firmware));
+    if (!valid) {
+        printf("%-20s | %10zu | writing failed\n", name, chunk_size);
+        return false;
+    }
+    printf("%-20s | %10zu | %7.1f MB/s\n", name, chunk_size, (firmware.size() * BENCHMARK_REPETITIONS) / seconds / 1e6);
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(35U);
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (auto & byte : firmware) {
+        byte = rng();
+    }
+    SDCard_Updater<> sd_card_updater(FIRMWARE_PATH);
+    File_Updater<> never_updater(FIRMWARE_PATH, File_Sync_Policy::NEVER);
+    File_Updater<> end_updater(FIRMWARE_PATH, File_Sync_Policy::END);
+    File_Updater<> block_updater(FIRMWARE_PATH, File_Sync_Policy::BLOCK);
+    int result = 0;
+    printf("updater              | chunk size | throughput\n");
+    for (size_t const chunk_size : WRITE_CHUNK_SIZES) {
+        // SDCard_Updater removes the file once the update is ended, therefore only the File_Updater results can be verified
+        result |= Benchmark("SDCard_Updater", sd_card_updater, firmware, chunk_size, false) ? 0 : 1;
+        result |= Benchmark("File_Updater NEVER", never_updater, firmware, chunk_size, true) ? 0 : 1;
+        result |= Benchmark("File_Updater END", end_updater, firmware, chunk_size, true) ? 0 : 1;
+        result |= Benchmark("File_Updater BLOCK", block_updater, firmware, chunk_size, true) ? 0 : 1;
+    }
+    (void)remove(FIRMWARE_PATH);
+    return result;
+}
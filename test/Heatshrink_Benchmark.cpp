@@ -0,0 +1,214 @@
+// Measures the throughput of the Heatshrink_Updater decompressing a synthetic firmware binary for every supported window size.
+// The firmware binary is compressed by the simple greedy encoder below, which produces the same bitstream as the reference heatshrink encoder, but finds fewer matches.
+// Throughput is measured in decompressed bytes per second, the decompressed firmware binary is written into an updater that only verifies it
+
+// Local include.
+#include "Heatshrink_Updater.h"
+
+// Library includes.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+
+// Size of the synthetic firmware binary
+constexpr size_t FIRMWARE_SIZE = 1024U * 1024U;
+// Size of the chunks the compressed firmware binary is written in, the same as the default OTA chunk size
+constexpr size_t WRITE_CHUNK_SIZE = 4096U;
+// Amount of times the compressed firmware binary is decompressed for every window size
+constexpr size_t BENCHMARK_REPETITIONS = 10U;
+// Lookahead bits every window size is compressed with, the heatshrink default
+constexpr uint8_t BENCHMARK_LOOKAHEAD_BITS = HEATSHRINK_LOOKAHEAD_BITS;
+// Amount of bits of the hash of the next three bytes, used by the encoder to find the previous occurence
+constexpr size_t ENCODER_HASH_BITS = 16U;
+
+
+/// @brief Updater that compares the written decompressed firmware binary against the expected one, without storing it
+class Verifying_Updater : public IUpdater {
+  public:
+    explicit Verifying_Updater(std::vector<uint8_t> const & expected)
+      : m_expected(expected)
+    {
+        // Nothing to do
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        m_written = 0U;
+        m_valid = firmware_size == m_expected.size();
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_valid = m_valid && m_written + total_bytes <= m_expected.size() && memcmp(m_expected.data() + m_written, payload, total_bytes) == 0;
+        m_written += total_bytes;
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_valid = false;
+    }
+
+    bool end() override {
+        return m_valid && m_written == m_expected.size();
+    }
+
+  private:
+    std::vector<uint8_t> const & m_expected; // Decompressed firmware binary that should be written
+    size_t                       m_written = {}; // Amount of bytes written since begin()
+    bool                         m_valid = {};   // Whether every written byte matched the expected firmware binary
+};
+
+
+/// @brief Writes bits into a byte buffer, most significant bit first, the same as the heatshrink encoder
+class Bit_Writer {
+  public:
+    explicit Bit_Writer(std::vector<uint8_t> & output)
+      : m_output(output)
+    {
+        // Nothing to do
+    }
+
+    void Write(uint32_t const & value, uint8_t const & bits) {
+        for (uint8_t bit = bits; bit > 0U; bit--) {
+            m_current = (m_current << 1U) | ((value >> (bit - 1U)) & 1U);
+            if (++m_count == 8U) {
+                m_output.push_back(m_current);
+                m_current = 0U;
+                m_count = 0U;
+            }
+        }
+    }
+
+    void Flush() {
+        if (m_count != 0U) {
+            m_output.push_back(m_current << (8U - m_count));
+            m_current = 0U;
+            m_count = 0U;
+        }
+    }
+
+  private:
+    std::vector<uint8_t> & m_output;      // Buffer the full bytes are appended to
+    uint8_t                m_current = {}; // Bits of the byte that is not full yet
+    uint8_t                m_count = {};   // Amount of bits in the byte that is not full yet
+};
+
+
+/// @brief Creates a synthetic firmware binary, consisting of instruction words out of a small vocabulary, repeated blocks, constant data and erased padding,
+/// which compresses to roughly half its size, the same as most real firmware binaries
+/// @return Synthetic firmware binary
+static std::vector<uint8_t> Create_Firmware() {
+    std::mt19937 rng(34U);
+    std::vector<uint32_t> vocabulary(512U);
+    for (auto & word : vocabulary) {
+        word = rng();
+    }
+    std::vector<uint8_t> firmware = {};
+    firmware.reserve(FIRMWARE_SIZE);
+    while (firmware.size() < FIRMWARE_SIZE) {
+        uint32_t const kind = rng() % 100U;
+        if (kind < 55U) {
+            uint32_t const word = vocabulary[rng() % vocabulary.size()];
+            for (size_t i = 0U; i < sizeof(word); i++) {
+                firmware.push_back(word >> (8U * i));
+            }
+        }
+        else if (kind < 70U && firmware.size() > 64U) {
+            // Repeated block, at a distance that is only reachable with bigger windows as well
+            size_t const length = rng() % 48U + 16U;
+            size_t const distance = rng() % (firmware.size() < 30000U ? firmware.size() : 30000U) + 1U;
+            size_t const start = firmware.size() - (distance > firmware.size() ? firmware.size() : distance);
+            for (size_t i = 0U; i < length; i++) {
+                firmware.push_back(firmware[start + i]);
+            }
+        }
+        else if (kind < 98U) {
+            for (size_t i = 0U; i < 4U; i++) {
+                firmware.push_back(rng());
+            }
+        }
+        else {
+            firmware.insert(firmware.end(), rng() % 64U, 0xFFU);
+        }
+    }
+    firmware.resize(FIRMWARE_SIZE);
+    return firmware;
+}
+
+/// @brief Compresses the given data with a greedy encoder, that only considers the most recent previous occurence of the next three bytes
+/// @param data Data that should be compressed
+/// @param window_bits Base two logarithm of the window size
+/// @param lookahead_bits Base two logarithm of the lookahead size
+/// @return Compressed data, prefixed with the decompressed size as expected by the Heatshrink_Updater
+static std::vector<uint8_t> Compress(std::vector<uint8_t> const & data, uint8_t const & window_bits, uint8_t const & lookahead_bits) {
+    std::vector<uint8_t> output = {};
+    for (size_t i = 0U; i < HEATSHRINK_SIZE_PREFIX_SIZE; i++) {
+        output.push_back(data.size() >> (8U * i));
+    }
+    Bit_Writer writer(output);
+    size_t const max_distance = static_cast<size_t>(1U) << window_bits;
+    size_t const max_count = static_cast<size_t>(1U) << lookahead_bits;
+    std::vector<size_t> last_occurence(static_cast<size_t>(1U) << ENCODER_HASH_BITS, SIZE_MAX);
+    size_t position = 0U;
+    while (position < data.size()) {
+        size_t count = 0U;
+        size_t distance = 0U;
+        if (position + 3U <= data.size()) {
+            uint32_t const hash = ((data[position] << 16U) ^ (data[position + 1U] << 8U) ^ data[position + 2U]) * 2654435761U >> (32U - ENCODER_HASH_BITS);
+            size_t const candidate = last_occurence[hash];
+            last_occurence[hash] = position;
+            if (candidate != SIZE_MAX && position - candidate <= max_distance) {
+                distance = position - candidate;
+                while (count < max_count && position + count < data.size() && data[position + count] == data[position + count - distance]) {
+                    count++;
+                }
+            }
+        }
+        // Back reference is only worth it, if it is shorter than encoding the bytes as literals
+        if (count * 9U > 1U + window_bits + lookahead_bits) {
+            writer.Write(0U, 1U);
+            writer.Write(distance - 1U, window_bits);
+            writer.Write(count - 1U, lookahead_bits);
+            position += count;
+            continue;
+        }
+        writer.Write(1U, 1U);
+        writer.Write(data[position], 8U);
+        position++;
+    }
+    writer.Flush();
+    return output;
+}
+
+int main() {
+    std::vector<uint8_t> const firmware = Create_Firmware();
+    Verifying_Updater target(firmware);
+    int result = 0;
+    printf("window bits | window bytes | compressed | throughput\n");
+    for (uint8_t window_bits = HEATSHRINK_MIN_WINDOW_BITS + 1U; window_bits <= HEATSHRINK_MAX_WINDOW_BITS; window_bits++) {
+        std::vector<uint8_t> compressed = Compress(firmware, window_bits, BENCHMARK_LOOKAHEAD_BITS);
+        Heatshrink_Updater<> updater(target, window_bits, BENCHMARK_LOOKAHEAD_BITS);
+        bool valid = true;
+        auto const start = std::chrono::steady_clock::now();
+        for (size_t repetition = 0U; repetition < BENCHMARK_REPETITIONS && valid; repetition++) {
+            valid = updater.begin(compressed.size());
+            for (size_t offset = 0U; offset < compressed.size() && valid; offset += WRITE_CHUNK_SIZE) {
+                size_t const length = compressed.size() - offset < WRITE_CHUNK_SIZE ? compressed.size() - offset : WRITE_CHUNK_SIZE;
+                valid = updater.write(compressed.data() + offset, length) == length;
+            }
+            valid = valid && updater.end();
+        }
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!valid) {
+            printf("%11u | decompressing failed\n", window_bits);
+            result = 1;
+            continue;
+        }
+        printf("%11u | %12zu | %9.1f%% | %7.1f MB/s\n", window_bits, static_cast<size_t>(1U) << window_bits,
+          100.0 * compressed.size() / firmware.size(), (firmware.size() * BENCHMARK_REPETITIONS) / seconds / 1e6);
+    }
+    return result;
+}
@@ -0,0 +1,185 @@
+// Decompresses randomly generated heatshrink bitstreams with the Heatshrink_Updater and compares the result against the firmware binary they encode.
+// Every bitstream is generated together with the firmware binary it decompresses to, out of random literals and back references, including back references overlapping the bytes they produce.
+// Every bitstream is written in randomly sized parts, the same as it would be when downloaded in chunks, and is additionally verified against a wrong and a truncated stream
+
+// Local includes.
+#include "HashGenerator.h"
+#include "Heatshrink_Updater.h"
+
+// Library includes.
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+
+// Amount of randomly generated bitstreams
+constexpr size_t TEST_ITERATIONS = 200U;
+
+
+/// @brief Updater that keeps the written firmware binary in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        m_reset = false;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+        m_reset = true;
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+    bool Was_Reset() const {
+        return m_reset;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {};  // Written firmware binary
+    size_t               m_size = {};  // Size of the firmware binary passed to begin()
+    bool                 m_reset = {}; // Whether reset() has been called since begin()
+};
+
+
+/// @brief Appends the given value to the given bitstream, most significant bit first, the same as the heatshrink encoder
+/// @param bits Bitstream with one bit per element, packed into bytes once it is complete
+/// @param value Value that should be appended
+/// @param count Amount of bits of the value that should be appended
+static void Append_Bits(std::vector<bool> & bits, uint32_t const & value, uint8_t const & count) {
+    for (uint8_t bit = count; bit > 0U; bit--) {
+        bits.push_back(((value >> (bit - 1U)) & 1U) != 0U);
+    }
+}
+
+/// @brief Creates a random heatshrink bitstream, consisting of literals and back references with random distances and counts
+/// @param rng Random number generator
+/// @param window_bits Base two logarithm of the window size
+/// @param lookahead_bits Base two logarithm of the lookahead size
+/// @param decompressed Firmware binary the bitstream decompresses to
+/// @return Bitstream prefixed with the decompressed size, as expected by the Heatshrink_Updater
+static std::vector<uint8_t> Create_Stream(std::mt19937 & rng, uint8_t const & window_bits, uint8_t const & lookahead_bits, std::vector<uint8_t> & decompressed) {
+    decompressed.clear();
+    std::vector<bool> bits = {};
+    size_t const tokens = rng() % 3000U + 1U;
+    for (size_t token = 0U; token < tokens; token++) {
+        if (decompressed.empty() || rng() % 2U == 0U) {
+            uint8_t const literal = rng();
+            Append_Bits(bits, 1U, 1U);
+            Append_Bits(bits, literal, 8U);
+            decompressed.push_back(literal);
+            continue;
+        }
+        size_t const max_distance = static_cast<size_t>(1U) << window_bits;
+        size_t const distance = rng() % (decompressed.size() < max_distance ? decompressed.size() : max_distance) + 1U;
+        size_t const count = rng() % (static_cast<size_t>(1U) << lookahead_bits) + 1U;
+        Append_Bits(bits, 0U, 1U);
+        Append_Bits(bits, distance - 1U, window_bits);
+        Append_Bits(bits, count - 1U, lookahead_bits);
+        // Copied byte by byte, because the back reference might overlap the bytes it produces
+        for (size_t i = 0U; i < count; i++) {
+            decompressed.push_back(decompressed[decompressed.size() - distance]);
+        }
+    }
+
+    std::vector<uint8_t> stream = {};
+    for (size_t i = 0U; i < HEATSHRINK_SIZE_PREFIX_SIZE; i++) {
+        stream.push_back(decompressed.size() >> (8U * i));
+    }
+    // Remaining bits of the last byte are zero padding, the same as written by the heatshrink encoder
+    for (size_t bit = 0U; bit < bits.size(); bit += 8U) {
+        uint8_t byte = 0U;
+        for (size_t i = 0U; i < 8U; i++) {
+            byte = (byte << 1U) | (bit + i < bits.size() && bits[bit + i] ? 1U : 0U);
+        }
+        stream.push_back(byte);
+    }
+    return stream;
+}
+
+/// @brief Decompresses the given bitstream, writing it in randomly sized parts
+/// @param rng Random number generator
+/// @param stream Bitstream that should be decompressed
+/// @param window_bits Base two logarithm of the window size
+/// @param lookahead_bits Base two logarithm of the lookahead size
+/// @param target_checksum Expected checksum of the decompressed firmware binary
+/// @param decompressed Firmware binary the updater wrote
+/// @param target_reset Whether the updater the firmware binary is decompressed into has been reset
+/// @return Whether decompressing the bitstream and verifying the checksum succeeded
+static bool Decompress(std::mt19937 & rng, std::vector<uint8_t> & stream, uint8_t const & window_bits, uint8_t const & lookahead_bits, char const * target_checksum,
+  std::vector<uint8_t> & decompressed, bool & target_reset) {
+    Memory_Updater target;
+    Heatshrink_Updater<> updater(target, window_bits, lookahead_bits);
+    updater.Set_Target_Checksum(target_checksum, Checksum_Algorithm::CRC32);
+    if (!updater.begin(stream.size())) {
+        return false;
+    }
+    size_t offset = 0U;
+    while (offset < stream.size()) {
+        size_t length = rng() % 700U + 1U;
+        length = length < stream.size() - offset ? length : stream.size() - offset;
+        if (updater.write(stream.data() + offset, length) != length) {
+            return false;
+        }
+        offset += length;
+    }
+    bool const result = updater.end();
+    decompressed = target.Get_Data();
+    target_reset = target.Was_Reset();
+    return result;
+}
+
+int main() {
+    std::mt19937 rng(34U);
+    size_t failures = 0U;
+    for (size_t iteration = 0U; iteration < TEST_ITERATIONS; iteration++) {
+        uint8_t const window_bits = HEATSHRINK_MIN_WINDOW_BITS + rng() % (HEATSHRINK_MAX_WINDOW_BITS - HEATSHRINK_MIN_WINDOW_BITS + 1U);
+        uint8_t const lookahead_bits = HEATSHRINK_MIN_LOOKAHEAD_BITS + rng() % (window_bits - HEATSHRINK_MIN_LOOKAHEAD_BITS);
+        std::vector<uint8_t> expected = {};
+        std::vector<uint8_t> stream = Create_Stream(rng, window_bits, lookahead_bits, expected);
+        HashGenerator hash;
+        (void)hash.start(Checksum_Algorithm::CRC32);
+        (void)hash.update(expected.data(), expected.size());
+        char expected_checksum[FIRMWARE_HASH_SIZE] = {};
+        (void)hash.finish(expected_checksum);
+
+        std::vector<uint8_t> decompressed = {};
+        bool target_reset = false;
+        if (!Decompress(rng, stream, window_bits, lookahead_bits, expected_checksum, decompressed, target_reset) || decompressed != expected || target_reset) {
+            printf("Iteration (%zu) with window bits (%u) and lookahead bits (%u) did not decompress the firmware binary\n", iteration, window_bits, lookahead_bits);
+            failures++;
+        }
+
+        // Truncated bitstreams and firmware binaries with a different checksum have to be rejected
+        std::vector<uint8_t> truncated(stream.begin(), stream.end() - 1);
+        if (Decompress(rng, truncated, window_bits, lookahead_bits, expected_checksum, decompressed, target_reset)) {
+            printf("Iteration (%zu) accepted a truncated bitstream\n", iteration);
+            failures++;
+        }
+        char const wrong_checksum[] = "00000000";
+        if (Decompress(rng, stream, window_bits, lookahead_bits, wrong_checksum, decompressed, target_reset)) {
+            printf("Iteration (%zu) accepted a firmware binary with a different checksum\n", iteration);
+            failures++;
+        }
+        // Rejected firmware binary must not be left behind in the wrapped updater, for example as an open OTA partition
+        else if (!target_reset) {
+            printf("Iteration (%zu) did not reset the wrapped updater after the checksum did not match\n", iteration);
+            failures++;
+        }
+    }
+    printf("%zu failures in %zu iterations\n", failures, TEST_ITERATIONS);
+    return failures == 0U ? 0 : 1;
+}
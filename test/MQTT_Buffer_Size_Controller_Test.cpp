@@ -0,0 +1,171 @@
+// Observes random message sizes with an MQTT_Buffer_Size_Controller and compares the desired buffer sizes against the documented growth and shrink rules,
+// both directly and through a ThingsBoard client connected to the Loopback_MQTT_Broker with a network client that fails to allocate big buffers.
+// Covers growing to the next power of two as soon as a message does not fit, shrinking only once a complete window of messages fit into a quarter of the buffer,
+// the sizes passed to setBufferSize() being the lower bound of the adaptive sizes, and a failed allocation only being retried once the desired sizes change instead of on every loop
+
+// Local includes.
+#include "Loopback_MQTT_Client.h"
+#include "MQTT_Buffer_Size_Controller.h"
+#include "ThingsBoard.h"
+
+// Library includes.
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+
+// Amount of random messages observed while checking the growth of the buffers
+constexpr size_t TEST_MESSAGES = 500U;
+// Bounds of the adaptive buffer sizes
+constexpr uint16_t MINIMUM_BUFFER_SIZE = 256U;
+constexpr uint16_t MAXIMUM_BUFFER_SIZE = 8192U;
+// Sizes passed to setBufferSize(), which are the lower bound of the adaptive sizes
+constexpr uint16_t REQUESTED_RECEIVE_SIZE = 2048U;
+constexpr uint16_t REQUESTED_SEND_SIZE = 1024U;
+// Size of the message that grows the buffer before it is shrunk again, and of the messages that fit into a quarter of the grown buffer
+constexpr size_t BIG_MESSAGE_SIZE = 3000U;
+constexpr size_t SMALL_MESSAGE_SIZE = 100U;
+// Biggest buffer the network client is able to allocate, allocating bigger buffers fails and keeps the previous buffers
+constexpr uint16_t ALLOCATABLE_BUFFER_SIZE = 1024U;
+// Amount of calls to loop() after the failed allocation, during which the allocation may not be retried
+constexpr size_t TEST_LOOPS = 20U;
+
+
+/// @brief Loopback client that fails to allocate buffers bigger than the given size and counts how often allocating buffers has been attempted
+class Limited_MQTT_Client : public Loopback_MQTT_Client<> {
+  public:
+    /// @brief Constructor
+    /// @param broker Broker the client connects to
+    /// @param allocatable_size Biggest buffer size that can be allocated
+    Limited_MQTT_Client(Loopback_MQTT_Broker & broker, uint16_t const & allocatable_size)
+      : Loopback_MQTT_Client<>(broker)
+      , m_allocatable_size(allocatable_size)
+      , m_allocations(0U)
+    {
+        // Nothing to do
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        m_allocations++;
+        if (receive_buffer_size > m_allocatable_size || send_buffer_size > m_allocatable_size) {
+            return false;
+        }
+        return Loopback_MQTT_Client<>::set_buffer_size(receive_buffer_size, send_buffer_size);
+    }
+
+    size_t Get_Allocations() const {
+        return m_allocations;
+    }
+
+  private:
+    uint16_t m_allocatable_size = {}; // Biggest buffer size that can be allocated
+    size_t   m_allocations = {};      // Amount of attempts to allocate buffers
+};
+
+
+/// @brief Rounds the given value up to the next power of two, capped at the maximum buffer size
+/// @param value Value that should be rounded
+/// @return Smallest power of two that is bigger or equal to the given value, or the maximum buffer size if that is smaller
+static size_t Round_Up_Power_Of_Two(size_t const & value) {
+    size_t power = 1U;
+    while (power < value) {
+        power *= 2U;
+    }
+    return power < MAXIMUM_BUFFER_SIZE ? power : MAXIMUM_BUFFER_SIZE;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(48U);
+    std::uniform_int_distribution<size_t> size_distribution(0U, MAXIMUM_BUFFER_SIZE);
+    size_t failures = 0U;
+
+    // Buffer grows to the next power of two that fits the message including its overhead, as soon as a message does not fit, but never above the maximum
+    MQTT_Buffer_Size_Controller controller;
+    controller.Start(MINIMUM_BUFFER_SIZE, MAXIMUM_BUFFER_SIZE);
+    size_t expected_size = MINIMUM_BUFFER_SIZE;
+    bool grown = true;
+    for (size_t message = 0U; message < TEST_MESSAGES; message++) {
+        size_t const size = size_distribution(random);
+        controller.Message_Received(size);
+        if (size + BUFFER_SIZE_MESSAGE_OVERHEAD > expected_size) {
+            expected_size = Round_Up_Power_Of_Two(size + BUFFER_SIZE_MESSAGE_OVERHEAD);
+        }
+        grown = grown && controller.Get_Desired_Receive_Size() == expected_size;
+    }
+    Check(grown && expected_size == MAXIMUM_BUFFER_SIZE, "growing to the next power of two that fits the message, capped at the maximum", failures);
+    Check(controller.Get_Desired_Send_Size() == MINIMUM_BUFFER_SIZE, "growing only the buffer the messages are handled with", failures);
+
+    // Buffer is only shrunk once a complete window of messages fit into a quarter of it, and then to twice the biggest message of that window
+    controller.Start(MINIMUM_BUFFER_SIZE, MAXIMUM_BUFFER_SIZE);
+    controller.Message_Sent(BIG_MESSAGE_SIZE);
+    size_t const grown_size = Round_Up_Power_Of_Two(BIG_MESSAGE_SIZE + BUFFER_SIZE_MESSAGE_OVERHEAD);
+    for (uint16_t message = 1U; message < BUFFER_SIZE_SHRINK_WINDOW; message++) {
+        controller.Message_Sent(message == 1U ? (grown_size / 4U) : SMALL_MESSAGE_SIZE);
+    }
+    Check(controller.Get_Desired_Send_Size() == grown_size, "keeping the size until the window is complete", failures);
+    controller.Message_Sent(SMALL_MESSAGE_SIZE);
+    Check(controller.Get_Desired_Send_Size() == grown_size, "keeping the size if a message of the window did not fit into a quarter of the buffer", failures);
+    for (uint16_t message = 1U; message < BUFFER_SIZE_SHRINK_WINDOW; message++) {
+        controller.Message_Sent(SMALL_MESSAGE_SIZE);
+    }
+    Check(controller.Get_Desired_Send_Size() == grown_size, "shrinking only after a complete window", failures);
+    controller.Message_Sent(SMALL_MESSAGE_SIZE);
+    size_t const shrunk_size = Round_Up_Power_Of_Two((SMALL_MESSAGE_SIZE + BUFFER_SIZE_MESSAGE_OVERHEAD) * 2U);
+    Check(controller.Get_Desired_Send_Size() == (shrunk_size > MINIMUM_BUFFER_SIZE ? shrunk_size : MINIMUM_BUFFER_SIZE),
+      "shrinking to twice the biggest message of the window once it fit into a quarter of the buffer", failures);
+
+    // Requested sizes are the lower bound of the adaptive sizes and are restored unchanged once adaptive sizing is disabled
+    controller.Set_Requested_Sizes(REQUESTED_RECEIVE_SIZE, REQUESTED_SEND_SIZE);
+    Check(controller.Get_Desired_Receive_Size() == REQUESTED_RECEIVE_SIZE && controller.Get_Desired_Send_Size() == REQUESTED_SEND_SIZE,
+      "never desiring less than the requested sizes", failures);
+    controller.Message_Received(BIG_MESSAGE_SIZE);
+    Check(controller.Get_Desired_Receive_Size() == grown_size, "growing above the requested size", failures);
+    controller.Stop();
+    Check(controller.Get_Desired_Receive_Size() == REQUESTED_RECEIVE_SIZE && controller.Get_Desired_Send_Size() == REQUESTED_SEND_SIZE,
+      "restoring the requested sizes once adaptive sizing is disabled", failures);
+
+    // Failed allocation keeps the previous sizes and is only retried once the desired sizes change
+    controller.Start(MINIMUM_BUFFER_SIZE, MAXIMUM_BUFFER_SIZE);
+    controller.Set_Requested_Sizes(MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE);
+    controller.Sizes_Applied(MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE);
+    controller.Message_Received(BIG_MESSAGE_SIZE);
+    Check(controller.Resize_Pending() && !controller.Send_Growth_Pending(), "requiring a resize of only the receive buffer", failures);
+    controller.Sizes_Applied(controller.Get_Desired_Receive_Size(), controller.Get_Desired_Send_Size(), MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE);
+    Check(!controller.Resize_Pending() && controller.Get_Receive_Size() == MINIMUM_BUFFER_SIZE, "not retrying the failed allocation while the desired sizes are the same", failures);
+    controller.Message_Received(MAXIMUM_BUFFER_SIZE);
+    Check(controller.Resize_Pending(), "retrying the allocation once the desired sizes changed", failures);
+
+    // Same through the ThingsBoard client, where every pending resize is applied in loop()
+    Loopback_MQTT_Broker broker;
+    Limited_MQTT_Client client(broker, ALLOCATABLE_BUFFER_SIZE);
+    ThingsBoard tb(client, MINIMUM_BUFFER_SIZE, MINIMUM_BUFFER_SIZE);
+    Check(tb.connect("localhost", "token"), "connecting to the loopback broker", failures);
+    Check(tb.setBufferSize(ALLOCATABLE_BUFFER_SIZE, MINIMUM_BUFFER_SIZE), "requesting the lower bound of the buffer sizes", failures);
+    tb.setAdaptiveBufferSize(true, MINIMUM_BUFFER_SIZE, MAXIMUM_BUFFER_SIZE);
+    Check(tb.getCurrentReceiveBufferSize() == ALLOCATABLE_BUFFER_SIZE && tb.getCurrentSendBufferSize() == MINIMUM_BUFFER_SIZE,
+      "applying the sizes passed to setBufferSize() as the lower bound", failures);
+    std::string const big_json = "{\"value\":\"" + std::string(BIG_MESSAGE_SIZE, 'a') + "\"}";
+    size_t const allocations = client.Get_Allocations();
+    Check(!tb.sendTelemetryString(big_json.c_str()), "failing to send a message that does not fit into the allocatable buffer", failures);
+    Check(client.Get_Allocations() == allocations + 1U && tb.getCurrentSendBufferSize() == MINIMUM_BUFFER_SIZE, "keeping the previous buffers if allocating failed", failures);
+    for (size_t loop = 0U; loop < TEST_LOOPS; loop++) {
+        (void)tb.loop();
+    }
+    Check(client.Get_Allocations() == allocations + 1U, "not retrying the failed allocation on every loop", failures);
+    Check(tb.sendTelemetryString("{\"value\":1}") && client.Get_Allocations() == allocations + 1U, "sending small messages with the previous buffers", failures);
+
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+// Shares the connection of one Loopback_MQTT_Client between two Multiplexed_MQTT_Client channels and checks which channel receives which message of the Loopback_MQTT_Broker.
+// Covers topics subscribed by both channels, which are only subscribed once on the broker and only unsubscribed once neither channel needs them anymore,
+// and responses to requests both channels published with the same request id, which have to be routed only to the channel that published the request
+
+// Local includes.
+#include "Loopback_MQTT_Client.h"
+#include "MQTT_Client_Multiplexer.h"
+#include "Multiplexed_MQTT_Client.h"
+
+// Library includes.
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+// Topic both channels subscribe and the server publishes on
+constexpr char SHARED_TOPIC[] = "v1/devices/me/attributes";
+// Request and response topics of the attribute request, the same as used by the ThingsBoard client
+constexpr char REQUEST_TOPIC[] = "v1/devices/me/attributes/request/1";
+constexpr char REQUEST_FILTER[] = "v1/devices/me/attributes/request/+";
+constexpr char RESPONSE_FILTER[] = "v1/devices/me/attributes/response/+";
+constexpr char RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/1";
+// Request topic without a request id, the response of which is routed to every subscribed channel
+constexpr char PROVISION_REQUEST_TOPIC[] = "/provision/request";
+constexpr char PROVISION_RESPONSE_TOPIC[] = "/provision/response";
+
+
+/// @brief Loopback client that counts the subscriptions and unsubscriptions sent to the broker
+class Counting_MQTT_Client : public Loopback_MQTT_Client<> {
+  public:
+    explicit Counting_MQTT_Client(Loopback_MQTT_Broker & broker)
+      : Loopback_MQTT_Client<>(broker)
+    {
+        // Nothing to do
+    }
+
+    bool subscribe(char const * topic) override {
+        m_subscribes++;
+        return Loopback_MQTT_Client<>::subscribe(topic);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        m_unsubscribes++;
+        return Loopback_MQTT_Client<>::unsubscribe(topic);
+    }
+
+    size_t Get_Subscribes() const {
+        return m_subscribes;
+    }
+
+    size_t Get_Unsubscribes() const {
+        return m_unsubscribes;
+    }
+
+  private:
+    size_t m_subscribes = {};   // Amount of topic filters subscribed on the broker
+    size_t m_unsubscribes = {}; // Amount of topic filters unsubscribed on the broker
+};
+
+/// @brief Message received by a channel
+struct Received_Message {
+    std::string topic;   // Topic the message was received over
+    std::string payload; // Payload of the message
+};
+
+
+/// @brief Registers the data callback at the given channel, which appends every received message to the given list
+/// @param channel Channel whose messages should be recorded
+/// @param received List the received messages are appended to
+static void Record_Messages(Multiplexed_MQTT_Client & channel, std::vector<Received_Message> & received) {
+    channel.set_data_callback([&received](char * topic, uint8_t * payload, unsigned int length) {
+        received.push_back({ topic, std::string(reinterpret_cast<char const *>(payload), length) });
+    });
+}
+
+/// @brief Publishes the given payload on the given topic over the given channel
+/// @param channel Channel that should publish the message
+/// @param topic Topic the message should be published on
+/// @param payload Null terminated payload of the message
+/// @return Whether the message was published
+static bool Publish(Multiplexed_MQTT_Client & channel, char const * topic, char const * payload) {
+    return channel.publish(topic, reinterpret_cast<uint8_t const *>(payload), strlen(payload));
+}
+
+/// @brief Whether the given list contains exactly one message, received over the given topic with the given payload, and clears the list afterwards
+/// @param received List of received messages
+/// @param topic Expected topic of the message
+/// @param payload Expected payload of the message
+/// @return Whether exactly the expected message was received
+static bool Received_Only(std::vector<Received_Message> & received, char const * topic, char const * payload) {
+    bool const result = received.size() == 1U && received.front().topic == topic && received.front().payload == payload;
+    received.clear();
+    return result;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    size_t failures = 0U;
+    Loopback_MQTT_Broker broker;
+    // Server answers every request on the response topic with the same request id level, only to the session that published the request, the same as ThingsBoard.
+    // The payload is the request payload, which allows to check that the response is routed to the channel that published the request
+    std::vector<std::string> request_topics = {};
+    size_t const request_handler = broker.Add_Handler(REQUEST_FILTER, [&](size_t sender, String_View const & topic, uint8_t * payload, size_t length) {
+        std::string response_topic(topic.data(), topic.size());
+        request_topics.push_back(response_topic);
+        response_topic.replace(response_topic.find("request"), sizeof("request") - 1U, "response");
+        (void)broker.Send(sender, response_topic.c_str(), payload, length);
+    });
+    size_t const provision_handler = broker.Add_Handler(PROVISION_REQUEST_TOPIC, [&](size_t sender, String_View const & /*topic*/, uint8_t * payload, size_t length) {
+        (void)broker.Send(sender, PROVISION_RESPONSE_TOPIC, payload, length);
+    });
+
+    Counting_MQTT_Client client(broker);
+    MQTT_Client_Multiplexer multiplexer(client);
+    std::vector<Received_Message> first_received = {};
+    std::vector<Received_Message> second_received = {};
+    {
+        Multiplexed_MQTT_Client first(multiplexer);
+        Multiplexed_MQTT_Client second(multiplexer);
+        Record_Messages(first, first_received);
+        Record_Messages(second, second_received);
+        Check(first.Get_Request_Id_Slot() != second.Get_Request_Id_Slot(), "assigning disjoint request id spaces", failures);
+        Check(first.connect("client", "token", nullptr) && second.connect("client", "token", nullptr) && client.connected(), "connecting both channels over the shared connection", failures);
+
+        // Topic filter subscribed by both channels is only subscribed once on the broker, but every message is passed to both channels
+        Check(first.subscribe(SHARED_TOPIC) && second.subscribe(SHARED_TOPIC) && client.Get_Subscribes() == 1U, "subscribing the shared topic once", failures);
+        Check(broker.Publish(Loopback_MQTT_Broker::SERVER_SESSION, SHARED_TOPIC, reinterpret_cast<uint8_t const *>("{}"), 2U), "publishing on the shared topic", failures);
+        (void)first.loop();
+        Check(Received_Only(first_received, SHARED_TOPIC, "{}") && Received_Only(second_received, SHARED_TOPIC, "{}"), "passing the shared topic to both channels", failures);
+
+        // Both channels publish a request with the same request id, the server receives two different ids and each response is only passed to the channel that published the request
+        Check(first.subscribe(RESPONSE_FILTER) && second.subscribe(RESPONSE_FILTER) && client.Get_Subscribes() == 2U, "subscribing the response topic once", failures);
+        Check(Publish(first, REQUEST_TOPIC, "first") && Publish(second, REQUEST_TOPIC, "second"), "publishing both requests", failures);
+        (void)second.loop();
+        Check(request_topics.size() == 2U && request_topics[0U] != request_topics[1U] && request_topics[0U] != REQUEST_TOPIC, "translating the request ids into disjoint request ids", failures);
+        Check(Received_Only(first_received, RESPONSE_TOPIC, "first") && Received_Only(second_received, RESPONSE_TOPIC, "second"), "routing each response only to the channel that published the request", failures);
+
+        // Responses are routed by their request id, not by the order the requests were published in
+        request_topics.clear();
+        Check(Publish(second, REQUEST_TOPIC, "second") && Publish(first, REQUEST_TOPIC, "first"), "publishing both requests in the reversed order", failures);
+        (void)first.loop();
+        Check(Received_Only(first_received, RESPONSE_TOPIC, "first") && Received_Only(second_received, RESPONSE_TOPIC, "second"), "routing the responses independent of the request order", failures);
+
+        // Requests without a request id are answered to every channel subscribed to the response topic
+        Check(first.subscribe(PROVISION_RESPONSE_TOPIC) && Publish(first, PROVISION_REQUEST_TOPIC, "provision"), "publishing a request without a request id", failures);
+        (void)first.loop();
+        Check(Received_Only(first_received, PROVISION_RESPONSE_TOPIC, "provision") && second_received.empty(), "passing the response without a request id to the subscribed channel", failures);
+        Check(first.unsubscribe(PROVISION_RESPONSE_TOPIC), "unsubscribing the response topic without a request id", failures);
+
+        // Topic filter is only unsubscribed on the broker once the last channel released it, until then the remaining channel still receives its messages
+        size_t const unsubscribes = client.Get_Unsubscribes();
+        Check(first.unsubscribe(SHARED_TOPIC) && client.Get_Unsubscribes() == unsubscribes, "keeping the shared topic subscribed for the second channel", failures);
+        (void)broker.Publish(Loopback_MQTT_Broker::SERVER_SESSION, SHARED_TOPIC, reinterpret_cast<uint8_t const *>("{}"), 2U);
+        (void)first.loop();
+        Check(first_received.empty() && Received_Only(second_received, SHARED_TOPIC, "{}"), "passing the shared topic only to the channel still subscribed to it", failures);
+        Check(second.unsubscribe(SHARED_TOPIC) && client.Get_Unsubscribes() == unsubscribes + 1U, "unsubscribing the shared topic with the last channel", failures);
+        size_t const delivered = broker.Get_Delivered_Messages();
+        (void)broker.Publish(Loopback_MQTT_Broker::SERVER_SESSION, SHARED_TOPIC, reinterpret_cast<uint8_t const *>("{}"), 2U);
+        (void)first.loop();
+        Check(first_received.empty() && second_received.empty() && broker.Get_Delivered_Messages() == delivered, "not receiving the unsubscribed topic anymore", failures);
+
+        // Response to a channel that has been destroyed in the meantime is not passed to the remaining channel, even though it is still subscribed to the response topic
+        {
+            Multiplexed_MQTT_Client third(multiplexer);
+            std::vector<Received_Message> third_received = {};
+            Record_Messages(third, third_received);
+            Check(third.Get_Request_Id_Slot() != first.Get_Request_Id_Slot() && third.Get_Request_Id_Slot() != second.Get_Request_Id_Slot(), "assigning a free request id space to the third channel", failures);
+            Check(third.connect("client", "token", nullptr) && third.subscribe(RESPONSE_FILTER) && Publish(third, REQUEST_TOPIC, "third"), "publishing the request of the third channel", failures);
+        }
+        size_t const unrouted = multiplexer.Get_Unrouted_Messages();
+        (void)first.loop();
+        Check(first_received.empty() && second_received.empty() && multiplexer.Get_Unrouted_Messages() == unrouted + 1U, "discarding the response to the destroyed channel", failures);
+    }
+    // Destroying the last channels releases all their subscriptions and closes the shared connection
+    Check(!client.connected() && multiplexer.Get_Channels() == 0U, "closing the connection once no channel needs it anymore", failures);
+
+    broker.Remove_Handler(request_handler);
+    broker.Remove_Handler(provision_handler);
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Drives the OTA_Chunk_Size_Controller the same way the OTA_Handler does, one chunk at a time with a simulated round trip time, with random bounds and initial chunk sizes.
+// Covers the chunk size always being a power of two within the rounded bounds, the offset of every requested chunk being a multiple of the chunk size it is requested with,
+// doubling up to the maximum on a fast connection, halving after a request timed out and never growing again once the chunk size has been decreased
+
+// Local includes.
+#include "Helper.h"
+#include "OTA_Chunk_Size_Controller.h"
+
+// Library includes.
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <thread>
+#include <utility>
+
+
+// Amount of random configurations of the bounds and the initial chunk size
+constexpr size_t TEST_ITERATIONS = 20U;
+// Range the bounds and the initial chunk size are chosen from
+constexpr size_t MIN_CONFIGURED_SIZE = 100U;
+constexpr size_t MAX_CONFIGURED_SIZE = 20000U;
+// Timeout in microseconds after which a requested chunk counts as lost
+constexpr uint64_t REQUEST_TIMEOUT_US = 200000U;
+// Simulated round trip time in microseconds of every chunk request, far below the timeout
+constexpr uint64_t ROUND_TRIP_TIME_US = 200U;
+// Maximum amount of chunks requested with the controller before it has to have reached the maximum chunk size
+constexpr size_t MAX_GROWTH_CHUNKS = 200U;
+// Amount of chunks requested after the chunk size has been decreased, during which it may not grow again
+constexpr size_t SHRUNK_CHUNKS = 40U;
+// Maximum amount of outstanding chunks, used to estimate the heap memory a bigger chunk size requires
+constexpr size_t REQUEST_WINDOW = 1U;
+
+
+/// @brief Whether the given value is a power of two
+/// @param value Value that should be checked
+/// @return Whether exactly one bit is set in the value
+static bool Is_Power_Of_Two(size_t const & value) {
+    return value != 0U && (value & (value - 1U)) == 0U;
+}
+
+/// @brief Rounds the given value down to the next power of two, the same as the controller rounds its bounds
+/// @param value Value that should be rounded, has to be bigger than 0
+/// @return Biggest power of two that is smaller or equal to the given value
+static size_t Round_Down_Power_Of_Two(size_t const & value) {
+    size_t power = 1U;
+    while (power * 2U <= value) {
+        power *= 2U;
+    }
+    return power;
+}
+
+/// @brief Changes the chunk size to the desired one and requests, receives and writes the chunk at the given offset, the same as the OTA_Handler does with a request window of one
+/// @param controller Controller deciding on the chunk size
+/// @param offset Byte offset of the chunk, increased by the size of the chunk
+/// @param minimum_chunk_size Rounded minimum chunk size, the chunk size may never be below it
+/// @param maximum_chunk_size Rounded maximum chunk size, the chunk size may never be above it
+/// @return Whether the chunk size is a power of two within the bounds and the offset is a multiple of it
+static bool Transfer_Chunk(OTA_Chunk_Size_Controller & controller, size_t & offset, size_t const & minimum_chunk_size, size_t const & maximum_chunk_size) {
+    size_t const desired_chunk_size = controller.Get_Desired_Chunk_Size(offset, REQUEST_WINDOW);
+    if (desired_chunk_size != controller.Get_Chunk_Size()) {
+        controller.Set_Chunk_Size(desired_chunk_size);
+    }
+    size_t const chunk_size = controller.Get_Chunk_Size();
+    bool const valid = Is_Power_Of_Two(chunk_size) && chunk_size >= minimum_chunk_size && chunk_size <= maximum_chunk_size && (offset % chunk_size) == 0U;
+    controller.Chunk_Requested(offset);
+    std::this_thread::sleep_for(std::chrono::microseconds(ROUND_TRIP_TIME_US));
+    controller.Chunk_Received(offset);
+    controller.Chunk_Written(chunk_size);
+    offset += chunk_size;
+    return valid;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param iteration Iteration the check was run in
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t const & iteration, size_t & failures) {
+    if (!passed) {
+        printf("Check failed in iteration (%zu): %s\n", iteration, message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(29U);
+    std::uniform_int_distribution<size_t> size_distribution(MIN_CONFIGURED_SIZE, MAX_CONFIGURED_SIZE);
+    size_t failures = 0U;
+
+    // Disabled controller keeps the configured chunk size unchanged, even if it is not a power of two and requests time out
+    OTA_Chunk_Size_Controller disabled;
+    disabled.Start(1000U, 0U, 0U, REQUEST_TIMEOUT_US);
+    disabled.Request_Timed_Out();
+    Check(!disabled.Is_Adaptive() && disabled.Get_Chunk_Size() == 1000U && disabled.Get_Desired_Chunk_Size(0U, REQUEST_WINDOW) == 1000U,
+      "keeping the configured chunk size if adaptive sizing is disabled", 0U, failures);
+    disabled.Start(1000U, 4096U, 4096U, REQUEST_TIMEOUT_US);
+    Check(!disabled.Is_Adaptive() && disabled.Get_Chunk_Size() == 1000U, "disabling adaptive sizing if the rounded bounds are the same", 0U, failures);
+
+    for (size_t iteration = 1U; iteration <= TEST_ITERATIONS; iteration++) {
+        size_t minimum = size_distribution(random);
+        size_t maximum = size_distribution(random);
+        if (minimum > maximum) {
+            std::swap(minimum, maximum);
+        }
+        // Bounds that round down to the same power of two would disable adaptive sizing
+        size_t const minimum_chunk_size = Round_Down_Power_Of_Two(minimum);
+        if (Round_Down_Power_Of_Two(maximum) == minimum_chunk_size) {
+            maximum *= 2U;
+        }
+        size_t const rounded_maximum = Round_Down_Power_Of_Two(maximum);
+        size_t const configured_chunk_size = size_distribution(random);
+
+        // Initial chunk size is the configured one clamped to the bounds and rounded down to a power of two
+        OTA_Chunk_Size_Controller controller;
+        controller.Start(configured_chunk_size, minimum, maximum, REQUEST_TIMEOUT_US);
+        size_t const initial_chunk_size = controller.Get_Chunk_Size();
+        Check(controller.Is_Adaptive() && Is_Power_Of_Two(initial_chunk_size) && initial_chunk_size >= minimum_chunk_size && initial_chunk_size <= rounded_maximum,
+          "starting with a power of two within the rounded bounds", iteration, failures);
+
+        // Fast connection doubles the chunk size up to the maximum, every offset stays a multiple of the chunk size it is requested with
+        size_t offset = 0U;
+        bool valid = true;
+        for (size_t chunk = 0U; chunk < MAX_GROWTH_CHUNKS && controller.Get_Chunk_Size() < rounded_maximum; chunk++) {
+            valid = Transfer_Chunk(controller, offset, minimum_chunk_size, rounded_maximum) && valid;
+        }
+        Check(valid, "keeping the chunk size a power of two within the bounds and aligned to the offset while growing", iteration, failures);
+        Check(controller.Get_Chunk_Size() == rounded_maximum, "growing up to the maximum chunk size", iteration, failures);
+
+        // Timeout halves the chunk size with the next change and the chunk size never grows again, even though the connection is fast again
+        controller.Request_Timed_Out();
+        size_t const halved_chunk_size = controller.Get_Desired_Chunk_Size(offset, REQUEST_WINDOW);
+        Check(halved_chunk_size == rounded_maximum / 2U, "halving the chunk size after a request timed out", iteration, failures);
+        for (size_t chunk = 0U; chunk < SHRUNK_CHUNKS; chunk++) {
+            valid = Transfer_Chunk(controller, offset, minimum_chunk_size, halved_chunk_size) && valid;
+        }
+        Check(valid && controller.Get_Chunk_Size() == halved_chunk_size, "never growing again after the chunk size has been decreased", iteration, failures);
+
+        // Repeated timeouts halve the chunk size down to the minimum, but never below it
+        for (size_t chunk = 0U; chunk < SHRUNK_CHUNKS; chunk++) {
+            controller.Request_Timed_Out();
+            valid = Transfer_Chunk(controller, offset, minimum_chunk_size, halved_chunk_size) && valid;
+        }
+        Check(valid && controller.Get_Chunk_Size() == minimum_chunk_size, "halving down to the minimum chunk size on repeated timeouts", iteration, failures);
+
+        // Resuming at an offset that is only a multiple of the minimum chunk size decreases the chunk size until the offset is aligned to it
+        OTA_Chunk_Size_Controller resumed;
+        resumed.Start(rounded_maximum, minimum, maximum, REQUEST_TIMEOUT_US);
+        Check(resumed.Align_Chunk_Size(minimum_chunk_size * 3U) && resumed.Get_Chunk_Size() == minimum_chunk_size, "aligning the chunk size to the resumed offset", iteration, failures);
+        Check(!resumed.Align_Chunk_Size(minimum_chunk_size + 1U), "rejecting a resumed offset that is not a multiple of the minimum chunk size", iteration, failures);
+    }
+    printf("%zu failures in %zu iterations\n", failures, TEST_ITERATIONS);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+// Downloads a firmware binary from the ThingsBoard_Emulator, which serves one corrupted chunk the first time it is requested, while OTA_Firmware_Update verifies every chunk with its CRC32.
+// Covers a corrupted chunk received as a single message, which has to be requested again on its own without rewinding anything, no matter if one or multiple chunks are requested at once,
+// and a corrupted chunk received in fragments, which has already been written and therefore has to rewind the update to the last checkpointed block with Rewind_Firmware_Update,
+// so only the chunks after that checkpoint are requested again. The checksum of the complete firmware binary has to match in the end in every case
+
+// Local includes.
+#include "Attribute_Request.h"
+#include "HashGenerator.h"
+#include "Loopback_MQTT_Client.h"
+#include "OTA_Firmware_Update.h"
+#include "ThingsBoard.h"
+#include "ThingsBoard_Emulator.h"
+
+// Library includes.
+#include <array>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+// Time in microseconds until the client requests the outstanding chunks again, long enough to never expire, because no message is lost
+constexpr uint64_t REQUEST_TIMEOUT_US = 2000000U;
+// Time in microseconds a complete update may take at most, before it is considered as failed
+constexpr uint64_t UPDATE_TIMEOUT_US = 10000000U;
+// Receive and send buffer size of the client, if every chunk is received as a single message or if the chunks are received in fragments
+constexpr uint16_t WHOLE_CHUNK_BUFFER_SIZE = 2048U;
+constexpr uint16_t FRAGMENTED_CHUNK_BUFFER_SIZE = 512U;
+// Identifier of the emulated device, used in the topics of the firmware chunks
+constexpr char DEVICE_ID[] = "Loopback_Device";
+// Title and version of the firmware the device is currently running, and version of the firmware served by the emulator
+constexpr char FIRMWARE_TITLE[] = "loopback";
+constexpr char CURRENT_VERSION[] = "1.0.0";
+constexpr char UPDATED_VERSION[] = "1.1.0";
+// Size of the served firmware binary and of the chunks it is downloaded in
+constexpr size_t FIRMWARE_SIZE = 16384U;
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 1024U;
+constexpr size_t FIRMWARE_CHUNKS = FIRMWARE_SIZE / FIRMWARE_CHUNK_SIZE;
+// Amount of times a single chunk is requested again before the update fails
+constexpr uint8_t FIRMWARE_CHUNK_RETRIES = 3U;
+// Amount of chunks requested at once, if a single or multiple chunks are requested at once
+constexpr uint8_t SINGLE_REQUEST_WINDOW = 1U;
+constexpr uint8_t MULTIPLE_REQUEST_WINDOW = 4U;
+// Amount of bytes written between two checkpoints of the hash state
+constexpr size_t FIRMWARE_CHECKPOINT_INTERVAL = 2U * FIRMWARE_CHUNK_SIZE;
+// Index of the chunk that is corrupted the first time it is served
+constexpr size_t CORRUPT_CHUNK = 5U;
+// Checkpoint the update is rewound to, the last multiple of the checkpoint interval before the corrupted chunk
+constexpr size_t REWIND_OFFSET = ((CORRUPT_CHUNK * FIRMWARE_CHUNK_SIZE) / FIRMWARE_CHECKPOINT_INTERVAL) * FIRMWARE_CHECKPOINT_INTERVAL;
+
+
+/// @brief Updater that keeps the written firmware binary in memory and supports resuming after already written bytes
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    bool resume(size_t const & firmware_size, size_t const & offset) override {
+        if (offset > m_data.size()) {
+            return false;
+        }
+        m_data.resize(offset);
+        m_size = firmware_size;
+        m_resumed_offsets.push_back(offset);
+        return true;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+    std::vector<size_t> const & Get_Resumed_Offsets() const {
+        return m_resumed_offsets;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {};            // Written firmware binary
+    size_t               m_size = {};            // Size of the firmware binary passed to begin()
+    std::vector<size_t>  m_resumed_offsets = {}; // Offsets the update has been resumed or rewound to
+};
+
+/// @brief Attribute request of the emulated device, implements the device identity the API implementations of this library require
+class Device_Attribute_Request : public Attribute_Request<1U, 2U> {
+  public:
+    char const * GetDeviceId() override {
+        return DEVICE_ID;
+    }
+
+    void SetDeviceId(char const * /*device_id*/) override {
+        // Nothing to do
+    }
+
+    char const * GetDeviceProfile() override {
+        return "";
+    }
+
+    void SetDeviceProfile(char const * /*device_profile*/) override {
+        // Nothing to do
+    }
+};
+
+/// @brief Result of a single firmware update
+struct Update_Result {
+    int                      result;   // 1 if the update succeeded, 0 if it failed and -1 if it did not finish before the update timeout expired
+    std::vector<uint8_t>     data;     // Firmware binary written into the updater
+    std::vector<size_t>      resumed;  // Offsets the updater has been rewound to
+    std::map<size_t, size_t> verified; // Amount of times every chunk has been verified, by byte offset
+    size_t                   requests; // Amount of firmware chunk requests answered by the emulator
+};
+
+
+/// @brief Downloads the given firmware binary from the emulator, which serves the corrupted chunk until it has been verified once
+/// @param buffer_size Receive and send buffer size of the client, chunks bigger than it are received in fragments
+/// @param request_window Amount of chunks requested at once
+/// @param firmware Firmware binary whose checksum is expected
+/// @param checksum SHA256 checksum of the firmware binary
+/// @return Result of the update
+static Update_Result Run_Update(uint16_t const & buffer_size, uint8_t const & request_window, std::vector<uint8_t> const & firmware, char const * checksum) {
+    std::vector<uint8_t> corrupted = firmware;
+    corrupted[(CORRUPT_CHUNK * FIRMWARE_CHUNK_SIZE) + (FIRMWARE_CHUNK_SIZE / 2U)] ^= 0xFFU;
+
+    Loopback_MQTT_Broker broker;
+    ThingsBoard_Emulator emulator(broker);
+    emulator.Set_Firmware(FIRMWARE_TITLE, UPDATED_VERSION, corrupted.data(), corrupted.size());
+    emulator.Set_Shared_Attribute(FW_TITLE_KEY, (std::string("\"") + FIRMWARE_TITLE + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_VER_KEY, (std::string("\"") + UPDATED_VERSION + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_KEY, (std::string("\"") + checksum + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_ALGO_KEY, (std::string("\"") + CHECKSUM_AGORITM_SHA256 + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_SIZE_KEY, std::to_string(firmware.size()).c_str());
+
+    Loopback_MQTT_Client<> client(broker);
+    OTA_Firmware_Update<> ota;
+    Device_Attribute_Request attribute_request;
+    std::array<IAPI_Implementation *, 2U> const apis = {&ota, &attribute_request};
+    ThingsBoardSized<> tb(client, buffer_size, buffer_size, Default_Max_Stack_Size, apis);
+    ota.SetDeviceId(DEVICE_ID);
+    Update_Result result = { -1, {}, {}, {}, 0U };
+    if (!tb.connect("localhost", "token")) {
+        return result;
+    }
+
+    Memory_Updater updater;
+    OTA_Update_Callback update_callback(FIRMWARE_TITLE, CURRENT_VERSION, &updater, [&](bool const & success) { result.result = success ? 1 : 0; },
+      nullptr, nullptr, FIRMWARE_CHUNK_RETRIES, FIRMWARE_CHUNK_SIZE, REQUEST_TIMEOUT_US);
+    update_callback.Set_Request_Window(request_window);
+    update_callback.Set_Checkpoint_Interval(FIRMWARE_CHECKPOINT_INTERVAL);
+    // Expected CRC32 is calculated over the intact firmware binary, the emulator serves the intact chunk once the corrupted one has been verified
+    update_callback.Set_Chunk_CRC_Callback([&](size_t const & offset, size_t const & length, uint32_t & expected_crc) {
+        if (result.verified[offset]++ == 0U && offset == CORRUPT_CHUNK * FIRMWARE_CHUNK_SIZE) {
+            emulator.Set_Firmware(FIRMWARE_TITLE, UPDATED_VERSION, firmware.data(), firmware.size());
+        }
+        expected_crc = Helper::calculateCRC32(firmware.data() + offset, length);
+        return true;
+    });
+    if (!ota.Start_Firmware_Update(update_callback)) {
+        return result;
+    }
+
+    uint64_t const start = Helper::getTimeMicroseconds();
+    while (result.result < 0 && Helper::getTimeMicroseconds() - start <= UPDATE_TIMEOUT_US) {
+        (void)tb.loop();
+    }
+    result.data = updater.Get_Data();
+    result.resumed = updater.Get_Resumed_Offsets();
+    result.requests = emulator.Get_Firmware_Chunk_Requests();
+    return result;
+}
+
+/// @brief Whether every chunk in the given range has been verified twice and every other chunk once
+/// @param result Result of the update
+/// @param first_repeated_chunk Index of the first chunk that had to be verified twice
+/// @param last_repeated_chunk Index of the last chunk that had to be verified twice
+/// @return Whether the chunks have been verified the expected amount of times
+static bool Verified_Again(Update_Result const & result, size_t const & first_repeated_chunk, size_t const & last_repeated_chunk) {
+    for (size_t chunk = 0U; chunk < FIRMWARE_CHUNKS; chunk++) {
+        auto const verified = result.verified.find(chunk * FIRMWARE_CHUNK_SIZE);
+        size_t const expected = (chunk >= first_repeated_chunk && chunk <= last_repeated_chunk) ? 2U : 1U;
+        if (verified == result.verified.cend() || verified->second != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (size_t i = 0U; i < firmware.size(); i++) {
+        firmware[i] = static_cast<uint8_t>((i * 13U) ^ (i >> 6U));
+    }
+    HashGenerator hash;
+    (void)hash.start(Checksum_Algorithm::SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    char checksum[FIRMWARE_HASH_SIZE] = {};
+    (void)hash.finish(checksum);
+
+    size_t failures = 0U;
+    // Corrupted chunk received as a single message is detected before it is written, therefore only it is requested again
+    Update_Result result = Run_Update(WHOLE_CHUNK_BUFFER_SIZE, SINGLE_REQUEST_WINDOW, firmware, checksum);
+    Check(result.result == 1 && result.data == firmware, "matching the checksum after requesting the corrupted chunk again", failures);
+    Check(result.requests == FIRMWARE_CHUNKS + 1U && Verified_Again(result, CORRUPT_CHUNK, CORRUPT_CHUNK) && result.resumed.empty(),
+      "requesting only the corrupted chunk again", failures);
+
+    // Same if the following chunks are already outstanding or buffered, while the corrupted chunk is requested again
+    result = Run_Update(WHOLE_CHUNK_BUFFER_SIZE, MULTIPLE_REQUEST_WINDOW, firmware, checksum);
+    Check(result.result == 1 && result.data == firmware, "matching the checksum after requesting the corrupted chunk again with multiple outstanding chunks", failures);
+    Check(result.requests == FIRMWARE_CHUNKS + 1U && Verified_Again(result, CORRUPT_CHUNK, CORRUPT_CHUNK) && result.resumed.empty(),
+      "requesting only the corrupted chunk again with multiple outstanding chunks", failures);
+
+    // Corrupted chunk received in fragments has already been written, therefore the update is rewound to the last checkpoint and only the chunks after it are requested again
+    result = Run_Update(FRAGMENTED_CHUNK_BUFFER_SIZE, SINGLE_REQUEST_WINDOW, firmware, checksum);
+    size_t const rewound_chunks = CORRUPT_CHUNK - (REWIND_OFFSET / FIRMWARE_CHUNK_SIZE) + 1U;
+    Check(result.result == 1 && result.data == firmware, "matching the checksum after rewinding the update", failures);
+    Check(result.resumed.size() == 1U && result.resumed.front() == REWIND_OFFSET, "rewinding the update to the last checkpoint before the corrupted chunk", failures);
+    Check(result.requests == FIRMWARE_CHUNKS + rewound_chunks && Verified_Again(result, REWIND_OFFSET / FIRMWARE_CHUNK_SIZE, CORRUPT_CHUNK),
+      "requesting only the chunks after the checkpoint again", failures);
+
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
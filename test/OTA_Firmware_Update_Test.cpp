@@ -0,0 +1,232 @@
+// Downloads a firmware binary chunk by chunk with OTA_Firmware_Update from the ThingsBoard_Emulator, while multiple chunks are requested at once.
+// Covers chunks that fail their CRC32 verification a few times each, which have to be retried with the retries of their own request slot instead of exhausting one shared counter,
+// a chunk that never passes its verification, which has to abort the update once its own retries are exhausted, even though the other chunks keep being written,
+// and the Loopback_MQTT_Broker losing and reordering messages, which has to be recovered from by the timeouts and retries of every outstanding chunk
+
+// Local includes.
+#include "Attribute_Request.h"
+#include "HashGenerator.h"
+#include "Loopback_MQTT_Client.h"
+#include "OTA_Firmware_Update.h"
+#include "ThingsBoard.h"
+#include "ThingsBoard_Emulator.h"
+
+// Library includes.
+#include <array>
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+// Amount of runs with a different seed of the broker, which decides the latency, loss and reordering of every message
+constexpr uint32_t TEST_SEEDS = 5U;
+// Latency in microseconds every message is delivered after, chosen uniformly between 0 and this value
+constexpr uint64_t MAX_LATENCY = 1000U;
+// Probability in percent of a message being lost
+constexpr uint8_t LOSS_PERCENT = 5U;
+// Probability in percent of a message being held back, so that following messages overtake it, and the time in microseconds it is held back for
+constexpr uint8_t REORDER_PERCENT = 30U;
+constexpr uint64_t REORDER_DELAY = 3000U;
+// Time in microseconds until the client requests the outstanding chunks again, if it did not receive any of them
+constexpr uint64_t REQUEST_TIMEOUT_US = 20000U;
+// Time in microseconds a complete update may take at most, before it is considered as failed
+constexpr uint64_t UPDATE_TIMEOUT_US = 10000000U;
+// Receive and send buffer size of the client, big enough to receive every chunk as a single message, because a corrupted chunk received in fragments would restart the update instead
+constexpr uint16_t CLIENT_BUFFER_SIZE = 2048U;
+// Identifier of the emulated device, used in the topics of the firmware chunks
+constexpr char DEVICE_ID[] = "Loopback_Device";
+// Title and version of the firmware the device is currently running, and version of the firmware served by the emulator
+constexpr char FIRMWARE_TITLE[] = "loopback";
+constexpr char CURRENT_VERSION[] = "1.0.0";
+constexpr char UPDATED_VERSION[] = "1.1.0";
+// Size of the served firmware binary and of the chunks it is downloaded in
+constexpr size_t FIRMWARE_SIZE = 24576U;
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 1024U;
+// Amount of chunks requested at once
+constexpr uint8_t FIRMWARE_REQUEST_WINDOW = 4U;
+// Amount of times a single chunk is requested again before the update fails
+constexpr uint8_t FIRMWARE_CHUNK_RETRIES = 2U;
+// Amount of times every chunk fails its verification, before it is received intact
+constexpr size_t FAILURES_PER_CHUNK = FIRMWARE_CHUNK_RETRIES;
+// Byte offset of the chunk that never passes its verification
+constexpr size_t CORRUPT_CHUNK_OFFSET = 5U * FIRMWARE_CHUNK_SIZE;
+// Amount of times a chunk fails its verification, if no failure is injected or if it never passes its verification
+constexpr size_t NO_FAILURES = 0U;
+constexpr size_t ALWAYS_FAILS = SIZE_MAX;
+
+
+/// @brief Updater that keeps the written firmware binary in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {}; // Written firmware binary
+    size_t               m_size = {}; // Size of the firmware binary passed to begin()
+};
+
+/// @brief Attribute request of the emulated device, implements the device identity the API implementations of this library require
+class Device_Attribute_Request : public Attribute_Request<1U, 2U> {
+  public:
+    char const * GetDeviceId() override {
+        return DEVICE_ID;
+    }
+
+    void SetDeviceId(char const * /*device_id*/) override {
+        // Nothing to do
+    }
+
+    char const * GetDeviceProfile() override {
+        return "";
+    }
+
+    void SetDeviceProfile(char const * /*device_profile*/) override {
+        // Nothing to do
+    }
+};
+
+/// @brief Result of a single firmware update
+struct Update_Result {
+    int                      result;   // 1 if the update succeeded, 0 if it failed and -1 if it did not finish before the update timeout expired
+    std::vector<uint8_t>     data;     // Firmware binary written into the updater
+    std::map<size_t, size_t> received; // Amount of times every chunk has been received, by byte offset
+    size_t                   requests; // Amount of firmware chunk requests answered by the emulator
+};
+
+
+/// @brief Downloads the given firmware binary from the emulator, while the chunks at the given offset fail their CRC32 verification the given amount of times
+/// @param seed Seed of the broker, which decides the latency, loss and reordering of every message
+/// @param loss_percent Probability in percent of a message being lost
+/// @param reorder_percent Probability in percent of a message being held back, so that following messages overtake it
+/// @param firmware Firmware binary served by the emulator
+/// @param checksum SHA256 checksum of the firmware binary
+/// @param failing_offset Byte offset of the chunk that fails its verification, SIZE_MAX if every chunk fails it
+/// @param failures Amount of times the chunk fails its verification before it is received intact
+/// @return Result of the update
+static Update_Result Run_Update(uint32_t const & seed, uint8_t const & loss_percent, uint8_t const & reorder_percent, std::vector<uint8_t> const & firmware, char const * checksum,
+  size_t const & failing_offset, size_t const & failures) {
+    Loopback_MQTT_Broker broker;
+    broker.Set_Seed(seed);
+    broker.Set_Latency(0U, MAX_LATENCY);
+    ThingsBoard_Emulator emulator(broker);
+    emulator.Set_Firmware(FIRMWARE_TITLE, UPDATED_VERSION, firmware.data(), firmware.size());
+    emulator.Set_Shared_Attribute(FW_TITLE_KEY, (std::string("\"") + FIRMWARE_TITLE + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_VER_KEY, (std::string("\"") + UPDATED_VERSION + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_KEY, (std::string("\"") + checksum + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_CHKS_ALGO_KEY, (std::string("\"") + CHECKSUM_AGORITM_SHA256 + "\"").c_str());
+    emulator.Set_Shared_Attribute(FW_SIZE_KEY, std::to_string(firmware.size()).c_str());
+
+    Loopback_MQTT_Client<> client(broker);
+    OTA_Firmware_Update<> ota;
+    Device_Attribute_Request attribute_request;
+    std::array<IAPI_Implementation *, 2U> const apis = {&ota, &attribute_request};
+    ThingsBoardSized<> tb(client, CLIENT_BUFFER_SIZE, CLIENT_BUFFER_SIZE, Default_Max_Stack_Size, apis);
+    ota.SetDeviceId(DEVICE_ID);
+    Update_Result result = { -1, {}, {}, 0U };
+    if (!tb.connect("localhost", "token")) {
+        return result;
+    }
+
+    Memory_Updater updater;
+    OTA_Update_Callback update_callback(FIRMWARE_TITLE, CURRENT_VERSION, &updater, [&](bool const & success) { result.result = success ? 1 : 0; },
+      nullptr, nullptr, FIRMWARE_CHUNK_RETRIES, FIRMWARE_CHUNK_SIZE, REQUEST_TIMEOUT_US);
+    update_callback.Set_Request_Window(FIRMWARE_REQUEST_WINDOW);
+    // Verification fails by expecting a CRC32 that differs from the one of the received chunk
+    update_callback.Set_Chunk_CRC_Callback([&](size_t const & offset, size_t const & length, uint32_t & expected_crc) {
+        size_t const received = result.received[offset]++;
+        expected_crc = Helper::calculateCRC32(firmware.data() + offset, length);
+        if ((failing_offset == SIZE_MAX || failing_offset == offset) && received < failures) {
+            expected_crc = ~expected_crc;
+        }
+        return true;
+    });
+    if (!ota.Start_Firmware_Update(update_callback)) {
+        return result;
+    }
+
+    // Messages are only lost and reordered once the first chunk has been requested, because only the chunks are retried by the client itself
+    uint64_t const start = Helper::getTimeMicroseconds();
+    bool unreliable = false;
+    while (result.result < 0 && Helper::getTimeMicroseconds() - start <= UPDATE_TIMEOUT_US) {
+        if (!unreliable && emulator.Get_Firmware_Chunk_Requests() != 0U) {
+            broker.Set_Loss(loss_percent);
+            broker.Set_Reordering(reorder_percent, REORDER_DELAY);
+            unreliable = true;
+        }
+        (void)tb.loop();
+    }
+    result.data = updater.Get_Data();
+    result.requests = emulator.Get_Firmware_Chunk_Requests();
+    return result;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param seed Seed of the broker the check was run with
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, uint32_t const & seed, size_t & failures) {
+    if (!passed) {
+        printf("Check failed with seed (%u): %s\n", seed, message);
+        failures++;
+    }
+}
+
+int main() {
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (size_t i = 0U; i < firmware.size(); i++) {
+        firmware[i] = static_cast<uint8_t>((i * 17U) ^ (i >> 5U));
+    }
+    HashGenerator hash;
+    (void)hash.start(Checksum_Algorithm::SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    char checksum[FIRMWARE_HASH_SIZE] = {};
+    (void)hash.finish(checksum);
+
+    size_t failures = 0U;
+    // Every chunk uses up all of its own retries, while the failures of the other outstanding chunks are interleaved with them
+    Update_Result result = Run_Update(0U, 0U, 0U, firmware, checksum, SIZE_MAX, FAILURES_PER_CHUNK);
+    Check(result.result == 1 && result.data == firmware, "retrying every chunk with the retries of its own request slot", 0U, failures);
+    bool every_chunk_retried = result.received.size() == FIRMWARE_SIZE / FIRMWARE_CHUNK_SIZE;
+    for (auto const & received : result.received) {
+        every_chunk_retried = every_chunk_retried && received.second == FAILURES_PER_CHUNK + 1U;
+    }
+    Check(every_chunk_retried, "receiving every chunk once more than it failed", 0U, failures);
+
+    // Writing the other chunks does not reset the retries of the chunk that keeps failing
+    result = Run_Update(0U, 0U, 0U, firmware, checksum, CORRUPT_CHUNK_OFFSET, ALWAYS_FAILS);
+    Check(result.result == 0, "aborting the update once the retries of the corrupted chunk are exhausted", 0U, failures);
+    Check(result.received[CORRUPT_CHUNK_OFFSET] == FIRMWARE_CHUNK_RETRIES + 1U, "requesting the corrupted chunk only as often as its own retries allow", 0U, failures);
+
+    // Lost and reordered chunks are recovered from by the timeouts and retries of every outstanding chunk
+    for (uint32_t seed = 1U; seed <= TEST_SEEDS; seed++) {
+        result = Run_Update(seed, LOSS_PERCENT, REORDER_PERCENT, firmware, checksum, SIZE_MAX, NO_FAILURES);
+        Check(result.result == 1 && result.data == firmware, "downloading the firmware binary with lost and reordered messages", seed, failures);
+        printf("Seed (%u) answered (%zu) firmware chunk requests\n", seed, result.requests);
+    }
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
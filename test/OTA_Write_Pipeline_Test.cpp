@@ -0,0 +1,156 @@
+// Adds firmware chunks with random sizes into an OTA_Write_Pipeline running on a std::thread, whose write callback takes a random time for every chunk.
+// Covers the chunks being written in exactly the order they have been added, even though adding them is faster than writing them and every slot is reused,
+// a failing write, which has to discard every following chunk and has to be reported by Enqueue(), Flush() and Has_Failed() until the pipeline is cancelled,
+// and Cancel() discarding the chunks that have not been written yet, after which new chunks are written normally again
+
+// Local includes.
+#include "OTA_Write_Pipeline.h"
+
+// Library includes.
+#include <chrono>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+
+// Amount of chunks added into the pipeline in every scenario
+constexpr size_t TEST_CHUNKS = 200U;
+// Amount of slots in the pipeline, far less than the added chunks, so every slot is reused multiple times
+constexpr size_t SLOT_COUNT = 4U;
+// Size in bytes every slot can hold and range the size of every added chunk is chosen from
+constexpr size_t SLOT_SIZE = 512U;
+constexpr size_t MIN_CHUNK_SIZE = 1U;
+// Maximum time in microseconds every write takes, chosen uniformly between 0 and this value
+constexpr uint64_t MAX_WRITE_DELAY_US = 200U;
+// Index of the chunk whose write fails
+constexpr size_t FAILING_CHUNK = 50U;
+// Time in microseconds the write callback blocks for, while the chunks that should be discarded by Cancel() are added
+constexpr uint64_t BLOCKED_WRITE_US = 20000U;
+
+
+/// @brief Chunk the write callback has been called with
+struct Written_Chunk {
+    size_t               offset; // Byte offset of the chunk in the firmware binary
+    std::vector<uint8_t> data;   // Binary data of the chunk
+};
+
+
+/// @brief Adds the given amount of chunks with random sizes and random content into the pipeline, continuing after the given offset
+/// @param pipeline Pipeline the chunks are added into
+/// @param random Random generator deciding the size and content of every chunk
+/// @param chunks Amount of chunks that should be added
+/// @param offset Byte offset of the first added chunk, increased by the size of every added chunk
+/// @param added Chunks that have been added, in the order they have been added
+/// @return Amount of chunks that have been accepted by the pipeline
+static size_t Add_Chunks(OTA_Write_Pipeline & pipeline, std::mt19937 & random, size_t const & chunks, size_t & offset, std::vector<Written_Chunk> & added) {
+    std::uniform_int_distribution<size_t> size_distribution(MIN_CHUNK_SIZE, SLOT_SIZE);
+    size_t accepted = 0U;
+    for (size_t chunk = 0U; chunk < chunks; chunk++) {
+        std::vector<uint8_t> data(size_distribution(random));
+        for (uint8_t & byte : data) {
+            byte = static_cast<uint8_t>(random());
+        }
+        if (pipeline.Enqueue(offset, data.data(), data.size())) {
+            accepted++;
+        }
+        added.push_back({ offset, data });
+        offset += data.size();
+    }
+    return accepted;
+}
+
+/// @brief Whether the given chunks have been written in the same order and with the same content as they have been added
+/// @param written Chunks the write callback has been called with
+/// @param added Chunks that have been added into the pipeline
+/// @param count Amount of added chunks that should have been written
+/// @return Whether exactly the first count added chunks have been written in order
+static bool Written_In_Order(std::vector<Written_Chunk> const & written, std::vector<Written_Chunk> const & added, size_t const & count) {
+    if (written.size() != count || added.size() < count) {
+        return false;
+    }
+    for (size_t index = 0U; index < count; index++) {
+        if (written[index].offset != added[index].offset || written[index].data != added[index].data) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(32U);
+    std::uniform_int_distribution<uint64_t> delay_distribution(0U, MAX_WRITE_DELAY_US);
+    std::vector<Written_Chunk> written = {};
+    size_t failing_chunk = SIZE_MAX;
+    uint64_t blocked_write = 0U;
+    std::mt19937 delay_random(320U);
+    auto const write_callback = [&](size_t const & chunk_offset, uint8_t * payload, size_t const & length) {
+        std::this_thread::sleep_for(std::chrono::microseconds(blocked_write != 0U ? blocked_write : delay_distribution(delay_random)));
+        if (written.size() == failing_chunk) {
+            failing_chunk = SIZE_MAX;
+            return false;
+        }
+        written.push_back({ chunk_offset, std::vector<uint8_t>(payload, payload + length) });
+        return true;
+    };
+
+    size_t failures = 0U;
+    OTA_Write_Pipeline pipeline;
+    Check(!pipeline.Is_Running() && !pipeline.Enqueue(0U, nullptr, 0U) && pipeline.Flush(), "rejecting chunks before the pipeline has been started", failures);
+    Check(pipeline.Start(SLOT_COUNT, SLOT_SIZE, WRITE_PIPELINE_NO_AFFINITY, write_callback) && pipeline.Is_Running(), "starting the pipeline on a std::thread", failures);
+
+    // Chunks are written in exactly the order they have been added, even though they are added faster than they are written
+    size_t offset = 0U;
+    std::vector<Written_Chunk> added = {};
+    size_t accepted = Add_Chunks(pipeline, random, TEST_CHUNKS, offset, added);
+    Check(accepted == TEST_CHUNKS && pipeline.Flush() && !pipeline.Has_Failed(), "accepting and writing every added chunk", failures);
+    Check(Written_In_Order(written, added, TEST_CHUNKS), "writing every chunk in the order it has been added", failures);
+    uint8_t oversized[SLOT_SIZE + 1U] = {};
+    Check(!pipeline.Enqueue(offset, oversized, sizeof(oversized)) && !pipeline.Has_Failed(), "rejecting a chunk that does not fit into a slot without failing", failures);
+
+    // Failing write discards every following chunk and is reported until the pipeline is cancelled
+    written.clear();
+    added.clear();
+    failing_chunk = FAILING_CHUNK;
+    accepted = Add_Chunks(pipeline, random, TEST_CHUNKS, offset, added);
+    Check(accepted > FAILING_CHUNK && accepted < TEST_CHUNKS, "rejecting chunks added after the write failure", failures);
+    Check(!pipeline.Flush() && pipeline.Has_Failed(), "reporting the write failure when flushing", failures);
+    Check(Written_In_Order(written, added, FAILING_CHUNK), "discarding every chunk added after the failed one", failures);
+    Check(!pipeline.Enqueue(offset, oversized, MIN_CHUNK_SIZE) && !pipeline.Flush(), "keeping the write failure until the pipeline is cancelled", failures);
+    pipeline.Cancel();
+    Check(!pipeline.Has_Failed() && pipeline.Flush(), "resetting the write failure when cancelling", failures);
+
+    // Cancelling discards the chunks that have not been written yet, the chunk currently being written is still completed
+    written.clear();
+    added.clear();
+    blocked_write = BLOCKED_WRITE_US;
+    accepted = Add_Chunks(pipeline, random, SLOT_COUNT, offset, added);
+    pipeline.Cancel();
+    blocked_write = 0U;
+    Check(accepted == SLOT_COUNT && written.size() < SLOT_COUNT && pipeline.Flush() && !pipeline.Has_Failed(), "discarding the chunks that have not been written when cancelling", failures);
+    Check(Written_In_Order(written, added, written.size()), "writing only chunks in the order they have been added before cancelling", failures);
+
+    // Chunks added after cancelling are written normally again, even if they need bigger slots
+    written.clear();
+    added.clear();
+    Check(pipeline.Resize(SLOT_SIZE * 2U), "increasing the size of the slots", failures);
+    accepted = Add_Chunks(pipeline, random, TEST_CHUNKS, offset, added);
+    Check(accepted == TEST_CHUNKS && pipeline.Flush() && Written_In_Order(written, added, TEST_CHUNKS), "writing every chunk in order after cancelling", failures);
+
+    pipeline.Stop();
+    Check(!pipeline.Is_Running() && !pipeline.Enqueue(offset, oversized, MIN_CHUNK_SIZE), "rejecting chunks once the pipeline has been stopped", failures);
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
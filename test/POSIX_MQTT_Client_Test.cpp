@@ -0,0 +1,310 @@
+// Connects the POSIX_MQTT_Client over TCP to a minimal MQTT 3.1.1 broker listening on localhost, which sends every received message back to the client if it matches a subscribed topic filter.
+// Covers connecting, subscribing, publishing single and segmented messages, receiving enough messages to wrap around the ring buffer,
+// receiving a message bigger than the receive buffer in fragments, unsubscribing and disconnecting gracefully
+
+// Local include.
+#include "POSIX_MQTT_Client.h"
+
+// Library includes.
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+// Receive and send buffer size of the client, small enough that the received messages wrap around the ring buffer multiple times
+constexpr uint16_t CLIENT_BUFFER_SIZE = 128U;
+// Amount of messages published one after another to exercise the ring buffer
+constexpr size_t RING_BUFFER_MESSAGES = 500U;
+// Size of the message that is bigger than the receive buffer and therefore received in fragments
+constexpr size_t FRAGMENTED_MESSAGE_SIZE = 5000U;
+// Time in milliseconds the client waits for the broker to send back the published messages
+constexpr int64_t RECEIVE_TIMEOUT = 5000;
+// Topic filter the client subscribes to and topic the messages are published on
+constexpr char SUBSCRIBE_TOPIC[] = "test/+";
+constexpr char PUBLISH_TOPIC[] = "test/echo";
+
+
+/// @brief Minimal MQTT 3.1.1 broker, that accepts a single client on a localhost TCP port chosen by the operating system.
+/// Acknowledges every connect, subscribe, unsubscribe and keep alive request and sends every received message back to the client,
+/// if its topic matches a subscribed topic filter. Only supports QoS level 0 and topic filters containing the single level wildcard
+class Local_Broker {
+  public:
+    ~Local_Broker() {
+        Stop();
+    }
+
+    /// @brief Starts listening on a localhost port and serves the first accepted client in its own thread
+    /// @return Whether listening was successful or not
+    bool Start() {
+        m_listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t address_length = sizeof(address);
+        if (m_listen_socket < 0 || bind(m_listen_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(m_listen_socket, 1) != 0 ||
+          getsockname(m_listen_socket, reinterpret_cast<sockaddr *>(&address), &address_length) != 0) {
+            return false;
+        }
+        m_port = ntohs(address.sin_port);
+        m_thread = std::thread(&Local_Broker::Serve, this);
+        return true;
+    }
+
+    /// @brief Waits until the served client disconnected and stops listening
+    void Stop() {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        if (m_listen_socket >= 0) {
+            (void)close(m_listen_socket);
+            m_listen_socket = -1;
+        }
+    }
+
+    uint16_t Get_Port() const {
+        return m_port;
+    }
+
+    /// @brief Gets whether the client sent a DISCONNECT packet before closing the connection
+    /// @return Whether the client disconnected gracefully
+    bool Received_Disconnect() const {
+        return m_received_disconnect;
+    }
+
+  private:
+    /// @brief Accepts a single client and handles its packets until the connection is closed
+    void Serve() {
+        m_client_socket = accept(m_listen_socket, nullptr, nullptr);
+        if (m_client_socket < 0) {
+            return;
+        }
+        uint8_t type_and_flags = 0U;
+        std::vector<uint8_t> body = {};
+        while (Read_Packet(type_and_flags, body)) {
+            MQTT_Packet_Type const type = static_cast<MQTT_Packet_Type>(type_and_flags >> 4U);
+            if (type == MQTT_Packet_Type::CONNECT) {
+                Send({static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::CONNACK) << 4U), 2U, 0U, 0U});
+            }
+            else if (type == MQTT_Packet_Type::SUBSCRIBE && body.size() >= 4U) {
+                m_topic_filters.emplace_back(reinterpret_cast<char const *>(body.data() + 4U), (body[2U] << 8U) | body[3U]);
+                Send({static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::SUBACK) << 4U), 3U, body[0U], body[1U], 0U});
+            }
+            else if (type == MQTT_Packet_Type::UNSUBSCRIBE && body.size() >= 4U) {
+                m_topic_filters.clear();
+                Send({static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::UNSUBACK) << 4U), 2U, body[0U], body[1U]});
+            }
+            else if (type == MQTT_Packet_Type::PINGREQ) {
+                Send({static_cast<uint8_t>(static_cast<uint8_t>(MQTT_Packet_Type::PINGRESP) << 4U), 0U});
+            }
+            else if (type == MQTT_Packet_Type::PUBLISH && body.size() >= 2U) {
+                std::string const topic(reinterpret_cast<char const *>(body.data() + 2U), (body[0U] << 8U) | body[1U]);
+                if (Is_Subscribed(topic)) {
+                    Send(Encode_Packet(type_and_flags, body));
+                }
+            }
+            else if (type == MQTT_Packet_Type::DISCONNECT) {
+                m_received_disconnect = true;
+                break;
+            }
+        }
+        (void)close(m_client_socket);
+        m_client_socket = -1;
+    }
+
+    /// @brief Reads exactly the given amount of bytes from the client
+    bool Read(uint8_t * buffer, size_t const & length) {
+        size_t received = 0U;
+        while (received < length) {
+            ssize_t const result = recv(m_client_socket, buffer + received, length - received, 0);
+            if (result <= 0) {
+                return false;
+            }
+            received += result;
+        }
+        return true;
+    }
+
+    /// @brief Reads the next packet of the client
+    /// @param type_and_flags First byte of the fixed header, containing the packet type and flags
+    /// @param body Variable header and payload of the packet
+    /// @return Whether a complete packet has been read before the connection was closed
+    bool Read_Packet(uint8_t & type_and_flags, std::vector<uint8_t> & body) {
+        if (!Read(&type_and_flags, 1U)) {
+            return false;
+        }
+        size_t remaining_length = 0U;
+        size_t multiplier = 1U;
+        uint8_t encoded_byte = 0U;
+        do {
+            if (!Read(&encoded_byte, 1U)) {
+                return false;
+            }
+            remaining_length += (encoded_byte & 127U) * multiplier;
+            multiplier *= 128U;
+        } while ((encoded_byte & 128U) != 0U);
+        body.resize(remaining_length);
+        return remaining_length == 0U || Read(body.data(), remaining_length);
+    }
+
+    /// @brief Prepends the fixed header to the given variable header and payload
+    static std::vector<uint8_t> Encode_Packet(uint8_t const & type_and_flags, std::vector<uint8_t> const & body) {
+        std::vector<uint8_t> packet = {type_and_flags};
+        size_t remaining_length = body.size();
+        do {
+            uint8_t encoded_byte = remaining_length % 128U;
+            remaining_length /= 128U;
+            packet.push_back(remaining_length > 0U ? (encoded_byte | 128U) : encoded_byte);
+        } while (remaining_length > 0U);
+        packet.insert(packet.end(), body.begin(), body.end());
+        return packet;
+    }
+
+    /// @brief Sends the given packet completely to the client
+    void Send(std::vector<uint8_t> const & packet) {
+        size_t sent = 0U;
+        while (sent < packet.size()) {
+            ssize_t const result = send(m_client_socket, packet.data() + sent, packet.size() - sent, POSIX_MQTT_SEND_FLAGS);
+            if (result <= 0) {
+                return;
+            }
+            sent += result;
+        }
+    }
+
+    /// @brief Checks whether the given topic matches any subscribed topic filter, where a single level wildcard matches exactly one complete topic level
+    bool Is_Subscribed(std::string const & topic) const {
+        for (auto const & filter : m_topic_filters) {
+            size_t topic_index = 0U;
+            size_t filter_index = 0U;
+            while (filter_index < filter.size()) {
+                if (filter[filter_index] == '+') {
+                    while (topic_index < topic.size() && topic[topic_index] != '/') {
+                        topic_index++;
+                    }
+                }
+                else if (topic_index >= topic.size() || filter[filter_index] != topic[topic_index]) {
+                    break;
+                }
+                else {
+                    topic_index++;
+                }
+                filter_index++;
+            }
+            if (filter_index == filter.size() && topic_index == topic.size()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int                      m_listen_socket = -1;         // Socket accepting the client
+    int                      m_client_socket = -1;         // Socket connected to the accepted client
+    uint16_t                 m_port = {};                  // Localhost port chosen by the operating system
+    std::thread              m_thread = {};                // Thread serving the accepted client
+    std::atomic<bool>        m_received_disconnect = {};   // Whether the client sent a DISCONNECT packet
+    std::vector<std::string> m_topic_filters = {};         // Topic filters the client subscribed to
+};
+
+
+/// @brief Calls loop() of the client until the given condition is met or the receive timeout expires
+/// @param client Client that should handle the received messages
+/// @param condition Condition that should be met
+/// @return Whether the condition was met before the timeout expired
+template <typename Condition>
+static bool Loop_Until(POSIX_MQTT_Client<> & client, Condition condition) {
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RECEIVE_TIMEOUT);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        (void)client.loop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t & failures) {
+    if (!passed) {
+        printf("Check failed: %s\n", message);
+        failures++;
+    }
+}
+
+int main() {
+    Local_Broker broker;
+    if (!broker.Start()) {
+        printf("Starting the local broker failed\n");
+        return 1;
+    }
+
+    POSIX_MQTT_Client<> client;
+    std::vector<std::string> received = {};
+    client.set_data_callback([&](char * topic, uint8_t * payload, unsigned int length) {
+        if (strcmp(topic, PUBLISH_TOPIC) == 0) {
+            received.emplace_back(reinterpret_cast<char const *>(payload), length);
+        }
+    });
+    std::string fragmented = {};
+    size_t fragmented_total = 0U;
+    client.set_fragment_callback([&](String_View const & topic, uint8_t * payload, size_t offset, size_t length, size_t total) {
+        if (offset != fragmented.size() || std::string(topic.data(), topic.size()) != PUBLISH_TOPIC) {
+            return false;
+        }
+        fragmented.append(reinterpret_cast<char const *>(payload), length);
+        fragmented_total = total;
+        return true;
+    });
+    client.set_server("127.0.0.1", broker.Get_Port());
+    size_t failures = 0U;
+    Check(client.set_buffer_size(CLIENT_BUFFER_SIZE, CLIENT_BUFFER_SIZE), "allocating the buffers", failures);
+    Check(client.connect("POSIX_MQTT_Client_Test", "token", nullptr) && client.connected(), "connecting to the local broker", failures);
+    Check(client.subscribe(SUBSCRIBE_TOPIC), "subscribing", failures);
+
+    std::string const message = "{\"temperature\":42}";
+    Check(client.publish(PUBLISH_TOPIC, reinterpret_cast<uint8_t const *>(message.data()), message.size()), "publishing a message", failures);
+    Check(Loop_Until(client, [&]() { return received.size() == 1U; }) && received.back() == message, "receiving the published message", failures);
+
+    char const first_segment[] = "{\"humidity\":";
+    char const second_segment[] = "13}";
+    MQTT_Segment const segments[] = {{reinterpret_cast<uint8_t const *>(first_segment), strlen(first_segment)}, {nullptr, 0U},
+      {reinterpret_cast<uint8_t const *>(second_segment), strlen(second_segment)}};
+    Check(client.publish_segments(PUBLISH_TOPIC, segments, 3U), "publishing a segmented message", failures);
+    Check(Loop_Until(client, [&]() { return received.size() == 2U; }) && received.back() == "{\"humidity\":13}", "receiving the segmented message", failures);
+
+    // Messages are published without calling loop() in between, so the broker sends them back while the ring buffer still contains previous ones
+    received.clear();
+    std::vector<std::string> expected = {};
+    for (size_t i = 0U; i < RING_BUFFER_MESSAGES; i++) {
+        expected.push_back(std::string(i % 60U, static_cast<char>('a' + i % 26U)) + std::to_string(i));
+        Check(client.publish(PUBLISH_TOPIC, reinterpret_cast<uint8_t const *>(expected.back().data()), expected.back().size()), "publishing a message into the ring buffer", failures);
+    }
+    Check(Loop_Until(client, [&]() { return received.size() == RING_BUFFER_MESSAGES; }) && received == expected, "receiving every message in order", failures);
+
+    std::string firmware_chunk(FRAGMENTED_MESSAGE_SIZE, '\0');
+    for (size_t i = 0U; i < firmware_chunk.size(); i++) {
+        firmware_chunk[i] = static_cast<char>(i * 7U);
+    }
+    MQTT_Segment const chunk_segment = {reinterpret_cast<uint8_t const *>(firmware_chunk.data()), firmware_chunk.size()};
+    Check(client.publish_segments(PUBLISH_TOPIC, &chunk_segment, 1U), "publishing a message bigger than the receive buffer", failures);
+    Check(Loop_Until(client, [&]() { return fragmented.size() == firmware_chunk.size(); }) && fragmented == firmware_chunk && fragmented_total == firmware_chunk.size(),
+      "receiving the message bigger than the receive buffer in fragments", failures);
+    Check(client.get_dropped_messages() == 0U, "not dropping any message", failures);
+
+    Check(client.unsubscribe(SUBSCRIBE_TOPIC), "unsubscribing", failures);
+    client.disconnect();
+    Check(!client.connected(), "disconnecting", failures);
+    broker.Stop();
+    Check(broker.Received_Disconnect(), "sending the disconnect packet", failures);
+
+    // Nothing listens on the port anymore, therefore connecting has to fail instead of blocking
+    client.set_network_timeout(1000U);
+    Check(!client.connect("POSIX_MQTT_Client_Test", "token", nullptr), "failing to connect without a broker", failures);
+
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+// Schedules reconnect attempts with a Reconnect_Backoff, with random delays and seeds, and compares every scheduled delay against the documented bounds.
+// Covers the first attempt being spread over the complete minimum delay, every following delay being jittered between half and the full delay, which doubles with every failed attempt
+// until it reaches the maximum delay and stays capped there without overflowing, and the delays starting again from the minimum delay once the backoff has been reset
+
+// Local includes.
+#include "Helper.h"
+#include "Reconnect_Backoff.h"
+
+// Library includes.
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+
+
+// Amount of random configurations of the delays and the seed
+constexpr size_t TEST_ITERATIONS = 200U;
+// Range the minimum and maximum delays in milliseconds are chosen from
+constexpr uint32_t MIN_CONFIGURED_DELAY = 1U;
+constexpr uint32_t MAX_CONFIGURED_DELAY = 10U * 60U * 1000U;
+// Amount of failed attempts scheduled in every configuration, enough for the doubled delay to reach even the largest possible maximum delay
+constexpr uint32_t TEST_ATTEMPTS = 40U;
+// Amount of first attempts scheduled with the same configuration, to check that the jitter actually spreads them
+constexpr size_t JITTER_SAMPLES = 100U;
+// Delays in milliseconds close to the maximum value, whose doubling would overflow
+constexpr uint32_t OVERFLOW_MINIMUM_DELAY = UINT32_MAX / 3U;
+constexpr uint32_t OVERFLOW_MAXIMUM_DELAY = UINT32_MAX - 1U;
+
+
+/// @brief Calculates the delay the given attempt is jittered from, the minimum delay doubled for every failed attempt except the first and capped at the maximum delay
+/// @param minimum_delay Delay in milliseconds the delays are doubled from
+/// @param maximum_delay Delay in milliseconds the doubled delays are capped at
+/// @param attempts Amount of attempts made before the scheduled one
+/// @return Delay in milliseconds the scheduled attempt is jittered from
+static uint64_t Expected_Delay(uint32_t const & minimum_delay, uint32_t const & maximum_delay, uint32_t const & attempts) {
+    uint64_t delay = minimum_delay;
+    for (uint32_t attempt = 1U; attempt < attempts && delay < maximum_delay; attempt++) {
+        delay *= 2U;
+    }
+    return delay < maximum_delay ? delay : maximum_delay;
+}
+
+/// @brief Whether the delay of the last scheduled attempt is within the bounds the given attempt has to be jittered in
+/// @param backoff Backoff the attempt has been scheduled with
+/// @param minimum_delay Delay in milliseconds the delays are doubled from
+/// @param maximum_delay Delay in milliseconds the doubled delays are capped at
+/// @return Whether the delay is between 0 and the minimum delay for the first attempt or between half and the full expected delay for the following attempts
+static bool Within_Bounds(Reconnect_Backoff const & backoff, uint32_t const & minimum_delay, uint32_t const & maximum_delay) {
+    uint64_t const expected = Expected_Delay(minimum_delay, maximum_delay, backoff.Get_Attempts());
+    uint64_t const lower_bound = backoff.Get_Attempts() == 0U ? 0U : expected - (expected / 2U);
+    return backoff.Get_Delay() >= lower_bound && backoff.Get_Delay() <= expected;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param iteration Iteration the check was run in
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, size_t const & iteration, size_t & failures) {
+    if (!passed) {
+        printf("Check failed in iteration (%zu): %s\n", iteration, message);
+        failures++;
+    }
+}
+
+int main() {
+    std::mt19937 random(47U);
+    std::uniform_int_distribution<uint32_t> delay_distribution(MIN_CONFIGURED_DELAY, MAX_CONFIGURED_DELAY);
+    size_t failures = 0U;
+
+    for (size_t iteration = 1U; iteration <= TEST_ITERATIONS; iteration++) {
+        uint32_t minimum_delay = delay_distribution(random);
+        uint32_t maximum_delay = delay_distribution(random);
+        if (minimum_delay > maximum_delay) {
+            std::swap(minimum_delay, maximum_delay);
+        }
+        Reconnect_Backoff backoff;
+        backoff.Set_Delays(minimum_delay, maximum_delay);
+        backoff.Set_Seed(static_cast<uint32_t>(random()));
+
+        // First attempt is spread over the complete minimum delay, not always the same delay
+        bool within_bounds = true;
+        uint32_t lowest_delay = UINT32_MAX;
+        uint32_t highest_delay = 0U;
+        for (size_t sample = 0U; sample < JITTER_SAMPLES; sample++) {
+            backoff.Schedule();
+            within_bounds = Within_Bounds(backoff, minimum_delay, maximum_delay) && within_bounds;
+            lowest_delay = backoff.Get_Delay() < lowest_delay ? backoff.Get_Delay() : lowest_delay;
+            highest_delay = backoff.Get_Delay() > highest_delay ? backoff.Get_Delay() : highest_delay;
+        }
+        Check(within_bounds, "spreading the first attempt between 0 and the minimum delay", iteration, failures);
+        Check(lowest_delay < highest_delay, "jittering the first attempt", iteration, failures);
+
+        // Following attempts are jittered between half and the full delay, which doubles with every failed attempt until it is capped at the maximum delay
+        bool capped = false;
+        for (uint32_t attempt = 1U; attempt <= TEST_ATTEMPTS; attempt++) {
+            backoff.Attempted();
+            Check(!backoff.Is_Scheduled() && backoff.Get_Attempts() == attempt, "removing the scheduled attempt once it has been made", iteration, failures);
+            backoff.Schedule();
+            within_bounds = Within_Bounds(backoff, minimum_delay, maximum_delay) && within_bounds;
+            capped = Expected_Delay(minimum_delay, maximum_delay, attempt) == maximum_delay;
+        }
+        Check(within_bounds, "jittering every following attempt between half and the full doubled delay", iteration, failures);
+        Check(capped && backoff.Get_Delay() <= maximum_delay, "capping the doubled delay at the maximum delay", iteration, failures);
+
+        // Reset starts the delays from the minimum delay again
+        backoff.Reset();
+        Check(!backoff.Is_Scheduled() && backoff.Get_Attempts() == 0U, "removing the scheduled attempt and the made attempts when resetting", iteration, failures);
+        backoff.Schedule();
+        Check(Within_Bounds(backoff, minimum_delay, maximum_delay), "spreading the first attempt after resetting over the minimum delay", iteration, failures);
+    }
+
+    // Doubling a delay close to the maximum value is capped instead of overflowing into a short delay
+    Reconnect_Backoff overflow;
+    overflow.Set_Delays(OVERFLOW_MINIMUM_DELAY, OVERFLOW_MAXIMUM_DELAY);
+    bool within_bounds = true;
+    for (uint32_t attempt = 1U; attempt <= TEST_ATTEMPTS; attempt++) {
+        overflow.Attempted();
+        overflow.Schedule();
+        within_bounds = Within_Bounds(overflow, OVERFLOW_MINIMUM_DELAY, OVERFLOW_MAXIMUM_DELAY) && within_bounds;
+    }
+    Check(within_bounds && overflow.Get_Delay() >= OVERFLOW_MAXIMUM_DELAY / 2U, "capping delays whose doubling would overflow", 0U, failures);
+
+    // Maximum delay smaller than the minimum delay is raised to it, the scheduled attempt is only due once its delay passed
+    Reconnect_Backoff raised;
+    raised.Set_Delays(MIN_CONFIGURED_DELAY * 2U, MIN_CONFIGURED_DELAY);
+    raised.Attempted();
+    raised.Attempted();
+    raised.Schedule();
+    Check(raised.Is_Scheduled() && raised.Get_Delay() >= MIN_CONFIGURED_DELAY && raised.Get_Delay() <= MIN_CONFIGURED_DELAY * 2U,
+      "raising the maximum delay to the minimum delay", 0U, failures);
+    uint64_t const scheduled = Helper::getTimeMicroseconds();
+    Check(!raised.Is_Due() || Helper::getTimeMicroseconds() - scheduled >= static_cast<uint64_t>(raised.Get_Delay()) * 1000U, "not being due before the delay passed", 0U, failures);
+    while (!raised.Is_Due() && Helper::getTimeMicroseconds() - scheduled <= static_cast<uint64_t>(MIN_CONFIGURED_DELAY) * 4000U) {
+        // Wait for the scheduled attempt
+    }
+    Check(raised.Is_Due(), "being due once the delay passed", 0U, failures);
+
+    printf("%zu failures in %zu iterations\n", failures, TEST_ITERATIONS);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// Runs the ThingsBoard client end to end over a Loopback_MQTT_Client against the ThingsBoard_Emulator, while the Loopback_MQTT_Broker delays, loses and reorders messages.
+// Covers answering a server side RPC request, requesting client side and shared attributes and downloading a complete firmware binary chunk by chunk over MQTT.
+// Lost requests and responses are recovered from by the timeouts and retries of the client, or by the test repeating the server side RPC request, the same as a real server would
+
+// Local includes.
+#include "Attribute_Request.h"
+#include "HashGenerator.h"
+#include "Loopback_MQTT_Client.h"
+#include "OTA_Firmware_Update.h"
+#include "Server_Side_RPC.h"
+#include "ThingsBoard.h"
+#include "ThingsBoard_Emulator.h"
+
+// Library includes.
+#include <array>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+// Amount of runs with a different seed of the broker, which decides the latency, loss and reordering of every message
+constexpr uint32_t TEST_SEEDS = 5U;
+// Latency in microseconds every message is delivered after, chosen uniformly between 0 and this value
+constexpr uint64_t MAX_LATENCY = 1000U;
+// Probability in percent of a message being lost
+constexpr uint8_t LOSS_PERCENT = 3U;
+// Probability in percent of a message being held back, so that following messages overtake it, and the time in microseconds it is held back for
+constexpr uint8_t REORDER_PERCENT = 20U;
+constexpr uint64_t REORDER_DELAY = 3000U;
+// Time in microseconds until a request without a response is repeated, either by the client itself or by the test
+constexpr uint64_t REQUEST_TIMEOUT_US = 20000U;
+// Time in microseconds every step of the test may take at most, before it is considered as failed
+constexpr uint64_t STEP_TIMEOUT_US = 10000000U;
+// Receive and send buffer size of the client
+constexpr uint16_t CLIENT_BUFFER_SIZE = 512U;
+// Identifier of the emulated device, used in the topics of the server side RPC and the firmware chunks
+constexpr char DEVICE_ID[] = "Loopback_Device";
+// Server side RPC method and its parameters
+constexpr char RPC_METHOD[] = "set_led";
+constexpr char RPC_PARAMS[] = "{\"on\":true}";
+constexpr char RPC_RESPONSE[] = "{\"led\":true}";
+// Requested client side attribute keys
+constexpr char MODE_KEY[] = "mode";
+constexpr char INTERVAL_KEY[] = "interval";
+// Title and version of the firmware the device is currently running, and version of the firmware served by the emulator
+constexpr char FIRMWARE_TITLE[] = "loopback";
+constexpr char CURRENT_VERSION[] = "1.0.0";
+constexpr char UPDATED_VERSION[] = "1.1.0";
+// Size of the served firmware binary and of the chunks it is downloaded in
+constexpr size_t FIRMWARE_SIZE = 40000U;
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 1024U;
+// Amount of times a single chunk is requested again before the update fails
+constexpr uint8_t FIRMWARE_CHUNK_RETRIES = 20U;
+
+
+/// @brief Updater that keeps the written firmware binary in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_data.clear();
+        m_size = firmware_size;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_data.insert(m_data.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_data.clear();
+    }
+
+    bool end() override {
+        return m_data.size() == m_size;
+    }
+
+    std::vector<uint8_t> const & Get_Data() const {
+        return m_data;
+    }
+
+  private:
+    std::vector<uint8_t> m_data = {}; // Written firmware binary
+    size_t               m_size = {}; // Size of the firmware binary passed to begin()
+};
+
+/// @brief Attribute request of the emulated device, implements the device identity the API implementations of this library require
+class Device_Attribute_Request : public Attribute_Request<1U, 2U> {
+  public:
+    char const * GetDeviceId() override {
+        return DEVICE_ID;
+    }
+
+    void SetDeviceId(char const * /*device_id*/) override {
+        // Nothing to do
+    }
+
+    char const * GetDeviceProfile() override {
+        return "";
+    }
+
+    void SetDeviceProfile(char const * /*device_profile*/) override {
+        // Nothing to do
+    }
+};
+
+
+/// @brief Calls loop() of the ThingsBoard client until the given condition is met or the step timeout expires
+/// @param tb ThingsBoard client that should handle the received messages
+/// @param condition Condition that should be met
+/// @param retry Method that is called every time the request timeout expired without the condition being met
+/// @return Whether the condition was met before the step timeout expired
+template <typename ThingsBoard_Client, typename Condition, typename Retry>
+static bool Loop_Until(ThingsBoard_Client & tb, Condition condition, Retry retry) {
+    uint64_t const start = Helper::getTimeMicroseconds();
+    uint64_t last_retry = start;
+    while (!condition()) {
+        uint64_t const now = Helper::getTimeMicroseconds();
+        if (now - start > STEP_TIMEOUT_US) {
+            return false;
+        }
+        else if (now - last_retry > REQUEST_TIMEOUT_US) {
+            retry();
+            last_retry = now;
+        }
+        (void)tb.loop();
+    }
+    return true;
+}
+
+/// @brief Prints the given message if the check failed and counts the failure
+/// @param passed Whether the check passed
+/// @param message Message describing the check
+/// @param seed Seed of the broker the check was run with
+/// @param failures Amount of failed checks, increased if the check failed
+static void Check(bool const & passed, char const * message, uint32_t const & seed, size_t & failures) {
+    if (!passed) {
+        printf("Check failed with seed (%u): %s\n", seed, message);
+        failures++;
+    }
+}
+
+int main() {
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    for (size_t i = 0U; i < firmware.size(); i++) {
+        firmware[i] = static_cast<uint8_t>((i * 31U) ^ (i >> 7U));
+    }
+    HashGenerator hash;
+    (void)hash.start(Checksum_Algorithm::SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    char checksum[FIRMWARE_HASH_SIZE] = {};
+    (void)hash.finish(checksum);
+
+    size_t failures = 0U;
+    for (uint32_t seed = 1U; seed <= TEST_SEEDS; seed++) {
+        Loopback_MQTT_Broker broker;
+        broker.Set_Seed(seed);
+        broker.Set_Latency(0U, MAX_LATENCY);
+        broker.Set_Loss(LOSS_PERCENT);
+        broker.Set_Reordering(REORDER_PERCENT, REORDER_DELAY);
+        ThingsBoard_Emulator emulator(broker);
+        emulator.Set_Client_Attribute(MODE_KEY, "\"eco\"");
+        emulator.Set_Client_Attribute(INTERVAL_KEY, "30");
+        emulator.Set_Firmware(FIRMWARE_TITLE, UPDATED_VERSION, firmware.data(), firmware.size());
+        emulator.Set_Shared_Attribute(FW_TITLE_KEY, (std::string("\"") + FIRMWARE_TITLE + "\"").c_str());
+        emulator.Set_Shared_Attribute(FW_VER_KEY, (std::string("\"") + UPDATED_VERSION + "\"").c_str());
+        emulator.Set_Shared_Attribute(FW_CHKS_KEY, (std::string("\"") + checksum + "\"").c_str());
+        emulator.Set_Shared_Attribute(FW_CHKS_ALGO_KEY, (std::string("\"") + CHECKSUM_AGORITM_SHA256 + "\"").c_str());
+        emulator.Set_Shared_Attribute(FW_SIZE_KEY, std::to_string(firmware.size()).c_str());
+
+        Loopback_MQTT_Client<> client(broker);
+        Server_Side_RPC<1U, 1U> rpc;
+        OTA_Firmware_Update<> ota;
+        Device_Attribute_Request attribute_request;
+        std::array<IAPI_Implementation *, 3U> const apis = {&rpc, &ota, &attribute_request};
+        ThingsBoardSized<> tb(client, CLIENT_BUFFER_SIZE, CLIENT_BUFFER_SIZE, Default_Max_Stack_Size, apis);
+        rpc.SetDeviceId(DEVICE_ID);
+        ota.SetDeviceId(DEVICE_ID);
+        Check(tb.connect("localhost", "token"), "connecting to the loopback broker", seed, failures);
+
+        // Server side RPC request or its response might be lost, in which case the server sends the request again with a new request id
+        Check(rpc.RPC_Subscribe(RPC_Callback(RPC_METHOD, [](JsonVariantConst const & data, JsonDocument & response) {
+            response["led"] = data["on"].as<bool>();
+        })), "subscribing the server side RPC", seed, failures);
+        size_t rpc_id = emulator.Send_RPC(DEVICE_ID, RPC_METHOD, RPC_PARAMS);
+        std::string rpc_response = {};
+        Check(Loop_Until(tb, [&]() { return emulator.Get_RPC_Response(rpc_id, rpc_response); }, [&]() { rpc_id = emulator.Send_RPC(DEVICE_ID, RPC_METHOD, RPC_PARAMS); }) &&
+          rpc_response == RPC_RESPONSE, "answering the server side RPC request", seed, failures);
+
+        // Attribute request is sent again once its timeout expired, which the client reports with the timeout callback
+        std::string mode = {};
+        int interval = 0;
+        bool attributes_timed_out = false;
+        constexpr std::array<char const *, 2U> attribute_keys = {MODE_KEY, INTERVAL_KEY};
+        Attribute_Request_Callback<2U> const attribute_callback([&](JsonObjectConst const & data) {
+            char const * received_mode = data[MODE_KEY];
+            mode = received_mode != nullptr ? received_mode : "";
+            interval = data[INTERVAL_KEY].as<int>();
+        }, REQUEST_TIMEOUT_US, [&]() { attributes_timed_out = true; }, attribute_keys.cbegin(), attribute_keys.cend());
+        Check(attribute_request.Client_Attributes_Request(attribute_callback), "sending the attribute request", seed, failures);
+        Check(Loop_Until(tb, [&]() { return !mode.empty(); }, [&]() {
+            if (attributes_timed_out) {
+                attributes_timed_out = false;
+                (void)attribute_request.Client_Attributes_Request(attribute_callback);
+            }
+        }) && mode == "eco" && interval == 30, "receiving the requested client side attributes", seed, failures);
+
+        // Firmware attribute request is sent again if the update did not start before its timeout expired, lost chunks are requested again by the client itself
+        Memory_Updater updater;
+        bool update_started = false;
+        int update_result = -1;
+        OTA_Update_Callback const update_callback(FIRMWARE_TITLE, CURRENT_VERSION, &updater, [&](bool const & success) { update_result = success ? 1 : 0; },
+          [&](size_t const & /*current*/, size_t const & /*total*/) { update_started = true; }, nullptr, FIRMWARE_CHUNK_RETRIES, FIRMWARE_CHUNK_SIZE, REQUEST_TIMEOUT_US);
+        Check(ota.Start_Firmware_Update(update_callback), "starting the firmware update", seed, failures);
+        Check(Loop_Until(tb, [&]() { return update_result >= 0; }, [&]() {
+            if (!update_started && emulator.Get_Firmware_Chunk_Requests() == 0U) {
+                (void)ota.Start_Firmware_Update(update_callback);
+            }
+        }) && update_result == 1 && updater.Get_Data() == firmware, "downloading the firmware binary", seed, failures);
+
+        printf("Seed (%u) delivered (%zu) and lost (%zu) messages, answered (%zu) firmware chunk requests\n", seed, broker.Get_Delivered_Messages(), broker.Get_Lost_Messages(),
+          emulator.Get_Firmware_Chunk_Requests());
+    }
+    printf("%zu failed checks\n", failures);
+    return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+// Header include.
+#include "Loopback_MQTT_Broker.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local include.
+#include "Helper.h"
+
+// Library include.
+#include <algorithm>
+
+
+Loopback_MQTT_Broker::Loopback_MQTT_Broker()
+  : m_clock()
+  , m_has_clock(false)
+  , m_random_state(1U)
+  , m_min_latency(0U)
+  , m_max_latency(0U)
+  , m_loss_percent(0U)
+  , m_reorder_percent(0U)
+  , m_reorder_delay(0U)
+  , m_sessions()
+  , m_handlers()
+  , m_pending()
+  , m_next_session(SERVER_SESSION + 1U)
+  , m_next_handler(1U)
+  , m_next_sequence(0U)
+  , m_delivered(0U)
+  , m_lost(0U)
+{
+    // Nothing to do
+}
+
+void Loopback_MQTT_Broker::Set_Clock(Callback<uint64_t>::function clock) {
+    m_clock.Set_Callback(clock);
+    m_has_clock = clock != nullptr;
+}
+
+void Loopback_MQTT_Broker::Set_Seed(uint32_t const & seed) {
+    m_random_state = seed != 0U ? seed : 1U;
+}
+
+void Loopback_MQTT_Broker::Set_Latency(uint64_t const & min_latency_us, uint64_t const & max_latency_us) {
+    m_min_latency = min_latency_us;
+    m_max_latency = max_latency_us < min_latency_us ? min_latency_us : max_latency_us;
+}
+
+void Loopback_MQTT_Broker::Set_Loss(uint8_t const & loss_percent) {
+    m_loss_percent = loss_percent;
+}
+
+void Loopback_MQTT_Broker::Set_Reordering(uint8_t const & reorder_percent, uint64_t const & reorder_delay_us) {
+    m_reorder_percent = reorder_percent;
+    m_reorder_delay = reorder_delay_us;
+}
+
+size_t Loopback_MQTT_Broker::Add_Handler(char const * filter, Message_Callback::function handler) {
+    if (filter == nullptr) {
+        return 0U;
+    }
+    size_t const id = m_next_handler++;
+    m_handlers.push_back(Handler{id, filter, Message_Callback(handler)});
+    return id;
+}
+
+void Loopback_MQTT_Broker::Remove_Handler(size_t const & handler) {
+    m_handlers.erase(std::remove_if(m_handlers.begin(), m_handlers.end(), [&handler](Handler const & added) { return added.id == handler; }), m_handlers.end());
+}
+
+size_t Loopback_MQTT_Broker::Connect(Message_Callback::function deliver) {
+    size_t const session = m_next_session++;
+    m_sessions.push_back(Session{session, Message_Callback(deliver), {}});
+    return session;
+}
+
+void Loopback_MQTT_Broker::Disconnect(size_t const & session) {
+    m_sessions.erase(std::remove_if(m_sessions.begin(), m_sessions.end(), [&session](Session const & connected) { return connected.id == session; }), m_sessions.end());
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        it = it->second.receiver == session ? m_pending.erase(it) : std::next(it);
+    }
+}
+
+bool Loopback_MQTT_Broker::Is_Connected(size_t const & session) const {
+    return std::any_of(m_sessions.cbegin(), m_sessions.cend(), [&session](Session const & connected) { return connected.id == session; });
+}
+
+bool Loopback_MQTT_Broker::Subscribe(size_t const & session, char const * filter) {
+    Session * const connected = Find_Session(session);
+    if (connected == nullptr || filter == nullptr) {
+        return false;
+    }
+    connected->subscriptions.emplace_back(filter);
+    return true;
+}
+
+bool Loopback_MQTT_Broker::Unsubscribe(size_t const & session, char const * filter) {
+    Session * const connected = Find_Session(session);
+    if (connected == nullptr || filter == nullptr) {
+        return false;
+    }
+    auto const it = std::find(connected->subscriptions.begin(), connected->subscriptions.end(), filter);
+    if (it == connected->subscriptions.end()) {
+        return false;
+    }
+    connected->subscriptions.erase(it);
+    return true;
+}
+
+bool Loopback_MQTT_Broker::Publish(size_t const & session, char const * topic, uint8_t const * payload, size_t const & length) {
+    if (topic == nullptr || (session != SERVER_SESSION && Find_Session(session) == nullptr)) {
+        return false;
+    }
+    String_View const topic_view(topic);
+    for (Session const & connected : m_sessions) {
+        if (Is_Subscribed(connected, topic_view)) {
+            Enqueue(session, connected.id, topic, payload, length);
+        }
+    }
+    if (session != SERVER_SESSION && std::any_of(m_handlers.cbegin(), m_handlers.cend(), [&topic_view](Handler const & handler) { return Topic_Matches(handler.filter.c_str(), topic_view); })) {
+        Enqueue(session, SERVER_SESSION, topic, payload, length);
+    }
+    return true;
+}
+
+bool Loopback_MQTT_Broker::Send(size_t const & session, char const * topic, uint8_t const * payload, size_t const & length) {
+    Session const * const connected = Find_Session(session);
+    if (topic == nullptr || connected == nullptr || !Is_Subscribed(*connected, topic)) {
+        return false;
+    }
+    Enqueue(SERVER_SESSION, session, topic, payload, length);
+    return true;
+}
+
+void Loopback_MQTT_Broker::Process(size_t const & session) {
+    // Delivering a message might enqueue new messages, for example the response of a handler, which are delivered in the same call if they are already due.
+    // Therefore the search is restarted from the earliest message after every delivered message
+    bool delivered = true;
+    while (delivered) {
+        delivered = false;
+        uint64_t const now = Get_Time();
+        for (auto it = m_pending.begin(); it != m_pending.end() && it->first.first <= now; ++it) {
+            if (it->second.receiver != SERVER_SESSION && it->second.receiver != session) {
+                continue;
+            }
+            Pending_Message message = std::move(it->second);
+            m_pending.erase(it);
+            Deliver(message);
+            delivered = true;
+            break;
+        }
+    }
+}
+
+size_t Loopback_MQTT_Broker::Get_Pending_Messages() const {
+    return m_pending.size();
+}
+
+size_t Loopback_MQTT_Broker::Get_Delivered_Messages() const {
+    return m_delivered;
+}
+
+size_t Loopback_MQTT_Broker::Get_Lost_Messages() const {
+    return m_lost;
+}
+
+bool Loopback_MQTT_Broker::Topic_Matches(String_View const & filter, String_View const & topic) {
+    return Helper::topicMatches(filter, topic);
+}
+
+uint64_t Loopback_MQTT_Broker::Get_Time() const {
+    return m_has_clock ? m_clock.Call_Callback() : Helper::getTimeMicroseconds();
+}
+
+uint32_t Loopback_MQTT_Broker::Get_Random() {
+    m_random_state ^= m_random_state << 13U;
+    m_random_state ^= m_random_state >> 17U;
+    m_random_state ^= m_random_state << 5U;
+    return m_random_state;
+}
+
+Loopback_MQTT_Broker::Session * Loopback_MQTT_Broker::Find_Session(size_t const & session) {
+    auto const it = std::find_if(m_sessions.begin(), m_sessions.end(), [&session](Session const & connected) { return connected.id == session; });
+    return it != m_sessions.end() ? &(*it) : nullptr;
+}
+
+bool Loopback_MQTT_Broker::Is_Subscribed(Session const & session, String_View const & topic) {
+    return std::any_of(session.subscriptions.cbegin(), session.subscriptions.cend(), [&topic](std::string const & filter) { return Topic_Matches(String_View(filter.data(), filter.size()), topic); });
+}
+
+void Loopback_MQTT_Broker::Enqueue(size_t const & sender, size_t const & receiver, char const * topic, uint8_t const * payload, size_t const & length) {
+    if (m_loss_percent > 0U && Get_Random() % 100U < m_loss_percent) {
+        m_lost++;
+        return;
+    }
+    uint64_t latency = m_min_latency;
+    if (m_max_latency > m_min_latency) {
+        latency += Get_Random() % (m_max_latency - m_min_latency + 1U);
+    }
+    if (m_reorder_percent > 0U && Get_Random() % 100U < m_reorder_percent) {
+        latency += m_reorder_delay;
+    }
+    Pending_Message message = {sender, receiver, topic, std::vector<uint8_t>()};
+    if (payload != nullptr && length > 0U) {
+        message.payload.assign(payload, payload + length);
+    }
+    (void)m_pending.emplace(std::make_pair(Get_Time() + latency, m_next_sequence++), std::move(message));
+}
+
+void Loopback_MQTT_Broker::Deliver(Pending_Message & message) {
+    String_View const topic(message.topic.data(), message.topic.size());
+    m_delivered++;
+    if (message.receiver == SERVER_SESSION) {
+        // Handlers might add or remove handlers, which would invalidate iterators, therefore they are accessed by index
+        for (size_t i = 0U; i < m_handlers.size(); i++) {
+            if (!Topic_Matches(m_handlers[i].filter.c_str(), topic)) {
+                continue;
+            }
+            Message_Callback const handler = m_handlers[i].handler;
+            handler.Call_Callback(message.sender, topic, message.payload.data(), message.payload.size());
+        }
+        return;
+    }
+    Session const * const connected = Find_Session(message.receiver);
+    // Session might have unsubscribed in the meantime, in which case the message is not delivered anymore
+    if (connected == nullptr || !Is_Subscribed(*connected, topic)) {
+        return;
+    }
+    // Copied because the session might disconnect while the message is delivered, which removes it from the connected sessions
+    Message_Callback const deliver = connected->deliver;
+    deliver.Call_Callback(message.sender, topic, message.payload.data(), message.payload.size());
+}
+
+#endif // THINGSBOARD_ENABLE_STL
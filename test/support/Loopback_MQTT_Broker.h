@@ -0,0 +1,211 @@
+#ifndef Loopback_MQTT_Broker_h
+#define Loopback_MQTT_Broker_h
+
+// Local includes.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "Callback.h"
+#include "String_View.h"
+
+// Library includes.
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/// @brief Minimal in-process MQTT broker, that routes the messages of Loopback_MQTT_Client instances to each other and to server side handlers, without any network access.
+/// Allows to exercise the ThingsBoard client end to end in integration tests and benchmarks, for example together with the ThingsBoard_Emulator, which registers itself as the server side handlers.
+/// Every message is delivered after a configurable latency and can additionally be lost or held back so that following messages overtake it, all decided by a seeded pseudo random generator,
+/// which makes runs with the same seed and the same clock repeatable. Messages are only delivered from within Process(), which is called by the loop() method of every Loopback_MQTT_Client,
+/// meaning all callbacks are called in the thread calling loop() and the broker is not thread safe
+class Loopback_MQTT_Broker {
+  public:
+    /// @brief Callback signature of handlers and connected sessions receiving messages,
+    /// with the session the message was published by (0 for the server side), the topic, the payload and the size of the payload
+    using Message_Callback = Callback<void, size_t, String_View const &, uint8_t *, size_t>;
+
+    /// @brief Server side session, that publishes messages which are only delivered to client sessions and receives all messages passed to handlers
+    static size_t constexpr SERVER_SESSION = 0U;
+
+    /// @brief Constructs a broker without any sessions or handlers, that delivers messages without latency, loss or reordering
+    /// and uses Helper::getTimeMicroseconds() as the clock
+    Loopback_MQTT_Broker();
+
+    /// @brief Sets the clock used to decide when a message is delivered, allows to use a simulated clock to make tests independent of the actual time it takes to run them
+    /// @param clock Method returning the current time in microseconds, nullptr uses Helper::getTimeMicroseconds() again
+    void Set_Clock(Callback<uint64_t>::function clock);
+
+    /// @brief Sets the seed of the pseudo random generator, that decides the latency, loss and reordering of every message
+    /// @param seed Seed of the generator, 0 is replaced with 1 because the generator would otherwise only return 0, default = 1
+    void Set_Seed(uint32_t const & seed);
+
+    /// @brief Sets the latency every message is delivered after, chosen uniformly between the minimum and maximum for every message
+    /// @param min_latency_us Minimum latency in microseconds
+    /// @param max_latency_us Maximum latency in microseconds, is set to the minimum if it is smaller
+    void Set_Latency(uint64_t const & min_latency_us, uint64_t const & max_latency_us);
+
+    /// @brief Sets the probability of a message being lost instead of delivered
+    /// @param loss_percent Probability in percent, values bigger than 100 are handled as 100
+    void Set_Loss(uint8_t const & loss_percent);
+
+    /// @brief Sets the probability of a message being held back, so that the messages published after it within the given delay are delivered first
+    /// @param reorder_percent Probability in percent, values bigger than 100 are handled as 100
+    /// @param reorder_delay_us Time in microseconds a message is held back additionally to its latency
+    void Set_Reordering(uint8_t const & reorder_percent, uint64_t const & reorder_delay_us);
+
+    /// @brief Adds a server side handler, which receives every message published by a client session on a topic matching the given filter.
+    /// Handlers are called in the order they have been added, until they are removed again with Remove_Handler()
+    /// @param filter Topic filter the topic of the message has to match, may contain the single level wildcard + and the multi level wildcard #
+    /// @param handler Method that should be called with the published message
+    /// @return Identifier of the added handler, has to be passed to Remove_Handler() before anything the handler references is destroyed, 0 if the filter is nullptr
+    size_t Add_Handler(char const * filter, Message_Callback::function handler);
+
+    /// @brief Removes the given server side handler, so it is not called for any following message, including messages that have already been published
+    /// @param handler Identifier of the handler returned by Add_Handler()
+    void Remove_Handler(size_t const & handler);
+
+    /// @brief Connects a new client session, which receives the messages of the topics it subscribes afterwards
+    /// @param deliver Method that should be called with every message delivered to the session
+    /// @return Identifier of the created session, never 0
+    size_t Connect(Message_Callback::function deliver);
+
+    /// @brief Disconnects the given session, removes all its subscriptions and discards the messages that have not been delivered to it yet
+    /// @param session Identifier of the session
+    void Disconnect(size_t const & session);
+
+    /// @brief Whether the given session is connected
+    /// @param session Identifier of the session
+    /// @return Whether the session has been connected and not disconnected since
+    bool Is_Connected(size_t const & session) const;
+
+    /// @brief Subscribes the given session to all topics matching the given filter
+    /// @param session Identifier of the session
+    /// @param filter Topic filter, may contain the single level wildcard + and the multi level wildcard #
+    /// @return Whether the subscription was added, fails if the session is not connected
+    bool Subscribe(size_t const & session, char const * filter);
+
+    /// @brief Removes the subscription of the given session with exactly the given filter
+    /// @param session Identifier of the session
+    /// @param filter Topic filter that was previously subscribed
+    /// @return Whether the subscription existed and was removed
+    bool Unsubscribe(size_t const & session, char const * filter);
+
+    /// @brief Publishes a message, which is delivered to every client session subscribed to a matching topic after the configured latency.
+    /// Messages of client sessions are additionally passed to every matching server side handler, with the same latency, loss and reordering
+    /// @param session Identifier of the publishing session or SERVER_SESSION if the message is published by the server side
+    /// @param topic Topic the message is published on
+    /// @param payload Payload of the message, copied so it does not have to stay valid until the message is delivered
+    /// @param length Amount of bytes in the payload
+    /// @return Whether the message was published, fails if the publishing client session is not connected
+    bool Publish(size_t const & session, char const * topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Sends a message from the server side to only the given client session, if it is subscribed to a matching topic.
+    /// Allows handlers to respond only to the session that sent the request, the same as ThingsBoard does for the v1/devices/me topics
+    /// @param session Identifier of the receiving client session
+    /// @param topic Topic the message is sent on
+    /// @param payload Payload of the message, copied so it does not have to stay valid until the message is delivered
+    /// @param length Amount of bytes in the payload
+    /// @return Whether the message was sent, fails if the session is not connected or not subscribed to a matching topic
+    bool Send(size_t const & session, char const * topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Delivers all messages that are due to the server side handlers and to the given client session, including messages that become due while doing so
+    /// @param session Identifier of the client session, whose messages should be delivered
+    void Process(size_t const & session);
+
+    /// @brief Gets the amount of messages that have been published or sent, but have not been delivered or lost yet
+    /// @return Amount of pending messages
+    size_t Get_Pending_Messages() const;
+
+    /// @brief Gets the amount of messages that have been delivered to handlers or sessions since this instance has been created
+    /// @return Amount of delivered messages
+    size_t Get_Delivered_Messages() const;
+
+    /// @brief Gets the amount of messages that have been lost because of the configured loss since this instance has been created
+    /// @return Amount of lost messages
+    size_t Get_Lost_Messages() const;
+
+    /// @brief Whether the given topic matches the given topic filter, following the wildcard rules of MQTT 3.1.1
+    /// @param filter Topic filter, may contain the single level wildcard + and the multi level wildcard #
+    /// @param topic Topic without wildcards
+    /// @return Whether the topic matches
+    static bool Topic_Matches(String_View const & filter, String_View const & topic);
+
+  private:
+    /// @brief Connected client session
+    struct Session {
+        size_t                   id;            // Identifier of the session
+        Message_Callback         deliver;       // Method messages are delivered to
+        std::vector<std::string> subscriptions; // Topic filters the session subscribed to
+    };
+
+    /// @brief Server side handler
+    struct Handler {
+        size_t           id;      // Identifier of the handler
+        std::string      filter;  // Topic filter the handler receives the messages of
+        Message_Callback handler; // Method messages are passed to
+    };
+
+    /// @brief Message that has not been delivered yet
+    struct Pending_Message {
+        size_t               sender;   // Session the message was published by
+        size_t               receiver; // Session the message is delivered to, SERVER_SESSION if it is passed to the handlers
+        std::string          topic;    // Topic of the message
+        std::vector<uint8_t> payload;  // Copy of the payload
+    };
+
+    /// @brief Gets the current time of the configured clock
+    /// @return Time in microseconds
+    uint64_t Get_Time() const;
+
+    /// @brief Gets the next value of the pseudo random generator (xorshift32)
+    /// @return Pseudo random value
+    uint32_t Get_Random();
+
+    /// @brief Gets the session with the given identifier
+    /// @param session Identifier of the session
+    /// @return Pointer to the session or nullptr if it is not connected
+    Session * Find_Session(size_t const & session);
+
+    /// @brief Whether the given session is subscribed to a topic filter matching the given topic
+    /// @param session Session whose subscriptions are checked
+    /// @param topic Topic that has to match
+    /// @return Whether any subscription matches
+    static bool Is_Subscribed(Session const & session, String_View const & topic);
+
+    /// @brief Enqueues the message to the given receiver, applying the configured latency, loss and reordering
+    /// @param sender Session the message was published by
+    /// @param receiver Session the message is delivered to, SERVER_SESSION if it is passed to the handlers
+    /// @param topic Topic of the message
+    /// @param payload Payload of the message
+    /// @param length Amount of bytes in the payload
+    void Enqueue(size_t const & sender, size_t const & receiver, char const * topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Delivers a message that is due to its receiver
+    /// @param message Message that should be delivered, its payload may be modified by the receiver
+    void Deliver(Pending_Message & message);
+
+    Callback<uint64_t>                                            m_clock = {};           // Clock deciding when messages are due, Helper::getTimeMicroseconds() if not set
+    bool                                                          m_has_clock = {};       // Whether a clock has been set
+    uint32_t                                                      m_random_state = {};    // State of the pseudo random generator
+    uint64_t                                                      m_min_latency = {};     // Minimum latency in microseconds
+    uint64_t                                                      m_max_latency = {};     // Maximum latency in microseconds
+    uint8_t                                                       m_loss_percent = {};    // Probability of a message being lost
+    uint8_t                                                       m_reorder_percent = {}; // Probability of a message being held back
+    uint64_t                                                      m_reorder_delay = {};   // Time in microseconds a held back message is delayed additionally
+    std::vector<Session>                                          m_sessions = {};        // Connected client sessions
+    std::vector<Handler>                                          m_handlers = {};        // Server side handlers
+    std::map<std::pair<uint64_t, uint64_t>, Pending_Message>      m_pending = {};         // Messages that have not been delivered yet, ordered by the time they are due and the order they were enqueued in
+    size_t                                                        m_next_session = {};    // Identifier of the next connected session
+    size_t                                                        m_next_handler = {};    // Identifier of the next added handler
+    uint64_t                                                      m_next_sequence = {};   // Sequence number of the next enqueued message, keeps messages due at the same time in order
+    size_t                                                        m_delivered = {};       // Amount of delivered messages
+    size_t                                                        m_lost = {};            // Amount of lost messages
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Loopback_MQTT_Broker_h
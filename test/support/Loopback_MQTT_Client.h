@@ -0,0 +1,279 @@
+#ifndef Loopback_MQTT_Client_h
+#define Loopback_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "Loopback_MQTT_Broker.h"
+
+// Library includes.
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Default receive and send buffer size, used until set_buffer_size() is called, the same default as the PubSubClient uses
+constexpr uint16_t LOOPBACK_MQTT_DEFAULT_BUFFER_SIZE = 256U;
+// Size of the fixed header with a remaining length encoded in 2 bytes plus the 2 bytes topic length, the send and receive buffer have to be big enough to hold it together with the topic and payload
+constexpr size_t LOOPBACK_MQTT_PACKET_OVERHEAD = 5U;
+constexpr char LOOPBACK_MQTT_NOT_CONNECTED[] = "Loopback session is not connected";
+constexpr char LOOPBACK_MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char LOOPBACK_MQTT_SEND_EXCEEDS_BUFFER[] = "Amount of data to send (%u) is bigger than current send buffer size (%u), increase accordingly";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char LOOPBACK_MQTT_CONNECTED[] = "Connected to loopback broker as session (%u)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief MQTT Client interface implementation that connects to a Loopback_MQTT_Broker in the same process instead of a server, without any network access.
+/// Allows to run the ThingsBoard client end to end in integration tests and benchmarks, while the broker decides the latency, loss and reordering of every message
+/// and the ThingsBoard_Emulator answers the requests of the client the same as a ThingsBoard server would.
+/// Buffer sizes are enforced the same way a real MQTT client does, meaning a message that would not fit into the receive buffer is discarded
+/// or passed in multiple parts to the fragment callback, which allows to exercise those code paths deterministically as well.
+/// Received messages are delivered from within loop(), the same as with the Arduino_MQTT_Client, meaning the ThingsBoard client does not need to be thread safe
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Loopback_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation, that does not connect to the given broker until connect() is called
+    /// @param broker Broker the client connects to, has to stay valid for as long as this instance exists
+    explicit Loopback_MQTT_Client(Loopback_MQTT_Broker & broker)
+      : m_broker(broker)
+      , m_session(Loopback_MQTT_Broker::SERVER_SESSION)
+      , m_received_data_callback()
+      , m_received_data_view_callback()
+      , m_receive_data_views(false)
+      , m_received_fragment_callback()
+      , m_receive_fragments(false)
+      , m_dropped_messages(0U)
+      , m_connected_callback()
+      , m_receive_buffer_size(LOOPBACK_MQTT_DEFAULT_BUFFER_SIZE)
+      , m_send_buffer_size(LOOPBACK_MQTT_DEFAULT_BUFFER_SIZE)
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+      , m_publish_topic()
+      , m_publish_payload()
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor, disconnects from the broker if still connected
+    ~Loopback_MQTT_Client() {
+        disconnect();
+    }
+
+    Loopback_MQTT_Client(Loopback_MQTT_Client const &) = delete;
+
+    Loopback_MQTT_Client & operator=(Loopback_MQTT_Client const &) = delete;
+
+    /// @brief Gets the identifier of the session this client is connected to the broker with, allows the server side to send messages only to this client
+    /// @return Identifier of the session or Loopback_MQTT_Broker::SERVER_SESSION if the client is not connected
+    size_t get_session() const {
+        return m_session;
+    }
+
+    /// @brief Gets the amount of messages, that have been discarded since this instance has been created,
+    /// because they were bigger than the receive buffer and were not handled by the fragment callback
+    /// @return Amount of discarded messages
+    size_t get_dropped_messages() const {
+        return m_dropped_messages;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_callback.Set_Callback(callback);
+    }
+
+    bool set_data_view_callback(Callback<void, String_View const &, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_view_callback.Set_Callback(callback);
+        m_receive_data_views = true;
+        return true;
+    }
+
+    /// @brief Messages bigger than the receive buffer are passed in parts of the payload that fit into the receive buffer together with the topic,
+    /// once this callback has been set those parts are forwarded instead of discarding the message
+    bool set_fragment_callback(Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t>::function callback) override {
+        m_received_fragment_callback.Set_Callback(callback);
+        m_receive_fragments = true;
+        return true;
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connected_callback.Set_Callback(callback);
+    }
+
+    /// @brief Does not allocate any memory, because messages are kept by the broker until they are delivered, but enforces the given sizes for sent and received messages
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        if (receive_buffer_size == 0U) {
+            return false;
+        }
+        m_receive_buffer_size = receive_buffer_size;
+        m_send_buffer_size = send_buffer_size;
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    /// @brief Ignored, because the client always connects to the broker passed in the constructor
+    void set_server(char const * /*domain*/, uint16_t /*port*/) override {
+        // Nothing to do
+    }
+
+    /// @brief Credentials are not validated, because the broker accepts every session, the emulator differentiates devices by session instead
+    bool connect(char const * /*client_id*/, char const * /*user_name*/, char const * /*password*/) override {
+        disconnect();
+        m_session = m_broker.Connect(std::bind(&Loopback_MQTT_Client::deliver, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(LOOPBACK_MQTT_CONNECTED, m_session);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_connected_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        if (m_session == Loopback_MQTT_Broker::SERVER_SESSION) {
+            return;
+        }
+        m_broker.Disconnect(m_session);
+        m_session = Loopback_MQTT_Broker::SERVER_SESSION;
+    }
+
+    bool loop() override {
+        if (!connected()) {
+            return false;
+        }
+        m_broker.Process(m_session);
+        // The session might have been disconnected by one of the callbacks called while processing the received messages
+        return connected();
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        if (!connected()) {
+            Logger::printfln(LOOPBACK_MQTT_NOT_CONNECTED);
+            return false;
+        }
+        size_t const packet_size = get_packet_size(topic, length);
+        if (packet_size > m_send_buffer_size) {
+            Logger::printfln(LOOPBACK_MQTT_SEND_EXCEEDS_BUFFER, packet_size, m_send_buffer_size);
+            return false;
+        }
+        return m_broker.Publish(m_session, topic, payload, length);
+    }
+
+    bool subscribe(char const * topic) override {
+        return m_broker.Subscribe(m_session, topic);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        return m_broker.Unsubscribe(m_session, topic);
+    }
+
+    bool connected() override {
+        return m_session != Loopback_MQTT_Broker::SERVER_SESSION && m_broker.Is_Connected(m_session);
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override {
+        if (!connected() || topic == nullptr) {
+            return false;
+        }
+        m_publish_topic = topic;
+        m_publish_payload.clear();
+        m_publish_payload.reserve(length);
+        return true;
+    }
+
+    bool end_publish() override {
+        bool const result = connected() && m_broker.Publish(m_session, m_publish_topic.c_str(), m_publish_payload.data(), m_publish_payload.size());
+        m_publish_topic.clear();
+        m_publish_payload.clear();
+        return result;
+    }
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override {
+        m_publish_payload.push_back(payload_byte);
+        return 1U;
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        m_publish_payload.insert(m_publish_payload.end(), buffer, buffer + size);
+        return size;
+    }
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Gets the size the PUBLISH packet with the given topic and payload would have, used to enforce the buffer sizes the same as a real MQTT client
+    /// @param topic Topic of the message
+    /// @param length Amount of bytes in the payload
+    /// @return Size of the packet in bytes
+    static size_t get_packet_size(char const * topic, size_t const & length) {
+        return LOOPBACK_MQTT_PACKET_OVERHEAD + (topic != nullptr ? strlen(topic) : 0U) + length;
+    }
+
+    /// @brief Called by the broker from within loop() with every message delivered to the session of this client
+    /// @param sender Session the message was published by, unused because a real MQTT client does not know the publisher either
+    /// @param topic Topic of the message
+    /// @param payload Payload of the message, owned by the broker until this method returns
+    /// @param length Amount of bytes in the payload
+    void deliver(size_t const & /*sender*/, String_View const & topic, uint8_t * payload, size_t const & length) {
+        size_t const packet_size = LOOPBACK_MQTT_PACKET_OVERHEAD + topic.size() + length;
+        if (packet_size <= m_receive_buffer_size) {
+            if (m_receive_data_views) {
+                m_received_data_view_callback.Call_Callback(topic, payload, length);
+                return;
+            }
+            // Topic view points into the std::string kept by the broker, which is always null terminated
+            m_received_data_callback.Call_Callback(const_cast<char *>(topic.data()), payload, length);
+            return;
+        }
+        size_t const fragment_size = m_receive_buffer_size > LOOPBACK_MQTT_PACKET_OVERHEAD + topic.size() ? m_receive_buffer_size - LOOPBACK_MQTT_PACKET_OVERHEAD - topic.size() : 0U;
+        if (!m_receive_fragments || fragment_size == 0U) {
+            Logger::printfln(LOOPBACK_MQTT_DATA_EXCEEDS_BUFFER, packet_size, m_receive_buffer_size);
+            m_dropped_messages++;
+            return;
+        }
+        for (size_t offset = 0U; offset < length; offset += fragment_size) {
+            size_t const current_size = std::min(fragment_size, length - offset);
+            bool const handled = m_received_fragment_callback.Call_Callback(topic, payload + offset, offset, current_size, length);
+            if (offset == 0U && !handled) {
+                Logger::printfln(LOOPBACK_MQTT_DATA_EXCEEDS_BUFFER, packet_size, m_receive_buffer_size);
+                m_dropped_messages++;
+                return;
+            }
+        }
+    }
+
+    Loopback_MQTT_Broker &                                                 m_broker;                              // Broker the client connects to
+    size_t                                                                 m_session = {};                        // Identifier of the session, Loopback_MQTT_Broker::SERVER_SESSION while not connected
+    Callback<void, char *, uint8_t *, unsigned int>                        m_received_data_callback = {};         // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, String_View const &, uint8_t *, unsigned int>           m_received_data_view_callback = {};    // Callback that will be called instead of the data callback, with the topic passed as a view
+    bool                                                                   m_receive_data_views = {};             // Whether the data view callback has been set and should be called instead of the data callback
+    Callback<bool, String_View const &, uint8_t *, size_t, size_t, size_t> m_received_fragment_callback = {};     // Callback that will be called with the parts of messages bigger than the receive buffer
+    bool                                                                   m_receive_fragments = {};              // Whether the fragment callback has been set and messages bigger than the receive buffer should be forwarded to it
+    size_t                                                                 m_dropped_messages = {};               // Amount of messages discarded because they were bigger than the receive buffer
+    Callback<void>                                                         m_connected_callback = {};             // Callback that will be called as soon as the mqtt client has connected
+    uint16_t                                                               m_receive_buffer_size = {};            // Maximum size of received messages
+    uint16_t                                                               m_send_buffer_size = {};               // Maximum size of messages sent with publish()
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    std::string                                                            m_publish_topic = {};                  // Topic of the message started with begin_publish()
+    std::vector<uint8_t>                                                   m_publish_payload = {};                // Payload written since begin_publish() has been called
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Loopback_MQTT_Client_h
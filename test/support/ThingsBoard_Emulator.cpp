@@ -0,0 +1,247 @@
+// Header include.
+#include "ThingsBoard_Emulator.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local include.
+#include "Helper.h"
+
+// Library includes.
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+// Topics the emulator handles and responds on, the same the ThingsBoard client uses, but kept seperate so the emulator does not depend on the API implementations
+constexpr char EMULATOR_ATTRIBUTE_REQUEST_FILTER[] = "v1/devices/me/attributes/request/+";
+constexpr char EMULATOR_ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/";
+constexpr char EMULATOR_ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
+constexpr char EMULATOR_ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+constexpr char EMULATOR_TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
+constexpr char EMULATOR_FIRMWARE_REQUEST_FILTER[] = "v3/fw/request/by-name/#";
+constexpr char EMULATOR_FIRMWARE_REQUEST_TOPIC[] = "v3/fw/request/by-name/";
+constexpr char EMULATOR_FIRMWARE_RESPONSE_TOPIC[] = "v3/fw/response/by-name/";
+constexpr char EMULATOR_FIRMWARE_CHUNK[] = "chunk";
+constexpr char EMULATOR_RPC_RESPONSE_FILTER[] = "sensor/+/response/+";
+constexpr char EMULATOR_SENSOR_TOPIC[] = "sensor/";
+constexpr char EMULATOR_RPC_REQUEST_TOPIC[] = "/request/";
+constexpr char EMULATOR_RPC_RESPONSE_TOPIC[] = "/response/";
+constexpr char EMULATOR_SHARED_ATTRIBUTE_TOPIC[] = "/sattrs";
+// Keys of the attribute request and response
+constexpr char EMULATOR_CLIENT_REQUEST_KEYS[] = "clientKeys";
+constexpr char EMULATOR_SHARED_REQUEST_KEYS[] = "sharedKeys";
+constexpr char EMULATOR_CLIENT_RESPONSE_KEY[] = "client";
+constexpr char EMULATOR_SHARED_RESPONSE_KEY[] = "shared";
+
+
+ThingsBoard_Emulator::ThingsBoard_Emulator(Loopback_MQTT_Broker & broker)
+  : m_broker(broker)
+  , m_client_attributes()
+  , m_shared_attributes()
+  , m_firmware_title()
+  , m_firmware_version()
+  , m_firmware()
+  , m_rpc_responses()
+  , m_next_rpc_id(1U)
+  , m_attribute_requests(0U)
+  , m_firmware_requests(0U)
+  , m_telemetry_messages(0U)
+  , m_attribute_messages(0U)
+  , m_last_telemetry()
+  , m_handlers()
+{
+    m_handlers.push_back(m_broker.Add_Handler(EMULATOR_ATTRIBUTE_REQUEST_FILTER, [this](size_t const & session, String_View const & topic, uint8_t * payload, size_t const & length) {
+        Handle_Attribute_Request(session, topic, payload, length);
+    }));
+    m_handlers.push_back(m_broker.Add_Handler(EMULATOR_FIRMWARE_REQUEST_FILTER, [this](size_t const & session, String_View const & topic, uint8_t * payload, size_t const & length) {
+        Handle_Firmware_Request(session, topic, payload, length);
+    }));
+    m_handlers.push_back(m_broker.Add_Handler(EMULATOR_RPC_RESPONSE_FILTER, [this](size_t const & /*session*/, String_View const & topic, uint8_t * payload, size_t const & length) {
+        Handle_RPC_Response(topic, payload, length);
+    }));
+    m_handlers.push_back(m_broker.Add_Handler(EMULATOR_TELEMETRY_TOPIC, [this](size_t const & /*session*/, String_View const & /*topic*/, uint8_t * payload, size_t const & length) {
+        m_telemetry_messages++;
+        m_last_telemetry.assign(reinterpret_cast<char const *>(payload), length);
+    }));
+    m_handlers.push_back(m_broker.Add_Handler(EMULATOR_ATTRIBUTE_TOPIC, [this](size_t const & /*session*/, String_View const & /*topic*/, uint8_t * /*payload*/, size_t const & /*length*/) {
+        m_attribute_messages++;
+    }));
+}
+
+ThingsBoard_Emulator::~ThingsBoard_Emulator() {
+    // Handlers capture this instance, therefore they have to be removed before the broker could call them with the next message
+    for (size_t const & handler : m_handlers) {
+        m_broker.Remove_Handler(handler);
+    }
+}
+
+void ThingsBoard_Emulator::Set_Client_Attribute(char const * key, char const * json_value) {
+    if (key == nullptr || json_value == nullptr) {
+        return;
+    }
+    m_client_attributes[key] = json_value;
+}
+
+void ThingsBoard_Emulator::Set_Shared_Attribute(char const * key, char const * json_value) {
+    if (key == nullptr || json_value == nullptr) {
+        return;
+    }
+    m_shared_attributes[key] = json_value;
+}
+
+void ThingsBoard_Emulator::Set_Firmware(char const * title, char const * version, uint8_t const * firmware, size_t const & size) {
+    m_firmware_title = title != nullptr ? title : "";
+    m_firmware_version = version != nullptr ? version : "";
+    m_firmware.assign(firmware, firmware != nullptr ? firmware + size : firmware);
+}
+
+size_t ThingsBoard_Emulator::Send_RPC(char const * device_id, char const * method, char const * json_params) {
+    if (device_id == nullptr || method == nullptr) {
+        return 0U;
+    }
+    size_t const request_id = m_next_rpc_id++;
+    std::string const topic = std::string(EMULATOR_SENSOR_TOPIC) + device_id + EMULATOR_RPC_REQUEST_TOPIC + std::to_string(request_id);
+    std::string payload = std::string("{\"method\":\"") + method + "\"";
+    if (json_params != nullptr) {
+        payload.append(",\"params\":").append(json_params);
+    }
+    payload.push_back('}');
+    return m_broker.Publish(Loopback_MQTT_Broker::SERVER_SESSION, topic.c_str(), reinterpret_cast<uint8_t const *>(payload.data()), payload.size()) ? request_id : 0U;
+}
+
+bool ThingsBoard_Emulator::Get_RPC_Response(size_t const & request_id, std::string & response) const {
+    auto const it = m_rpc_responses.find(request_id);
+    if (it == m_rpc_responses.cend()) {
+        return false;
+    }
+    response = it->second;
+    return true;
+}
+
+bool ThingsBoard_Emulator::Update_Shared_Attribute(char const * device_id, char const * key, char const * json_value) {
+    if (device_id == nullptr || key == nullptr || json_value == nullptr) {
+        return false;
+    }
+    m_shared_attributes[key] = json_value;
+    std::string const topic = std::string(EMULATOR_SENSOR_TOPIC) + device_id + EMULATOR_SHARED_ATTRIBUTE_TOPIC;
+    std::string const payload = std::string("{\"") + key + "\":" + json_value + "}";
+    return m_broker.Publish(Loopback_MQTT_Broker::SERVER_SESSION, topic.c_str(), reinterpret_cast<uint8_t const *>(payload.data()), payload.size());
+}
+
+size_t ThingsBoard_Emulator::Get_Attribute_Requests() const {
+    return m_attribute_requests;
+}
+
+size_t ThingsBoard_Emulator::Get_Firmware_Chunk_Requests() const {
+    return m_firmware_requests;
+}
+
+size_t ThingsBoard_Emulator::Get_Telemetry_Messages() const {
+    return m_telemetry_messages;
+}
+
+size_t ThingsBoard_Emulator::Get_Attribute_Messages() const {
+    return m_attribute_messages;
+}
+
+std::string const & ThingsBoard_Emulator::Get_Last_Telemetry() const {
+    return m_last_telemetry;
+}
+
+void ThingsBoard_Emulator::Handle_Attribute_Request(size_t const & session, String_View const & topic, uint8_t const * payload, size_t const & length) {
+    size_t const request_id = Helper::parseRequestId(EMULATOR_ATTRIBUTE_REQUEST_TOPIC, topic);
+    std::string const request(reinterpret_cast<char const *>(payload), length);
+    std::string response = "{";
+    std::string const client_keys = Get_String_Value(request, EMULATOR_CLIENT_REQUEST_KEYS);
+    if (!client_keys.empty()) {
+        response.append("\"").append(EMULATOR_CLIENT_RESPONSE_KEY).append("\":{");
+        Append_Attributes(m_client_attributes, client_keys, response);
+        response.push_back('}');
+    }
+    std::string const shared_keys = Get_String_Value(request, EMULATOR_SHARED_REQUEST_KEYS);
+    if (!shared_keys.empty()) {
+        if (response.size() > 1U) {
+            response.push_back(',');
+        }
+        response.append("\"").append(EMULATOR_SHARED_RESPONSE_KEY).append("\":{");
+        Append_Attributes(m_shared_attributes, shared_keys, response);
+        response.push_back('}');
+    }
+    response.push_back('}');
+    m_attribute_requests++;
+    std::string const response_topic = std::string(EMULATOR_ATTRIBUTE_RESPONSE_TOPIC) + std::to_string(request_id);
+    (void)m_broker.Send(session, response_topic.c_str(), reinterpret_cast<uint8_t const *>(response.data()), response.size());
+}
+
+void ThingsBoard_Emulator::Handle_Firmware_Request(size_t const & session, String_View const & topic, uint8_t const * payload, size_t const & length) {
+    // Topic consists of the prefix followed by <device id>/<title>/<version>/chunk/<chunk>
+    std::string const request(topic.data(), topic.size());
+    size_t const prefix_length = strlen(EMULATOR_FIRMWARE_REQUEST_TOPIC);
+    std::vector<std::string> parts;
+    size_t start = prefix_length;
+    while (start <= request.size()) {
+        size_t const end = std::min(request.find('/', start), request.size());
+        parts.emplace_back(request, start, end - start);
+        start = end + 1U;
+    }
+    if (parts.size() != 5U || parts[3U] != EMULATOR_FIRMWARE_CHUNK || parts[1U] != m_firmware_title || parts[2U] != m_firmware_version) {
+        return;
+    }
+    size_t const chunk = strtoul(parts[4U].c_str(), nullptr, 10);
+    size_t const chunk_size = strtoul(std::string(reinterpret_cast<char const *>(payload), length).c_str(), nullptr, 10);
+    size_t const offset = std::min(chunk * chunk_size, m_firmware.size());
+    size_t const size = std::min(chunk_size, m_firmware.size() - offset);
+    m_firmware_requests++;
+    std::string const response_topic = std::string(EMULATOR_FIRMWARE_RESPONSE_TOPIC) + parts[0U] + "/" + EMULATOR_FIRMWARE_CHUNK + "/" + parts[4U];
+    (void)m_broker.Send(session, response_topic.c_str(), m_firmware.data() + offset, size);
+}
+
+void ThingsBoard_Emulator::Handle_RPC_Response(String_View const & topic, uint8_t const * payload, size_t const & length) {
+    std::string const response_topic(topic.data(), topic.size());
+    size_t const separator = response_topic.rfind(EMULATOR_RPC_RESPONSE_TOPIC);
+    if (separator == std::string::npos) {
+        return;
+    }
+    size_t const request_id = strtoul(response_topic.c_str() + separator + strlen(EMULATOR_RPC_RESPONSE_TOPIC), nullptr, 10);
+    m_rpc_responses[request_id].assign(reinterpret_cast<char const *>(payload), length);
+}
+
+void ThingsBoard_Emulator::Append_Attributes(std::map<std::string, std::string> const & attributes, std::string const & keys, std::string & json) {
+    bool first = true;
+    size_t start = 0U;
+    while (start <= keys.size()) {
+        size_t const end = std::min(keys.find(',', start), keys.size());
+        auto const it = attributes.find(keys.substr(start, end - start));
+        start = end + 1U;
+        if (it == attributes.cend()) {
+            continue;
+        }
+        if (!first) {
+            json.push_back(',');
+        }
+        json.append("\"").append(it->first).append("\":").append(it->second);
+        first = false;
+    }
+}
+
+std::string ThingsBoard_Emulator::Get_String_Value(std::string const & payload, char const * key) {
+    std::string const quoted_key = std::string("\"") + key + "\"";
+    size_t position = payload.find(quoted_key);
+    if (position == std::string::npos) {
+        return std::string();
+    }
+    position = payload.find_first_not_of(" \t\r\n", position + quoted_key.size());
+    if (position == std::string::npos || payload[position] != ':') {
+        return std::string();
+    }
+    position = payload.find_first_not_of(" \t\r\n", position + 1U);
+    if (position == std::string::npos || payload[position] != '"') {
+        return std::string();
+    }
+    size_t const end = payload.find('"', position + 1U);
+    if (end == std::string::npos) {
+        return std::string();
+    }
+    return payload.substr(position + 1U, end - position - 1U);
+}
+
+#endif // THINGSBOARD_ENABLE_STL
@@ -0,0 +1,148 @@
+#ifndef ThingsBoard_Emulator_h
+#define ThingsBoard_Emulator_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "Loopback_MQTT_Broker.h"
+
+// Library includes.
+#include <map>
+#include <string>
+#include <vector>
+
+
+/// @brief Scripted stand-in for a ThingsBoard server, that registers itself as the server side handlers of a Loopback_MQTT_Broker.
+/// Answers attribute requests (v1/devices/me/attributes/request/+) with the configured client and shared attributes, serves the chunks of the configured firmware binary
+/// (v3/fw/request/by-name/<device id>/<title>/<version>/chunk/<chunk>), issues server side RPC requests (sensor/<device id>/request/<request id>) and collects their responses,
+/// and pushes shared attribute updates (sensor/<device id>/sattrs). Together with the latency, loss and reordering of the broker this allows to exercise the complete
+/// request and response flow of the ThingsBoard client repeatably, without a real server. Attribute values and RPC parameters are kept as already serialized JSON,
+/// meaning a string value has to include its quotes, and the received payloads are only parsed as far as needed for the fixed formats the ThingsBoard client sends
+class ThingsBoard_Emulator {
+  public:
+    /// @brief Constructs the emulator and registers its handlers at the given broker
+    /// @param broker Broker the emulator receives requests from and sends responses over, has to stay valid for as long as this instance exists
+    explicit ThingsBoard_Emulator(Loopback_MQTT_Broker & broker);
+
+    /// @brief Destructor, removes the handlers of the emulator from the broker, which may therefore outlive this instance
+    ~ThingsBoard_Emulator();
+
+    ThingsBoard_Emulator(ThingsBoard_Emulator const &) = delete;
+
+    ThingsBoard_Emulator & operator=(ThingsBoard_Emulator const &) = delete;
+
+    /// @brief Sets the value of a client side attribute, that is returned if it is requested with its key in the clientKeys of an attribute request
+    /// @param key Key of the attribute
+    /// @param json_value Serialized JSON value of the attribute, for example 42, true or "text" including the quotes
+    void Set_Client_Attribute(char const * key, char const * json_value);
+
+    /// @brief Sets the value of a shared attribute, that is returned if it is requested with its key in the sharedKeys of an attribute request
+    /// @param key Key of the attribute
+    /// @param json_value Serialized JSON value of the attribute, for example 42, true or "text" including the quotes
+    void Set_Shared_Attribute(char const * key, char const * json_value);
+
+    /// @brief Sets the firmware binary, whose chunks are served to requests for the given title and version.
+    /// Does not set the fw_title, fw_version, fw_size, fw_checksum and fw_checksum_algorithm shared attributes, because the checksum depends on the algorithm the test wants to use
+    /// @param title Title of the firmware
+    /// @param version Version of the firmware
+    /// @param firmware Firmware binary, copied so it does not have to stay valid
+    /// @param size Amount of bytes in the firmware binary
+    void Set_Firmware(char const * title, char const * version, uint8_t const * firmware, size_t const & size);
+
+    /// @brief Issues a server side RPC request to all sessions subscribed to the request topic of the given device
+    /// @param device_id Identifier of the device the request is sent to
+    /// @param method Name of the called method
+    /// @param json_params Serialized JSON parameters of the request, nullptr sends the request without parameters
+    /// @return Request id the response will be received with, 0 if the device id or method is nullptr
+    size_t Send_RPC(char const * device_id, char const * method, char const * json_params);
+
+    /// @brief Gets the response of a previously issued server side RPC request
+    /// @param request_id Request id returned by Send_RPC()
+    /// @param response Serialized JSON response the device sent
+    /// @return Whether a response with the given request id has been received
+    bool Get_RPC_Response(size_t const & request_id, std::string & response) const;
+
+    /// @brief Pushes a shared attribute update to all sessions subscribed to the shared attribute topic of the given device
+    /// and additionally stores the updated values, so they are returned by following attribute requests
+    /// @param device_id Identifier of the device the update is sent to
+    /// @param key Key of the updated attribute
+    /// @param json_value Serialized JSON value of the attribute, for example 42, true or "text" including the quotes
+    /// @return Whether the update was published
+    bool Update_Shared_Attribute(char const * device_id, char const * key, char const * json_value);
+
+    /// @brief Gets the amount of attribute requests that have been answered since this instance has been created
+    /// @return Amount of answered attribute requests
+    size_t Get_Attribute_Requests() const;
+
+    /// @brief Gets the amount of firmware chunk requests that have been answered since this instance has been created
+    /// @return Amount of answered firmware chunk requests
+    size_t Get_Firmware_Chunk_Requests() const;
+
+    /// @brief Gets the amount of telemetry messages that have been received since this instance has been created
+    /// @return Amount of received telemetry messages
+    size_t Get_Telemetry_Messages() const;
+
+    /// @brief Gets the amount of client side attribute messages that have been received since this instance has been created
+    /// @return Amount of received client side attribute messages
+    size_t Get_Attribute_Messages() const;
+
+    /// @brief Gets the payload of the last received telemetry message
+    /// @return Serialized JSON payload, empty if no telemetry message has been received yet
+    std::string const & Get_Last_Telemetry() const;
+
+  private:
+    /// @brief Answers an attribute request with the requested client and shared attributes that are set, keys that are not set are left out the same as ThingsBoard does
+    /// @param session Session that sent the request and receives the response
+    /// @param topic Topic of the request, containing the request id
+    /// @param payload Serialized JSON request, containing the comma seperated clientKeys and sharedKeys
+    /// @param length Amount of bytes in the payload
+    void Handle_Attribute_Request(size_t const & session, String_View const & topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Answers a firmware chunk request with the bytes starting at the requested chunk multiplied with the requested chunk size,
+    /// or an empty payload if the chunk starts after the end of the firmware binary. Requests for a different title or version are not answered
+    /// @param session Session that sent the request and receives the response
+    /// @param topic Topic of the request, containing the device id, title, version and chunk
+    /// @param payload Requested chunk size as a decimal string
+    /// @param length Amount of bytes in the payload
+    void Handle_Firmware_Request(size_t const & session, String_View const & topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Stores the response to a server side RPC request
+    /// @param topic Topic of the response, containing the request id
+    /// @param payload Serialized JSON response
+    /// @param length Amount of bytes in the payload
+    void Handle_RPC_Response(String_View const & topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Appends the attributes with the keys in the given comma seperated list, that are set, to the given JSON object
+    /// @param attributes Attributes the values are taken from
+    /// @param keys Comma seperated list of requested keys
+    /// @param json Serialized JSON object without the closing bracket, the attributes are appended to
+    static void Append_Attributes(std::map<std::string, std::string> const & attributes, std::string const & keys, std::string & json);
+
+    /// @brief Gets the string value of the given key in the given flat JSON object
+    /// @param payload Serialized JSON object
+    /// @param key Key of the string value
+    /// @return Value without quotes, empty if the key does not exist or its value is not a string
+    static std::string Get_String_Value(std::string const & payload, char const * key);
+
+    Loopback_MQTT_Broker &             m_broker;                   // Broker the emulator is registered at
+    std::map<std::string, std::string> m_client_attributes = {};   // Serialized JSON values of the client side attributes
+    std::map<std::string, std::string> m_shared_attributes = {};   // Serialized JSON values of the shared attributes
+    std::string                        m_firmware_title = {};      // Title of the served firmware
+    std::string                        m_firmware_version = {};    // Version of the served firmware
+    std::vector<uint8_t>               m_firmware = {};            // Served firmware binary
+    std::map<size_t, std::string>      m_rpc_responses = {};       // Received responses to server side RPC requests by request id
+    size_t                             m_next_rpc_id = {};         // Request id of the next server side RPC request
+    size_t                             m_attribute_requests = {};  // Amount of answered attribute requests
+    size_t                             m_firmware_requests = {};   // Amount of answered firmware chunk requests
+    size_t                             m_telemetry_messages = {};  // Amount of received telemetry messages
+    size_t                             m_attribute_messages = {};  // Amount of received client side attribute messages
+    std::string                        m_last_telemetry = {};      // Payload of the last received telemetry message
+    std::vector<size_t>                m_handlers = {};            // Identifiers of the handlers registered at the broker
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // ThingsBoard_Emulator_h
@@ -0,0 +1,90 @@
+#ifndef arduino_timer_h
+#define arduino_timer_h
+
+// Library includes.
+#include <chrono>
+#include <stddef.h>
+
+
+/// @brief Host replacement of the arduino-timer library (https://github.com/contrem/arduino-timer), which needs the Arduino core and can therefore not be used on a host.
+/// Implements only the subset Callback_Watchdog uses, meaning oneshot and repeating tasks started with in(), which are called from within tick() once their delay has passed,
+/// and cancel() which removes all tasks. Together with micros() and millis() based on the steady clock, it allows to run the ThingsBoard client in host tests and benchmarks
+/// @tparam max_tasks Maximum amount of tasks that can be started at the same time
+/// @tparam time_func Method returning the current time, the delay passed to in() has to be in the same unit
+/// @tparam T Argument passed to the handler of every task
+template <size_t max_tasks, unsigned long (*time_func)(), typename T = void *>
+class Timer {
+  public:
+    /// @brief Handler called once the delay of a task has passed, returns whether the task should be repeated with the same delay
+    using handler_t = bool (*)(T);
+
+    /// @brief Starts a task, which calls the given handler once the given delay has passed
+    /// @param delay Delay in the unit of the time method
+    /// @param handler Method called once the delay has passed
+    /// @param opaque Argument passed to the handler
+    /// @return Whether the task was started, fails if max_tasks tasks are already running
+    bool in(unsigned long delay, handler_t handler, T opaque = T()) {
+        for (Task & task : m_tasks) {
+            if (task.handler != nullptr) {
+                continue;
+            }
+            task = Task{time_func(), delay, handler, opaque};
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Removes all tasks, without calling their handlers
+    void cancel() {
+        for (Task & task : m_tasks) {
+            task = Task();
+        }
+    }
+
+    /// @brief Calls the handlers of all tasks whose delay has passed, has to be called regularly
+    /// @tparam R Return type of the original library, unused
+    template <typename R = void>
+    void tick() {
+        for (Task & task : m_tasks) {
+            unsigned long const now = time_func();
+            if (task.handler == nullptr || now - task.start < task.delay) {
+                continue;
+            }
+            // Handler might start the same task again, therefore the task is removed before it is called
+            Task const expired = task;
+            task = Task();
+            if (expired.handler(expired.opaque) && task.handler == nullptr) {
+                task = Task{now, expired.delay, expired.handler, expired.opaque};
+            }
+        }
+    }
+
+  private:
+    /// @brief Started task
+    struct Task {
+        unsigned long start;   // Time the task was started at
+        unsigned long delay;   // Delay after which the handler is called
+        handler_t     handler; // Handler called once the delay has passed, nullptr if the task is not running
+        T             opaque;  // Argument passed to the handler
+    };
+
+    Task m_tasks[max_tasks] = {}; // Running tasks
+};
+
+#ifndef ARDUINO
+
+/// @brief Gets the time since an arbitrary point in the past, the same as the Arduino core
+/// @return Time in microseconds
+inline unsigned long micros() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// @brief Gets the time since an arbitrary point in the past, the same as the Arduino core
+/// @return Time in milliseconds
+inline unsigned long millis() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif // !ARDUINO
+
+#endif // arduino_timer_h